@@ -30,6 +30,16 @@
 
 /* == Declarations ========================================================= */
 
+/** Mapped shared memory, backing one or multiple buffers. */
+typedef struct {
+    /** Mapped data. */
+    void                      *data_ptr;
+    /** Size of the mapping, in bytes. */
+    size_t                    size;
+    /** Number of client buffers using this region. Unmapped when zero. */
+    unsigned                  references;
+} shm_region_t;
+
 /** Actual buffer. TODO(kaeser@gubbe.ch): Clean this up. */
 typedef struct {
     /** Points to the data area, ie. the pixels. */
@@ -47,10 +57,10 @@ typedef struct {
 
 /** All elements contributing to a wl_buffer. */
 struct _wlclient_buffer_t {
-    /** Mapped data. */
-    void                      *data_ptr;
-    /** Shared memory pool. */
-    struct wl_shm_pool        *wl_shm_pool_ptr;
+    /** Element of @ref wlclient_buffer_pool_t `buffers` or `orphans`. */
+    bs_dllist_node_t          dlnode;
+    /** The shared memory holding the pixels. */
+    shm_region_t              *region_ptr;
 
     /** Width of the buffer, in pixels. */
     unsigned                  width;
@@ -64,6 +74,39 @@ struct _wlclient_buffer_t {
     wlclient_buffer_ready_callback_t ready_callback;
     /** Argument to said callback. */
     void                      *ready_callback_ud_ptr;
+
+    /** The pool this buffer belongs to, or NULL. */
+    wlclient_buffer_pool_t    *pool_ptr;
+    /** Whether the buffer is in the pool's `orphans`. */
+    bool                      orphan;
+};
+
+/** State of a buffer pool. */
+struct _wlclient_buffer_pool_t {
+    /** Back-link to the client. */
+    const wlclient_t          *wlclient_ptr;
+    /** Width of the buffers, in pixels. */
+    unsigned                  width;
+    /** Height of the buffers, in pixels. */
+    unsigned                  height;
+    /** Number of buffers to allocate. */
+    unsigned                  num_buffers;
+
+    /** Buffers of the current dimensions. @ref wlclient_buffer_t::dlnode. */
+    bs_dllist_t               buffers;
+    /**
+     * Buffers of earlier dimensions, still held by the compositor. Destroyed
+     * once released.
+     */
+    bs_dllist_t               orphans;
+
+    /** Callback to indicate a buffer is ready to draw into. */
+    wlclient_buffer_ready_callback_t ready_callback;
+    /** Argument to said callback. */
+    void                      *ready_callback_ud_ptr;
+
+    /** Statistics. */
+    wlclient_buffer_pool_stats_t stats;
 };
 
 static void handle_wl_buffer_release(
@@ -71,6 +114,24 @@ static void handle_wl_buffer_release(
     struct wl_buffer *wl_buffer_ptr);
 static int shm_creat(const char *app_id_ptr, size_t size);
 
+static shm_region_t *shm_region_create(
+    const wlclient_t *wlclient_ptr,
+    size_t size,
+    struct wl_shm_pool **wl_shm_pool_ptr_ptr);
+static void shm_region_unref(shm_region_t *region_ptr);
+
+static wlclient_buffer_t *client_buffer_create(
+    shm_region_t *region_ptr,
+    struct wl_shm_pool *wl_shm_pool_ptr,
+    size_t ofs,
+    unsigned width,
+    unsigned height);
+static bool pool_allocate(
+    wlclient_buffer_pool_t *pool_ptr,
+    unsigned width,
+    unsigned height);
+static void pool_release_buffers(wlclient_buffer_pool_t *pool_ptr);
+
 static buffer_t *create_buffer(
     struct wl_shm_pool *wl_shm_pool_ptr,
     void *data_base_ptr,
@@ -100,58 +161,20 @@ wlclient_buffer_t *wlclient_buffer_create(
     wlclient_buffer_ready_callback_t ready_callback,
     void *ready_callback_ud_ptr)
 {
-    wlclient_buffer_t *client_buffer_ptr = logged_calloc(
-        1, sizeof(wlclient_buffer_t));
-    if (NULL == client_buffer_ptr) return NULL;
-    client_buffer_ptr->ready_callback = ready_callback;
-    client_buffer_ptr->ready_callback_ud_ptr = ready_callback_ud_ptr;
-
-    client_buffer_ptr->width = width;
-    client_buffer_ptr->height = height;
-
-    size_t shm_pool_size = width * height * sizeof(uint32_t);
-    int fd = shm_creat(
-        wlclient_attributes(wlclient_ptr)->app_id_ptr, shm_pool_size);
-    if (0 >= fd) {
-        wlclient_buffer_destroy(client_buffer_ptr);
-        return NULL;
-    }
-    client_buffer_ptr->data_ptr = mmap(
-        NULL, shm_pool_size, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
-    if (MAP_FAILED == client_buffer_ptr->data_ptr) {
-        bs_log(BS_ERROR | BS_ERRNO, "Failed mmap(NULL, %zu, "
-               "PROT_READ|PROT_WRITE, MAP_SHARED, %d, 0)",
-               shm_pool_size, fd);
-        close(fd);
-        wlclient_buffer_destroy(client_buffer_ptr);
-        return NULL;
-    }
-
-    struct wl_shm_pool *wl_shm_pool_ptr = wl_shm_create_pool(
-        wlclient_attributes(wlclient_ptr)->wl_shm_ptr, fd, shm_pool_size);
-    close(fd);
-    if (NULL == wl_shm_pool_ptr) {
-        bs_log(BS_ERROR, "Failed wl_shm_create_pool(%p, %d, %zu)",
-               wlclient_attributes(wlclient_ptr)->wl_shm_ptr,
-               fd, shm_pool_size);
-        wlclient_buffer_destroy(client_buffer_ptr);
-        return NULL;
-    }
+    struct wl_shm_pool *wl_shm_pool_ptr;
+    shm_region_t *region_ptr = shm_region_create(
+        wlclient_ptr, width * height * sizeof(uint32_t), &wl_shm_pool_ptr);
+    if (NULL == region_ptr) return NULL;
 
-    client_buffer_ptr->buffer_ptr = create_buffer(
-        wl_shm_pool_ptr,
-        client_buffer_ptr->data_ptr,
-        0,
-        width,
-        height,
-        width * sizeof(uint32_t));
-    if (NULL == client_buffer_ptr->buffer_ptr) {
-        wlclient_buffer_destroy(client_buffer_ptr);
+    wlclient_buffer_t *client_buffer_ptr = client_buffer_create(
+        region_ptr, wl_shm_pool_ptr, 0, width, height);
+    wl_shm_pool_destroy(wl_shm_pool_ptr);
+    if (NULL == client_buffer_ptr) {
+        shm_region_unref(region_ptr);
         return NULL;
     }
-    client_buffer_ptr->buffer_ptr->client_buffer_ptr = client_buffer_ptr;
-
-    wl_shm_pool_destroy(wl_shm_pool_ptr);
+    client_buffer_ptr->ready_callback = ready_callback;
+    client_buffer_ptr->ready_callback_ud_ptr = ready_callback_ud_ptr;
 
     if (NULL != client_buffer_ptr->ready_callback) {
         client_buffer_ptr->ready_callback(
@@ -167,8 +190,12 @@ void wlclient_buffer_destroy(wlclient_buffer_t *client_buffer_ptr)
         buffer_destroy(client_buffer_ptr->buffer_ptr);
         client_buffer_ptr->buffer_ptr = NULL;
     }
+    if (NULL != client_buffer_ptr->region_ptr) {
+        shm_region_unref(client_buffer_ptr->region_ptr);
+        client_buffer_ptr->region_ptr = NULL;
+    }
 
-    bs_log(BS_WARNING, "Destroyed %p", client_buffer_ptr);
+    bs_log(BS_DEBUG, "Destroyed %p", client_buffer_ptr);
     free(client_buffer_ptr);
 }
 
@@ -193,6 +220,92 @@ void wlclient_buffer_attach_to_surface_and_commit(
     wl_surface_commit(wl_surface_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+wlclient_buffer_pool_t *wlclient_buffer_pool_create(
+    const wlclient_t *wlclient_ptr,
+    unsigned width,
+    unsigned height,
+    unsigned num_buffers,
+    wlclient_buffer_ready_callback_t ready_callback,
+    void *ready_callback_ud_ptr)
+{
+    BS_ASSERT(0 < num_buffers);
+    wlclient_buffer_pool_t *pool_ptr = logged_calloc(
+        1, sizeof(wlclient_buffer_pool_t));
+    if (NULL == pool_ptr) return NULL;
+    pool_ptr->wlclient_ptr = wlclient_ptr;
+    pool_ptr->num_buffers = num_buffers;
+    pool_ptr->ready_callback = ready_callback;
+    pool_ptr->ready_callback_ud_ptr = ready_callback_ud_ptr;
+
+    if (!pool_allocate(pool_ptr, width, height)) {
+        wlclient_buffer_pool_destroy(pool_ptr);
+        return NULL;
+    }
+
+    if (NULL != pool_ptr->ready_callback) {
+        pool_ptr->ready_callback(pool_ptr->ready_callback_ud_ptr);
+    }
+    return pool_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlclient_buffer_pool_destroy(wlclient_buffer_pool_t *pool_ptr)
+{
+    pool_release_buffers(pool_ptr);
+
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(&pool_ptr->orphans))) {
+        wlclient_buffer_destroy(
+            BS_CONTAINER_OF(dlnode_ptr, wlclient_buffer_t, dlnode));
+    }
+    free(pool_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlclient_buffer_pool_resize(
+    wlclient_buffer_pool_t *pool_ptr,
+    unsigned width,
+    unsigned height)
+{
+    if (width == pool_ptr->width && height == pool_ptr->height &&
+        NULL != pool_ptr->buffers.head_ptr) return true;
+
+    pool_release_buffers(pool_ptr);
+    pool_ptr->stats.resizes++;
+    if (!pool_allocate(pool_ptr, width, height)) return false;
+
+    if (NULL != pool_ptr->ready_callback) {
+        pool_ptr->ready_callback(pool_ptr->ready_callback_ud_ptr);
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+wlclient_buffer_t *wlclient_buffer_pool_acquire(
+    wlclient_buffer_pool_t *pool_ptr)
+{
+    for (bs_dllist_node_t *dlnode_ptr = pool_ptr->buffers.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlclient_buffer_t *client_buffer_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlclient_buffer_t, dlnode);
+        if (!client_buffer_ptr->buffer_ptr->committed) {
+            pool_ptr->stats.acquisitions++;
+            return client_buffer_ptr;
+        }
+    }
+    pool_ptr->stats.stalls++;
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+const wlclient_buffer_pool_stats_t *wlclient_buffer_pool_stats(
+    const wlclient_buffer_pool_t *pool_ptr)
+{
+    return &pool_ptr->stats;
+}
+
 /* == Local (static) methods =============================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -209,10 +322,208 @@ static void handle_wl_buffer_release(
     buffer_t *buffer_ptr = data_ptr;
     buffer_ptr->committed = false;
 
+    wlclient_buffer_t *client_buffer_ptr = buffer_ptr->client_buffer_ptr;
+    wlclient_buffer_pool_t *pool_ptr = client_buffer_ptr->pool_ptr;
+    if (NULL != pool_ptr) {
+        if (client_buffer_ptr->orphan) {
+            // An orphan of an earlier size. Not needed anymore.
+            bs_dllist_remove(&pool_ptr->orphans, &client_buffer_ptr->dlnode);
+            wlclient_buffer_destroy(client_buffer_ptr);
+            return;
+        }
+        if (NULL != pool_ptr->ready_callback) {
+            pool_ptr->ready_callback(pool_ptr->ready_callback_ud_ptr);
+        }
+        return;
+    }
+
     // Signal a potential user that this buffer is ready to draw into.
-    if (NULL != buffer_ptr->client_buffer_ptr->ready_callback) {
-        buffer_ptr->client_buffer_ptr->ready_callback(
-            buffer_ptr->client_buffer_ptr->ready_callback_ud_ptr);
+    if (NULL != client_buffer_ptr->ready_callback) {
+        client_buffer_ptr->ready_callback(
+            client_buffer_ptr->ready_callback_ud_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates a shared memory region of `size` bytes, maps it and creates a
+ * `wl_shm_pool` for it.
+ *
+ * @param wlclient_ptr
+ * @param size
+ * @param wl_shm_pool_ptr_ptr Set to the `wl_shm_pool` of the region. Must be
+ *                            destroyed by the caller, once all buffers of
+ *                            the region are created.
+ *
+ * @return The region, holding no references yet. Or NULL on error.
+ */
+shm_region_t *shm_region_create(
+    const wlclient_t *wlclient_ptr,
+    size_t size,
+    struct wl_shm_pool **wl_shm_pool_ptr_ptr)
+{
+    shm_region_t *region_ptr = logged_calloc(1, sizeof(shm_region_t));
+    if (NULL == region_ptr) return NULL;
+    region_ptr->size = size;
+
+    int fd = shm_creat(wlclient_attributes(wlclient_ptr)->app_id_ptr, size);
+    if (0 >= fd) {
+        free(region_ptr);
+        return NULL;
+    }
+
+    region_ptr->data_ptr = mmap(
+        NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (MAP_FAILED == region_ptr->data_ptr) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed mmap(NULL, %zu, "
+               "PROT_READ | PROT_WRITE, MAP_SHARED, %d, 0)", size, fd);
+        close(fd);
+        free(region_ptr);
+        return NULL;
+    }
+
+    *wl_shm_pool_ptr_ptr = wl_shm_create_pool(
+        wlclient_attributes(wlclient_ptr)->wl_shm_ptr, fd, size);
+    close(fd);
+    if (NULL == *wl_shm_pool_ptr_ptr) {
+        bs_log(BS_ERROR, "Failed wl_shm_create_pool(%p, %d, %zu)",
+               wlclient_attributes(wlclient_ptr)->wl_shm_ptr, fd, size);
+        munmap(region_ptr->data_ptr, size);
+        free(region_ptr);
+        return NULL;
+    }
+    return region_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Drops a reference to the region. Unmaps it, once unused. */
+void shm_region_unref(shm_region_t *region_ptr)
+{
+    BS_ASSERT(0 < region_ptr->references);
+    if (0 < --region_ptr->references) return;
+
+    if (0 != munmap(region_ptr->data_ptr, region_ptr->size)) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed munmap(%p, %zu)",
+               region_ptr->data_ptr, region_ptr->size);
+    }
+    free(region_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates a client buffer at offset `ofs` of the region. The buffer holds a
+ * reference to the region.
+ *
+ * @param region_ptr
+ * @param wl_shm_pool_ptr
+ * @param ofs
+ * @param width
+ * @param height
+ *
+ * @return The client buffer, or NULL on error. Must be destroyed by calling
+ *     @ref wlclient_buffer_destroy.
+ */
+wlclient_buffer_t *client_buffer_create(
+    shm_region_t *region_ptr,
+    struct wl_shm_pool *wl_shm_pool_ptr,
+    size_t ofs,
+    unsigned width,
+    unsigned height)
+{
+    wlclient_buffer_t *client_buffer_ptr = logged_calloc(
+        1, sizeof(wlclient_buffer_t));
+    if (NULL == client_buffer_ptr) return NULL;
+    client_buffer_ptr->width = width;
+    client_buffer_ptr->height = height;
+
+    client_buffer_ptr->buffer_ptr = create_buffer(
+        wl_shm_pool_ptr, region_ptr->data_ptr, ofs,
+        width, height, width * sizeof(uint32_t));
+    if (NULL == client_buffer_ptr->buffer_ptr) {
+        free(client_buffer_ptr);
+        return NULL;
+    }
+    client_buffer_ptr->buffer_ptr->client_buffer_ptr = client_buffer_ptr;
+
+    client_buffer_ptr->region_ptr = region_ptr;
+    region_ptr->references++;
+    return client_buffer_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Allocates `num_buffers` buffers of the given dimensions, from a single
+ * shared memory region and `wl_shm_pool`. On failure, none are kept.
+ *
+ * @param pool_ptr
+ * @param width
+ * @param height
+ *
+ * @return true on success.
+ */
+bool pool_allocate(
+    wlclient_buffer_pool_t *pool_ptr,
+    unsigned width,
+    unsigned height)
+{
+    pool_ptr->width = width;
+    pool_ptr->height = height;
+
+    size_t buffer_size = (size_t)width * height * sizeof(uint32_t);
+    struct wl_shm_pool *wl_shm_pool_ptr;
+    shm_region_t *region_ptr = shm_region_create(
+        pool_ptr->wlclient_ptr, buffer_size * pool_ptr->num_buffers,
+        &wl_shm_pool_ptr);
+    if (NULL == region_ptr) return false;
+
+    for (unsigned i = 0; i < pool_ptr->num_buffers; ++i) {
+        wlclient_buffer_t *client_buffer_ptr = client_buffer_create(
+            region_ptr, wl_shm_pool_ptr, i * buffer_size, width, height);
+        if (NULL == client_buffer_ptr) break;
+        client_buffer_ptr->pool_ptr = pool_ptr;
+        bs_dllist_push_back(&pool_ptr->buffers, &client_buffer_ptr->dlnode);
+    }
+    wl_shm_pool_destroy(wl_shm_pool_ptr);
+
+    if (0 == region_ptr->references) {
+        munmap(region_ptr->data_ptr, region_ptr->size);
+        free(region_ptr);
+        return false;
+    }
+    if (bs_dllist_size(&pool_ptr->buffers) != pool_ptr->num_buffers) {
+        // Partially allocated. None are committed yet, so drop them all: The
+        // last one releases the region.
+        bs_dllist_node_t *dlnode_ptr;
+        while (NULL != (dlnode_ptr = bs_dllist_pop_front(
+                            &pool_ptr->buffers))) {
+            wlclient_buffer_destroy(
+                BS_CONTAINER_OF(dlnode_ptr, wlclient_buffer_t, dlnode));
+        }
+        return false;
+    }
+    pool_ptr->stats.allocations += pool_ptr->num_buffers;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Releases all buffers of the current dimensions: Destroys those that are
+ * ready, and moves those still committed to the orphans.
+ *
+ * @param pool_ptr
+ */
+void pool_release_buffers(wlclient_buffer_pool_t *pool_ptr)
+{
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(&pool_ptr->buffers))) {
+        wlclient_buffer_t *client_buffer_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlclient_buffer_t, dlnode);
+        if (client_buffer_ptr->buffer_ptr->committed) {
+            client_buffer_ptr->orphan = true;
+            bs_dllist_push_back(&pool_ptr->orphans, dlnode_ptr);
+        } else {
+            wlclient_buffer_destroy(client_buffer_ptr);
+        }
     }
 }
 
@@ -28,6 +28,8 @@ extern "C" {
 
 /** Forward declaration of the buffer state. */
 typedef struct _wlclient_buffer_t wlclient_buffer_t;
+/** Forward declaration of a buffer pool. */
+typedef struct _wlclient_buffer_pool_t wlclient_buffer_pool_t;
 
 /** Forward declaration of a wayland surface. */
 struct wl_surface;
@@ -84,6 +86,87 @@ void wlclient_buffer_attach_to_surface_and_commit(
 bs_gfxbuf_t *bs_gfxbuf_from_wlclient_buffer(
     wlclient_buffer_t *buffer_ptr);
 
+/** Counters of a buffer pool. */
+typedef struct {
+    /** Buffers handed out by @ref wlclient_buffer_pool_acquire. */
+    uint64_t                  acquisitions;
+    /** Acquire attempts that found all buffers still held by the server. */
+    uint64_t                  stalls;
+    /** Buffers allocated, including those for resizes. */
+    uint64_t                  allocations;
+    /** Changes of the pool's buffer dimensions. */
+    uint64_t                  resizes;
+} wlclient_buffer_pool_stats_t;
+
+/**
+ * Creates a pool of `num_buffers` buffers with the given dimensions.
+ *
+ * All buffers are allocated from a single shared memory region and
+ * `wl_shm_pool`. Each buffer is a @ref wlclient_buffer_t, to be used with
+ * @ref bs_gfxbuf_from_wlclient_buffer and
+ * @ref wlclient_buffer_attach_to_surface_and_commit.
+ *
+ * @param wlclient_ptr
+ * @param width
+ * @param height
+ * @param num_buffers         Number of buffers. Must be at least 1.
+ * @param ready_callback      Called when a buffer of the pool may be ready
+ *                            to draw into: After creation, resize, and when
+ *                            a buffer is released by the server.
+ * @param ready_callback_ud_ptr
+ *
+ * @return A pointer to the pool, or NULL on error. Must be destroyed by
+ *     calling @ref wlclient_buffer_pool_destroy.
+ */
+wlclient_buffer_pool_t *wlclient_buffer_pool_create(
+    const wlclient_t *wlclient_ptr,
+    unsigned width,
+    unsigned height,
+    unsigned num_buffers,
+    wlclient_buffer_ready_callback_t ready_callback,
+    void *ready_callback_ud_ptr);
+
+/**
+ * Destroys the buffer pool, and all of it's buffers.
+ *
+ * @param pool_ptr
+ */
+void wlclient_buffer_pool_destroy(wlclient_buffer_pool_t *pool_ptr);
+
+/**
+ * Changes the dimensions of the pool's buffers.
+ *
+ * Allocates a new shared memory region for the new dimensions. Buffers of the
+ * previous dimensions are destroyed right away, or once released by the
+ * server if they are still committed.
+ *
+ * @param pool_ptr
+ * @param width
+ * @param height
+ *
+ * @return true on success, or if the dimensions are unchanged.
+ */
+bool wlclient_buffer_pool_resize(
+    wlclient_buffer_pool_t *pool_ptr,
+    unsigned width,
+    unsigned height);
+
+/**
+ * Returns the first buffer of the pool that is not held by the server.
+ *
+ * @param pool_ptr
+ *
+ * @return A buffer ready to draw into, or NULL if all buffers are still
+ *     committed. This is counted as a stall; the ready callback will be
+ *     invoked once a buffer is released. The buffer is owned by the pool.
+ */
+wlclient_buffer_t *wlclient_buffer_pool_acquire(
+    wlclient_buffer_pool_t *pool_ptr);
+
+/** @return Pointer to the counters of the pool. */
+const wlclient_buffer_pool_stats_t *wlclient_buffer_pool_stats(
+    const wlclient_buffer_pool_t *pool_ptr);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -25,6 +25,7 @@
 #include <signal.h>
 #include <stdarg.h>
 #include <sys/signalfd.h>
+#include <sys/timerfd.h>
 
 #include <wayland-client.h>
 #include "wlmaker-icon-unstable-v1-client-protocol.h"
@@ -40,27 +41,78 @@ struct _wlclient_t {
     /** Registry singleton for the above connection. */
     struct wl_registry        *wl_registry_ptr;
 
-    /** List of registered timers. TODO(kaeser@gubbe.ch): Replace with HEAP. */
-    bs_dllist_t               timers;
+    /** Min-heap of armed timers, ordered by their target time. */
+    wlclient_timer_t          **timers;
+    /** Number of armed timers in @ref _wlclient_t::timers. */
+    size_t                    num_timers;
+    /** Allocated capacity of @ref _wlclient_t::timers. */
+    size_t                    timers_capacity;
+    /** List of timers to destroy after firing: @ref wlclient_register_timer. */
+    bs_dllist_t               oneshot_timers;
 
     /** File descriptor to monitor SIGINT. */
     int                       signal_fd;
+    /** A timerfd, armed for the earliest timer's target time. */
+    int                       timer_fd;
+    /** Target time the timerfd is armed for, or 0 if disarmed. */
+    uint64_t                  armed_usec;
+
+    /** Extra file descriptors to poll. See @ref wlclient_fd_t::dlnode. */
+    bs_dllist_t               fds;
+    /** Extra file descriptors removed while dispatching. Freed after. */
+    bs_dllist_t               removed_fds;
+    /**
+     * Whether any callbacks are dispatched after `poll()`. While set,
+     * removed file descriptors may still be referenced from
+     * @ref _wlclient_t::pollfd_entries, and are only freed after dispatching.
+     */
+    bool                      dispatching_fds;
+    /** Poll descriptors, re-used across iterations of @ref wlclient_run. */
+    struct pollfd             *pollfds;
+    /** Entries corresponding to @ref _wlclient_t::pollfds. */
+    wlclient_fd_t             **pollfd_entries;
+    /** Allocated capacity of the two arrays above. */
+    size_t                    pollfds_capacity;
 
     /** Whether to keep the client running. */
     volatile bool             keep_running;
 };
 
-/** State of a registered timer. */
-typedef struct {
-    /** Node within the list of timers, see `wlclient_t.timers`. */
+/** State of a timer. */
+struct _wlclient_timer_t {
+    /** Back-link to the client. */
+    wlclient_t                *wlclient_ptr;
+    /** Position in `wlclient_t.timers`, or `SIZE_MAX` if not armed. */
+    size_t                    heap_index;
+    /** Node within `wlclient_t.oneshot_timers`, for one-shot registrations. */
     bs_dllist_node_t          dlnode;
+    /** Whether to destroy the timer once it fired. */
+    bool                      oneshot;
     /** Target time, in usec since epoch. */
     uint64_t                  target_usec;
+    /** Period for re-arming the timer after it fired. 0 if not periodic. */
+    uint64_t                  period_usec;
     /** Callback once the timer is triggered. */
     wlclient_callback_t       callback;
     /** Argument to the callback. */
     void                      *callback_ud_ptr;
-} wlclient_timer_t;
+};
+
+/** State of an extra file descriptor to poll. */
+struct _wlclient_fd_t {
+    /** Node within `wlclient_t.fds` or `wlclient_t.removed_fds`. */
+    bs_dllist_node_t          dlnode;
+    /** Back-link to the client. */
+    wlclient_t                *wlclient_ptr;
+    /** The file descriptor. */
+    int                       fd;
+    /** Events to poll for, as for `struct pollfd`. */
+    short                     events;
+    /** Callback for when any of the events occurred. NULL if removed. */
+    wlclient_fd_callback_t    callback;
+    /** Argument to the callback. */
+    void                      *callback_ud_ptr;
+};
 
 /** Descriptor for a wayland object to bind to. */
 typedef struct {
@@ -87,13 +139,20 @@ static void handle_global_remove(
     struct wl_registry *registry,
     uint32_t name);
 
-static wlclient_timer_t *wlc_timer_create(
+static bool wlc_timer_heap_insert(
+    wlclient_t *client_ptr,
+    wlclient_timer_t *timer_ptr);
+static void wlc_timer_heap_remove(
     wlclient_t *client_ptr,
-    uint64_t target_usec,
-    wlclient_callback_t callback,
-    void *callback_ud_ptr);
-static void wlc_timer_destroy(
     wlclient_timer_t *timer_ptr);
+static void wlc_timer_heap_sift_up(wlclient_t *client_ptr, size_t idx);
+static void wlc_timer_heap_sift_down(wlclient_t *client_ptr, size_t idx);
+static void wlc_timer_heap_swap(wlclient_t *client_ptr, size_t i, size_t j);
+static void wlc_timers_fire(wlclient_t *client_ptr);
+static bool wlc_timer_fd_update(wlclient_t *client_ptr);
+static size_t wlc_pollfds_prepare(wlclient_t *client_ptr);
+static void wlc_fds_dispatch(wlclient_t *client_ptr, size_t num_pollfds);
+static void wlc_fds_release_removed(wlclient_t *client_ptr);
 
 /* == Data ================================================================= */
 
@@ -159,6 +218,15 @@ wlclient_t *wlclient_create(const char *app_id_ptr)
         return NULL;
     }
 
+    wlclient_ptr->timer_fd = timerfd_create(
+        CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (0 >= wlclient_ptr->timer_fd) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed timerfd_create(CLOCK_REALTIME, "
+               "TFD_NONBLOCK | TFD_CLOEXEC)");
+        wlclient_destroy(wlclient_ptr);
+        return NULL;
+    }
+
     wlclient_ptr->attributes.wl_display_ptr = wl_display_connect(NULL);
     if (NULL == wlclient_ptr->attributes.wl_display_ptr) {
         bs_log(BS_ERROR, "Failed wl_display_connect(NULL).");
@@ -211,8 +279,25 @@ wlclient_t *wlclient_create(const char *app_id_ptr)
 void wlclient_destroy(wlclient_t *wlclient_ptr)
 {
     bs_dllist_node_t *dlnode_ptr;
-    while (NULL != (dlnode_ptr = bs_dllist_pop_front(&wlclient_ptr->timers))) {
-        wlc_timer_destroy((wlclient_timer_t*)dlnode_ptr);
+    while (NULL != (dlnode_ptr = wlclient_ptr->oneshot_timers.head_ptr)) {
+        wlclient_timer_destroy(
+            BS_CONTAINER_OF(dlnode_ptr, wlclient_timer_t, dlnode));
+    }
+    if (NULL != wlclient_ptr->timers) {
+        free(wlclient_ptr->timers);
+        wlclient_ptr->timers = NULL;
+    }
+
+    while (NULL != (dlnode_ptr = wlclient_ptr->fds.head_ptr)) {
+        wlclient_remove_fd(BS_CONTAINER_OF(dlnode_ptr, wlclient_fd_t, dlnode));
+    }
+    if (NULL != wlclient_ptr->pollfds) {
+        free(wlclient_ptr->pollfds);
+        wlclient_ptr->pollfds = NULL;
+    }
+    if (NULL != wlclient_ptr->pollfd_entries) {
+        free(wlclient_ptr->pollfd_entries);
+        wlclient_ptr->pollfd_entries = NULL;
     }
 
     if (NULL != wlclient_ptr->wl_registry_ptr) {
@@ -225,6 +310,11 @@ void wlclient_destroy(wlclient_t *wlclient_ptr)
         wlclient_ptr->attributes.wl_display_ptr = NULL;
     }
 
+    if (0 < wlclient_ptr->timer_fd) {
+        close(wlclient_ptr->timer_fd);
+        wlclient_ptr->timer_fd = 0;
+    }
+
     if (0 < wlclient_ptr->signal_fd) {
         close(wlclient_ptr->signal_fd);
         wlclient_ptr->signal_fd = 0;
@@ -271,21 +361,27 @@ void wlclient_run(wlclient_t *wlclient_ptr)
             }
         }
 
-        struct pollfd pollfds[2];
-        pollfds[0].fd = wl_display_get_fd(wlclient_ptr->attributes.wl_display_ptr);
-        pollfds[0].events = POLLIN;
-        pollfds[0].revents = 0;
-
-        pollfds[1].fd = wlclient_ptr->signal_fd;
-        pollfds[1].events = POLLIN;
-        pollfds[1].revents = 0;
+        if (!wlc_timer_fd_update(wlclient_ptr)) {
+            wl_display_cancel_read(wlclient_ptr->attributes.wl_display_ptr);
+            break;  // Error!
+        }
+        size_t num_pollfds = wlc_pollfds_prepare(wlclient_ptr);
+        if (0 == num_pollfds) {
+            wl_display_cancel_read(wlclient_ptr->attributes.wl_display_ptr);
+            break;  // Error!
+        }
+        struct pollfd *pollfds = wlclient_ptr->pollfds;
 
-        int rv = poll(&pollfds[0], 2, 100);
+        // Sleeps until an event arrives, or the timerfd expires.
+        int rv = poll(pollfds, num_pollfds, -1);
         if (0 > rv && EINTR != errno) {
-            bs_log(BS_ERROR | BS_ERRNO, "Failed poll(%p, 1, 100)", &pollfds);
+            bs_log(BS_ERROR | BS_ERRNO, "Failed poll(%p, %zu, -1)",
+                   pollfds, num_pollfds);
             wl_display_cancel_read(wlclient_ptr->attributes.wl_display_ptr);
             break;  // Error!
         }
+        // Any callback from here on may remove file descriptors.
+        wlclient_ptr->dispatching_fds = true;
 
         if (pollfds[0].revents & POLLIN) {
             if (0 > wl_display_read_events(wlclient_ptr->attributes.wl_display_ptr)) {
@@ -334,19 +430,22 @@ void wlclient_run(wlclient_t *wlclient_ptr)
             break;  // Error!
         }
 
-        // Flush the timer queue.
-        uint64_t current_usec = bs_usec();
-        bs_dllist_node_t *dlnode_ptr;
-        while (NULL != (dlnode_ptr = wlclient_ptr->timers.head_ptr) &&
-               ((wlclient_timer_t*)dlnode_ptr)->target_usec <= current_usec) {
-            bs_dllist_pop_front(&wlclient_ptr->timers);
-
-            wlclient_timer_t *timer_ptr = (wlclient_timer_t*)dlnode_ptr;
-            timer_ptr->callback(wlclient_ptr, timer_ptr->callback_ud_ptr);
-            wlc_timer_destroy(timer_ptr);
+        if (pollfds[2].revents & POLLIN) {
+            uint64_t expirations;
+            if (0 > read(wlclient_ptr->timer_fd, &expirations,
+                         sizeof(expirations)) && EAGAIN != errno) {
+                bs_log(BS_ERROR | BS_ERRNO, "Failed read(%d, %p, %zu)",
+                       wlclient_ptr->timer_fd, &expirations,
+                       sizeof(expirations));
+                break;
+            }
         }
+        wlc_timers_fire(wlclient_ptr);
+        wlc_fds_dispatch(wlclient_ptr, num_pollfds);
+        wlc_fds_release_removed(wlclient_ptr);
 
     } while (wlclient_ptr->keep_running);
+    wlc_fds_release_removed(wlclient_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -356,9 +455,95 @@ bool wlclient_register_timer(
     wlclient_callback_t callback,
     void *callback_ud_ptr)
 {
-    wlclient_timer_t *timer_ptr = wlc_timer_create(
-        wlclient_ptr, target_usec, callback, callback_ud_ptr);
-    return (timer_ptr != NULL);
+    wlclient_timer_t *timer_ptr = wlclient_timer_create(
+        wlclient_ptr, callback, callback_ud_ptr);
+    if (NULL == timer_ptr) return false;
+    timer_ptr->oneshot = true;
+    bs_dllist_push_back(&wlclient_ptr->oneshot_timers, &timer_ptr->dlnode);
+
+    if (!wlclient_timer_arm(timer_ptr, target_usec, 0)) {
+        wlclient_timer_destroy(timer_ptr);
+        return false;
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+wlclient_timer_t *wlclient_timer_create(
+    wlclient_t *wlclient_ptr,
+    wlclient_callback_t callback,
+    void *callback_ud_ptr)
+{
+    wlclient_timer_t *timer_ptr = logged_calloc(1, sizeof(wlclient_timer_t));
+    if (NULL == timer_ptr) return NULL;
+    timer_ptr->wlclient_ptr = wlclient_ptr;
+    timer_ptr->heap_index = SIZE_MAX;
+    timer_ptr->callback = callback;
+    timer_ptr->callback_ud_ptr = callback_ud_ptr;
+    return timer_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlclient_timer_destroy(wlclient_timer_t *timer_ptr)
+{
+    wlclient_timer_disarm(timer_ptr);
+    if (timer_ptr->oneshot) {
+        bs_dllist_remove(&timer_ptr->wlclient_ptr->oneshot_timers,
+                         &timer_ptr->dlnode);
+    }
+    free(timer_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlclient_timer_arm(
+    wlclient_timer_t *timer_ptr,
+    uint64_t target_usec,
+    uint64_t period_usec)
+{
+    wlclient_timer_disarm(timer_ptr);
+    timer_ptr->target_usec = target_usec;
+    timer_ptr->period_usec = period_usec;
+    return wlc_timer_heap_insert(timer_ptr->wlclient_ptr, timer_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlclient_timer_disarm(wlclient_timer_t *timer_ptr)
+{
+    if (SIZE_MAX == timer_ptr->heap_index) return;
+    wlc_timer_heap_remove(timer_ptr->wlclient_ptr, timer_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+wlclient_fd_t *wlclient_add_fd(
+    wlclient_t *wlclient_ptr,
+    int fd,
+    short events,
+    wlclient_fd_callback_t callback,
+    void *callback_ud_ptr)
+{
+    wlclient_fd_t *fd_ptr = logged_calloc(1, sizeof(wlclient_fd_t));
+    if (NULL == fd_ptr) return NULL;
+    fd_ptr->wlclient_ptr = wlclient_ptr;
+    fd_ptr->fd = fd;
+    fd_ptr->events = events;
+    fd_ptr->callback = callback;
+    fd_ptr->callback_ud_ptr = callback_ud_ptr;
+    bs_dllist_push_back(&wlclient_ptr->fds, &fd_ptr->dlnode);
+    return fd_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlclient_remove_fd(wlclient_fd_t *fd_ptr)
+{
+    wlclient_t *wlclient_ptr = fd_ptr->wlclient_ptr;
+    bs_dllist_remove(&wlclient_ptr->fds, &fd_ptr->dlnode);
+    if (wlclient_ptr->dispatching_fds) {
+        // Still referenced from `pollfd_entries`. Free after dispatching.
+        fd_ptr->callback = NULL;
+        bs_dllist_push_back(&wlclient_ptr->removed_fds, &fd_ptr->dlnode);
+        return;
+    }
+    free(fd_ptr);
 }
 
 /* == Local (static) methods =============================================== */
@@ -451,53 +636,252 @@ void handle_global_remove(
 
 /* ------------------------------------------------------------------------- */
 /**
- * Creates a timer and registers it with the client.
+ * Inserts the timer into the client's heap of armed timers.
  *
  * @param client_ptr
- * @param target_usec
- * @param callback
- * @param callback_ud_ptr
+ * @param timer_ptr
  *
- * @return A pointer to the created timer, or NULL on error. The pointer must
- *     be destroyed by @ref wlc_timer_destroy.
+ * @return true on success.
  */
-wlclient_timer_t *wlc_timer_create(
+bool wlc_timer_heap_insert(
     wlclient_t *client_ptr,
-    uint64_t target_usec,
-    wlclient_callback_t callback,
-    void *callback_ud_ptr)
+    wlclient_timer_t *timer_ptr)
 {
-    wlclient_timer_t *timer_ptr = logged_calloc(1, sizeof(wlclient_timer_t));
-    if (NULL == timer_ptr) return NULL;
+    if (client_ptr->num_timers >= client_ptr->timers_capacity) {
+        size_t capacity = BS_MAX(16, 2 * client_ptr->timers_capacity);
+        wlclient_timer_t **timers = realloc(
+            client_ptr->timers, capacity * sizeof(wlclient_timer_t*));
+        if (NULL == timers) {
+            bs_log(BS_ERROR | BS_ERRNO, "Failed realloc(%p, %zu)",
+                   client_ptr->timers, capacity * sizeof(wlclient_timer_t*));
+            return false;
+        }
+        client_ptr->timers = timers;
+        client_ptr->timers_capacity = capacity;
+    }
 
-    timer_ptr->target_usec = target_usec;
-    timer_ptr->callback = callback;
-    timer_ptr->callback_ud_ptr = callback_ud_ptr;
+    timer_ptr->heap_index = client_ptr->num_timers++;
+    client_ptr->timers[timer_ptr->heap_index] = timer_ptr;
+    wlc_timer_heap_sift_up(client_ptr, timer_ptr->heap_index);
+    return true;
+}
 
-    // TODO(kaeser@gubbe.ch): This should be a HEAP.
-    bs_dllist_node_t *dlnode_ptr = client_ptr->timers.head_ptr;
-    for (; dlnode_ptr != NULL; dlnode_ptr = dlnode_ptr->next_ptr) {
-        wlclient_timer_t *ref_timer_ptr = (wlclient_timer_t *)dlnode_ptr;
-        if (timer_ptr->target_usec > ref_timer_ptr->target_usec) continue;
-        bs_dllist_insert_node_before(
-            &client_ptr->timers, dlnode_ptr, &timer_ptr->dlnode);
+/* ------------------------------------------------------------------------- */
+/** Removes the timer from the client's heap of armed timers. */
+void wlc_timer_heap_remove(
+    wlclient_t *client_ptr,
+    wlclient_timer_t *timer_ptr)
+{
+    size_t idx = timer_ptr->heap_index;
+    BS_ASSERT(idx < client_ptr->num_timers);
+    BS_ASSERT(client_ptr->timers[idx] == timer_ptr);
+
+    size_t last = --client_ptr->num_timers;
+    if (idx != last) {
+        wlc_timer_heap_swap(client_ptr, idx, last);
+        wlc_timer_heap_sift_down(client_ptr, idx);
+        wlc_timer_heap_sift_up(client_ptr, idx);
     }
-    if (NULL == dlnode_ptr) {
-        bs_dllist_push_back(&client_ptr->timers, &timer_ptr->dlnode);
+    timer_ptr->heap_index = SIZE_MAX;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Moves the timer at `idx` towards the root, until the heap is ordered. */
+void wlc_timer_heap_sift_up(wlclient_t *client_ptr, size_t idx)
+{
+    while (0 < idx) {
+        size_t parent = (idx - 1) / 2;
+        if (client_ptr->timers[parent]->target_usec <=
+            client_ptr->timers[idx]->target_usec) return;
+        wlc_timer_heap_swap(client_ptr, parent, idx);
+        idx = parent;
     }
+}
 
-    return timer_ptr;
+/* ------------------------------------------------------------------------- */
+/** Moves the timer at `idx` towards the leaves, until the heap is ordered. */
+void wlc_timer_heap_sift_down(wlclient_t *client_ptr, size_t idx)
+{
+    for (;;) {
+        size_t min = idx;
+        for (size_t child = 2 * idx + 1;
+             child <= 2 * idx + 2 && child < client_ptr->num_timers;
+             ++child) {
+            if (client_ptr->timers[child]->target_usec <
+                client_ptr->timers[min]->target_usec) min = child;
+        }
+        if (min == idx) return;
+        wlc_timer_heap_swap(client_ptr, min, idx);
+        idx = min;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Swaps the timers at `i` and `j`, and updates their heap index. */
+void wlc_timer_heap_swap(wlclient_t *client_ptr, size_t i, size_t j)
+{
+    wlclient_timer_t *timer_ptr = client_ptr->timers[i];
+    client_ptr->timers[i] = client_ptr->timers[j];
+    client_ptr->timers[j] = timer_ptr;
+    client_ptr->timers[i]->heap_index = i;
+    client_ptr->timers[j]->heap_index = j;
 }
 
 /* ------------------------------------------------------------------------- */
 /**
- * Destroys the timer. Note: The timer will NOT be unregistered first.
+ * Fires all timers that are due. Periodic timers are re-armed for their next
+ * period that is still due, skipping periods that were missed.
  *
- * @param timer_ptr
+ * @param client_ptr
  */
-void wlc_timer_destroy(wlclient_timer_t *timer_ptr)
+void wlc_timers_fire(wlclient_t *client_ptr)
 {
-    free(timer_ptr);
+    uint64_t current_usec = bs_usec();
+    while (0 < client_ptr->num_timers &&
+           client_ptr->timers[0]->target_usec <= current_usec) {
+        wlclient_timer_t *timer_ptr = client_ptr->timers[0];
+        wlc_timer_heap_remove(client_ptr, timer_ptr);
+
+        if (0 < timer_ptr->period_usec) {
+            uint64_t missed = (current_usec - timer_ptr->target_usec) /
+                timer_ptr->period_usec;
+            timer_ptr->target_usec += (missed + 1) * timer_ptr->period_usec;
+            wlc_timer_heap_insert(client_ptr, timer_ptr);
+        }
+
+        // The callback may re-arm, disarm or destroy non-oneshot timers.
+        bool oneshot = timer_ptr->oneshot;
+        timer_ptr->callback(client_ptr, timer_ptr->callback_ud_ptr);
+        if (oneshot) wlclient_timer_destroy(timer_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Arms the timerfd for the earliest timer, or disarms it if there is none.
+ *
+ * @param client_ptr
+ *
+ * @return true on success.
+ */
+bool wlc_timer_fd_update(wlclient_t *client_ptr)
+{
+    uint64_t target_usec = 0;
+    if (0 < client_ptr->num_timers) {
+        // A zero `it_value` disarms the timerfd. Fire right away, instead.
+        target_usec = BS_MAX(1, client_ptr->timers[0]->target_usec);
+    }
+    if (target_usec == client_ptr->armed_usec) return true;
+
+    struct itimerspec spec = {
+        .it_interval = { .tv_sec = 0, .tv_nsec = 0 },
+        .it_value = {
+            .tv_sec = target_usec / 1000000,
+            .tv_nsec = (target_usec % 1000000) * 1000
+        }
+    };
+    if (0 != timerfd_settime(
+            client_ptr->timer_fd, TFD_TIMER_ABSTIME, &spec, NULL)) {
+        bs_log(BS_ERROR | BS_ERRNO,
+               "Failed timerfd_settime(%d, TFD_TIMER_ABSTIME, %p, NULL)",
+               client_ptr->timer_fd, &spec);
+        return false;
+    }
+    client_ptr->armed_usec = target_usec;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Fills `pollfds`: The display, the signal and the timer file descriptors,
+ * followed by the extra file descriptors.
+ *
+ * @param client_ptr
+ *
+ * @return Number of elements in `pollfds`, or 0 on error.
+ */
+size_t wlc_pollfds_prepare(wlclient_t *client_ptr)
+{
+    size_t num_pollfds = 3 + bs_dllist_size(&client_ptr->fds);
+    if (num_pollfds > client_ptr->pollfds_capacity) {
+        struct pollfd *pollfds = realloc(
+            client_ptr->pollfds, num_pollfds * sizeof(struct pollfd));
+        if (NULL == pollfds) {
+            bs_log(BS_ERROR | BS_ERRNO, "Failed realloc(%p, %zu)",
+                   client_ptr->pollfds, num_pollfds * sizeof(struct pollfd));
+            return 0;
+        }
+        client_ptr->pollfds = pollfds;
+        wlclient_fd_t **entries = realloc(
+            client_ptr->pollfd_entries, num_pollfds * sizeof(wlclient_fd_t*));
+        if (NULL == entries) {
+            bs_log(BS_ERROR | BS_ERRNO, "Failed realloc(%p, %zu)",
+                   client_ptr->pollfd_entries,
+                   num_pollfds * sizeof(wlclient_fd_t*));
+            return 0;
+        }
+        client_ptr->pollfd_entries = entries;
+        client_ptr->pollfds_capacity = num_pollfds;
+    }
+
+    struct pollfd *pollfds = client_ptr->pollfds;
+    pollfds[0].fd = wl_display_get_fd(client_ptr->attributes.wl_display_ptr);
+    pollfds[1].fd = client_ptr->signal_fd;
+    pollfds[2].fd = client_ptr->timer_fd;
+    for (size_t i = 0; i < 3; ++i) {
+        pollfds[i].events = POLLIN;
+        pollfds[i].revents = 0;
+        client_ptr->pollfd_entries[i] = NULL;
+    }
+
+    size_t i = 3;
+    for (bs_dllist_node_t *dlnode_ptr = client_ptr->fds.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr, ++i) {
+        wlclient_fd_t *fd_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlclient_fd_t, dlnode);
+        pollfds[i].fd = fd_ptr->fd;
+        pollfds[i].events = fd_ptr->events;
+        pollfds[i].revents = 0;
+        client_ptr->pollfd_entries[i] = fd_ptr;
+    }
+    return num_pollfds;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Calls the callbacks of the extra file descriptors that have events.
+ *
+ * @param client_ptr
+ * @param num_pollfds
+ */
+void wlc_fds_dispatch(wlclient_t *client_ptr, size_t num_pollfds)
+{
+    for (size_t i = 3; i < num_pollfds; ++i) {
+        wlclient_fd_t *fd_ptr = client_ptr->pollfd_entries[i];
+        if (0 == client_ptr->pollfds[i].revents) continue;
+        if (NULL == fd_ptr->callback) continue;  // Removed meanwhile.
+        fd_ptr->callback(client_ptr, fd_ptr->fd,
+                         client_ptr->pollfds[i].revents,
+                         fd_ptr->callback_ud_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Ends dispatching, and frees the file descriptors removed meanwhile.
+ *
+ * @param client_ptr
+ */
+void wlc_fds_release_removed(wlclient_t *client_ptr)
+{
+    client_ptr->dispatching_fds = false;
+
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(
+                        &client_ptr->removed_fds))) {
+        free(BS_CONTAINER_OF(dlnode_ptr, wlclient_fd_t, dlnode));
+    }
 }
 
 /* == End of client.c ====================================================== */
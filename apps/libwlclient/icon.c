@@ -47,13 +47,11 @@ typedef struct _wlclient_icon_t {
     /** Argument to that callback. */
     void                      *buffer_ready_callback_ud_ptr;
 
-    /** The buffer backing the icon. */
-    wlclient_buffer_t        *buffer_ptr;
+    /** The buffers backing the icon. */
+    wlclient_buffer_pool_t   *buffer_pool_ptr;
 
     /** Outstanding frames to display. Considered ready to draw when zero. */
     int                       pending_frames;
-    /** Whether the buffer was reported as ready. */
-    bool                      buffer_ready;
     /** Whether there is currently a callback in progress. */
     bool                      callback_in_progress;
 } wlclient_icon_t;
@@ -73,6 +71,9 @@ static void state(wlclient_icon_t *icon_ptr);
 
 /* == Data ================================================================= */
 
+/** Number of buffers for the icon: One displayed, one to draw into. */
+static const unsigned         icon_num_buffers = 2;
+
 /** Listener implementation for toplevel icon. */
 static const struct zwlmaker_toplevel_icon_v1_listener toplevel_icon_listener={
     .configure = handle_toplevel_icon_configure,
@@ -136,6 +137,17 @@ void wlclient_icon_destroy(wlclient_icon_t *icon_ptr)
         icon_ptr->toplevel_icon_ptr = NULL;
     }
 
+    if (NULL != icon_ptr->buffer_pool_ptr) {
+        const wlclient_buffer_pool_stats_t *stats_ptr =
+            wlclient_buffer_pool_stats(icon_ptr->buffer_pool_ptr);
+        bs_log(BS_DEBUG, "Icon %p buffers: %"PRIu64" acquired, %"PRIu64
+               " stalls, %"PRIu64" allocated, %"PRIu64" resizes.", icon_ptr,
+               stats_ptr->acquisitions, stats_ptr->stalls,
+               stats_ptr->allocations, stats_ptr->resizes);
+        wlclient_buffer_pool_destroy(icon_ptr->buffer_pool_ptr);
+        icon_ptr->buffer_pool_ptr = NULL;
+    }
+
     if (NULL != icon_ptr->wl_surface_ptr) {
         wl_surface_destroy(icon_ptr->wl_surface_ptr);
         icon_ptr->wl_surface_ptr = NULL;
@@ -167,7 +179,8 @@ void wlclient_icon_callback_when_ready(
 
 /* ------------------------------------------------------------------------- */
 /**
- * Handles the 'configure' event: Creates appropriately sized buffer.
+ * Handles the 'configure' event: Creates appropriately sized buffers, or
+ * resizes them.
  *
  * @param data_ptr
  * @param zwlmaker_toplevel_icon_v1_ptr
@@ -191,14 +204,26 @@ void handle_toplevel_icon_configure(
 
     wlclient_t *wlclient_ptr = icon_ptr->wlclient_ptr;
 
-    icon_ptr->buffer_ptr = wlclient_buffer_create(
-        wlclient_ptr, icon_ptr->width, icon_ptr->height,
-        handle_buffer_ready, icon_ptr);
-    if (NULL == icon_ptr->buffer_ptr) {
-        bs_log(BS_FATAL, "Failed wlclient_buffer_create(%p, %u, %u)",
-               wlclient_ptr, icon_ptr->width, icon_ptr->height);
-        // TODO(kaeser@gubbe.ch): Error handling.
-        return;
+    if (NULL != icon_ptr->buffer_pool_ptr) {
+        if (!wlclient_buffer_pool_resize(
+                icon_ptr->buffer_pool_ptr,
+                icon_ptr->width, icon_ptr->height)) {
+            bs_log(BS_FATAL, "Failed wlclient_buffer_pool_resize(%p, %u, %u)",
+                   icon_ptr->buffer_pool_ptr,
+                   icon_ptr->width, icon_ptr->height);
+            // TODO(kaeser@gubbe.ch): Error handling.
+            return;
+        }
+    } else {
+        icon_ptr->buffer_pool_ptr = wlclient_buffer_pool_create(
+            wlclient_ptr, icon_ptr->width, icon_ptr->height,
+            icon_num_buffers, handle_buffer_ready, icon_ptr);
+        if (NULL == icon_ptr->buffer_pool_ptr) {
+            bs_log(BS_FATAL, "Failed wlclient_buffer_pool_create(%p, %u, %u)",
+                   wlclient_ptr, icon_ptr->width, icon_ptr->height);
+            // TODO(kaeser@gubbe.ch): Error handling.
+            return;
+        }
     }
 
     state(icon_ptr);
@@ -206,14 +231,13 @@ void handle_toplevel_icon_configure(
 
 /* ------------------------------------------------------------------------- */
 /**
- * Updates the information that there is a buffer ready to be drawn into.
+ * Handles a buffer of the pool becoming ready to be drawn into.
  *
  * @param data_ptr
  */
 void handle_buffer_ready(void *data_ptr)
 {
     wlclient_icon_t *icon_ptr = data_ptr;
-    icon_ptr->buffer_ready = true;
     state(icon_ptr);
 }
 
@@ -246,13 +270,17 @@ void handle_frame_done(
 void state(wlclient_icon_t *icon_ptr)
 {
     // Not fully initialized, skip this attempt.
-    if (NULL == icon_ptr->buffer_ptr) return;
+    if (NULL == icon_ptr->buffer_pool_ptr) return;
     // ... or, no callback...
     if (NULL == icon_ptr->buffer_ready_callback) return;
     // ... or, actually not ready.
-    if (0 < icon_ptr->pending_frames || !icon_ptr->buffer_ready) return;
+    if (0 < icon_ptr->pending_frames) return;
     // ... or, a callback is currently in progress.
     if (icon_ptr->callback_in_progress) return;
+    // ... or, all buffers are still held by the compositor.
+    wlclient_buffer_t *buffer_ptr = wlclient_buffer_pool_acquire(
+        icon_ptr->buffer_pool_ptr);
+    if (NULL == buffer_ptr) return;
 
     wlclient_icon_gfxbuf_callback_t callback = icon_ptr->buffer_ready_callback;
     void *ud_ptr = icon_ptr->buffer_ready_callback_ud_ptr;
@@ -260,7 +288,7 @@ void state(wlclient_icon_t *icon_ptr)
     icon_ptr->buffer_ready_callback_ud_ptr = NULL;
     icon_ptr->callback_in_progress = true;
     bool rv = callback(
-        icon_ptr, bs_gfxbuf_from_wlclient_buffer(icon_ptr->buffer_ptr), ud_ptr);
+        icon_ptr, bs_gfxbuf_from_wlclient_buffer(buffer_ptr), ud_ptr);
     icon_ptr->callback_in_progress = false;
     if (!rv) return;
 
@@ -273,9 +301,8 @@ void state(wlclient_icon_t *icon_ptr)
         0, 0, INT32_MAX, INT32_MAX);
 
     icon_ptr->pending_frames++;
-    icon_ptr->buffer_ready = false;
     wlclient_buffer_attach_to_surface_and_commit(
-        icon_ptr->buffer_ptr,
+        buffer_ptr,
         icon_ptr->wl_surface_ptr);
 }
 
@@ -26,6 +26,10 @@
 
 /** Forward declaration: Wayland client handle. */
 typedef struct _wlclient_t wlclient_t;
+/** Forward declaration: A timer of the client. */
+typedef struct _wlclient_timer_t wlclient_timer_t;
+/** Forward declaration: An extra file descriptor polled by the client. */
+typedef struct _wlclient_fd_t wlclient_fd_t;
 
 #include "icon.h"
 
@@ -43,6 +47,20 @@ typedef void (*wlclient_callback_t)(
     wlclient_t *wlclient_ptr,
     void *ud_ptr);
 
+/**
+ * Callback for an extra file descriptor, as used in @ref wlclient_add_fd.
+ *
+ * @param wlclient_ptr
+ * @param fd
+ * @param revents             The events that occurred, as from poll(2).
+ * @param ud_ptr
+ */
+typedef void (*wlclient_fd_callback_t)(
+    wlclient_t *wlclient_ptr,
+    int fd,
+    short revents,
+    void *ud_ptr);
+
 /** Accessor to 'public' client attributes. */
 typedef struct {
     /** Wayland display connection. */
@@ -90,6 +108,9 @@ const wlclient_attributes_t *wlclient_attributes(
 /**
  * Runs the client's mainloop.
  *
+ * Sleeps until there are events on the wayland display, on any of the extra
+ * file descriptors, or until the earliest timer is due.
+ *
  * @param wlclient_ptr
  */
 void wlclient_run(wlclient_t *wlclient_ptr);
@@ -114,6 +135,77 @@ bool wlclient_register_timer(
     wlclient_callback_t callback,
     void *callback_ud_ptr);
 
+/**
+ * Creates a timer. The timer is not armed.
+ *
+ * @param wlclient_ptr
+ * @param callback            Called each time the timer fires.
+ * @param callback_ud_ptr
+ *
+ * @return A pointer to the timer, or NULL on error. Must be destroyed by
+ *     calling @ref wlclient_timer_destroy, before the client is destroyed.
+ */
+wlclient_timer_t *wlclient_timer_create(
+    wlclient_t *wlclient_ptr,
+    wlclient_callback_t callback,
+    void *callback_ud_ptr);
+
+/**
+ * Destroys the timer. May be called from within the timer's callback.
+ *
+ * @param timer_ptr
+ */
+void wlclient_timer_destroy(wlclient_timer_t *timer_ptr);
+
+/**
+ * Arms the timer, replacing an earlier target time.
+ *
+ * @param timer_ptr
+ * @param target_usec         Time to fire, in usec since epoch.
+ * @param period_usec         If non-zero, the timer is re-armed for
+ *                            `target_usec + n * period_usec` after firing.
+ *                            Missed periods are skipped.
+ *
+ * @return true on success.
+ */
+bool wlclient_timer_arm(
+    wlclient_timer_t *timer_ptr,
+    uint64_t target_usec,
+    uint64_t period_usec);
+
+/**
+ * Disarms the timer. Does nothing if the timer is not armed.
+ *
+ * @param timer_ptr
+ */
+void wlclient_timer_disarm(wlclient_timer_t *timer_ptr);
+
+/**
+ * Adds a file descriptor to poll in @ref wlclient_run.
+ *
+ * @param wlclient_ptr
+ * @param fd                  The file descriptor. Remains owned by caller.
+ * @param events              Events to poll for, eg. `POLLIN`.
+ * @param callback            Called when any of `events` occurred.
+ * @param callback_ud_ptr
+ *
+ * @return A handle for the registration, or NULL on error. Must be removed by
+ *     calling @ref wlclient_remove_fd.
+ */
+wlclient_fd_t *wlclient_add_fd(
+    wlclient_t *wlclient_ptr,
+    int fd,
+    short events,
+    wlclient_fd_callback_t callback,
+    void *callback_ud_ptr);
+
+/**
+ * Removes the file descriptor from polling. May be called from any callback.
+ *
+ * @param fd_ptr
+ */
+void wlclient_remove_fd(wlclient_fd_t *fd_ptr);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
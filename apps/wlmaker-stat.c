@@ -0,0 +1,161 @@
+/* ========================================================================= */
+/**
+ * @file wlmaker-stat.c
+ *
+ * Polls the statistics socket of wlmaker, and prints the JSON documents.
+ *
+ * @copyright
+ * Copyright 2024 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/// getopt() is a POSIX extension.
+#define _POSIX_C_SOURCE 200809L
+
+#include <libbase/libbase.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+/* ------------------------------------------------------------------------- */
+/** Prints usage of the program to stderr. */
+void usage(const char *name_ptr)
+{
+    fprintf(stderr,
+            "Usage: %s [-s SOCKET] [-i SECONDS] [-n COUNT]\n"
+            "\n"
+            "Prints statistics of a running wlmaker, as JSON.\n"
+            "\n"
+            "  -s SOCKET   Path of the statistics socket. Defaults to\n"
+            "              $XDG_RUNTIME_DIR/$WAYLAND_DISPLAY.stats\n"
+            "  -i SECONDS  Polls repeatedly, at this interval.\n"
+            "  -n COUNT    Stops after COUNT polls. Default: 1, or unlimited\n"
+            "              with -i.\n",
+            name_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Connects to the statistics socket, and copies the document to stdout.
+ *
+ * @param addr_ptr
+ *
+ * @return true on success.
+ */
+bool poll_stats(const struct sockaddr_un *addr_ptr)
+{
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (0 > fd) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed socket(AF_UNIX, SOCK_STREAM)");
+        return false;
+    }
+    if (0 != connect(fd, (const struct sockaddr*)addr_ptr,
+                     sizeof(struct sockaddr_un))) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed connect(%d, %s)",
+               fd, addr_ptr->sun_path);
+        close(fd);
+        return false;
+    }
+
+    char buf[4096];
+    ssize_t rv;
+    while (0 != (rv = read(fd, buf, sizeof(buf)))) {
+        if (0 > rv) {
+            if (EINTR == errno) continue;
+            bs_log(BS_ERROR | BS_ERRNO, "Failed read(%d)", fd);
+            close(fd);
+            return false;
+        }
+        fwrite(buf, 1, rv, stdout);
+    }
+    close(fd);
+    fflush(stdout);
+    return true;
+}
+
+/* == Main program ========================================================= */
+/** Main program. */
+int main(int argc, char **argv)
+{
+    const char *path_ptr = NULL;
+    double interval_sec = 0;
+    long count = 0;
+
+    int opt;
+    while (-1 != (opt = getopt(argc, argv, "s:i:n:h"))) {
+        switch (opt) {
+        case 's':
+            path_ptr = optarg;
+            break;
+        case 'i':
+            interval_sec = strtod(optarg, NULL);
+            if (0 >= interval_sec) {
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'n':
+            count = strtol(optarg, NULL, 10);
+            if (0 >= count) {
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            break;
+        default:
+            usage(argv[0]);
+            return 'h' == opt ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (optind < argc) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (0 == count && 0 == interval_sec) count = 1;
+
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    size_t len;
+    if (NULL != path_ptr) {
+        len = snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path_ptr);
+    } else {
+        const char *runtime_dir_ptr = getenv("XDG_RUNTIME_DIR");
+        const char *display_ptr = getenv("WAYLAND_DISPLAY");
+        if (NULL == runtime_dir_ptr) {
+            bs_log(BS_ERROR, "XDG_RUNTIME_DIR not set. Use -s SOCKET.");
+            return EXIT_FAILURE;
+        }
+        if (NULL == display_ptr) display_ptr = "wayland-0";
+        len = snprintf(addr.sun_path, sizeof(addr.sun_path), "%s/%s.stats",
+                       runtime_dir_ptr, display_ptr);
+    }
+    if (len >= sizeof(addr.sun_path)) {
+        bs_log(BS_ERROR, "Socket path too long.");
+        return EXIT_FAILURE;
+    }
+
+    struct timespec interval = {
+        .tv_sec = (time_t)interval_sec,
+        .tv_nsec = (long)((interval_sec - (time_t)interval_sec) * 1e9)
+    };
+    for (long i = 0; 0 == count || i < count; ++i) {
+        if (0 < i) nanosleep(&interval, NULL);
+        if (!poll_stats(&addr)) return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+/* == End of wlmaker-stat.c ================================================ */
@@ -167,13 +167,11 @@ bool icon_callback(
 
 /* ------------------------------------------------------------------------- */
 /** Called once per second. */
-void timer_callback(wlclient_t *client_ptr, void *ud_ptr)
+void timer_callback(__UNUSED__ wlclient_t *client_ptr, void *ud_ptr)
 {
     wlclient_icon_t *icon_ptr = ud_ptr;
 
     wlclient_icon_callback_when_ready(icon_ptr, icon_callback, NULL);
-    wlclient_register_timer(
-        client_ptr, next_draw_time(), timer_callback, icon_ptr);
 }
 
 /* == Main program ========================================================= */
@@ -192,10 +190,16 @@ int main(__UNUSED__ int argc, __UNUSED__ char **argv)
         } else {
             wlclient_icon_callback_when_ready(icon_ptr, icon_callback, NULL);
 
-            wlclient_register_timer(
-                wlclient_ptr, next_draw_time(), timer_callback, icon_ptr);
-
-            wlclient_run(wlclient_ptr);
+            // Redraws at the start of each second.
+            wlclient_timer_t *timer_ptr = wlclient_timer_create(
+                wlclient_ptr, timer_callback, icon_ptr);
+            if (NULL == timer_ptr ||
+                !wlclient_timer_arm(timer_ptr, next_draw_time(), 1000000)) {
+                bs_log(BS_ERROR, "Failed to set up timer for %p", icon_ptr);
+            } else {
+                wlclient_run(wlclient_ptr);
+            }
+            if (NULL != timer_ptr) wlclient_timer_destroy(timer_ptr);
             wlclient_icon_destroy(icon_ptr);
         }
     } else {
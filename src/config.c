@@ -54,16 +54,68 @@ const char *config_xcursor_theme_name = NULL;
 /** Base size for the xcursor theme (when scale==1.0). */
 const uint32_t config_xcursor_theme_size = 24;
 
+/**
+ * When to process pointer motion: Looking up the element under the pointer
+ * and updating pointer focus. The cursor image moves right away, and relative
+ * motion is always sent right away.
+ */
+const wlmaker_config_pointer_motion_t config_pointer_motion =
+    WLMAKER_CONFIG_POINTER_MOTION_FRAME;
+
 /** Delay in milliseconds until the idle monitor invokes a lock. */
 const int config_idle_lock_msec = 300000;
 
+/**
+ * Whether to write wlroots log messages from a ring buffer, flushed by a
+ * timer of the event loop, rather than right away.
+ */
+const bool config_log_async = false;
+
+/**
+ * Whether to record trace events from startup. Requires building with
+ * `config_TRACE`. Recording is toggled by SIGUSR2, and the recorded events
+ * are written to @ref config_trace_file_ptr on SIGUSR1 or key binding. These
+ * also log a summary of input-to-commit latencies.
+ */
+const bool config_trace_enabled = false;
+
+/** Number of trace events to retain. The buffer is allocated on first use. */
+const size_t config_trace_events = 65536;
+
+/** File to write trace events to, in Chrome trace event JSON format. */
+const char *config_trace_file_ptr = "/tmp/wlmaker-trace.json";
+
+/**
+ * Whether to serve statistics on a UNIX socket next to the Wayland socket,
+ * at `$XDG_RUNTIME_DIR/<wl_socket_name>.stats`. Read with `wlmaker-stat`.
+ */
+const bool config_stats_enabled = true;
+
 /** Overall scale of output. */
 const float config_output_scale = 1.0;
 
+/**
+ * Render late: Time before the predicted next vblank, in microseconds, by
+ * which rendering must be complete. Rendering is delayed until then, so that
+ * client commits arriving during the frame are still shown. The offset gets
+ * increased whenever frames are missed. 0 renders at the start of the frame.
+ */
+const int config_output_render_deadline_usec = 0;
+
 /** Whether to always request server-side decorations. */
 const wlmaker_config_decoration_t config_decoration =
     WLMAKER_CONFIG_DECORATION_SUGGEST_SERVER;
 
+/** When to start XWayland. */
+const wlmaker_config_xwayland_t config_xwayland =
+    WLMAKER_CONFIG_XWAYLAND_LAZY;
+
+/**
+ * With @ref WLMAKER_CONFIG_XWAYLAND_LAZY: Starts XWayland in the background
+ * once there was no input for this long, in milliseconds. 0 to disable.
+ */
+const int config_xwayland_prewarm_idle_msec = 0;
+
 /** Time interval within two clicks need to happen to count as double-click. */
 const uint64_t wlmaker_config_double_click_wait_msec = 250ull;
 
@@ -44,6 +44,24 @@ typedef enum {
     WLMAKER_CONFIG_DECORATION_ENFORCE_SERVER
 } wlmaker_config_decoration_t;
 
+/** When to process pointer motion. */
+typedef enum {
+    /** Processes each motion event right away. */
+    WLMAKER_CONFIG_POINTER_MOTION_IMMEDIATE,
+    /** Accumulates motion, and processes it once per pointer frame. */
+    WLMAKER_CONFIG_POINTER_MOTION_FRAME,
+    /** Accumulates motion, and processes it once per output refresh. */
+    WLMAKER_CONFIG_POINTER_MOTION_OUTPUT,
+} wlmaker_config_pointer_motion_t;
+
+/** When to start XWayland. */
+typedef enum {
+    /** Starts XWayland along with the compositor. */
+    WLMAKER_CONFIG_XWAYLAND_EAGER,
+    /** Starts XWayland once the first X11 client connects. */
+    WLMAKER_CONFIG_XWAYLAND_LAZY,
+} wlmaker_config_xwayland_t;
+
 /** The theme. */
 typedef struct {
     /** Color of the window margin. */
@@ -96,13 +114,26 @@ extern const struct xkb_rule_names *config_keyboard_rule_names;
 
 extern const char *config_xcursor_theme_name;
 extern const uint32_t config_xcursor_theme_size;
+extern const wlmaker_config_pointer_motion_t config_pointer_motion;
 
 extern const int config_idle_lock_msec;
 
+extern const bool config_log_async;
+
+extern const bool config_trace_enabled;
+extern const size_t config_trace_events;
+extern const char *config_trace_file_ptr;
+
+extern const bool config_stats_enabled;
+
 extern const float config_output_scale;
+extern const int config_output_render_deadline_usec;
 
 extern const wlmaker_config_decoration_t config_decoration;
 
+extern const wlmaker_config_xwayland_t config_xwayland;
+extern const int config_xwayland_prewarm_idle_msec;
+
 extern const uint64_t wlmaker_config_double_click_wait_msec;
 extern const uint32_t wlmaker_config_window_drag_modifiers;
 
@@ -28,6 +28,7 @@
 #define WLR_USE_UNSTABLE
 #include <wlr/types/wlr_cursor.h>
 #include <wlr/types/wlr_input_device.h>
+#include <wlr/types/wlr_relative_pointer_v1.h>
 #include <wlr/types/wlr_xcursor_manager.h>
 #undef WLR_USE_UNSTABLE
 
@@ -53,6 +54,9 @@ static void handle_seat_request_set_cursor(
     struct wl_listener *listener_ptr,
     void *data_ptr);
 
+static void handle_motion_time(
+    wlmaker_cursor_t *cursor_ptr,
+    uint32_t time_msec);
 static void process_motion(wlmaker_cursor_t *cursor_ptr, uint32_t time_msec);
 static void update_under_cursor_view(wlmaker_cursor_t *cursor_ptr,
                                      wlmaker_view_t *view_ptr);
@@ -79,6 +83,15 @@ wlmaker_cursor_t *wlmaker_cursor_create(wlmaker_server_t *server_ptr)
     wlr_cursor_attach_output_layout(cursor_ptr->wlr_cursor_ptr,
                                     server_ptr->wlr_output_layout_ptr);
 
+    cursor_ptr->wlr_relative_pointer_manager_ptr =
+        wlr_relative_pointer_manager_v1_create(server_ptr->wl_display_ptr);
+    if (NULL == cursor_ptr->wlr_relative_pointer_manager_ptr) {
+        bs_log(BS_ERROR, "Failed wlr_relative_pointer_manager_v1_create(%p)",
+               server_ptr->wl_display_ptr);
+        wlmaker_cursor_destroy(cursor_ptr);
+        return NULL;
+    }
+
     cursor_ptr->wlr_xcursor_manager_ptr = wlr_xcursor_manager_create(
         config_xcursor_theme_name,
         config_xcursor_theme_size);
@@ -172,6 +185,19 @@ void wlmaker_cursor_get_position(
     if (NULL != y_ptr) *y_ptr = cursor_ptr->wlr_cursor_ptr->y;
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmaker_cursor_flush_motion(wlmaker_cursor_t *cursor_ptr)
+{
+    if (cursor_ptr->motion_pending) {
+        cursor_ptr->motion_pending = false;
+        process_motion(cursor_ptr, cursor_ptr->motion_time_msec);
+    }
+    if (cursor_ptr->frame_pending) {
+        cursor_ptr->frame_pending = false;
+        wlr_seat_pointer_notify_frame(cursor_ptr->server_ptr->wlr_seat_ptr);
+    }
+}
+
 /* == Local (static) methods =============================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -189,6 +215,19 @@ void handle_motion(struct wl_listener *listener_ptr,
     struct wlr_pointer_motion_event *wlr_pointer_motion_event_ptr = data_ptr;
 
     wlmaker_idle_monitor_reset(cursor_ptr->server_ptr->idle_monitor_ptr);
+    wlmaker_latency_input(cursor_ptr->server_ptr->latency_ptr,
+                          WLMAKER_LATENCY_POINTER,
+                          wlr_pointer_motion_event_ptr->time_msec);
+
+    // Relative motion is not accumulated: Clients may need each event.
+    wlr_relative_pointer_manager_v1_send_relative_motion(
+        cursor_ptr->wlr_relative_pointer_manager_ptr,
+        cursor_ptr->server_ptr->wlr_seat_ptr,
+        (uint64_t)wlr_pointer_motion_event_ptr->time_msec * 1000,
+        wlr_pointer_motion_event_ptr->delta_x,
+        wlr_pointer_motion_event_ptr->delta_y,
+        wlr_pointer_motion_event_ptr->unaccel_dx,
+        wlr_pointer_motion_event_ptr->unaccel_dy);
 
     wlr_cursor_move(
         cursor_ptr->wlr_cursor_ptr,
@@ -196,7 +235,7 @@ void handle_motion(struct wl_listener *listener_ptr,
         wlr_pointer_motion_event_ptr->delta_x,
         wlr_pointer_motion_event_ptr->delta_y);
 
-    process_motion(
+    handle_motion_time(
         cursor_ptr,
         wlr_pointer_motion_event_ptr->time_msec);
 }
@@ -217,6 +256,9 @@ void handle_motion_absolute(struct wl_listener *listener_ptr,
         *wlr_pointer_motion_absolute_event_ptr = data_ptr;
 
     wlmaker_idle_monitor_reset(cursor_ptr->server_ptr->idle_monitor_ptr);
+    wlmaker_latency_input(cursor_ptr->server_ptr->latency_ptr,
+                          WLMAKER_LATENCY_POINTER,
+                          wlr_pointer_motion_absolute_event_ptr->time_msec);
 
     wlr_cursor_warp_absolute(
         cursor_ptr->wlr_cursor_ptr,
@@ -224,7 +266,7 @@ void handle_motion_absolute(struct wl_listener *listener_ptr,
         wlr_pointer_motion_absolute_event_ptr->x,
         wlr_pointer_motion_absolute_event_ptr->y);
 
-    process_motion(
+    handle_motion_time(
         cursor_ptr,
         wlr_pointer_motion_absolute_event_ptr->time_msec);
 }
@@ -244,6 +286,11 @@ void handle_button(struct wl_listener *listener_ptr,
     struct wlr_pointer_button_event *wlr_pointer_button_event_ptr = data_ptr;
 
     wlmaker_idle_monitor_reset(cursor_ptr->server_ptr->idle_monitor_ptr);
+    wlmaker_latency_input(cursor_ptr->server_ptr->latency_ptr,
+                          WLMAKER_LATENCY_POINTER,
+                          wlr_pointer_button_event_ptr->time_msec);
+    // Pointer focus must be current when delivering the button.
+    wlmaker_cursor_flush_motion(cursor_ptr);
 
     bool consumed;
     wlmtk_button_event_t event = {};
@@ -309,6 +356,10 @@ void handle_axis(struct wl_listener *listener_ptr,
     struct wlr_pointer_axis_event *wlr_pointer_axis_event_ptr = data_ptr;
 
     wlmaker_idle_monitor_reset(cursor_ptr->server_ptr->idle_monitor_ptr);
+    wlmaker_latency_input(cursor_ptr->server_ptr->latency_ptr,
+                          WLMAKER_LATENCY_POINTER,
+                          wlr_pointer_axis_event_ptr->time_msec);
+    wlmaker_cursor_flush_motion(cursor_ptr);
 
     bool consumed;
     consumed = wlmtk_element_pointer_axis(
@@ -365,6 +416,14 @@ void handle_frame(struct wl_listener *listener_ptr,
     wlmaker_cursor_t *cursor_ptr = BS_CONTAINER_OF(
         listener_ptr, wlmaker_cursor_t, frame_listener);
 
+    if (WLMAKER_CONFIG_POINTER_MOTION_OUTPUT == config_pointer_motion &&
+        cursor_ptr->motion_pending) {
+        // Sent after the motion, when processed on the next output refresh.
+        cursor_ptr->frame_pending = true;
+        return;
+    }
+    wlmaker_cursor_flush_motion(cursor_ptr);
+
     /* Notify the client with pointer focus of the frame event. */
     wlr_seat_pointer_notify_frame(cursor_ptr->server_ptr->wlr_seat_ptr);
 }
@@ -403,6 +462,35 @@ void handle_seat_request_set_cursor(
     }
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Processes the cursor motion right away, or accumulates it until the pointer
+ * frame or output refresh. See @ref config_pointer_motion.
+ *
+ * @param cursor_ptr
+ * @param time_msec
+ */
+void handle_motion_time(wlmaker_cursor_t *cursor_ptr, uint32_t time_msec)
+{
+    if (WLMAKER_CONFIG_POINTER_MOTION_IMMEDIATE == config_pointer_motion) {
+        process_motion(cursor_ptr, time_msec);
+        return;
+    }
+
+    cursor_ptr->motion_time_msec = time_msec;
+    if (cursor_ptr->motion_pending) return;
+    cursor_ptr->motion_pending = true;
+
+    if (WLMAKER_CONFIG_POINTER_MOTION_OUTPUT == config_pointer_motion) {
+        // A hardware cursor moves without a new frame: Ensure there is one.
+        struct wlr_output *wlr_output_ptr = wlr_output_layout_output_at(
+            cursor_ptr->server_ptr->wlr_output_layout_ptr,
+            cursor_ptr->wlr_cursor_ptr->x,
+            cursor_ptr->wlr_cursor_ptr->y);
+        if (NULL != wlr_output_ptr) wlr_output_schedule_frame(wlr_output_ptr);
+    }
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Processes the cursor motion: Lookups up the view & surface under the
@@ -414,6 +502,7 @@ void handle_seat_request_set_cursor(
  */
 void process_motion(wlmaker_cursor_t *cursor_ptr, uint32_t time_msec)
 {
+    WLMTK_TRACE_SCOPE("process_motion");
     wlmtk_workspace_motion(
         wlmaker_workspace_wlmtk(wlmaker_server_get_current_workspace(
                                     cursor_ptr->server_ptr)),
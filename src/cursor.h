@@ -54,6 +54,16 @@ struct _wlmaker_cursor_t {
     /** Listener for the `request_set_cursor` event of `wlr_seat`. */
     struct wl_listener        seat_request_set_cursor_listener;
 
+    /** Sends relative pointer motion to clients that requested it. */
+    struct wlr_relative_pointer_manager_v1 *wlr_relative_pointer_manager_ptr;
+
+    /** Whether there is motion not yet processed. */
+    bool                      motion_pending;
+    /** Time of the latest motion not yet processed, in msec. */
+    uint32_t                  motion_time_msec;
+    /** Whether a pointer frame is held back until motion is processed. */
+    bool                      frame_pending;
+
     /** The view that is currently active and under the cursor. */
     wlmaker_view_t            *under_cursor_view_ptr;
 
@@ -99,6 +109,18 @@ void wlmaker_cursor_get_position(
     double *x_ptr,
     double *y_ptr);
 
+/**
+ * Processes motion that was accumulated, if any: Looks up the element under
+ * the pointer, and updates pointer focus. Sends a pointer frame, if one was
+ * held back.
+ *
+ * To be called before rendering each output. See
+ * @ref wlmaker_config_pointer_motion_t.
+ *
+ * @param cursor_ptr
+ */
+void wlmaker_cursor_flush_motion(wlmaker_cursor_t *cursor_ptr);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
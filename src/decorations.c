@@ -25,6 +25,7 @@
 #include <stdint.h>
 #include <libbase/libbase.h>
 
+#include "icon_cache.h"
 #include "toolkit/toolkit.h"
 
 /* == Declarations ========================================================= */
@@ -78,21 +79,9 @@ bool wlmaker_decorations_draw_tile_icon(
     BS_ASSERT((int)wlmaker_decorations_tile_size ==
               cairo_image_surface_get_height(cairo_get_target(cairo_ptr)));
 
-    char full_path[PATH_MAX];
-    char *path_ptr = bs_file_lookup(icon_path_ptr, lookup_paths, 0, full_path);
-    if (NULL == path_ptr) {
-        bs_log(BS_ERROR, "Failed bs_file_lookup(%s, ...) in lookup_paths.",
-               icon_path_ptr);
-        return false;
-    }
-
-    cairo_surface_t *icon_surface_ptr = cairo_image_surface_create_from_png(
-        path_ptr);
-    if (NULL == icon_surface_ptr) {
-        bs_log(BS_ERROR, "Failed cairo_image_surface_create_from_png(%s).",
-               path_ptr);
-        return false;
-    }
+    cairo_surface_t *icon_surface_ptr = wlmaker_icon_cache_get(
+        icon_path_ptr, lookup_paths);
+    if (NULL == icon_surface_ptr) return false;
 
     // Find top-left, and cap the icon to max the tile size.
     int width = BS_MIN(
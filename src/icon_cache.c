@@ -0,0 +1,405 @@
+/* ========================================================================= */
+/**
+ * @file icon_cache.c
+ *
+ * @copyright
+ * Copyright 2024 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "icon_cache.h"
+
+#include "toolkit/util.h"
+
+#include <limits.h>
+#include <sys/stat.h>
+#include <time.h>
+
+/* == Declarations ========================================================= */
+
+/** A decoded icon. */
+typedef struct {
+    /** Node within @ref _wlmaker_icon_cache_entries. */
+    bs_dllist_node_t          dlnode;
+    /** Icon name or path, as requested. */
+    char                      *icon_path_ptr;
+    /** Hash of the lookup paths, as requested. */
+    uint64_t                  lookup_paths_hash;
+    /** Path the icon was loaded from. */
+    char                      *resolved_path_ptr;
+    /** Modification time of the file, when loaded. */
+    struct timespec           mtime;
+    /** When the modification time was last checked, in monotonic msec. */
+    uint64_t                  validated_msec;
+    /** The decoded icon. The cache holds one reference. */
+    cairo_surface_t           *surface_ptr;
+    /** Memory used by the decoded icon. */
+    size_t                    bytes;
+} wlmaker_icon_cache_entry_t;
+
+static wlmaker_icon_cache_entry_t *_wlmaker_icon_cache_entry_create(
+    const char *icon_path_ptr,
+    const char **lookup_paths);
+static void _wlmaker_icon_cache_entry_destroy(
+    wlmaker_icon_cache_entry_t *entry_ptr);
+static bool _wlmaker_icon_cache_entry_valid(
+    wlmaker_icon_cache_entry_t *entry_ptr,
+    uint64_t now_msec);
+static void _wlmaker_icon_cache_trim(size_t max_bytes);
+static uint64_t _wlmaker_icon_cache_hash_paths(const char **lookup_paths);
+
+/* == Data ================================================================= */
+
+/** Cached icons, most recently used first. */
+static bs_dllist_t            _wlmaker_icon_cache_entries;
+/** Memory used by all icons in @ref _wlmaker_icon_cache_entries. */
+static size_t                 _wlmaker_icon_cache_bytes;
+/** Counters. */
+static wlmaker_icon_cache_stats_t _wlmaker_icon_cache_stats;
+
+/** Memory cap for the decoded icons. */
+static const size_t           _wlmaker_icon_cache_max_bytes = 4 << 20;
+/** Interval for checking whether a cached icon has changed on disk. */
+static const uint64_t         _wlmaker_icon_cache_validate_msec = 5000;
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+cairo_surface_t *wlmaker_icon_cache_get(
+    const char *icon_path_ptr,
+    const char **lookup_paths)
+{
+    uint64_t now_msec = wlmtk_util_now_msec();
+    uint64_t lookup_paths_hash = _wlmaker_icon_cache_hash_paths(lookup_paths);
+    for (bs_dllist_node_t *dlnode_ptr = _wlmaker_icon_cache_entries.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmaker_icon_cache_entry_t *entry_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_icon_cache_entry_t, dlnode);
+        if (entry_ptr->lookup_paths_hash != lookup_paths_hash ||
+            0 != strcmp(entry_ptr->icon_path_ptr, icon_path_ptr)) continue;
+
+        bs_dllist_remove(&_wlmaker_icon_cache_entries, &entry_ptr->dlnode);
+        if (_wlmaker_icon_cache_entry_valid(entry_ptr, now_msec)) {
+            ++_wlmaker_icon_cache_stats.hits;
+            bs_dllist_push_front(&_wlmaker_icon_cache_entries,
+                                 &entry_ptr->dlnode);
+            return cairo_surface_reference(entry_ptr->surface_ptr);
+        }
+
+        // Changed or gone: Drop, and load again.
+        ++_wlmaker_icon_cache_stats.reloads;
+        _wlmaker_icon_cache_bytes -= entry_ptr->bytes;
+        _wlmaker_icon_cache_entry_destroy(entry_ptr);
+        break;
+    }
+
+    wlmaker_icon_cache_entry_t *entry_ptr = _wlmaker_icon_cache_entry_create(
+        icon_path_ptr, lookup_paths);
+    if (NULL == entry_ptr) return NULL;
+    ++_wlmaker_icon_cache_stats.loads;
+    entry_ptr->lookup_paths_hash = lookup_paths_hash;
+    entry_ptr->validated_msec = now_msec;
+
+    cairo_surface_t *surface_ptr = cairo_surface_reference(
+        entry_ptr->surface_ptr);
+    if (entry_ptr->bytes > _wlmaker_icon_cache_max_bytes) {
+        // Too large for the cache: Return it, but don't keep it.
+        _wlmaker_icon_cache_entry_destroy(entry_ptr);
+        return surface_ptr;
+    }
+
+    _wlmaker_icon_cache_trim(_wlmaker_icon_cache_max_bytes - entry_ptr->bytes);
+    bs_dllist_push_front(&_wlmaker_icon_cache_entries, &entry_ptr->dlnode);
+    _wlmaker_icon_cache_bytes += entry_ptr->bytes;
+    return surface_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_icon_cache_purge(void)
+{
+    _wlmaker_icon_cache_trim(0);
+}
+
+/* ------------------------------------------------------------------------- */
+const wlmaker_icon_cache_stats_t *wlmaker_icon_cache_stats(void)
+{
+    return &_wlmaker_icon_cache_stats;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Looks up and decodes the icon.
+ *
+ * @param icon_path_ptr
+ * @param lookup_paths
+ *
+ * @return The entry, or NULL on error. Must be destroyed by calling
+ *     @ref _wlmaker_icon_cache_entry_destroy.
+ */
+wlmaker_icon_cache_entry_t *_wlmaker_icon_cache_entry_create(
+    const char *icon_path_ptr,
+    const char **lookup_paths)
+{
+    char full_path[PATH_MAX];
+    char *path_ptr = bs_file_lookup(icon_path_ptr, lookup_paths, 0, full_path);
+    if (NULL == path_ptr) {
+        bs_log(BS_ERROR, "Failed bs_file_lookup(%s, ...) in lookup_paths.",
+               icon_path_ptr);
+        return NULL;
+    }
+    struct stat stat_buf;
+    if (0 != stat(path_ptr, &stat_buf)) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed stat(%s, %p)",
+               path_ptr, &stat_buf);
+        return NULL;
+    }
+
+    wlmaker_icon_cache_entry_t *entry_ptr = logged_calloc(
+        1, sizeof(wlmaker_icon_cache_entry_t));
+    if (NULL == entry_ptr) return NULL;
+    entry_ptr->mtime = stat_buf.st_mtim;
+    entry_ptr->icon_path_ptr = logged_strdup(icon_path_ptr);
+    entry_ptr->resolved_path_ptr = logged_strdup(path_ptr);
+    if (NULL == entry_ptr->icon_path_ptr ||
+        NULL == entry_ptr->resolved_path_ptr) {
+        _wlmaker_icon_cache_entry_destroy(entry_ptr);
+        return NULL;
+    }
+
+    entry_ptr->surface_ptr = cairo_image_surface_create_from_png(path_ptr);
+    if (CAIRO_STATUS_SUCCESS != cairo_surface_status(entry_ptr->surface_ptr)) {
+        bs_log(BS_ERROR, "Failed cairo_image_surface_create_from_png(%s): %s",
+               path_ptr, cairo_status_to_string(
+                   cairo_surface_status(entry_ptr->surface_ptr)));
+        _wlmaker_icon_cache_entry_destroy(entry_ptr);
+        return NULL;
+    }
+    entry_ptr->bytes =
+        (size_t)cairo_image_surface_get_stride(entry_ptr->surface_ptr) *
+        cairo_image_surface_get_height(entry_ptr->surface_ptr);
+    return entry_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroys the entry. Must not be in @ref _wlmaker_icon_cache_entries. */
+void _wlmaker_icon_cache_entry_destroy(wlmaker_icon_cache_entry_t *entry_ptr)
+{
+    if (NULL != entry_ptr->surface_ptr) {
+        cairo_surface_destroy(entry_ptr->surface_ptr);
+        entry_ptr->surface_ptr = NULL;
+    }
+    if (NULL != entry_ptr->resolved_path_ptr) {
+        free(entry_ptr->resolved_path_ptr);
+        entry_ptr->resolved_path_ptr = NULL;
+    }
+    if (NULL != entry_ptr->icon_path_ptr) {
+        free(entry_ptr->icon_path_ptr);
+        entry_ptr->icon_path_ptr = NULL;
+    }
+    free(entry_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns whether the cached icon is still current. Checks the file's
+ * modification time, if not done within the last few seconds.
+ *
+ * @param entry_ptr
+ * @param now_msec
+ *
+ * @return false if the file has changed or cannot be accessed.
+ */
+bool _wlmaker_icon_cache_entry_valid(
+    wlmaker_icon_cache_entry_t *entry_ptr,
+    uint64_t now_msec)
+{
+    if (now_msec - entry_ptr->validated_msec <
+        _wlmaker_icon_cache_validate_msec) return true;
+
+    struct stat stat_buf;
+    if (0 != stat(entry_ptr->resolved_path_ptr, &stat_buf) ||
+        stat_buf.st_mtim.tv_sec != entry_ptr->mtime.tv_sec ||
+        stat_buf.st_mtim.tv_nsec != entry_ptr->mtime.tv_nsec) return false;
+    entry_ptr->validated_msec = now_msec;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Evicts least recently used icons, until they use at most `max_bytes`.
+ *
+ * @param max_bytes
+ */
+void _wlmaker_icon_cache_trim(size_t max_bytes)
+{
+    while (_wlmaker_icon_cache_bytes > max_bytes) {
+        bs_dllist_node_t *dlnode_ptr = _wlmaker_icon_cache_entries.tail_ptr;
+        BS_ASSERT(NULL != dlnode_ptr);
+        wlmaker_icon_cache_entry_t *entry_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_icon_cache_entry_t, dlnode);
+        bs_dllist_remove(&_wlmaker_icon_cache_entries, dlnode_ptr);
+        _wlmaker_icon_cache_bytes -= entry_ptr->bytes;
+        _wlmaker_icon_cache_entry_destroy(entry_ptr);
+        ++_wlmaker_icon_cache_stats.evictions;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Computes a 64-bit FNV-1a hash of the lookup paths. Includes the
+ * terminating NUL of each path, so paths are not confused when split
+ * differently.
+ *
+ * @param lookup_paths        NULL-terminated array of directories.
+ *
+ * @return The hash.
+ */
+uint64_t _wlmaker_icon_cache_hash_paths(const char **lookup_paths)
+{
+    uint64_t hash = UINT64_C(0xcbf29ce484222325);
+    for (const char **path_ptr_ptr = lookup_paths;
+         NULL != *path_ptr_ptr;
+         ++path_ptr_ptr) {
+        const char *path_ptr = *path_ptr_ptr;
+        do {
+            hash = (hash ^ (uint8_t)*path_ptr) * UINT64_C(0x100000001b3);
+        } while ('\0' != *path_ptr++);
+    }
+    return hash;
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_get(bs_test_t *test_ptr);
+static void test_trim(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmaker_icon_cache_test_cases[] = {
+    { 1, "get", test_get },
+    { 1, "trim", test_trim },
+    { 0, NULL, NULL }
+};
+
+/** Lookup paths for the tests. */
+static const char *_test_lookup_paths[] = {
+#if defined(WLMAKER_SOURCE_DIR)
+    WLMAKER_SOURCE_DIR "/icons",
+#endif  // WLMAKER_SOURCE_DIR
+    NULL
+};
+
+/** Other lookup paths, resolving to the same icons. */
+static const char *_test_other_lookup_paths[] = {
+#if defined(WLMAKER_SOURCE_DIR)
+    WLMAKER_SOURCE_DIR "/icons/",
+#endif  // WLMAKER_SOURCE_DIR
+    NULL
+};
+
+/* ------------------------------------------------------------------------- */
+/** Verifies icons are decoded once, and then served from the cache. */
+void test_get(bs_test_t *test_ptr)
+{
+    wlmaker_icon_cache_purge();
+    wlmaker_icon_cache_stats_t s = *wlmaker_icon_cache_stats();
+
+    cairo_surface_t *s1_ptr = wlmaker_icon_cache_get(
+        "clip-48x48.png", _test_lookup_paths);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, s1_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 48, cairo_image_surface_get_width(s1_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, s.loads + 1, wlmaker_icon_cache_stats()->loads);
+
+    cairo_surface_t *s2_ptr = wlmaker_icon_cache_get(
+        "clip-48x48.png", _test_lookup_paths);
+    BS_TEST_VERIFY_EQ(test_ptr, s1_ptr, s2_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, s.loads + 1, wlmaker_icon_cache_stats()->loads);
+    BS_TEST_VERIFY_EQ(test_ptr, s.hits + 1, wlmaker_icon_cache_stats()->hits);
+
+    // Forces a re-validation. The file is unchanged: Still a hit.
+    wlmaker_icon_cache_entry_t *entry_ptr = BS_CONTAINER_OF(
+        _wlmaker_icon_cache_entries.head_ptr,
+        wlmaker_icon_cache_entry_t, dlnode);
+    entry_ptr->validated_msec -= _wlmaker_icon_cache_validate_msec;
+    cairo_surface_t *s3_ptr = wlmaker_icon_cache_get(
+        "clip-48x48.png", _test_lookup_paths);
+    BS_TEST_VERIFY_EQ(test_ptr, s1_ptr, s3_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, s.reloads, wlmaker_icon_cache_stats()->reloads);
+
+    // A different modification time: Re-loads.
+    entry_ptr->validated_msec -= _wlmaker_icon_cache_validate_msec;
+    entry_ptr->mtime.tv_sec -= 1;
+    cairo_surface_t *s4_ptr = wlmaker_icon_cache_get(
+        "clip-48x48.png", _test_lookup_paths);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, s4_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, s.reloads + 1,
+                      wlmaker_icon_cache_stats()->reloads);
+    BS_TEST_VERIFY_EQ(test_ptr, s.loads + 2, wlmaker_icon_cache_stats()->loads);
+
+    // Same name, other lookup paths: Not served from the cache.
+    cairo_surface_t *s5_ptr = wlmaker_icon_cache_get(
+        "clip-48x48.png", _test_other_lookup_paths);
+    BS_TEST_VERIFY_NEQ(test_ptr, s4_ptr, s5_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, s.loads + 3, wlmaker_icon_cache_stats()->loads);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 2, bs_dllist_size(&_wlmaker_icon_cache_entries));
+    if (NULL != s5_ptr) cairo_surface_destroy(s5_ptr);
+
+    // Unknown icon: NULL.
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL,
+        wlmaker_icon_cache_get("does-not-exist.png", _test_lookup_paths));
+
+    wlmaker_icon_cache_purge();
+    cairo_surface_destroy(s4_ptr);
+    cairo_surface_destroy(s3_ptr);
+    cairo_surface_destroy(s2_ptr);
+    cairo_surface_destroy(s1_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies least recently used icons are evicted first. */
+void test_trim(bs_test_t *test_ptr)
+{
+    wlmaker_icon_cache_purge();
+    cairo_surface_t *s1_ptr = wlmaker_icon_cache_get(
+        "clip-48x48.png", _test_lookup_paths);
+    cairo_surface_t *s2_ptr = wlmaker_icon_cache_get(
+        "chrome-48x48.png", _test_lookup_paths);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, s1_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, s2_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, bs_dllist_size(&_wlmaker_icon_cache_entries));
+    size_t bytes = _wlmaker_icon_cache_bytes;
+
+    // Uses clip again: Chrome is now the least recently used.
+    cairo_surface_destroy(wlmaker_icon_cache_get(
+                              "clip-48x48.png", _test_lookup_paths));
+    _wlmaker_icon_cache_trim(bytes - 1);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, bs_dllist_size(&_wlmaker_icon_cache_entries));
+    wlmaker_icon_cache_entry_t *entry_ptr = BS_CONTAINER_OF(
+        _wlmaker_icon_cache_entries.head_ptr,
+        wlmaker_icon_cache_entry_t, dlnode);
+    BS_TEST_VERIFY_STREQ(test_ptr, "clip-48x48.png", entry_ptr->icon_path_ptr);
+
+    // The evicted surface remains valid while referenced.
+    BS_TEST_VERIFY_EQ(test_ptr, 48, cairo_image_surface_get_width(s2_ptr));
+
+    wlmaker_icon_cache_purge();
+    BS_TEST_VERIFY_EQ(test_ptr, 0, _wlmaker_icon_cache_bytes);
+    cairo_surface_destroy(s2_ptr);
+    cairo_surface_destroy(s1_ptr);
+}
+
+/* == End of icon_cache.c ================================================== */
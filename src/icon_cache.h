@@ -0,0 +1,77 @@
+/* ========================================================================= */
+/**
+ * @file icon_cache.h
+ *
+ * @copyright
+ * Copyright 2024 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __ICON_CACHE_H__
+#define __ICON_CACHE_H__
+
+#include <cairo.h>
+#include <stdint.h>
+#include <libbase/libbase.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/** Counters of the icon cache. */
+typedef struct {
+    /** Lookups served from the cache. */
+    uint64_t                  hits;
+    /** Lookups that required loading and decoding the icon. */
+    uint64_t                  loads;
+    /** Cached icons that were found changed on disk, and re-loaded. */
+    uint64_t                  reloads;
+    /** Icons evicted from the cache. */
+    uint64_t                  evictions;
+} wlmaker_icon_cache_stats_t;
+
+/**
+ * Returns the decoded icon for `icon_path_ptr`, from the process-wide cache.
+ *
+ * Icons are looked up in `lookup_paths` and decoded on first use only.
+ * Entries are keyed by `icon_path_ptr` and `lookup_paths`. The cache records
+ * the resolved path and it's modification time, and checks for changes at
+ * most every few seconds. Least recently used icons are evicted once the
+ * decoded icons exceed the cache's memory cap.
+ *
+ * @param icon_path_ptr       Icon name or path, as for `bs_file_lookup`.
+ * @param lookup_paths        NULL-terminated array of directories.
+ *
+ * @return A reference to the decoded, premultiplied `CAIRO_FORMAT_ARGB32`
+ *     image surface, or NULL on error. Must be released by calling
+ *     `cairo_surface_destroy`.
+ */
+cairo_surface_t *wlmaker_icon_cache_get(
+    const char *icon_path_ptr,
+    const char **lookup_paths);
+
+/** Drops all icons from the cache. Returned references stay valid. */
+void wlmaker_icon_cache_purge(void);
+
+/** @return Pointer to the counters of the icon cache. */
+const wlmaker_icon_cache_stats_t *wlmaker_icon_cache_stats(void);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmaker_icon_cache_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __ICON_CACHE_H__ */
+/* == End of icon_cache.h ================================================== */
@@ -40,6 +40,14 @@ struct _wlmaker_idle_monitor_t {
     struct wl_event_loop      *wl_event_loop_ptr;
     /** The timer's event source. */
     struct wl_event_source    *timer_event_source_ptr;
+    /** Whether the timer is armed. */
+    bool                      timer_armed;
+    /**
+     * Time of the last activity, in milliseconds (monotonic). Updated by
+     * @ref wlmaker_idle_monitor_reset without re-arming the timer: When the
+     * timer fires early, it re-arms itself for the remaining time.
+     */
+    uint64_t                  last_activity_msec;
 
     /** Listener for `new_inhibitor` of wlr_idle_inhibit_manager_v1`. */
     struct wl_listener        new_inhibitor_listener;
@@ -71,6 +79,21 @@ struct _wlmaker_idle_inhibitor_t {
 };
 
 static int _wlmaker_idle_monitor_timer(void *data_ptr);
+static bool _wlmaker_idle_monitor_arm_timer(
+    wlmaker_idle_monitor_t *idle_monitor_ptr,
+    int msec);
+static bool _wlmaker_idle_monitor_record_activity(
+    wlmaker_idle_monitor_t *idle_monitor_ptr,
+    uint64_t now_msec,
+    int lock_msec);
+static bool _wlmaker_idle_monitor_lock_due(
+    wlmaker_idle_monitor_t *idle_monitor_ptr,
+    uint64_t now_msec,
+    int lock_msec);
+static int _wlmaker_idle_monitor_remaining_msec(
+    uint64_t last_activity_msec,
+    uint64_t now_msec,
+    int lock_msec);
 
 static bool _wlmaker_idle_monitor_add_inhibitor(
     wlmaker_idle_monitor_t *idle_monitor_ptr,
@@ -124,11 +147,8 @@ wlmaker_idle_monitor_t *wlmaker_idle_monitor_create(
         return NULL;
     }
 
-    if (0 != wl_event_source_timer_update(
-            monitor_ptr->timer_event_source_ptr,
-            config_idle_lock_msec)) {
-        bs_log(BS_ERROR, "Failed wl_event_source_timer_update(%p, 1000)",
-               monitor_ptr->timer_event_source_ptr);
+    monitor_ptr->last_activity_msec = wlmtk_util_now_msec();
+    if (!_wlmaker_idle_monitor_arm_timer(monitor_ptr, config_idle_lock_msec)) {
         wlmaker_idle_monitor_destroy(monitor_ptr);
         return NULL;
     }
@@ -159,10 +179,20 @@ void wlmaker_idle_monitor_reset(wlmaker_idle_monitor_t *idle_monitor_ptr)
 {
     if (idle_monitor_ptr->locked) return;
 
-    int rv = wl_event_source_timer_update(
-        idle_monitor_ptr->timer_event_source_ptr,
+    bool rv = _wlmaker_idle_monitor_record_activity(
+        idle_monitor_ptr,
+        wlmtk_util_now_msec(),
         config_idle_lock_msec);
-    BS_ASSERT(0 == rv);
+    BS_ASSERT(rv);
+}
+
+/* ------------------------------------------------------------------------- */
+uint64_t wlmaker_idle_monitor_idle_msec(
+    const wlmaker_idle_monitor_t *idle_monitor_ptr)
+{
+    uint64_t now_msec = wlmtk_util_now_msec();
+    if (now_msec < idle_monitor_ptr->last_activity_msec) return 0;
+    return now_msec - idle_monitor_ptr->last_activity_msec;
 }
 
 /* == Local (static) methods =============================================== */
@@ -180,6 +210,12 @@ void wlmaker_idle_monitor_reset(wlmaker_idle_monitor_t *idle_monitor_ptr)
 int _wlmaker_idle_monitor_timer(void *data_ptr)
 {
     wlmaker_idle_monitor_t *idle_monitor_ptr = data_ptr;
+    idle_monitor_ptr->timer_armed = false;
+
+    if (!_wlmaker_idle_monitor_lock_due(
+            idle_monitor_ptr,
+            wlmtk_util_now_msec(),
+            config_idle_lock_msec)) return 0;
 
     // TODO(kaeser@gubbe.ch): We should better handle this via a subprocess.
     // And maybe keep monitoring the outcome?
@@ -199,6 +235,95 @@ int _wlmaker_idle_monitor_timer(void *data_ptr)
     return 0;
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Arms the timer to fire in `msec` milliseconds, or disarms it for 0.
+ *
+ * @param idle_monitor_ptr
+ * @param msec
+ *
+ * @return true on success.
+ */
+bool _wlmaker_idle_monitor_arm_timer(
+    wlmaker_idle_monitor_t *idle_monitor_ptr,
+    int msec)
+{
+    if (0 != wl_event_source_timer_update(
+            idle_monitor_ptr->timer_event_source_ptr, msec)) {
+        bs_log(BS_ERROR, "Failed wl_event_source_timer_update(%p, %d)",
+               idle_monitor_ptr->timer_event_source_ptr, msec);
+        return false;
+    }
+    idle_monitor_ptr->timer_armed = 0 < msec;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Records activity at `now_msec`. Called for every input event, so it just
+ * notes the time: An armed timer will re-arm itself, if it fires before the
+ * lock is due. Arms the timer only if it isn't armed.
+ *
+ * @param idle_monitor_ptr
+ * @param now_msec
+ * @param lock_msec           Idle time after which to lock.
+ *
+ * @return true on success.
+ */
+bool _wlmaker_idle_monitor_record_activity(
+    wlmaker_idle_monitor_t *idle_monitor_ptr,
+    uint64_t now_msec,
+    int lock_msec)
+{
+    idle_monitor_ptr->last_activity_msec = now_msec;
+    if (idle_monitor_ptr->timer_armed) return true;
+    return _wlmaker_idle_monitor_arm_timer(idle_monitor_ptr, lock_msec);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Checks whether the lock is due, when the timer fired at `now_msec`. If
+ * there was activity since arming the timer, re-arms it for the rest.
+ *
+ * @param idle_monitor_ptr
+ * @param now_msec
+ * @param lock_msec           Idle time after which to lock.
+ *
+ * @return true if the lock is due.
+ */
+bool _wlmaker_idle_monitor_lock_due(
+    wlmaker_idle_monitor_t *idle_monitor_ptr,
+    uint64_t now_msec,
+    int lock_msec)
+{
+    int remaining_msec = _wlmaker_idle_monitor_remaining_msec(
+        idle_monitor_ptr->last_activity_msec, now_msec, lock_msec);
+    if (0 >= remaining_msec) return true;
+    _wlmaker_idle_monitor_arm_timer(idle_monitor_ptr, remaining_msec);
+    return false;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Computes the time remaining until the lock is due.
+ *
+ * @param last_activity_msec
+ * @param now_msec
+ * @param lock_msec           Idle time after which to lock.
+ *
+ * @return Remaining time, in milliseconds. 0 if the lock is due.
+ */
+int _wlmaker_idle_monitor_remaining_msec(
+    uint64_t last_activity_msec,
+    uint64_t now_msec,
+    int lock_msec)
+{
+    if (now_msec < last_activity_msec) return lock_msec;
+    uint64_t idle_msec = now_msec - last_activity_msec;
+    if (idle_msec >= (uint64_t)lock_msec) return 0;
+    return lock_msec - idle_msec;
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Creates and adds a new inhibitor to the monitor.
@@ -227,10 +352,9 @@ bool _wlmaker_idle_monitor_add_inhibitor(
                         &idle_inhibitor_ptr->dlnode);
 
     // Coming here: We know to have at least 1 inhibitor.
-    if (0 != wl_event_source_timer_update(
-            idle_monitor_ptr->timer_event_source_ptr, 0)) {
+    if (!_wlmaker_idle_monitor_arm_timer(idle_monitor_ptr, 0)) {
         // Huh. Failed. We'll keep the inhibitor nonetheless. Yes?
-        bs_log(BS_WARNING, "Failed wl_event_source_timer_update(%p, 0)",
+        bs_log(BS_WARNING, "Failed to disarm timer %p",
                idle_monitor_ptr->timer_event_source_ptr);
     }
     return true;
@@ -310,4 +434,94 @@ void _wlmaker_idle_monitor_handle_unlock(
     wlmaker_idle_monitor_reset(idle_monitor_ptr);
 }
 
+/* == Unit tests =========================================================== */
+
+static void test_remaining(bs_test_t *test_ptr);
+static void test_schedule(bs_test_t *test_ptr);
+
+/** Unit tests. */
+const bs_test_case_t wlmaker_idle_test_cases[] = {
+    { 1, "remaining", test_remaining },
+    { 1, "schedule", test_schedule },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Verifies the lock is due exactly `lock_msec` after the last activity, no
+ * matter how often activity got recorded in-between.
+ */
+void test_remaining(bs_test_t *test_ptr)
+{
+    // Timer armed at 1000 with 300: Fires at 1300, lock is due.
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 0, _wlmaker_idle_monitor_remaining_msec(1000, 1300, 300));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 0, _wlmaker_idle_monitor_remaining_msec(1000, 1500, 300));
+
+    // Activity at 1200: At 1300, re-arms for 200. Fires at 1500, lock is due.
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 200, _wlmaker_idle_monitor_remaining_msec(1200, 1300, 300));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 0, _wlmaker_idle_monitor_remaining_msec(1200, 1500, 300));
+
+    // Activity at 1499: At 1500, re-arms for 299.
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 299, _wlmaker_idle_monitor_remaining_msec(1499, 1500, 300));
+
+    // Clock moving backwards (it should not): Re-arms for the full time.
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 300, _wlmaker_idle_monitor_remaining_msec(1600, 1500, 300));
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Verifies scheduling of the timer: Activity only arms a disarmed timer, and
+ * the timer re-arms itself until the lock is due.
+ */
+void test_schedule(bs_test_t *test_ptr)
+{
+    struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
+    wlmaker_idle_monitor_t m = { .wl_event_loop_ptr = wl_event_loop_ptr };
+    m.timer_event_source_ptr = wl_event_loop_add_timer(
+        wl_event_loop_ptr, _wlmaker_idle_monitor_timer, &m);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, m.timer_event_source_ptr);
+
+    // Activity at 1000: Arms the timer.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, _wlmaker_idle_monitor_record_activity(&m, 1000, 300));
+    BS_TEST_VERIFY_TRUE(test_ptr, m.timer_armed);
+
+    // Activity at 1200: Only notes the time, the timer stays armed.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, _wlmaker_idle_monitor_record_activity(&m, 1200, 300));
+    BS_TEST_VERIFY_EQ(test_ptr, 1200, m.last_activity_msec);
+    BS_TEST_VERIFY_TRUE(test_ptr, m.timer_armed);
+
+    // Fires at 1300: Not due. Re-arms.
+    m.timer_armed = false;
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, _wlmaker_idle_monitor_lock_due(&m, 1300, 300));
+    BS_TEST_VERIFY_TRUE(test_ptr, m.timer_armed);
+
+    // Fires at 1500: Due. Remains disarmed.
+    m.timer_armed = false;
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, _wlmaker_idle_monitor_lock_due(&m, 1500, 300));
+    BS_TEST_VERIFY_FALSE(test_ptr, m.timer_armed);
+
+    // Activity after: Arms the timer again.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, _wlmaker_idle_monitor_record_activity(&m, 1600, 300));
+    BS_TEST_VERIFY_TRUE(test_ptr, m.timer_armed);
+
+    // Disarming, as done for inhibitors.
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlmaker_idle_monitor_arm_timer(&m, 0));
+    BS_TEST_VERIFY_FALSE(test_ptr, m.timer_armed);
+
+    wl_event_source_remove(m.timer_event_source_ptr);
+    wl_event_loop_destroy(wl_event_loop_ptr);
+}
+
 /* == End of idle.c ======================================================== */
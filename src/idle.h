@@ -53,6 +53,19 @@ void wlmaker_idle_monitor_destroy(wlmaker_idle_monitor_t *idle_monitor_ptr);
  */
 void wlmaker_idle_monitor_reset(wlmaker_idle_monitor_t *idle_monitor_ptr);
 
+/**
+ * Returns for how long there has not been any activity.
+ *
+ * @param idle_monitor_ptr
+ *
+ * @return Time since the last activity, in milliseconds.
+ */
+uint64_t wlmaker_idle_monitor_idle_msec(
+    const wlmaker_idle_monitor_t *idle_monitor_ptr);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmaker_idle_test_cases[];
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -0,0 +1,674 @@
+/* ========================================================================= */
+/**
+ * @file key_bindings.c
+ *
+ * @copyright
+ * Copyright 2024 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "key_bindings.h"
+
+#include <string.h>
+
+#define WLR_USE_UNSTABLE
+#include <wlr/types/wlr_keyboard.h>
+#undef WLR_USE_UNSTABLE
+
+/* == Declarations ========================================================= */
+
+/** Initial number of hash buckets. Must be a power of 2. */
+#define WLMAKER_KEY_BINDINGS_INITIAL_BUCKETS 16
+/** Maximum number of distinct modifier masks in the table. */
+#define WLMAKER_KEY_BINDINGS_MAX_MASKS 32
+
+/** A modifier mask in use by entries of the table. */
+typedef struct {
+    /** The modifiers. */
+    uint32_t                  modifiers;
+    /** Number of entries using these modifiers. */
+    unsigned                  references;
+} wlmaker_key_bindings_mask_t;
+
+/** State of the key bindings table. */
+struct _wlmaker_key_bindings_t {
+    /** Hash buckets, of @ref wlmaker_key_binding_t::dlnode. */
+    bs_dllist_t               *buckets_ptr;
+    /** Number of hash buckets. A power of 2. */
+    size_t                    num_buckets;
+    /** Number of entries in the table. */
+    size_t                    num_entries;
+
+    /**
+     * Distinct modifier masks of all entries, ordered by decreasing number
+     * of modifiers. Candidates for the lookup of a key press.
+     */
+    wlmaker_key_bindings_mask_t masks[WLMAKER_KEY_BINDINGS_MAX_MASKS];
+    /** Number of elements in `masks`. */
+    size_t                    num_masks;
+
+    /** Current chord state. 0 if no key chord is pending. */
+    uint32_t                  state;
+    /** Last chord state that was handed out. */
+    uint32_t                  last_state;
+};
+
+/**
+ * An entry of the table: A key binding, or a prefix of key chords.
+ *
+ * Key chords are stored as a chain of entries: Each prefix entry leads to a
+ * chord state, which is part of the key of the subsequent entries.
+ */
+struct _wlmaker_key_binding_t {
+    /** Element of @ref wlmaker_key_bindings_t::buckets_ptr. */
+    bs_dllist_node_t          dlnode;
+
+    /** Chord state the entry applies in. 0 for the first key. */
+    uint32_t                  state;
+    /** The key, lower case. */
+    xkb_keysym_t              key_sym;
+    /** Modifiers. */
+    uint32_t                  modifiers;
+
+    /** For prefixes: The chord state entered. 0 for bindings. */
+    uint32_t                  next_state;
+    /** For bindings: Argument returned when matched. */
+    void                      *data_ptr;
+
+    /** Number of bindings using this entry. */
+    unsigned                  references;
+    /** The prefix entry leading to `state`, or NULL. */
+    wlmaker_key_binding_t     *parent_ptr;
+};
+
+static wlmaker_key_binding_t *_wlmaker_key_bindings_lookup(
+    wlmaker_key_bindings_t *key_bindings_ptr,
+    uint32_t state,
+    xkb_keysym_t key_sym,
+    uint32_t modifiers);
+static wlmaker_key_binding_t *_wlmaker_key_bindings_insert(
+    wlmaker_key_bindings_t *key_bindings_ptr,
+    wlmaker_key_binding_t *parent_ptr,
+    xkb_keysym_t key_sym,
+    uint32_t modifiers);
+static void _wlmaker_key_bindings_release(
+    wlmaker_key_bindings_t *key_bindings_ptr,
+    wlmaker_key_binding_t *entry_ptr);
+static bool _wlmaker_key_bindings_grow(
+    wlmaker_key_bindings_t *key_bindings_ptr);
+static bool _wlmaker_key_bindings_mask_ref(
+    wlmaker_key_bindings_t *key_bindings_ptr,
+    uint32_t modifiers);
+static void _wlmaker_key_bindings_mask_unref(
+    wlmaker_key_bindings_t *key_bindings_ptr,
+    uint32_t modifiers);
+static size_t _wlmaker_key_bindings_bucket(
+    const wlmaker_key_bindings_t *key_bindings_ptr,
+    uint32_t state,
+    xkb_keysym_t key_sym,
+    uint32_t modifiers);
+static bool _wlmaker_key_bindings_is_modifier(xkb_keysym_t key_sym);
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlmaker_key_bindings_t *wlmaker_key_bindings_create(void)
+{
+    wlmaker_key_bindings_t *key_bindings_ptr = logged_calloc(
+        1, sizeof(wlmaker_key_bindings_t));
+    if (NULL == key_bindings_ptr) return NULL;
+
+    key_bindings_ptr->num_buckets = WLMAKER_KEY_BINDINGS_INITIAL_BUCKETS;
+    key_bindings_ptr->buckets_ptr = logged_calloc(
+        key_bindings_ptr->num_buckets, sizeof(bs_dllist_t));
+    if (NULL == key_bindings_ptr->buckets_ptr) {
+        wlmaker_key_bindings_destroy(key_bindings_ptr);
+        return NULL;
+    }
+    return key_bindings_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_key_bindings_destroy(wlmaker_key_bindings_t *key_bindings_ptr)
+{
+    if (NULL != key_bindings_ptr->buckets_ptr) {
+        for (size_t i = 0; i < key_bindings_ptr->num_buckets; ++i) {
+            bs_dllist_node_t *dlnode_ptr;
+            while (NULL != (dlnode_ptr = bs_dllist_pop_front(
+                                &key_bindings_ptr->buckets_ptr[i]))) {
+                free(BS_CONTAINER_OF(dlnode_ptr, wlmaker_key_binding_t,
+                                     dlnode));
+            }
+        }
+        free(key_bindings_ptr->buckets_ptr);
+        key_bindings_ptr->buckets_ptr = NULL;
+    }
+    free(key_bindings_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+wlmaker_key_binding_t *wlmaker_key_bindings_bind(
+    wlmaker_key_bindings_t *key_bindings_ptr,
+    const wlmaker_key_combo_t *combos,
+    size_t num_combos,
+    void *data_ptr)
+{
+    BS_ASSERT(0 < num_combos);
+    wlmaker_key_binding_t *parent_ptr = NULL;
+    for (size_t i = 0; i < num_combos; ++i) {
+        xkb_keysym_t key_sym = xkb_keysym_to_lower(combos[i].key_sym);
+        uint32_t state = NULL != parent_ptr ? parent_ptr->next_state : 0;
+        wlmaker_key_binding_t *entry_ptr = _wlmaker_key_bindings_lookup(
+            key_bindings_ptr, state, key_sym, combos[i].modifiers);
+
+        bool is_prefix = i + 1 < num_combos;
+        if (NULL != entry_ptr && (!is_prefix || 0 == entry_ptr->next_state)) {
+            bs_log(BS_WARNING, "Key sym 0x%x, modifier 0x%x is already bound, "
+                   "cannot bind again.", combos[i].key_sym,
+                   combos[i].modifiers);
+            if (NULL != parent_ptr) {
+                _wlmaker_key_bindings_release(key_bindings_ptr, parent_ptr);
+            }
+            return NULL;
+        }
+
+        if (NULL != entry_ptr) {
+            // Prefix is shared with an existing chord.
+            ++entry_ptr->references;
+        } else {
+            entry_ptr = _wlmaker_key_bindings_insert(
+                key_bindings_ptr, parent_ptr, key_sym, combos[i].modifiers);
+            if (NULL == entry_ptr) {
+                if (NULL != parent_ptr) {
+                    _wlmaker_key_bindings_release(key_bindings_ptr, parent_ptr);
+                }
+                return NULL;
+            }
+            if (is_prefix) {
+                entry_ptr->next_state = ++key_bindings_ptr->last_state;
+            } else {
+                entry_ptr->data_ptr = data_ptr;
+            }
+        }
+        parent_ptr = entry_ptr;
+    }
+    return parent_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_key_bindings_unbind(
+    wlmaker_key_bindings_t *key_bindings_ptr,
+    wlmaker_key_binding_t *key_binding_ptr)
+{
+    BS_ASSERT(0 == key_binding_ptr->next_state);
+    // An unbound chord may still be pending. Drop it, it's state is stale.
+    key_bindings_ptr->state = 0;
+    _wlmaker_key_bindings_release(key_bindings_ptr, key_binding_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+wlmaker_key_bindings_result_t wlmaker_key_bindings_process(
+    wlmaker_key_bindings_t *key_bindings_ptr,
+    xkb_keysym_t key_sym,
+    uint32_t modifiers,
+    void **data_ptr_ptr)
+{
+    if (_wlmaker_key_bindings_is_modifier(key_sym)) {
+        return WLMAKER_KEY_BINDINGS_NONE;
+    }
+    key_sym = xkb_keysym_to_lower(key_sym);
+
+    wlmaker_key_binding_t *entry_ptr = NULL;
+    for (size_t i = 0;
+         i < key_bindings_ptr->num_masks && NULL == entry_ptr;
+         ++i) {
+        uint32_t mask = key_bindings_ptr->masks[i].modifiers;
+        if (mask != (mask & modifiers)) continue;
+        entry_ptr = _wlmaker_key_bindings_lookup(
+            key_bindings_ptr, key_bindings_ptr->state, key_sym, mask);
+    }
+
+    if (NULL == entry_ptr) {
+        if (0 == key_bindings_ptr->state) return WLMAKER_KEY_BINDINGS_NONE;
+        key_bindings_ptr->state = 0;
+        return WLMAKER_KEY_BINDINGS_ABORTED;
+    }
+
+    if (0 != entry_ptr->next_state) {
+        key_bindings_ptr->state = entry_ptr->next_state;
+        return WLMAKER_KEY_BINDINGS_PENDING;
+    }
+
+    key_bindings_ptr->state = 0;
+    if (NULL != data_ptr_ptr) *data_ptr_ptr = entry_ptr->data_ptr;
+    return WLMAKER_KEY_BINDINGS_MATCHED;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/** Returns the entry exactly matching state, key and modifiers, or NULL. */
+wlmaker_key_binding_t *_wlmaker_key_bindings_lookup(
+    wlmaker_key_bindings_t *key_bindings_ptr,
+    uint32_t state,
+    xkb_keysym_t key_sym,
+    uint32_t modifiers)
+{
+    size_t bucket = _wlmaker_key_bindings_bucket(
+        key_bindings_ptr, state, key_sym, modifiers);
+    for (bs_dllist_node_t *dlnode_ptr =
+             key_bindings_ptr->buckets_ptr[bucket].head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmaker_key_binding_t *entry_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_key_binding_t, dlnode);
+        if (entry_ptr->state == state &&
+            entry_ptr->key_sym == key_sym &&
+            entry_ptr->modifiers == modifiers) return entry_ptr;
+    }
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates an entry and inserts it into the table. The entry holds a reference
+ * on `parent_ptr`, which is passed on by the caller.
+ *
+ * @param key_bindings_ptr
+ * @param parent_ptr
+ * @param key_sym
+ * @param modifiers
+ *
+ * @return The entry, with a reference count of 1, or NULL on error.
+ */
+wlmaker_key_binding_t *_wlmaker_key_bindings_insert(
+    wlmaker_key_bindings_t *key_bindings_ptr,
+    wlmaker_key_binding_t *parent_ptr,
+    xkb_keysym_t key_sym,
+    uint32_t modifiers)
+{
+    if (key_bindings_ptr->num_entries >= 2 * key_bindings_ptr->num_buckets &&
+        !_wlmaker_key_bindings_grow(key_bindings_ptr)) return NULL;
+    if (!_wlmaker_key_bindings_mask_ref(key_bindings_ptr, modifiers)) {
+        return NULL;
+    }
+
+    wlmaker_key_binding_t *entry_ptr = logged_calloc(
+        1, sizeof(wlmaker_key_binding_t));
+    if (NULL == entry_ptr) {
+        _wlmaker_key_bindings_mask_unref(key_bindings_ptr, modifiers);
+        return NULL;
+    }
+    entry_ptr->state = NULL != parent_ptr ? parent_ptr->next_state : 0;
+    entry_ptr->key_sym = key_sym;
+    entry_ptr->modifiers = modifiers;
+    entry_ptr->references = 1;
+    entry_ptr->parent_ptr = parent_ptr;
+
+    size_t bucket = _wlmaker_key_bindings_bucket(
+        key_bindings_ptr, entry_ptr->state, key_sym, modifiers);
+    bs_dllist_push_back(&key_bindings_ptr->buckets_ptr[bucket],
+                        &entry_ptr->dlnode);
+    ++key_bindings_ptr->num_entries;
+    return entry_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Releases a reference on `entry_ptr`, and on it's parents. Entries without
+ * references are removed from the table and destroyed.
+ *
+ * @param key_bindings_ptr
+ * @param entry_ptr
+ */
+void _wlmaker_key_bindings_release(
+    wlmaker_key_bindings_t *key_bindings_ptr,
+    wlmaker_key_binding_t *entry_ptr)
+{
+    while (NULL != entry_ptr) {
+        wlmaker_key_binding_t *parent_ptr = entry_ptr->parent_ptr;
+        BS_ASSERT(0 < entry_ptr->references);
+        if (0 == --entry_ptr->references) {
+            size_t bucket = _wlmaker_key_bindings_bucket(
+                key_bindings_ptr, entry_ptr->state, entry_ptr->key_sym,
+                entry_ptr->modifiers);
+            bs_dllist_remove(&key_bindings_ptr->buckets_ptr[bucket],
+                             &entry_ptr->dlnode);
+            --key_bindings_ptr->num_entries;
+            _wlmaker_key_bindings_mask_unref(
+                key_bindings_ptr, entry_ptr->modifiers);
+            free(entry_ptr);
+        }
+        entry_ptr = parent_ptr;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Doubles the number of hash buckets, and re-distributes all entries. */
+bool _wlmaker_key_bindings_grow(wlmaker_key_bindings_t *key_bindings_ptr)
+{
+    size_t old_num_buckets = key_bindings_ptr->num_buckets;
+    bs_dllist_t *old_buckets_ptr = key_bindings_ptr->buckets_ptr;
+
+    bs_dllist_t *buckets_ptr = logged_calloc(
+        2 * old_num_buckets, sizeof(bs_dllist_t));
+    if (NULL == buckets_ptr) return false;
+    key_bindings_ptr->buckets_ptr = buckets_ptr;
+    key_bindings_ptr->num_buckets = 2 * old_num_buckets;
+
+    for (size_t i = 0; i < old_num_buckets; ++i) {
+        bs_dllist_node_t *dlnode_ptr;
+        while (NULL != (dlnode_ptr = bs_dllist_pop_front(
+                            &old_buckets_ptr[i]))) {
+            wlmaker_key_binding_t *entry_ptr = BS_CONTAINER_OF(
+                dlnode_ptr, wlmaker_key_binding_t, dlnode);
+            size_t bucket = _wlmaker_key_bindings_bucket(
+                key_bindings_ptr, entry_ptr->state, entry_ptr->key_sym,
+                entry_ptr->modifiers);
+            bs_dllist_push_back(&buckets_ptr[bucket], &entry_ptr->dlnode);
+        }
+    }
+    free(old_buckets_ptr);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Adds a reference to `modifiers` in the table's masks. New masks are
+ * inserted after all masks with at least as many modifiers.
+ *
+ * @param key_bindings_ptr
+ * @param modifiers
+ *
+ * @return false if the table has too many distinct masks.
+ */
+bool _wlmaker_key_bindings_mask_ref(
+    wlmaker_key_bindings_t *key_bindings_ptr,
+    uint32_t modifiers)
+{
+    wlmaker_key_bindings_mask_t *masks = key_bindings_ptr->masks;
+    size_t pos = 0;
+    for (; pos < key_bindings_ptr->num_masks; ++pos) {
+        if (masks[pos].modifiers == modifiers) {
+            ++masks[pos].references;
+            return true;
+        }
+        if (__builtin_popcount(masks[pos].modifiers) <
+            __builtin_popcount(modifiers)) break;
+    }
+    // Not found in the masks with more bits. Search the remaining ones.
+    for (size_t i = pos; i < key_bindings_ptr->num_masks; ++i) {
+        if (masks[i].modifiers == modifiers) {
+            ++masks[i].references;
+            return true;
+        }
+    }
+
+    if (WLMAKER_KEY_BINDINGS_MAX_MASKS <= key_bindings_ptr->num_masks) {
+        bs_log(BS_WARNING, "Too many distinct modifier masks, cannot bind "
+               "modifier 0x%x.", modifiers);
+        return false;
+    }
+    memmove(&masks[pos + 1], &masks[pos],
+            (key_bindings_ptr->num_masks - pos) * sizeof(masks[0]));
+    masks[pos].modifiers = modifiers;
+    masks[pos].references = 1;
+    ++key_bindings_ptr->num_masks;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Releases a reference to `modifiers`, and removes the mask if unused. */
+void _wlmaker_key_bindings_mask_unref(
+    wlmaker_key_bindings_t *key_bindings_ptr,
+    uint32_t modifiers)
+{
+    wlmaker_key_bindings_mask_t *masks = key_bindings_ptr->masks;
+    for (size_t i = 0; i < key_bindings_ptr->num_masks; ++i) {
+        if (masks[i].modifiers != modifiers) continue;
+        if (0 < --masks[i].references) return;
+        memmove(&masks[i], &masks[i + 1],
+                (key_bindings_ptr->num_masks - i - 1) * sizeof(masks[0]));
+        --key_bindings_ptr->num_masks;
+        return;
+    }
+    BS_ASSERT(false);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Returns the hash bucket for state, key and modifiers. */
+size_t _wlmaker_key_bindings_bucket(
+    const wlmaker_key_bindings_t *key_bindings_ptr,
+    uint32_t state,
+    xkb_keysym_t key_sym,
+    uint32_t modifiers)
+{
+    uint32_t h = state * 0x9e3779b1u;
+    h = (h ^ key_sym) * 0x85ebca6bu;
+    h = (h ^ modifiers) * 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h & (key_bindings_ptr->num_buckets - 1);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Returns whether `key_sym` is a modifier key, eg. Shift or Alt. */
+bool _wlmaker_key_bindings_is_modifier(xkb_keysym_t key_sym)
+{
+    return ((XKB_KEY_Shift_L <= key_sym &&
+             key_sym <= XKB_KEY_Hyper_R) ||
+            (XKB_KEY_ISO_Lock <= key_sym &&
+             key_sym <= XKB_KEY_ISO_Level5_Lock));
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_bind(bs_test_t *test_ptr);
+static void test_modifiers(bs_test_t *test_ptr);
+static void test_chord(bs_test_t *test_ptr);
+static void test_grow(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmaker_key_bindings_test_cases[] = {
+    { 1, "bind", test_bind },
+    { 1, "modifiers", test_modifiers },
+    { 1, "chord", test_chord },
+    { 1, "grow", test_grow },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Verifies binding, matching in either case, and unbinding. */
+void test_bind(bs_test_t *test_ptr)
+{
+    wlmaker_key_bindings_t *kb_ptr = wlmaker_key_bindings_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, kb_ptr);
+    int a, b;
+    void *data_ptr = NULL;
+
+    wlmaker_key_combo_t combo = { XKB_KEY_Q, WLR_MODIFIER_CTRL };
+    wlmaker_key_binding_t *kb1_ptr = wlmaker_key_bindings_bind(
+        kb_ptr, &combo, 1, &a);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, kb1_ptr);
+    // Already bound, also in lower case.
+    combo.key_sym = XKB_KEY_q;
+    BS_TEST_VERIFY_EQ(test_ptr, NULL,
+                      wlmaker_key_bindings_bind(kb_ptr, &combo, 1, &b));
+
+    BS_TEST_VERIFY_EQ(
+        test_ptr, WLMAKER_KEY_BINDINGS_MATCHED,
+        wlmaker_key_bindings_process(
+            kb_ptr, XKB_KEY_q, WLR_MODIFIER_CTRL, &data_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, &a, data_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, WLMAKER_KEY_BINDINGS_MATCHED,
+        wlmaker_key_bindings_process(
+            kb_ptr, XKB_KEY_Q, WLR_MODIFIER_CTRL, &data_ptr));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, WLMAKER_KEY_BINDINGS_NONE,
+        wlmaker_key_bindings_process(
+            kb_ptr, XKB_KEY_w, WLR_MODIFIER_CTRL, &data_ptr));
+
+    wlmaker_key_bindings_unbind(kb_ptr, kb1_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, WLMAKER_KEY_BINDINGS_NONE,
+        wlmaker_key_bindings_process(
+            kb_ptr, XKB_KEY_q, WLR_MODIFIER_CTRL, &data_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, kb_ptr->num_masks);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL,
+                       wlmaker_key_bindings_bind(kb_ptr, &combo, 1, &b));
+
+    wlmaker_key_bindings_destroy(kb_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies subset modifier matches, and preference for exact matches. */
+void test_modifiers(bs_test_t *test_ptr)
+{
+    wlmaker_key_bindings_t *kb_ptr = wlmaker_key_bindings_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, kb_ptr);
+    int a, b;
+    void *data_ptr = NULL;
+
+    wlmaker_key_combo_t combo_a = { XKB_KEY_Up, WLR_MODIFIER_ALT };
+    wlmaker_key_combo_t combo_b = {
+        XKB_KEY_Up, WLR_MODIFIER_ALT | WLR_MODIFIER_LOGO };
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL,
+                       wlmaker_key_bindings_bind(kb_ptr, &combo_a, 1, &a));
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL,
+                       wlmaker_key_bindings_bind(kb_ptr, &combo_b, 1, &b));
+
+    // Exact match.
+    wlmaker_key_bindings_process(
+        kb_ptr, XKB_KEY_Up, WLR_MODIFIER_ALT, &data_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, &a, data_ptr);
+    wlmaker_key_bindings_process(
+        kb_ptr, XKB_KEY_Up, WLR_MODIFIER_ALT | WLR_MODIFIER_LOGO, &data_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, &b, data_ptr);
+
+    // Subset: Caps lock doesn't prevent a match, and most modifiers win.
+    wlmaker_key_bindings_process(
+        kb_ptr, XKB_KEY_Up,
+        WLR_MODIFIER_ALT | WLR_MODIFIER_LOGO | WLR_MODIFIER_CAPS, &data_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, &b, data_ptr);
+    wlmaker_key_bindings_process(
+        kb_ptr, XKB_KEY_Up, WLR_MODIFIER_ALT | WLR_MODIFIER_CAPS, &data_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, &a, data_ptr);
+
+    BS_TEST_VERIFY_EQ(
+        test_ptr, WLMAKER_KEY_BINDINGS_NONE,
+        wlmaker_key_bindings_process(
+            kb_ptr, XKB_KEY_Up, WLR_MODIFIER_LOGO, &data_ptr));
+
+    wlmaker_key_bindings_destroy(kb_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies key chords. */
+void test_chord(bs_test_t *test_ptr)
+{
+    wlmaker_key_bindings_t *kb_ptr = wlmaker_key_bindings_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, kb_ptr);
+    int a, b, c;
+    void *data_ptr = NULL;
+
+    const wlmaker_key_combo_t chord_a[] = {
+        { XKB_KEY_x, WLR_MODIFIER_CTRL }, { XKB_KEY_c, WLR_MODIFIER_CTRL } };
+    const wlmaker_key_combo_t chord_b[] = {
+        { XKB_KEY_x, WLR_MODIFIER_CTRL }, { XKB_KEY_b, 0 } };
+    wlmaker_key_binding_t *kba_ptr = wlmaker_key_bindings_bind(
+        kb_ptr, chord_a, 2, &a);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, kba_ptr);
+    wlmaker_key_binding_t *kbb_ptr = wlmaker_key_bindings_bind(
+        kb_ptr, chord_b, 2, &b);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, kbb_ptr);
+
+    // Conflicts: The prefix itself, or extending a complete binding.
+    BS_TEST_VERIFY_EQ(test_ptr, NULL,
+                      wlmaker_key_bindings_bind(kb_ptr, chord_a, 1, &c));
+    const wlmaker_key_combo_t chord_c[] = {
+        { XKB_KEY_x, WLR_MODIFIER_CTRL }, { XKB_KEY_b, 0 }, { XKB_KEY_a, 0 } };
+    BS_TEST_VERIFY_EQ(test_ptr, NULL,
+                      wlmaker_key_bindings_bind(kb_ptr, chord_c, 3, &c));
+
+    BS_TEST_VERIFY_EQ(
+        test_ptr, WLMAKER_KEY_BINDINGS_PENDING,
+        wlmaker_key_bindings_process(
+            kb_ptr, XKB_KEY_x, WLR_MODIFIER_CTRL, &data_ptr));
+    // A modifier key press keeps the chord pending.
+    BS_TEST_VERIFY_EQ(
+        test_ptr, WLMAKER_KEY_BINDINGS_NONE,
+        wlmaker_key_bindings_process(
+            kb_ptr, XKB_KEY_Control_L, WLR_MODIFIER_CTRL, &data_ptr));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, WLMAKER_KEY_BINDINGS_MATCHED,
+        wlmaker_key_bindings_process(kb_ptr, XKB_KEY_b, 0, &data_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, &b, data_ptr);
+
+    // The second key alone doesn't match. A wrong second key aborts.
+    BS_TEST_VERIFY_EQ(
+        test_ptr, WLMAKER_KEY_BINDINGS_NONE,
+        wlmaker_key_bindings_process(kb_ptr, XKB_KEY_b, 0, &data_ptr));
+    wlmaker_key_bindings_process(
+        kb_ptr, XKB_KEY_x, WLR_MODIFIER_CTRL, &data_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, WLMAKER_KEY_BINDINGS_ABORTED,
+        wlmaker_key_bindings_process(kb_ptr, XKB_KEY_z, 0, &data_ptr));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, WLMAKER_KEY_BINDINGS_PENDING,
+        wlmaker_key_bindings_process(
+            kb_ptr, XKB_KEY_x, WLR_MODIFIER_CTRL, &data_ptr));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, WLMAKER_KEY_BINDINGS_MATCHED,
+        wlmaker_key_bindings_process(
+            kb_ptr, XKB_KEY_c, WLR_MODIFIER_CTRL, &data_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, &a, data_ptr);
+
+    // The prefix is shared, and removed with the last chord using it.
+    wlmaker_key_bindings_unbind(kb_ptr, kba_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, kb_ptr->num_entries);
+    wlmaker_key_bindings_unbind(kb_ptr, kbb_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, kb_ptr->num_entries);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL,
+                       wlmaker_key_bindings_bind(kb_ptr, chord_a, 1, &c));
+
+    wlmaker_key_bindings_destroy(kb_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies the table grows, and all bindings remain accessible. */
+void test_grow(bs_test_t *test_ptr)
+{
+    wlmaker_key_bindings_t *kb_ptr = wlmaker_key_bindings_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, kb_ptr);
+    static int data[200];
+
+    for (int i = 0; i < 200; ++i) {
+        wlmaker_key_combo_t combo = {
+            XKB_KEY_F1 + (i % 20), (i / 20) << 8 };
+        BS_TEST_VERIFY_NEQ(test_ptr, NULL, wlmaker_key_bindings_bind(
+                               kb_ptr, &combo, 1, &data[i]));
+    }
+    BS_TEST_VERIFY_TRUE(test_ptr, kb_ptr->num_buckets >= 100);
+    BS_TEST_VERIFY_EQ(test_ptr, 10, kb_ptr->num_masks);
+
+    for (int i = 0; i < 200; ++i) {
+        void *data_ptr = NULL;
+        wlmaker_key_bindings_process(
+            kb_ptr, XKB_KEY_F1 + (i % 20), (i / 20) << 8, &data_ptr);
+        BS_TEST_VERIFY_EQ(test_ptr, &data[i], data_ptr);
+    }
+
+    wlmaker_key_bindings_destroy(kb_ptr);
+}
+
+/* == End of key_bindings.c ================================================ */
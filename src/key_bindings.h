@@ -0,0 +1,134 @@
+/* ========================================================================= */
+/**
+ * @file key_bindings.h
+ *
+ * @copyright
+ * Copyright 2024 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __KEY_BINDINGS_H__
+#define __KEY_BINDINGS_H__
+
+#include <stdint.h>
+#include <libbase/libbase.h>
+#include <xkbcommon/xkbcommon.h>
+
+/** Forward declaration: Table of key bindings. */
+typedef struct _wlmaker_key_bindings_t wlmaker_key_bindings_t;
+/** Forward declaration: A key binding. */
+typedef struct _wlmaker_key_binding_t wlmaker_key_binding_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/** A key with modifiers. One step of a key binding. */
+typedef struct {
+    /** The key. Upper- and lower-case are treated the same. */
+    xkb_keysym_t              key_sym;
+    /** Modifiers, a bitmask of `enum wlr_keyboard_modifier`. */
+    uint32_t                  modifiers;
+} wlmaker_key_combo_t;
+
+/** Result of @ref wlmaker_key_bindings_process. */
+typedef enum {
+    /** No binding matched the key. */
+    WLMAKER_KEY_BINDINGS_NONE,
+    /** The key continues a key chord. Further keys are expected. */
+    WLMAKER_KEY_BINDINGS_PENDING,
+    /** The key did not continue the pending key chord. Chord is aborted. */
+    WLMAKER_KEY_BINDINGS_ABORTED,
+    /** A binding matched. */
+    WLMAKER_KEY_BINDINGS_MATCHED,
+} wlmaker_key_bindings_result_t;
+
+/**
+ * Creates a table of key bindings.
+ *
+ * Bindings are hashed by chord state, lower-case key and modifiers. A key
+ * press is looked up once for each distinct modifier mask that is bound, and
+ * that is a subset of the pressed modifiers.
+ *
+ * @return Pointer to the table, or NULL on error. Must be destroyed by calling
+ *     @ref wlmaker_key_bindings_destroy.
+ */
+wlmaker_key_bindings_t *wlmaker_key_bindings_create(void);
+
+/**
+ * Destroys the table, and all bindings it holds.
+ *
+ * @param key_bindings_ptr
+ */
+void wlmaker_key_bindings_destroy(wlmaker_key_bindings_t *key_bindings_ptr);
+
+/**
+ * Binds a key, or a sequence of keys (a key chord), to `data_ptr`.
+ *
+ * Fails if the sequence is already bound, if one of it's prefixes is bound
+ * as a key binding, or if the sequence is a prefix of an existing chord.
+ *
+ * @param key_bindings_ptr
+ * @param combos              The keys to press in sequence.
+ * @param num_combos          Number of keys in `combos`. Must be at least 1.
+ * @param data_ptr            Returned by @ref wlmaker_key_bindings_process
+ *                            when the sequence completes.
+ *
+ * @return The binding, or NULL on error. Must be released by calling
+ *     @ref wlmaker_key_bindings_unbind.
+ */
+wlmaker_key_binding_t *wlmaker_key_bindings_bind(
+    wlmaker_key_bindings_t *key_bindings_ptr,
+    const wlmaker_key_combo_t *combos,
+    size_t num_combos,
+    void *data_ptr);
+
+/**
+ * Releases a binding.
+ *
+ * @param key_bindings_ptr
+ * @param key_binding_ptr
+ */
+void wlmaker_key_bindings_unbind(
+    wlmaker_key_bindings_t *key_bindings_ptr,
+    wlmaker_key_binding_t *key_binding_ptr);
+
+/**
+ * Processes a key press.
+ *
+ * Exact matches of the modifiers are preferred, otherwise the binding with
+ * the most modifiers that are all pressed is taken. Modifier keys do not
+ * affect a pending chord.
+ *
+ * @param key_bindings_ptr
+ * @param key_sym
+ * @param modifiers
+ * @param data_ptr_ptr        Set to the binding's `data_ptr`, if matched.
+ *
+ * @return See @ref wlmaker_key_bindings_result_t.
+ */
+wlmaker_key_bindings_result_t wlmaker_key_bindings_process(
+    wlmaker_key_bindings_t *key_bindings_ptr,
+    xkb_keysym_t key_sym,
+    uint32_t modifiers,
+    void **data_ptr_ptr);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmaker_key_bindings_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __KEY_BINDINGS_H__ */
+/* == End of key_bindings.h ================================================ */
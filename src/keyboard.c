@@ -125,11 +125,15 @@ void wlmaker_keyboard_destroy(wlmaker_keyboard_t *keyboard_ptr)
  */
 void handle_key(struct wl_listener *listener_ptr, void *data_ptr)
 {
+    WLMTK_TRACE_SCOPE("handle_key");
     wlmaker_keyboard_t *keyboard_ptr = BS_CONTAINER_OF(
         listener_ptr, wlmaker_keyboard_t, key_listener);
     struct wlr_keyboard_key_event *wlr_keyboard_key_event_ptr = data_ptr;
 
     wlmaker_idle_monitor_reset(keyboard_ptr->server_ptr->idle_monitor_ptr);
+    wlmaker_latency_input(keyboard_ptr->server_ptr->latency_ptr,
+                          WLMAKER_LATENCY_KEYBOARD,
+                          wlr_keyboard_key_event_ptr->time_msec);
 
     // TODO(kaeser@gubbe.ch): Omit consumed modifiers, see xkbcommon.h.
     uint32_t modifiers = wlr_keyboard_get_modifiers(
@@ -156,11 +160,12 @@ void handle_key(struct wl_listener *listener_ptr, void *data_ptr)
         // Translates libinput keycode -> xkbcommon.
         uint32_t keycode = wlr_keyboard_key_event_ptr->keycode + 8;
 
-        // A key may have multiple syms associated; get them here.
+        // A key may have multiple syms associated; get them here. Stop at the
+        // first processed sym, so the key advances a key chord only once.
         const xkb_keysym_t *key_syms;
         int key_syms_count = xkb_state_key_get_syms(
             keyboard_ptr->wlr_keyboard_ptr->xkb_state, keycode, &key_syms);
-        for (int i = 0; i < key_syms_count; ++i) {
+        for (int i = 0; i < key_syms_count && !processed; ++i) {
 
             if (((modifiers & WLR_MODIFIER_ALT) == WLR_MODIFIER_ALT) &&
                 (key_syms[i] == XKB_KEY_Escape)) {
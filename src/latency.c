@@ -0,0 +1,378 @@
+/* ========================================================================= */
+/**
+ * @file latency.c
+ *
+ * @copyright
+ * Copyright 2024 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "latency.h"
+
+#include <inttypes.h>
+#include <string.h>
+
+/* == Declarations ========================================================= */
+
+/** Bits of sub-buckets per power of two. 16 sub-buckets: Error <= 1/16. */
+#define _WLMAKER_LATENCY_SUB_BITS 4
+/** Number of sub-buckets per power of two. */
+#define _WLMAKER_LATENCY_SUB (1 << _WLMAKER_LATENCY_SUB_BITS)
+/** Largest exponent held in the histogram. Larger values are clamped. */
+#define _WLMAKER_LATENCY_MAX_EXP 31
+/** Number of buckets in the histogram. */
+#define _WLMAKER_LATENCY_BUCKETS                                        \
+    ((_WLMAKER_LATENCY_MAX_EXP - _WLMAKER_LATENCY_SUB_BITS + 2) *       \
+     _WLMAKER_LATENCY_SUB)
+
+/**
+ * Log-linear histogram of latencies, in microseconds.
+ *
+ * Values below @ref _WLMAKER_LATENCY_SUB are held exactly. Each further
+ * power of two is split into @ref _WLMAKER_LATENCY_SUB equal buckets.
+ */
+typedef struct {
+    /** Counts per bucket. */
+    uint64_t                  buckets[_WLMAKER_LATENCY_BUCKETS];
+    /** Number of recorded values. */
+    uint64_t                  count;
+    /** Smallest recorded value. */
+    uint64_t                  min_usec;
+    /** Largest recorded value. */
+    uint64_t                  max_usec;
+} wlmaker_latency_histogram_t;
+
+/** State of the latency tracker. */
+struct _wlmaker_latency_t {
+    /** Per source: Timestamp of the newest input, in milliseconds. */
+    uint32_t                  input_msec[WLMAKER_LATENCY_SOURCES];
+    /** Per source: Sequence number of the newest input. */
+    uint64_t                  sequence[WLMAKER_LATENCY_SOURCES];
+    /** Per source: Histogram of latencies. */
+    wlmaker_latency_histogram_t histograms[WLMAKER_LATENCY_SOURCES];
+    /** Per source: Number of discarded latencies. */
+    uint64_t                  discarded[WLMAKER_LATENCY_SOURCES];
+};
+
+static size_t _wlmaker_latency_bucket_index(uint64_t value);
+static uint64_t _wlmaker_latency_bucket_value(size_t index);
+static void _wlmaker_latency_histogram_record(
+    wlmaker_latency_histogram_t *histogram_ptr,
+    uint64_t value);
+static uint64_t _wlmaker_latency_histogram_percentile(
+    const wlmaker_latency_histogram_t *histogram_ptr,
+    unsigned percentile);
+
+/** Input older than this many refresh periods is discarded on commit. */
+static const uint64_t         _wlmaker_latency_max_periods = 4;
+/** Refresh period to assume, if the output's is unknown: 60 Hz. */
+static const uint64_t         _wlmaker_latency_default_period_usec = 16667;
+
+/** Names of the sources, for logging. */
+static const char *_wlmaker_latency_source_names[WLMAKER_LATENCY_SOURCES] = {
+    "pointer",
+    "keyboard"
+};
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlmaker_latency_t *wlmaker_latency_create(void)
+{
+    wlmaker_latency_t *latency_ptr = logged_calloc(
+        1, sizeof(wlmaker_latency_t));
+    if (NULL == latency_ptr) return NULL;
+    return latency_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_latency_destroy(wlmaker_latency_t *latency_ptr)
+{
+    free(latency_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_latency_input(
+    wlmaker_latency_t *latency_ptr,
+    wlmaker_latency_source_t source,
+    uint32_t time_msec)
+{
+    latency_ptr->input_msec[source] = time_msec;
+    ++latency_ptr->sequence[source];
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_latency_output_init(
+    wlmaker_latency_t *latency_ptr,
+    wlmaker_latency_output_t *output_ptr)
+{
+    for (int s = 0; s < WLMAKER_LATENCY_SOURCES; ++s) {
+        output_ptr->seen_sequence[s] = latency_ptr->sequence[s];
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_latency_commit(
+    wlmaker_latency_t *latency_ptr,
+    wlmaker_latency_output_t *output_ptr,
+    uint64_t now_usec,
+    uint64_t period_usec)
+{
+    if (0 == period_usec) period_usec = _wlmaker_latency_default_period_usec;
+    uint64_t max_usec = _wlmaker_latency_max_periods * period_usec;
+    for (int s = 0; s < WLMAKER_LATENCY_SOURCES; ++s) {
+        if (output_ptr->seen_sequence[s] == latency_ptr->sequence[s]) continue;
+        output_ptr->seen_sequence[s] = latency_ptr->sequence[s];
+
+        // Input timestamps are milliseconds, truncated to 32 bits. Compute
+        // the difference in that domain, and add back the sub-millisecond
+        // part of `now_usec`. Discard timestamps from the future, which
+        // indicate a backend with a different clock, and stale input.
+        int32_t delta_msec = (uint32_t)(now_usec / 1000) -
+            latency_ptr->input_msec[s];
+        uint64_t latency_usec = (uint64_t)delta_msec * 1000 + now_usec % 1000;
+        if (0 > delta_msec || latency_usec > max_usec) {
+            ++latency_ptr->discarded[s];
+            continue;
+        }
+        _wlmaker_latency_histogram_record(
+            &latency_ptr->histograms[s], latency_usec);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_latency_summary(
+    wlmaker_latency_t *latency_ptr,
+    wlmaker_latency_source_t source,
+    wlmaker_latency_summary_t *summary_ptr)
+{
+    const wlmaker_latency_histogram_t *h_ptr =
+        &latency_ptr->histograms[source];
+    summary_ptr->count = h_ptr->count;
+    summary_ptr->discarded = latency_ptr->discarded[source];
+    summary_ptr->min_usec = h_ptr->min_usec;
+    summary_ptr->max_usec = h_ptr->max_usec;
+    summary_ptr->p50_usec = _wlmaker_latency_histogram_percentile(h_ptr, 50);
+    summary_ptr->p95_usec = _wlmaker_latency_histogram_percentile(h_ptr, 95);
+    summary_ptr->p99_usec = _wlmaker_latency_histogram_percentile(h_ptr, 99);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_latency_reset(wlmaker_latency_t *latency_ptr)
+{
+    memset(latency_ptr->histograms, 0, sizeof(latency_ptr->histograms));
+    memset(latency_ptr->discarded, 0, sizeof(latency_ptr->discarded));
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_latency_log(wlmaker_latency_t *latency_ptr)
+{
+    for (int s = 0; s < WLMAKER_LATENCY_SOURCES; ++s) {
+        wlmaker_latency_summary_t summary;
+        wlmaker_latency_summary(latency_ptr, s, &summary);
+        bs_log(BS_INFO, "Input-to-commit latency, %s: %"PRIu64" samples "
+               "(%"PRIu64" discarded), min %"PRIu64" us, p50 %"PRIu64" us, "
+               "p95 %"PRIu64" us, p99 %"PRIu64" us, max %"PRIu64" us.",
+               _wlmaker_latency_source_names[s], summary.count,
+               summary.discarded, summary.min_usec, summary.p50_usec,
+               summary.p95_usec, summary.p99_usec, summary.max_usec);
+    }
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/** Returns the histogram bucket holding `value`. */
+size_t _wlmaker_latency_bucket_index(uint64_t value)
+{
+    value = BS_MIN(value, (UINT64_C(1) << (_WLMAKER_LATENCY_MAX_EXP + 1)) - 1);
+    if (value < _WLMAKER_LATENCY_SUB) return value;
+
+    int exp = 63 - __builtin_clzll(value);
+    int shift = exp - _WLMAKER_LATENCY_SUB_BITS;
+    return ((exp - _WLMAKER_LATENCY_SUB_BITS + 1) * _WLMAKER_LATENCY_SUB +
+            ((value >> shift) & (_WLMAKER_LATENCY_SUB - 1)));
+}
+
+/** Returns the highest value held by bucket `index`. */
+uint64_t _wlmaker_latency_bucket_value(size_t index)
+{
+    if (index < _WLMAKER_LATENCY_SUB) return index;
+
+    int shift = index / _WLMAKER_LATENCY_SUB - 1;
+    uint64_t sub = _WLMAKER_LATENCY_SUB + index % _WLMAKER_LATENCY_SUB;
+    return ((sub + 1) << shift) - 1;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Records `value` into the histogram. */
+void _wlmaker_latency_histogram_record(
+    wlmaker_latency_histogram_t *histogram_ptr,
+    uint64_t value)
+{
+    if (0 == histogram_ptr->count || value < histogram_ptr->min_usec) {
+        histogram_ptr->min_usec = value;
+    }
+    histogram_ptr->max_usec = BS_MAX(histogram_ptr->max_usec, value);
+    ++histogram_ptr->count;
+    ++histogram_ptr->buckets[_wlmaker_latency_bucket_index(value)];
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the value at `percentile`: The highest value of the bucket holding
+ * the percentile, capped to the largest recorded value. 0 if empty.
+ */
+uint64_t _wlmaker_latency_histogram_percentile(
+    const wlmaker_latency_histogram_t *histogram_ptr,
+    unsigned percentile)
+{
+    if (0 == histogram_ptr->count) return 0;
+
+    uint64_t rank = (histogram_ptr->count * percentile + 99) / 100;
+    if (0 == rank) rank = 1;
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < _WLMAKER_LATENCY_BUCKETS; ++i) {
+        cumulative += histogram_ptr->buckets[i];
+        if (cumulative >= rank) {
+            return BS_MIN(_wlmaker_latency_bucket_value(i),
+                          histogram_ptr->max_usec);
+        }
+    }
+    return histogram_ptr->max_usec;
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_buckets(bs_test_t *test_ptr);
+static void test_percentiles(bs_test_t *test_ptr);
+static void test_commit(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmaker_latency_test_cases[] = {
+    { 1, "buckets", test_buckets },
+    { 1, "percentiles", test_percentiles },
+    { 1, "commit", test_commit },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Verifies bucket indices are contiguous, and values within error bound. */
+void test_buckets(bs_test_t *test_ptr)
+{
+    BS_TEST_VERIFY_EQ(test_ptr, 0, _wlmaker_latency_bucket_index(0));
+    BS_TEST_VERIFY_EQ(test_ptr, 15, _wlmaker_latency_bucket_index(15));
+    BS_TEST_VERIFY_EQ(test_ptr, 16, _wlmaker_latency_bucket_index(16));
+    BS_TEST_VERIFY_EQ(test_ptr, 31, _wlmaker_latency_bucket_index(31));
+    BS_TEST_VERIFY_EQ(test_ptr, 32, _wlmaker_latency_bucket_index(32));
+    BS_TEST_VERIFY_EQ(test_ptr, 32, _wlmaker_latency_bucket_index(33));
+    BS_TEST_VERIFY_EQ(test_ptr, 33, _wlmaker_latency_bucket_index(34));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, _WLMAKER_LATENCY_BUCKETS - 1,
+        _wlmaker_latency_bucket_index(UINT64_MAX));
+
+    for (uint64_t v = 1; v < (UINT64_C(1) << 30); v += v / 7 + 1) {
+        uint64_t bucket_value = _wlmaker_latency_bucket_value(
+            _wlmaker_latency_bucket_index(v));
+        BS_TEST_VERIFY_TRUE(test_ptr, bucket_value >= v);
+        BS_TEST_VERIFY_TRUE(test_ptr, bucket_value - v <= v / 16);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests percentiles of a uniform distribution. */
+void test_percentiles(bs_test_t *test_ptr)
+{
+    wlmaker_latency_histogram_t h = {};
+    BS_TEST_VERIFY_EQ(test_ptr, 0, _wlmaker_latency_histogram_percentile(
+                          &h, 50));
+
+    for (uint64_t v = 1; v <= 100; ++v) {
+        _wlmaker_latency_histogram_record(&h, v);
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, 100, h.count);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, h.min_usec);
+    BS_TEST_VERIFY_EQ(test_ptr, 100, h.max_usec);
+    BS_TEST_VERIFY_EQ(test_ptr, 51, _wlmaker_latency_histogram_percentile(
+                          &h, 50));
+    BS_TEST_VERIFY_EQ(test_ptr, 95, _wlmaker_latency_histogram_percentile(
+                          &h, 95));
+    BS_TEST_VERIFY_EQ(test_ptr, 99, _wlmaker_latency_histogram_percentile(
+                          &h, 99));
+    BS_TEST_VERIFY_EQ(test_ptr, 100, _wlmaker_latency_histogram_percentile(
+                          &h, 100));
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests correlating input with commits, per output. */
+void test_commit(bs_test_t *test_ptr)
+{
+    wlmaker_latency_t *latency_ptr = wlmaker_latency_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, latency_ptr);
+    wlmaker_latency_output_t o1, o2;
+    wlmaker_latency_summary_t s;
+
+    wlmaker_latency_output_init(latency_ptr, &o1);
+    wlmaker_latency_input(latency_ptr, WLMAKER_LATENCY_POINTER, 9990);
+    wlmaker_latency_output_init(latency_ptr, &o2);
+
+    // Only the first output accounts for the input, and only once.
+    wlmaker_latency_commit(latency_ptr, &o1, 10000500, 16667);
+    wlmaker_latency_commit(latency_ptr, &o1, 10016500, 16667);
+    wlmaker_latency_commit(latency_ptr, &o2, 10000500, 16667);
+    wlmaker_latency_summary(latency_ptr, WLMAKER_LATENCY_POINTER, &s);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, s.count);
+    BS_TEST_VERIFY_EQ(test_ptr, 10500, s.min_usec);
+    BS_TEST_VERIFY_EQ(test_ptr, 10500, s.p99_usec);
+    wlmaker_latency_summary(latency_ptr, WLMAKER_LATENCY_KEYBOARD, &s);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, s.count);
+
+    // Newest input counts. Both outputs account for it.
+    wlmaker_latency_input(latency_ptr, WLMAKER_LATENCY_KEYBOARD, 19000);
+    wlmaker_latency_input(latency_ptr, WLMAKER_LATENCY_KEYBOARD, 19995);
+    wlmaker_latency_commit(latency_ptr, &o1, 20000000, 16667);
+    wlmaker_latency_commit(latency_ptr, &o2, 20002000, 0);
+    wlmaker_latency_summary(latency_ptr, WLMAKER_LATENCY_KEYBOARD, &s);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, s.count);
+    BS_TEST_VERIFY_EQ(test_ptr, 5000, s.min_usec);
+    BS_TEST_VERIFY_EQ(test_ptr, 7000, s.max_usec);
+
+    // Input from the future is discarded.
+    wlmaker_latency_input(latency_ptr, WLMAKER_LATENCY_KEYBOARD, 30000);
+    wlmaker_latency_commit(latency_ptr, &o1, 20100000, 16667);
+    wlmaker_latency_summary(latency_ptr, WLMAKER_LATENCY_KEYBOARD, &s);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, s.count);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, s.discarded);
+
+    // Input older than a few refresh periods is discarded. The output was
+    // idle, and only commits for something else.
+    wlmaker_latency_input(latency_ptr, WLMAKER_LATENCY_KEYBOARD, 40000);
+    wlmaker_latency_commit(latency_ptr, &o1, 40100000, 16667);
+    wlmaker_latency_summary(latency_ptr, WLMAKER_LATENCY_KEYBOARD, &s);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, s.count);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, s.discarded);
+    // But is within bounds, for a slower refresh.
+    wlmaker_latency_commit(latency_ptr, &o2, 40100000, 33333);
+    wlmaker_latency_summary(latency_ptr, WLMAKER_LATENCY_KEYBOARD, &s);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, s.count);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, s.discarded);
+
+    wlmaker_latency_reset(latency_ptr);
+    wlmaker_latency_summary(latency_ptr, WLMAKER_LATENCY_KEYBOARD, &s);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, s.count);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, s.discarded);
+
+    wlmaker_latency_destroy(latency_ptr);
+}
+
+/* == End of latency.c ===================================================== */
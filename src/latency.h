@@ -0,0 +1,163 @@
+/* ========================================================================= */
+/**
+ * @file latency.h
+ *
+ * @copyright
+ * Copyright 2024 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __LATENCY_H__
+#define __LATENCY_H__
+
+#include <stdint.h>
+#include <libbase/libbase.h>
+
+/** Forward declaration: Input-to-commit latency tracker. */
+typedef struct _wlmaker_latency_t wlmaker_latency_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/** Sources of input, tracked separately. */
+typedef enum {
+    /** Pointer motion, buttons and axis. */
+    WLMAKER_LATENCY_POINTER,
+    /** Keys. */
+    WLMAKER_LATENCY_KEYBOARD,
+    /** Number of sources. Not a source. */
+    WLMAKER_LATENCY_SOURCES
+} wlmaker_latency_source_t;
+
+/** Per-output state of the latency tracker. Embed into the output. */
+typedef struct {
+    /** Per source: Sequence number of the last input accounted for. */
+    uint64_t                  seen_sequence[WLMAKER_LATENCY_SOURCES];
+} wlmaker_latency_output_t;
+
+/** Summary of the latencies recorded for a source. */
+typedef struct {
+    /** Number of latencies recorded. */
+    uint64_t                  count;
+    /** Number of latencies discarded: Stale input, or from the future. */
+    uint64_t                  discarded;
+    /** Smallest latency, in microseconds. */
+    uint64_t                  min_usec;
+    /** Largest latency, in microseconds. */
+    uint64_t                  max_usec;
+    /** Median latency, in microseconds. */
+    uint64_t                  p50_usec;
+    /** 95th percentile, in microseconds. */
+    uint64_t                  p95_usec;
+    /** 99th percentile, in microseconds. */
+    uint64_t                  p99_usec;
+} wlmaker_latency_summary_t;
+
+/**
+ * Creates the latency tracker.
+ *
+ * Latency is measured from the timestamp of the newest input event to the
+ * next frame committed on each output. Latencies are kept in log-linear
+ * histograms, with a relative error of at most 1/16.
+ *
+ * @return Pointer to the tracker, or NULL on error.
+ */
+wlmaker_latency_t *wlmaker_latency_create(void);
+
+/**
+ * Destroys the latency tracker.
+ *
+ * @param latency_ptr
+ */
+void wlmaker_latency_destroy(wlmaker_latency_t *latency_ptr);
+
+/**
+ * Registers an input event.
+ *
+ * @param latency_ptr
+ * @param source
+ * @param time_msec           Timestamp of the event, as provided by wlroots.
+ *                            Milliseconds, from CLOCK_MONOTONIC.
+ */
+void wlmaker_latency_input(
+    wlmaker_latency_t *latency_ptr,
+    wlmaker_latency_source_t source,
+    uint32_t time_msec);
+
+/**
+ * Initializes the per-output state. Input that happened before will not be
+ * accounted for by this output.
+ *
+ * @param latency_ptr
+ * @param output_ptr
+ */
+void wlmaker_latency_output_init(
+    wlmaker_latency_t *latency_ptr,
+    wlmaker_latency_output_t *output_ptr);
+
+/**
+ * Registers a committed frame on an output. Records the latency of each
+ * source that had input since the output's last commit.
+ *
+ * Input older than a few refresh periods did not trigger this commit, eg.
+ * when the output was idle. It is discarded and counted, instead of recorded.
+ *
+ * @param latency_ptr
+ * @param output_ptr
+ * @param now_usec            Time of the commit, in microseconds, from
+ *                            CLOCK_MONOTONIC.
+ * @param period_usec         Refresh period of the output, in microseconds.
+ *                            Or 0, if unknown.
+ */
+void wlmaker_latency_commit(
+    wlmaker_latency_t *latency_ptr,
+    wlmaker_latency_output_t *output_ptr,
+    uint64_t now_usec,
+    uint64_t period_usec);
+
+/**
+ * Computes the summary of latencies recorded for `source`.
+ *
+ * @param latency_ptr
+ * @param source
+ * @param summary_ptr
+ */
+void wlmaker_latency_summary(
+    wlmaker_latency_t *latency_ptr,
+    wlmaker_latency_source_t source,
+    wlmaker_latency_summary_t *summary_ptr);
+
+/**
+ * Clears all recorded latencies.
+ *
+ * @param latency_ptr
+ */
+void wlmaker_latency_reset(wlmaker_latency_t *latency_ptr);
+
+/**
+ * Logs the summary for each source, at `BS_INFO` severity.
+ *
+ * @param latency_ptr
+ */
+void wlmaker_latency_log(wlmaker_latency_t *latency_ptr);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmaker_latency_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __LATENCY_H__ */
+/* == End of latency.h ===================================================== */
@@ -23,9 +23,11 @@
 
 #include "output.h"
 
+#include "config.h"
 #include "toolkit/toolkit.h"
 
 #include <libbase/libbase.h>
+#include <inttypes.h>
 
 /* == Declarations ========================================================= */
 
@@ -35,6 +37,14 @@ static void handle_output_frame(struct wl_listener *listener_ptr,
                                 void *data_ptr);
 static void handle_request_state(struct wl_listener *listener_ptr,
                                  void *data_ptr);
+static int _wlmaker_output_handle_render_timer(void *data_ptr);
+
+static void _wlmaker_output_render(wlmaker_output_t *output_ptr, bool late);
+static void _wlmaker_output_update_deadline(
+    wlmaker_output_t *output_ptr,
+    uint64_t now_usec);
+static uint64_t _wlmaker_output_render_delay_usec(
+    wlmaker_output_t *output_ptr);
 
 /* == Exported Methods ===================================================== */
 
@@ -53,6 +63,10 @@ wlmaker_output_t *wlmaker_output_create(
     output_ptr->wlr_renderer_ptr = wlr_renderer_ptr;
     output_ptr->wlr_scene_ptr = wlr_scene_ptr;
     output_ptr->server_ptr = server_ptr;
+    if (NULL != server_ptr->latency_ptr) {
+        wlmaker_latency_output_init(
+            server_ptr->latency_ptr, &output_ptr->latency_output);
+    }
 
     wlmtk_util_connect_listener_signal(
         &output_ptr->wlr_output_ptr->events.destroy,
@@ -67,6 +81,19 @@ wlmaker_output_t *wlmaker_output_create(
         &output_ptr->output_request_state_listener,
         handle_request_state);
 
+    if (0 < config_output_render_deadline_usec) {
+        output_ptr->render_deadline_usec = config_output_render_deadline_usec;
+        output_ptr->render_timer_event_source_ptr = wl_event_loop_add_timer(
+            wl_display_get_event_loop(server_ptr->wl_display_ptr),
+            _wlmaker_output_handle_render_timer,
+            output_ptr);
+        if (NULL == output_ptr->render_timer_event_source_ptr) {
+            bs_log(BS_ERROR, "Failed wl_event_loop_add_timer()");
+            wlmaker_output_destroy(output_ptr);
+            return NULL;
+        }
+    }
+
     // From tinwywl: Configures the output created by the backend to use our
     // allocator and our renderer. Must be done once, before commiting the
     // output.
@@ -99,6 +126,15 @@ wlmaker_output_t *wlmaker_output_create(
 /* ------------------------------------------------------------------------- */
 void wlmaker_output_destroy(wlmaker_output_t *output_ptr)
 {
+    bs_log(BS_INFO, "Output %p: %"PRIu64" frames committed, "
+           "%"PRIu64" frames skipped, %"PRIu64" frames missed.", output_ptr,
+           output_ptr->committed_frames, output_ptr->skipped_frames,
+           output_ptr->missed_frames);
+
+    if (NULL != output_ptr->render_timer_event_source_ptr) {
+        wl_event_source_remove(output_ptr->render_timer_event_source_ptr);
+        output_ptr->render_timer_event_source_ptr = NULL;
+    }
     wl_list_remove(&output_ptr->output_request_state_listener.link);
     wl_list_remove(&output_ptr->output_frame_listener.link);
     wl_list_remove(&output_ptr->output_destroy_listener.link);
@@ -128,23 +164,43 @@ void handle_output_destroy(struct wl_listener *listener_ptr,
 /**
  * Event handler for the `frame` signal raised by `wlr_output`.
  *
+ * Renders right away, or -- if rendering late is enabled -- arms the render
+ * timer to render just ahead of the next vblank. While the timer is armed,
+ * further `frame` signals neither re-arm it, nor move the vblank reference.
+ *
  * @param listener_ptr
  * @param data_ptr
  */
 void handle_output_frame(struct wl_listener *listener_ptr,
                          __UNUSED__ void *data_ptr)
 {
+    WLMTK_TRACE_SCOPE("output_frame");
     wlmaker_output_t *output_ptr = BS_CONTAINER_OF(
         listener_ptr, wlmaker_output_t, output_frame_listener);
+    if (output_ptr->render_pending) return;
 
-    struct wlr_scene_output *wlr_scene_output_ptr = wlr_scene_get_scene_output(
-        output_ptr->wlr_scene_ptr,
-        output_ptr->wlr_output_ptr);
-    wlr_scene_output_commit(wlr_scene_output_ptr, NULL);
+    uint64_t now_usec = wlmtk_util_now_usec();
+    _wlmaker_output_update_deadline(output_ptr, now_usec);
+    output_ptr->last_frame_usec = now_usec;
 
-    struct timespec now;
-    clock_gettime(CLOCK_MONOTONIC, &now);
-    wlr_scene_output_send_frame_done(wlr_scene_output_ptr, &now);
+    uint64_t delay_usec = _wlmaker_output_render_delay_usec(output_ptr);
+    if (1000 <= delay_usec &&
+        0 == wl_event_source_timer_update(
+            output_ptr->render_timer_event_source_ptr,
+            delay_usec / 1000)) {
+        output_ptr->render_pending = true;
+        return;
+    }
+
+    _wlmaker_output_render(output_ptr, false);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Callback for @ref wlmaker_output_t::render_timer_event_source_ptr. */
+int _wlmaker_output_handle_render_timer(void *data_ptr)
+{
+    _wlmaker_output_render(data_ptr, true);
+    return 0;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -164,4 +220,124 @@ void handle_request_state(struct wl_listener *listener_ptr,
     wlr_output_commit_state(output_ptr->wlr_output_ptr, event_ptr->state);
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Renders and commits the scene to the output, if there is damage. Then sends
+ * the frame-done callbacks to the clients.
+ *
+ * @param output_ptr
+ * @param late                Whether called from the render timer.
+ */
+void _wlmaker_output_render(wlmaker_output_t *output_ptr, bool late)
+{
+    WLMTK_TRACE_SCOPE("output_render");
+    output_ptr->render_pending = false;
+
+    // Pointer motion may be accumulated until the output refreshes.
+    if (NULL != output_ptr->server_ptr->cursor_ptr) {
+        wlmaker_cursor_flush_motion(output_ptr->server_ptr->cursor_ptr);
+    }
+
+    // Interactive resizes are throttled to (at most) one update per frame.
+    wlmaker_workspace_t *workspace_ptr = wlmaker_server_get_current_workspace(
+        output_ptr->server_ptr);
+    if (NULL != workspace_ptr) {
+        wlmtk_workspace_flush_resize(wlmaker_workspace_wlmtk(workspace_ptr));
+    }
+
+    struct wlr_scene_output *wlr_scene_output_ptr = wlr_scene_get_scene_output(
+        output_ptr->wlr_scene_ptr,
+        output_ptr->wlr_output_ptr);
+
+    // Only render & commit if there is damage. The scene schedules a new
+    // frame when it gets damaged, so an idle output won't receive further
+    // frame events. Frame callbacks are still sent below: A client may have
+    // committed just for requesting one. wlroots will only send these to
+    // surfaces that are enabled and visible on this output; so surfaces that
+    // are occluded or on a hidden workspace do not get woken up.
+    output_ptr->rendered_late = false;
+    if (wlr_scene_output_needs_frame(wlr_scene_output_ptr)) {
+        uint64_t start_usec = wlmtk_util_now_usec();
+        if (wlr_scene_output_commit(wlr_scene_output_ptr, NULL)) {
+            ++output_ptr->committed_frames;
+            output_ptr->rendered_late = late;
+            if (NULL != output_ptr->server_ptr->latency_ptr) {
+                wlmaker_latency_commit(
+                    output_ptr->server_ptr->latency_ptr,
+                    &output_ptr->latency_output,
+                    wlmtk_util_now_usec(),
+                    0 < output_ptr->wlr_output_ptr->refresh ?
+                    1000000000 / output_ptr->wlr_output_ptr->refresh : 0);
+            }
+        }
+        // Exponentially-weighted average, with a weight of 1/8.
+        uint64_t duration_usec = wlmtk_util_now_usec() - start_usec;
+        output_ptr->render_duration_usec =
+            (7 * output_ptr->render_duration_usec + duration_usec) / 8;
+    } else {
+        ++output_ptr->skipped_frames;
+    }
+
+    uint64_t now_usec = wlmtk_util_now_usec();
+    struct timespec now = {
+        .tv_sec = now_usec / 1000000,
+        .tv_nsec = (now_usec % 1000000) * 1000
+    };
+    wlr_scene_output_send_frame_done(wlr_scene_output_ptr, &now);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Adapts @ref wlmaker_output_t::render_deadline_usec: If the last frame was
+ * rendered late and the `frame` signal is overdue, the vblank was missed and
+ * the deadline is doubled. Otherwise, it slowly recovers towards the
+ * configured value.
+ *
+ * @param output_ptr
+ * @param now_usec            Time of the current `frame` signal.
+ */
+void _wlmaker_output_update_deadline(
+    wlmaker_output_t *output_ptr,
+    uint64_t now_usec)
+{
+    if (!output_ptr->rendered_late ||
+        0 >= output_ptr->wlr_output_ptr->refresh) return;
+
+    uint64_t period_usec = 1000000000 / output_ptr->wlr_output_ptr->refresh;
+    uint64_t min_usec = config_output_render_deadline_usec;
+    uint64_t *deadline_usec_ptr = &output_ptr->render_deadline_usec;
+    if (now_usec - output_ptr->last_frame_usec > period_usec + period_usec / 2) {
+        ++output_ptr->missed_frames;
+        *deadline_usec_ptr = BS_MIN(2 * *deadline_usec_ptr, period_usec);
+    } else if (*deadline_usec_ptr > min_usec) {
+        *deadline_usec_ptr -= (*deadline_usec_ptr - min_usec + 15) / 16;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Computes how long to wait until rendering, to complete just before the
+ * predicted next vblank.
+ *
+ * The `frame` signal is emitted at the vblank, so the next one is predicted
+ * a refresh period after @ref wlmaker_output_t::last_frame_usec. Rendering
+ * must complete @ref wlmaker_output_t::render_deadline_usec before that, and
+ * is expected to take @ref wlmaker_output_t::render_duration_usec.
+ *
+ * @param output_ptr
+ *
+ * @return The delay in microseconds, or 0 to render right away.
+ */
+uint64_t _wlmaker_output_render_delay_usec(wlmaker_output_t *output_ptr)
+{
+    if (NULL == output_ptr->render_timer_event_source_ptr ||
+        0 >= output_ptr->wlr_output_ptr->refresh) return 0;
+
+    uint64_t period_usec = 1000000000 / output_ptr->wlr_output_ptr->refresh;
+    uint64_t budget_usec = output_ptr->render_duration_usec +
+        output_ptr->render_deadline_usec;
+    if (budget_usec >= period_usec) return 0;
+    return period_usec - budget_usec;
+}
+
 /* == End of output.c ====================================================== */
@@ -31,6 +31,7 @@
 /** Handle for a compositor output device. */
 typedef struct _wlmaker_output_t wlmaker_output_t;
 
+#include "latency.h"
 #include "server.h"
 
 #ifdef __cplusplus
@@ -59,6 +60,35 @@ struct _wlmaker_output_t {
     struct wl_listener        output_frame_listener;
     /** Listener for `request_state` signals raised by `wlr_output`. */
     struct wl_listener        output_request_state_listener;
+
+    /** Number of frames that were rendered and committed to the output. */
+    uint64_t                  committed_frames;
+    /** Number of frame events skipped, since the scene had no damage. */
+    uint64_t                  skipped_frames;
+    /** Number of frames rendered late, that missed the vblank. */
+    uint64_t                  missed_frames;
+
+    /** Timer for rendering late. Only set if rendering late is enabled. */
+    struct wl_event_source    *render_timer_event_source_ptr;
+    /**
+     * Whether @ref wlmaker_output_t::render_timer_event_source_ptr is armed.
+     * Further `frame` signals are ignored until the timer renders.
+     */
+    bool                      render_pending;
+    /** Time of the last `frame` signal, in microseconds (monotonic). */
+    uint64_t                  last_frame_usec;
+    /** Average time taken to render and commit a frame, in microseconds. */
+    uint64_t                  render_duration_usec;
+    /**
+     * Time before the vblank by which rendering must be complete. Starts at
+     * @ref config_output_render_deadline_usec, and adapts to missed frames.
+     */
+    uint64_t                  render_deadline_usec;
+    /** Whether the last frame was committed from the render timer. */
+    bool                      rendered_late;
+
+    /** State for correlating input with this output's commits. */
+    wlmaker_latency_output_t  latency_output;
 };
 
 /**
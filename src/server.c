@@ -26,6 +26,9 @@
 
 #include <libbase/libbase.h>
 
+#include <errno.h>
+#include <poll.h>
+
 #define WLR_USE_UNSTABLE
 #include <wlr/types/wlr_cursor.h>
 #undef WLR_USE_UNSTABLE
@@ -54,12 +57,8 @@ struct _wlmaker_server_key_binding_t {
     /** List node, as an element of `wlmaker_server_t.key_bindings`. */
     bs_dllist_node_t          node;
 
-    /** The bound key, upper case. */
-    xkb_keysym_t              key_sym_upper;
-    /** The bound key, lower case. */
-    xkb_keysym_t              key_sym_lower;
-    /** Modifiers of the bound key. */
-    uint32_t                  modifiers;
+    /** The binding in @ref wlmaker_server_t::key_bindings_ptr. */
+    wlmaker_key_binding_t     *key_binding_ptr;
     /** Callback for when key is pressed. */
     wlmaker_server_bind_key_callback_t callback;
     /** Argument to pass to |callback| when key is pressed. */
@@ -281,6 +280,14 @@ wlmaker_server_t *wlmaker_server_create(void)
         return NULL;
     }
 
+    // Key bindings.
+    server_ptr->key_bindings_ptr = wlmaker_key_bindings_create();
+    if (NULL == server_ptr->key_bindings_ptr) {
+        bs_log(BS_ERROR, "Failed wlmaker_key_bindings_create()");
+        wlmaker_server_destroy(server_ptr);
+        return NULL;
+    }
+
     // Idle monitor.
     server_ptr->idle_monitor_ptr = wlmaker_idle_monitor_create(server_ptr);
     if (NULL == server_ptr->idle_monitor_ptr) {
@@ -288,6 +295,14 @@ wlmaker_server_t *wlmaker_server_create(void)
         return NULL;
     }
 
+    // Latency tracker.
+    server_ptr->latency_ptr = wlmaker_latency_create();
+    if (NULL == server_ptr->latency_ptr) {
+        bs_log(BS_ERROR, "Failed wlmaker_latency_create()");
+        wlmaker_server_destroy(server_ptr);
+        return NULL;
+    }
+
     // The below helpers all setup a listener |display_destroy| for freeing the
     // assets held via the respective create() calls. Hence no need to call a
     // clean-up method from our end.
@@ -355,6 +370,14 @@ wlmaker_server_t *wlmaker_server_create(void)
         return NULL;
     }
 
+    if (config_stats_enabled) {
+        server_ptr->stats_ptr = wlmaker_stats_create(server_ptr);
+        if (NULL == server_ptr->stats_ptr) {
+            bs_log(BS_WARNING, "Failed wlmaker_stats_create(%p), continuing "
+                   "without statistics.", server_ptr);
+        }
+    }
+
     return server_ptr;
 }
 
@@ -369,6 +392,11 @@ void wlmaker_server_destroy(wlmaker_server_t *server_ptr)
     // * server_ptr->wlr_scene_ptr  (there is no "destroy" function)
     // * server_ptr->void_wlr_scene_ptr
 
+    if (NULL != server_ptr->stats_ptr) {
+        wlmaker_stats_destroy(server_ptr->stats_ptr);
+        server_ptr->stats_ptr = NULL;
+    }
+
     if (NULL != server_ptr->monitor_ptr) {
         wlmaker_subprocess_monitor_destroy(server_ptr->monitor_ptr);
         server_ptr->monitor_ptr =NULL;
@@ -441,6 +469,12 @@ void wlmaker_server_destroy(wlmaker_server_t *server_ptr)
         server_ptr->wl_display_ptr = NULL;
     }
 
+    if (NULL != server_ptr->latency_ptr) {
+        wlmaker_latency_log(server_ptr->latency_ptr);
+        wlmaker_latency_destroy(server_ptr->latency_ptr);
+        server_ptr->latency_ptr = NULL;
+    }
+
     if (NULL != server_ptr->idle_monitor_ptr) {
         wlmaker_idle_monitor_destroy(server_ptr->idle_monitor_ptr);
         server_ptr->idle_monitor_ptr = NULL;
@@ -456,6 +490,10 @@ void wlmaker_server_destroy(wlmaker_server_t *server_ptr)
             (wlmaker_server_key_binding_t *)server_ptr->key_bindings.head_ptr;
         wlmaker_server_unbind_key(server_ptr, key_binding_ptr);
     }
+    if (NULL != server_ptr->key_bindings_ptr) {
+        wlmaker_key_bindings_destroy(server_ptr->key_bindings_ptr);
+        server_ptr->key_bindings_ptr = NULL;
+    }
 
     if (NULL != server_ptr->wlr_allocator_ptr) {
         wlr_allocator_destroy(server_ptr->wlr_allocator_ptr);
@@ -465,6 +503,49 @@ void wlmaker_server_destroy(wlmaker_server_t *server_ptr)
     free(server_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmaker_server_run(wlmaker_server_t *server_ptr)
+{
+    struct wl_event_loop *wl_event_loop_ptr = wl_display_get_event_loop(
+        server_ptr->wl_display_ptr);
+    struct pollfd pollfd = {
+        .fd = wl_event_loop_get_fd(wl_event_loop_ptr),
+        .events = POLLIN
+    };
+
+    // As wl_display_run(), but waits separately from dispatching: Only the
+    // time spent on handling events is recorded.
+    server_ptr->running = true;
+    while (server_ptr->running) {
+        wl_display_flush_clients(server_ptr->wl_display_ptr);
+
+        uint64_t start_usec = wlmtk_util_now_usec();
+        wl_event_loop_dispatch_idle(wl_event_loop_ptr);
+        uint64_t idle_usec = wlmtk_util_now_usec() - start_usec;
+        if (!server_ptr->running) break;
+
+        if (0 > poll(&pollfd, 1, -1) && EINTR != errno) {
+            bs_log(BS_ERROR | BS_ERRNO, "Failed poll(%d)", pollfd.fd);
+            break;
+        }
+
+        start_usec = wlmtk_util_now_usec();
+        wl_event_loop_dispatch(wl_event_loop_ptr, 0);
+        if (NULL != server_ptr->stats_ptr) {
+            wlmaker_stats_record_dispatch(
+                server_ptr->stats_ptr,
+                idle_usec + wlmtk_util_now_usec() - start_usec);
+        }
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_server_terminate(wlmaker_server_t *server_ptr)
+{
+    server_ptr->running = false;
+    wl_display_terminate(server_ptr->wl_display_ptr);
+}
+
 /* ------------------------------------------------------------------------- */
 void wlmaker_server_output_add(wlmaker_server_t *server_ptr,
                                wlmaker_output_t *output_ptr)
@@ -503,27 +584,29 @@ wlmaker_server_key_binding_t *wlmaker_server_bind_key(
     wlmaker_server_bind_key_callback_t callback,
     void *callback_arg_ptr)
 {
-    for (bs_dllist_node_t *node_ptr = server_ptr->key_bindings.head_ptr;
-         NULL != node_ptr;
-         node_ptr = node_ptr->next_ptr) {
-        wlmaker_server_key_binding_t *iter_kb_ptr =
-            (wlmaker_server_key_binding_t*)node_ptr;
-        if ((iter_kb_ptr->key_sym_lower == key_sym ||
-             iter_kb_ptr->key_sym_upper == key_sym) &&
-            iter_kb_ptr->modifiers == modifiers) {
-            bs_log(BS_WARNING, "Key sym 0x%d, modifier 0x%x is already bound, "
-                   "cannot bind again.", key_sym, modifiers);
-            return NULL;
-        }
-    }
+    wlmaker_key_combo_t combo = { .key_sym = key_sym, .modifiers = modifiers };
+    return wlmaker_server_bind_key_sequence(
+        server_ptr, &combo, 1, callback, callback_arg_ptr);
+}
 
+/* ------------------------------------------------------------------------- */
+wlmaker_server_key_binding_t *wlmaker_server_bind_key_sequence(
+    wlmaker_server_t *server_ptr,
+    const wlmaker_key_combo_t *combos,
+    size_t num_combos,
+    wlmaker_server_bind_key_callback_t callback,
+    void *callback_arg_ptr)
+{
     wlmaker_server_key_binding_t *key_binding_ptr = logged_calloc(
         1, sizeof(wlmaker_server_key_binding_t));
     if (NULL == key_binding_ptr) return NULL;
 
-    key_binding_ptr->key_sym_lower = xkb_keysym_to_lower(key_sym);
-    key_binding_ptr->key_sym_upper = xkb_keysym_to_upper(key_sym);
-    key_binding_ptr->modifiers = modifiers;
+    key_binding_ptr->key_binding_ptr = wlmaker_key_bindings_bind(
+        server_ptr->key_bindings_ptr, combos, num_combos, key_binding_ptr);
+    if (NULL == key_binding_ptr->key_binding_ptr) {
+        free(key_binding_ptr);
+        return NULL;
+    }
     key_binding_ptr->callback = callback;
     key_binding_ptr->callback_arg_ptr = callback_arg_ptr;
 
@@ -536,6 +619,8 @@ void wlmaker_server_unbind_key(
     wlmaker_server_t *server_ptr,
     wlmaker_server_key_binding_t *key_binding_ptr)
 {
+    wlmaker_key_bindings_unbind(server_ptr->key_bindings_ptr,
+                                key_binding_ptr->key_binding_ptr);
     bs_dllist_remove(&server_ptr->key_bindings, &key_binding_ptr->node);
     free(key_binding_ptr);
 }
@@ -546,20 +631,21 @@ bool wlmaker_server_process_key(
     xkb_keysym_t key_sym,
     uint32_t modifiers)
 {
-    for (bs_dllist_node_t *node_ptr = server_ptr->key_bindings.head_ptr;
-         NULL != node_ptr;
-         node_ptr = node_ptr->next_ptr) {
-        wlmaker_server_key_binding_t *iter_kb_ptr =
-            (wlmaker_server_key_binding_t*)node_ptr;
-
-        if ((iter_kb_ptr->key_sym_lower == key_sym ||
-             iter_kb_ptr->key_sym_upper == key_sym) &&
-            iter_kb_ptr->modifiers == (iter_kb_ptr->modifiers & modifiers)) {
-            iter_kb_ptr->callback(server_ptr, iter_kb_ptr->callback_arg_ptr);
-            return true;
-        }
+    void *data_ptr = NULL;
+    switch (wlmaker_key_bindings_process(
+                server_ptr->key_bindings_ptr, key_sym, modifiers, &data_ptr)) {
+    case WLMAKER_KEY_BINDINGS_NONE:
+        return false;
+    case WLMAKER_KEY_BINDINGS_MATCHED: {
+        wlmaker_server_key_binding_t *key_binding_ptr = data_ptr;
+        key_binding_ptr->callback(
+            server_ptr, key_binding_ptr->callback_arg_ptr);
+        return true;
+    }
+    default:
+        // Pending or aborted key chord: The key was consumed.
+        return true;
     }
-    return false;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -40,11 +40,14 @@ typedef struct _wlmaker_server_t wlmaker_server_t;
 
 #include "cursor.h"
 #include "idle.h"
+#include "key_bindings.h"
+#include "latency.h"
 #include "output.h"
 #include "keyboard.h"
 #include "layer_shell.h"
 #include "lock_mgr.h"
 #include "root.h"
+#include "stats.h"
 #include "view.h"
 #include "subprocess_monitor.h"
 #include "icon_manager.h"
@@ -70,6 +73,12 @@ struct _wlmaker_server_t {
     wlmaker_lock_mgr_t        *lock_mgr_ptr;
     /** Idle monitor. */
     wlmaker_idle_monitor_t    *idle_monitor_ptr;
+    /** Input-to-commit latency tracker. */
+    wlmaker_latency_t         *latency_ptr;
+    /** Statistics endpoint. NULL if disabled, or failed to create. */
+    wlmaker_stats_t           *stats_ptr;
+    /** Whether @ref wlmaker_server_run keeps dispatching events. */
+    bool                      running;
 
     /** wlroots allocator. */
     struct wlr_allocator      *wlr_allocator_ptr;
@@ -151,8 +160,10 @@ struct _wlmaker_server_t {
     /** Signal: When the task list is disabled. (to be hidden) */
     struct wl_signal          task_list_disabled_event;
 
-    /** Keys bound to specific actions. */
+    /** Keys bound to specific actions. @ref wlmaker_server_key_binding_t. */
     bs_dllist_t               key_bindings;
+    /** Table of the bound keys, for dispatching key presses. */
+    wlmaker_key_bindings_t    *key_bindings_ptr;
 
     /** Clients for this server. */
     bs_dllist_t               clients;
@@ -203,6 +214,23 @@ wlmaker_server_t *wlmaker_server_create(void);
  */
 void wlmaker_server_destroy(wlmaker_server_t *server_ptr);
 
+/**
+ * Runs the event loop, until @ref wlmaker_server_terminate is called.
+ *
+ * Equivalent to `wl_display_run`, but records the time spent in each
+ * dispatch of the event loop.
+ *
+ * @param server_ptr
+ */
+void wlmaker_server_run(wlmaker_server_t *server_ptr);
+
+/**
+ * Terminates @ref wlmaker_server_run, once the current dispatch completes.
+ *
+ * @param server_ptr
+ */
+void wlmaker_server_terminate(wlmaker_server_t *server_ptr);
+
 /**
  * Adds the output.
  *
@@ -238,6 +266,28 @@ wlmaker_server_key_binding_t *wlmaker_server_bind_key(
     wlmaker_server_bind_key_callback_t callback,
     void *callback_arg_ptr);
 
+/**
+ * Binds the callback to a sequence of keys, ie. a key chord.
+ *
+ * The callback is triggered once all keys were pressed in sequence. Key
+ * presses that partially match a sequence are consumed.
+ *
+ * @param server_ptr
+ * @param combos              Keys and modifiers to press in sequence.
+ * @param num_combos          Number of elements in `combos`.
+ * @param callback            Callback for when the sequence was pressed.
+ * @param callback_arg_ptr    Argument to pass to |callback|.
+ *
+ * @return The key binding, or NULL on error, eg. if conflicting with another
+ *     binding.
+ */
+wlmaker_server_key_binding_t *wlmaker_server_bind_key_sequence(
+    wlmaker_server_t *server_ptr,
+    const wlmaker_key_combo_t *combos,
+    size_t num_combos,
+    wlmaker_server_bind_key_callback_t callback,
+    void *callback_arg_ptr);
+
 /**
  * Releases a previously-bound key binding.
  *
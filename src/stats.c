@@ -0,0 +1,969 @@
+/* ========================================================================= */
+/**
+ * @file stats.c
+ *
+ * @copyright
+ * Copyright 2024 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/// open_memstream() is a POSIX extension.
+#define _POSIX_C_SOURCE 200809L
+
+#include "stats.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define WLR_USE_UNSTABLE
+#include <wlr/types/wlr_compositor.h>
+#include <wlr/types/wlr_output.h>
+#undef WLR_USE_UNSTABLE
+
+/* == Declarations ========================================================= */
+
+/** Commit statistics of a client. */
+typedef struct {
+    /** Element of @ref _wlmaker_stats_t::clients, until the client is gone. */
+    bs_dllist_node_t          dlnode;
+    /** Back-link to the statistics endpoint. */
+    wlmaker_stats_t           *stats_ptr;
+    /** The client. NULL once the client is destroyed. */
+    struct wl_client          *wl_client_ptr;
+    /** Process ID of the client. */
+    pid_t                     pid;
+    /** Listener for when the client is destroyed. */
+    struct wl_listener        client_destroy_listener;
+
+    /** Number of tracked surfaces. Each holds a reference to this record. */
+    size_t                    surfaces;
+    /** Total number of commits. */
+    uint64_t                  commits;
+    /** Start of the current rate window, in microseconds. */
+    uint64_t                  window_start_usec;
+    /** Commits within the current rate window. */
+    uint64_t                  window_commits;
+    /** Commits per second, over the last completed rate window. */
+    double                    commits_per_sec;
+} wlmaker_stats_client_t;
+
+/** A surface, tracked for commits. */
+typedef struct {
+    /** Element of @ref _wlmaker_stats_t::surfaces. */
+    bs_dllist_node_t          dlnode;
+    /** Back-link to the statistics endpoint. */
+    wlmaker_stats_t           *stats_ptr;
+    /** Record of the client owning the surface. */
+    wlmaker_stats_client_t    *client_ptr;
+    /** Listener for the surface's `commit` signal. */
+    struct wl_listener        commit_listener;
+    /** Listener for the surface's `destroy` signal. */
+    struct wl_listener        destroy_listener;
+} wlmaker_stats_surface_t;
+
+/** A connection to the socket, being served the statistics. */
+typedef struct {
+    /** Element of @ref _wlmaker_stats_t::connections. */
+    bs_dllist_node_t          dlnode;
+    /** Back-link to the statistics endpoint. */
+    wlmaker_stats_t           *stats_ptr;
+    /** The connection's file descriptor. Non-blocking. */
+    int                       fd;
+    /** Event source, for when `fd` is writable again. */
+    struct wl_event_source    *wl_event_source_ptr;
+    /** Timer, to drop the connection if writing makes no progress. */
+    struct wl_event_source    *timer_wl_event_source_ptr;
+    /** The JSON document, from `open_memstream`. */
+    char                      *buf_ptr;
+    /** Size of the document at `buf_ptr`. */
+    size_t                    size;
+    /** Bytes already written. */
+    size_t                    written;
+} wlmaker_stats_connection_t;
+
+/** State of the statistics endpoint. */
+struct _wlmaker_stats_t {
+    /** Back-link to the server. */
+    wlmaker_server_t          *server_ptr;
+    /** Time the endpoint was created, in microseconds. */
+    uint64_t                  created_usec;
+
+    /** Path of the socket. */
+    char                      *path_ptr;
+    /** The listening socket. */
+    int                       listen_fd;
+    /** Event source, for incoming connections on `listen_fd`. */
+    struct wl_event_source    *listen_wl_event_source_ptr;
+    /** Connections being served. @ref wlmaker_stats_connection_t. */
+    bs_dllist_t               connections;
+
+    /** Listener for `new_surface` signals raised by `wlr_compositor`. */
+    struct wl_listener        new_surface_listener;
+    /** Records of connected clients. @ref wlmaker_stats_client_t. */
+    bs_dllist_t               clients;
+    /** Tracked surfaces. @ref wlmaker_stats_surface_t. */
+    bs_dllist_t               surfaces;
+
+    /** Number of event loop dispatches. */
+    uint64_t                  dispatches;
+    /** Total time spent dispatching, in microseconds. */
+    uint64_t                  dispatch_total_usec;
+    /** Longest dispatch, in microseconds. */
+    uint64_t                  dispatch_max_usec;
+};
+
+static bool _wlmaker_stats_listen(wlmaker_stats_t *stats_ptr);
+static int _wlmaker_stats_handle_accept(
+    int fd,
+    uint32_t mask,
+    void *data_ptr);
+static int _wlmaker_stats_handle_write_timeout(void *data_ptr);
+static int _wlmaker_stats_handle_writable(
+    int fd,
+    uint32_t mask,
+    void *data_ptr);
+static bool _wlmaker_stats_connection_write(
+    wlmaker_stats_connection_t *connection_ptr);
+static void _wlmaker_stats_connection_destroy(
+    wlmaker_stats_connection_t *connection_ptr);
+
+static void _wlmaker_stats_handle_new_surface(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void _wlmaker_stats_handle_surface_commit(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void _wlmaker_stats_handle_surface_destroy(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void _wlmaker_stats_handle_client_destroy(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void _wlmaker_stats_surface_destroy(
+    wlmaker_stats_surface_t *surface_ptr);
+static void _wlmaker_stats_client_commit(
+    wlmaker_stats_client_t *client_ptr,
+    uint64_t now_usec);
+static double _wlmaker_stats_client_rate(
+    wlmaker_stats_client_t *client_ptr,
+    uint64_t now_usec);
+
+static bool _wlmaker_stats_write_json(
+    wlmaker_stats_t *stats_ptr,
+    FILE *file_ptr,
+    uint64_t now_usec);
+static void _wlmaker_stats_write_outputs(
+    wlmaker_stats_t *stats_ptr,
+    FILE *file_ptr);
+static void _wlmaker_stats_write_latency(
+    wlmaker_stats_t *stats_ptr,
+    FILE *file_ptr);
+static void _wlmaker_stats_write_clients(
+    wlmaker_stats_t *stats_ptr,
+    FILE *file_ptr,
+    uint64_t now_usec);
+static void _wlmaker_stats_write_workspaces(
+    wlmaker_stats_t *stats_ptr,
+    FILE *file_ptr);
+
+/* == Data ================================================================= */
+
+/** Length of the window for computing commit rates, in microseconds. */
+static const uint64_t         _wlmaker_stats_rate_window_usec = 1000000;
+/** Maximum number of connections being served at the same time. */
+static const size_t           _wlmaker_stats_max_connections = 8;
+/** Connections making no write progress for this long are dropped. */
+static const int              _wlmaker_stats_write_timeout_msec = 2000;
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlmaker_stats_t *wlmaker_stats_create(wlmaker_server_t *server_ptr)
+{
+    wlmaker_stats_t *stats_ptr = logged_calloc(1, sizeof(wlmaker_stats_t));
+    if (NULL == stats_ptr) return NULL;
+    stats_ptr->server_ptr = server_ptr;
+    stats_ptr->created_usec = wlmtk_util_now_usec();
+    stats_ptr->listen_fd = -1;
+
+    if (!_wlmaker_stats_listen(stats_ptr)) {
+        wlmaker_stats_destroy(stats_ptr);
+        return NULL;
+    }
+
+    wlmtk_util_connect_listener_signal(
+        &server_ptr->wlr_compositor_ptr->events.new_surface,
+        &stats_ptr->new_surface_listener,
+        _wlmaker_stats_handle_new_surface);
+
+    bs_log(BS_INFO, "Serving statistics on %s", stats_ptr->path_ptr);
+    return stats_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_stats_destroy(wlmaker_stats_t *stats_ptr)
+{
+    wlmtk_util_disconnect_listener(&stats_ptr->new_surface_listener);
+
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = stats_ptr->surfaces.head_ptr)) {
+        _wlmaker_stats_surface_destroy(BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_stats_surface_t, dlnode));
+    }
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(&stats_ptr->clients))) {
+        wlmaker_stats_client_t *client_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_stats_client_t, dlnode);
+        wlmtk_util_disconnect_listener(&client_ptr->client_destroy_listener);
+        free(client_ptr);
+    }
+
+    while (NULL != (dlnode_ptr = stats_ptr->connections.head_ptr)) {
+        _wlmaker_stats_connection_destroy(BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_stats_connection_t, dlnode));
+    }
+
+    if (NULL != stats_ptr->listen_wl_event_source_ptr) {
+        wl_event_source_remove(stats_ptr->listen_wl_event_source_ptr);
+        stats_ptr->listen_wl_event_source_ptr = NULL;
+    }
+    if (0 <= stats_ptr->listen_fd) {
+        close(stats_ptr->listen_fd);
+        unlink(stats_ptr->path_ptr);
+        stats_ptr->listen_fd = -1;
+    }
+    if (NULL != stats_ptr->path_ptr) {
+        free(stats_ptr->path_ptr);
+        stats_ptr->path_ptr = NULL;
+    }
+    free(stats_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_stats_record_dispatch(
+    wlmaker_stats_t *stats_ptr,
+    uint64_t duration_usec)
+{
+    ++stats_ptr->dispatches;
+    stats_ptr->dispatch_total_usec += duration_usec;
+    stats_ptr->dispatch_max_usec = BS_MAX(
+        stats_ptr->dispatch_max_usec, duration_usec);
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmaker_stats_write_json(wlmaker_stats_t *stats_ptr, FILE *file_ptr)
+{
+    return _wlmaker_stats_write_json(
+        stats_ptr, file_ptr, wlmtk_util_now_usec());
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates the socket at `$XDG_RUNTIME_DIR/<wl_socket_name>.stats` and adds
+ * it to the event loop.
+ *
+ * @param stats_ptr
+ *
+ * @return true on success.
+ */
+bool _wlmaker_stats_listen(wlmaker_stats_t *stats_ptr)
+{
+    const char *runtime_dir_ptr = getenv("XDG_RUNTIME_DIR");
+    if (NULL == runtime_dir_ptr) {
+        bs_log(BS_ERROR, "XDG_RUNTIME_DIR not set, no statistics socket.");
+        return false;
+    }
+
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    size_t len = snprintf(addr.sun_path, sizeof(addr.sun_path), "%s/%s.stats",
+                          runtime_dir_ptr,
+                          stats_ptr->server_ptr->wl_socket_name_ptr);
+    if (len >= sizeof(addr.sun_path)) {
+        bs_log(BS_ERROR, "Path too long for statistics socket in %s",
+               runtime_dir_ptr);
+        return false;
+    }
+    stats_ptr->path_ptr = logged_strdup(addr.sun_path);
+    if (NULL == stats_ptr->path_ptr) return false;
+
+    stats_ptr->listen_fd = socket(
+        AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (0 > stats_ptr->listen_fd) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed socket(AF_UNIX, SOCK_STREAM)");
+        return false;
+    }
+    // The Wayland socket's lock guards the name. A file here is stale.
+    unlink(stats_ptr->path_ptr);
+    if (0 != bind(stats_ptr->listen_fd,
+                  (struct sockaddr*)&addr, sizeof(addr)) ||
+        0 != listen(stats_ptr->listen_fd, 4)) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed bind() or listen() on %s",
+               stats_ptr->path_ptr);
+        close(stats_ptr->listen_fd);
+        stats_ptr->listen_fd = -1;
+        return false;
+    }
+
+    stats_ptr->listen_wl_event_source_ptr = wl_event_loop_add_fd(
+        wl_display_get_event_loop(stats_ptr->server_ptr->wl_display_ptr),
+        stats_ptr->listen_fd,
+        WL_EVENT_READABLE,
+        _wlmaker_stats_handle_accept,
+        stats_ptr);
+    if (NULL == stats_ptr->listen_wl_event_source_ptr) {
+        bs_log(BS_ERROR, "Failed wl_event_loop_add_fd(%d)",
+               stats_ptr->listen_fd);
+        return false;
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handles incoming connections: Accepts, and writes the statistics. Writing
+ * continues from the event loop, if the connection's buffer fills up. At most
+ * @ref _wlmaker_stats_max_connections are served; further ones are closed.
+ *
+ * @param fd
+ * @param mask
+ * @param data_ptr            Points to @ref wlmaker_stats_t.
+ *
+ * @return 0.
+ */
+int _wlmaker_stats_handle_accept(
+    int fd,
+    __UNUSED__ uint32_t mask,
+    void *data_ptr)
+{
+    wlmaker_stats_t *stats_ptr = data_ptr;
+
+    int connection_fd;
+    while (0 <= (connection_fd = accept(fd, NULL, NULL))) {
+        if (0 != fcntl(connection_fd, F_SETFD, FD_CLOEXEC) ||
+            0 != fcntl(connection_fd, F_SETFL, O_NONBLOCK)) {
+            bs_log(BS_WARNING | BS_ERRNO, "Failed fcntl(%d)", connection_fd);
+            close(connection_fd);
+            continue;
+        }
+        if (bs_dllist_size(&stats_ptr->connections) >=
+            _wlmaker_stats_max_connections) {
+            bs_log(BS_WARNING, "Too many statistics connections, closing %d",
+                   connection_fd);
+            close(connection_fd);
+            continue;
+        }
+
+        wlmaker_stats_connection_t *connection_ptr = logged_calloc(
+            1, sizeof(wlmaker_stats_connection_t));
+        if (NULL == connection_ptr) {
+            close(connection_fd);
+            continue;
+        }
+        connection_ptr->stats_ptr = stats_ptr;
+        connection_ptr->fd = connection_fd;
+        bs_dllist_push_back(&stats_ptr->connections, &connection_ptr->dlnode);
+
+        FILE *file_ptr = open_memstream(
+            &connection_ptr->buf_ptr, &connection_ptr->size);
+        if (NULL == file_ptr) {
+            bs_log(BS_WARNING | BS_ERRNO, "Failed open_memstream()");
+            _wlmaker_stats_connection_destroy(connection_ptr);
+            continue;
+        }
+        bool written = wlmaker_stats_write_json(stats_ptr, file_ptr);
+        if (0 != fclose(file_ptr) || !written) {
+            bs_log(BS_WARNING, "Failed to write statistics.");
+            _wlmaker_stats_connection_destroy(connection_ptr);
+            continue;
+        }
+
+        if (_wlmaker_stats_connection_write(connection_ptr)) {
+            _wlmaker_stats_connection_destroy(connection_ptr);
+            continue;
+        }
+        struct wl_event_loop *wl_event_loop_ptr = wl_display_get_event_loop(
+            stats_ptr->server_ptr->wl_display_ptr);
+        connection_ptr->wl_event_source_ptr = wl_event_loop_add_fd(
+            wl_event_loop_ptr,
+            connection_fd,
+            WL_EVENT_WRITABLE,
+            _wlmaker_stats_handle_writable,
+            connection_ptr);
+        if (NULL == connection_ptr->wl_event_source_ptr) {
+            bs_log(BS_WARNING, "Failed wl_event_loop_add_fd(%d)",
+                   connection_fd);
+            _wlmaker_stats_connection_destroy(connection_ptr);
+            continue;
+        }
+        connection_ptr->timer_wl_event_source_ptr = wl_event_loop_add_timer(
+            wl_event_loop_ptr,
+            _wlmaker_stats_handle_write_timeout,
+            connection_ptr);
+        if (NULL == connection_ptr->timer_wl_event_source_ptr ||
+            0 != wl_event_source_timer_update(
+                connection_ptr->timer_wl_event_source_ptr,
+                _wlmaker_stats_write_timeout_msec)) {
+            bs_log(BS_WARNING, "Failed to set up timer for connection %d",
+                   connection_fd);
+            _wlmaker_stats_connection_destroy(connection_ptr);
+        }
+    }
+    if (EAGAIN != errno && EWOULDBLOCK != errno) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed accept(%d)", fd);
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Drops a connection that made no write progress within
+ * @ref _wlmaker_stats_write_timeout_msec.
+ *
+ * @param data_ptr            Points to @ref wlmaker_stats_connection_t.
+ *
+ * @return 0.
+ */
+int _wlmaker_stats_handle_write_timeout(void *data_ptr)
+{
+    wlmaker_stats_connection_t *connection_ptr = data_ptr;
+    bs_log(BS_DEBUG, "Statistics connection %d timed out, %zu of %zu written",
+           connection_ptr->fd, connection_ptr->written, connection_ptr->size);
+    _wlmaker_stats_connection_destroy(connection_ptr);
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Continues writing to a connection, once it is writable. Re-arms the
+ * connection's timeout, if there was progress.
+ *
+ * @param fd
+ * @param mask
+ * @param data_ptr            Points to @ref wlmaker_stats_connection_t.
+ *
+ * @return 0.
+ */
+int _wlmaker_stats_handle_writable(
+    __UNUSED__ int fd,
+    __UNUSED__ uint32_t mask,
+    void *data_ptr)
+{
+    wlmaker_stats_connection_t *connection_ptr = data_ptr;
+    size_t written = connection_ptr->written;
+    if (_wlmaker_stats_connection_write(connection_ptr)) {
+        _wlmaker_stats_connection_destroy(connection_ptr);
+        return 0;
+    }
+    if (connection_ptr->written > written) {
+        wl_event_source_timer_update(
+            connection_ptr->timer_wl_event_source_ptr,
+            _wlmaker_stats_write_timeout_msec);
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Writes as much of the document as the connection takes.
+ *
+ * @param connection_ptr
+ *
+ * @return true if the connection is done: All written, or failed.
+ */
+bool _wlmaker_stats_connection_write(
+    wlmaker_stats_connection_t *connection_ptr)
+{
+    while (connection_ptr->written < connection_ptr->size) {
+        ssize_t rv = send(
+            connection_ptr->fd,
+            connection_ptr->buf_ptr + connection_ptr->written,
+            connection_ptr->size - connection_ptr->written,
+            MSG_NOSIGNAL);
+        if (0 > rv) {
+            if (EAGAIN == errno || EWOULDBLOCK == errno) return false;
+            if (EINTR == errno) continue;
+            bs_log(BS_DEBUG | BS_ERRNO, "Failed send(%d)", connection_ptr->fd);
+            return true;
+        }
+        connection_ptr->written += rv;
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Closes the connection, and frees associated resources. */
+void _wlmaker_stats_connection_destroy(
+    wlmaker_stats_connection_t *connection_ptr)
+{
+    bs_dllist_remove(&connection_ptr->stats_ptr->connections,
+                     &connection_ptr->dlnode);
+    if (NULL != connection_ptr->wl_event_source_ptr) {
+        wl_event_source_remove(connection_ptr->wl_event_source_ptr);
+        connection_ptr->wl_event_source_ptr = NULL;
+    }
+    if (NULL != connection_ptr->timer_wl_event_source_ptr) {
+        wl_event_source_remove(connection_ptr->timer_wl_event_source_ptr);
+        connection_ptr->timer_wl_event_source_ptr = NULL;
+    }
+    if (NULL != connection_ptr->buf_ptr) {
+        free(connection_ptr->buf_ptr);
+        connection_ptr->buf_ptr = NULL;
+    }
+    close(connection_ptr->fd);
+    free(connection_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handles `new_surface` signals of `wlr_compositor`: Tracks the surface's
+ * commits, on the record of the surface's client.
+ *
+ * @param listener_ptr
+ * @param data_ptr            Points to the new `struct wlr_surface`.
+ */
+void _wlmaker_stats_handle_new_surface(
+    struct wl_listener *listener_ptr,
+    void *data_ptr)
+{
+    wlmaker_stats_t *stats_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_stats_t, new_surface_listener);
+    struct wlr_surface *wlr_surface_ptr = data_ptr;
+    struct wl_client *wl_client_ptr = wl_resource_get_client(
+        wlr_surface_ptr->resource);
+
+    wlmaker_stats_client_t *client_ptr = NULL;
+    for (bs_dllist_node_t *dlnode_ptr = stats_ptr->clients.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmaker_stats_client_t *c_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_stats_client_t, dlnode);
+        if (c_ptr->wl_client_ptr == wl_client_ptr) {
+            client_ptr = c_ptr;
+            break;
+        }
+    }
+    if (NULL == client_ptr) {
+        client_ptr = logged_calloc(1, sizeof(wlmaker_stats_client_t));
+        if (NULL == client_ptr) return;
+        client_ptr->stats_ptr = stats_ptr;
+        client_ptr->wl_client_ptr = wl_client_ptr;
+        wl_client_get_credentials(wl_client_ptr, &client_ptr->pid, NULL, NULL);
+        client_ptr->window_start_usec = wlmtk_util_now_usec();
+        client_ptr->client_destroy_listener.notify =
+            _wlmaker_stats_handle_client_destroy;
+        wl_client_add_destroy_listener(
+            wl_client_ptr, &client_ptr->client_destroy_listener);
+        bs_dllist_push_back(&stats_ptr->clients, &client_ptr->dlnode);
+    }
+
+    wlmaker_stats_surface_t *surface_ptr = logged_calloc(
+        1, sizeof(wlmaker_stats_surface_t));
+    if (NULL == surface_ptr) return;
+    surface_ptr->stats_ptr = stats_ptr;
+    surface_ptr->client_ptr = client_ptr;
+    ++client_ptr->surfaces;
+    bs_dllist_push_back(&stats_ptr->surfaces, &surface_ptr->dlnode);
+    wlmtk_util_connect_listener_signal(
+        &wlr_surface_ptr->events.commit,
+        &surface_ptr->commit_listener,
+        _wlmaker_stats_handle_surface_commit);
+    wlmtk_util_connect_listener_signal(
+        &wlr_surface_ptr->events.destroy,
+        &surface_ptr->destroy_listener,
+        _wlmaker_stats_handle_surface_destroy);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Handles the `commit` signal of a tracked surface. */
+void _wlmaker_stats_handle_surface_commit(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    wlmaker_stats_surface_t *surface_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_stats_surface_t, commit_listener);
+    _wlmaker_stats_client_commit(
+        surface_ptr->client_ptr, wlmtk_util_now_usec());
+}
+
+/* ------------------------------------------------------------------------- */
+/** Handles the `destroy` signal of a tracked surface. */
+void _wlmaker_stats_handle_surface_destroy(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    wlmaker_stats_surface_t *surface_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_stats_surface_t, destroy_listener);
+    _wlmaker_stats_surface_destroy(surface_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handles the client's `destroy` signal: Drops the record from the list of
+ * clients. It is freed once all its surfaces are destroyed, too.
+ */
+void _wlmaker_stats_handle_client_destroy(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    wlmaker_stats_client_t *client_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_stats_client_t, client_destroy_listener);
+    wlmtk_util_disconnect_listener(&client_ptr->client_destroy_listener);
+    bs_dllist_remove(&client_ptr->stats_ptr->clients, &client_ptr->dlnode);
+    client_ptr->wl_client_ptr = NULL;
+    if (0 == client_ptr->surfaces) free(client_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Stops tracking the surface. Frees the client record, if this was the last
+ * surface of a destroyed client.
+ *
+ * @param surface_ptr
+ */
+void _wlmaker_stats_surface_destroy(wlmaker_stats_surface_t *surface_ptr)
+{
+    wlmaker_stats_client_t *client_ptr = surface_ptr->client_ptr;
+    BS_ASSERT(0 < client_ptr->surfaces);
+    --client_ptr->surfaces;
+    if (NULL == client_ptr->wl_client_ptr && 0 == client_ptr->surfaces) {
+        free(client_ptr);
+    }
+
+    wlmtk_util_disconnect_listener(&surface_ptr->destroy_listener);
+    wlmtk_util_disconnect_listener(&surface_ptr->commit_listener);
+    bs_dllist_remove(&surface_ptr->stats_ptr->surfaces, &surface_ptr->dlnode);
+    free(surface_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Accounts for a commit. Completes the rate window, if it elapsed.
+ *
+ * @param client_ptr
+ * @param now_usec
+ */
+void _wlmaker_stats_client_commit(
+    wlmaker_stats_client_t *client_ptr,
+    uint64_t now_usec)
+{
+    uint64_t elapsed_usec = now_usec - client_ptr->window_start_usec;
+    if (elapsed_usec >= _wlmaker_stats_rate_window_usec) {
+        client_ptr->commits_per_sec =
+            client_ptr->window_commits * 1e6 / elapsed_usec;
+        client_ptr->window_start_usec = now_usec;
+        client_ptr->window_commits = 0;
+    }
+    ++client_ptr->commits;
+    ++client_ptr->window_commits;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the client's commit rate: Of the current window, if it already
+ * elapsed. Otherwise, of the last completed window.
+ *
+ * @param client_ptr
+ * @param now_usec
+ *
+ * @return Commits per second.
+ */
+double _wlmaker_stats_client_rate(
+    wlmaker_stats_client_t *client_ptr,
+    uint64_t now_usec)
+{
+    uint64_t elapsed_usec = now_usec - client_ptr->window_start_usec;
+    if (elapsed_usec >= _wlmaker_stats_rate_window_usec) {
+        return client_ptr->window_commits * 1e6 / elapsed_usec;
+    }
+    return client_ptr->commits_per_sec;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Writes the statistics as a JSON object, one member per line.
+ *
+ * @param stats_ptr
+ * @param file_ptr
+ * @param now_usec
+ *
+ * @return true on success.
+ */
+bool _wlmaker_stats_write_json(
+    wlmaker_stats_t *stats_ptr,
+    FILE *file_ptr,
+    uint64_t now_usec)
+{
+    fprintf(file_ptr, "{\"uptime_usec\":%"PRIu64",\n",
+            now_usec - stats_ptr->created_usec);
+
+    fprintf(file_ptr,
+            "\"event_loop\":{\"dispatches\":%"PRIu64
+            ",\"total_usec\":%"PRIu64",\"max_usec\":%"PRIu64
+            ",\"mean_usec\":%"PRIu64"},\n",
+            stats_ptr->dispatches,
+            stats_ptr->dispatch_total_usec,
+            stats_ptr->dispatch_max_usec,
+            stats_ptr->dispatch_total_usec / BS_MAX(1u, stats_ptr->dispatches));
+
+    _wlmaker_stats_write_outputs(stats_ptr, file_ptr);
+    _wlmaker_stats_write_latency(stats_ptr, file_ptr);
+    _wlmaker_stats_write_clients(stats_ptr, file_ptr, now_usec);
+    _wlmaker_stats_write_workspaces(stats_ptr, file_ptr);
+
+    const wlmtk_title_cache_stats_t *title_stats_ptr =
+        wlmtk_title_cache_stats();
+    fprintf(file_ptr,
+            "\"decorations\":{\"fill_cache_bytes\":%zu"
+            ",\"title_cache_bytes\":%zu"
+            ",\"title_texture_hits\":%"PRIu64
+            ",\"title_texture_misses\":%"PRIu64"},\n",
+            wlmtk_fill_cache_bytes(),
+            wlmtk_title_cache_bytes(),
+            title_stats_ptr->texture_hits,
+            title_stats_ptr->texture_misses);
+
+    wlmaker_subprocess_monitor_stats_t subprocess_stats = {};
+    if (NULL != stats_ptr->server_ptr->monitor_ptr) {
+        wlmaker_subprocess_monitor_get_stats(
+            stats_ptr->server_ptr->monitor_ptr, &subprocess_stats);
+    }
+    fprintf(file_ptr,
+            "\"subprocesses\":{\"count\":%zu,\"sigchld\":%zu"
+            ",\"windows\":%zu}}\n",
+            subprocess_stats.subprocesses,
+            subprocess_stats.sigchld_subprocesses,
+            subprocess_stats.windows);
+    return 0 == ferror(file_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Writes frame counts and render times of each output. */
+void _wlmaker_stats_write_outputs(wlmaker_stats_t *stats_ptr, FILE *file_ptr)
+{
+    fprintf(file_ptr, "\"outputs\":[");
+    for (bs_dllist_node_t *dlnode_ptr = stats_ptr->server_ptr->outputs.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmaker_output_t *output_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_output_t, node);
+        struct wlr_output *wlr_output_ptr = output_ptr->wlr_output_ptr;
+        fprintf(file_ptr, "%s{\"name\":",
+                dlnode_ptr->prev_ptr == NULL ? "" : ",");
+        wlmtk_util_write_json_string(file_ptr, wlr_output_ptr->name);
+        fprintf(file_ptr,
+                ",\"width\":%d,\"height\":%d,\"refresh_mhz\":%d"
+                ",\"committed_frames\":%"PRIu64
+                ",\"skipped_frames\":%"PRIu64
+                ",\"missed_frames\":%"PRIu64
+                ",\"render_duration_usec\":%"PRIu64
+                ",\"render_deadline_usec\":%"PRIu64"}",
+                wlr_output_ptr->width,
+                wlr_output_ptr->height,
+                wlr_output_ptr->refresh,
+                output_ptr->committed_frames,
+                output_ptr->skipped_frames,
+                output_ptr->missed_frames,
+                output_ptr->render_duration_usec,
+                output_ptr->render_deadline_usec);
+    }
+    fprintf(file_ptr, "],\n");
+}
+
+/* ------------------------------------------------------------------------- */
+/** Writes the summary of input-to-commit latencies, per source. */
+void _wlmaker_stats_write_latency(wlmaker_stats_t *stats_ptr, FILE *file_ptr)
+{
+    static const char *source_names[WLMAKER_LATENCY_SOURCES] = {
+        [WLMAKER_LATENCY_POINTER] = "pointer",
+        [WLMAKER_LATENCY_KEYBOARD] = "keyboard",
+    };
+
+    fprintf(file_ptr, "\"latency\":{");
+    for (int source = 0; source < WLMAKER_LATENCY_SOURCES; ++source) {
+        wlmaker_latency_summary_t summary = {};
+        if (NULL != stats_ptr->server_ptr->latency_ptr) {
+            wlmaker_latency_summary(
+                stats_ptr->server_ptr->latency_ptr, source, &summary);
+        }
+        fprintf(file_ptr,
+                "%s\"%s\":{\"count\":%"PRIu64",\"discarded\":%"PRIu64
+                ",\"min_usec\":%"PRIu64",\"p50_usec\":%"PRIu64
+                ",\"p95_usec\":%"PRIu64",\"p99_usec\":%"PRIu64
+                ",\"max_usec\":%"PRIu64"}",
+                0 == source ? "" : ",", source_names[source],
+                summary.count, summary.discarded, summary.min_usec,
+                summary.p50_usec, summary.p95_usec, summary.p99_usec,
+                summary.max_usec);
+    }
+    fprintf(file_ptr, "},\n");
+}
+
+/* ------------------------------------------------------------------------- */
+/** Writes surfaces, commits and commit rate of each client. */
+void _wlmaker_stats_write_clients(
+    wlmaker_stats_t *stats_ptr,
+    FILE *file_ptr,
+    uint64_t now_usec)
+{
+    fprintf(file_ptr, "\"clients\":[");
+    for (bs_dllist_node_t *dlnode_ptr = stats_ptr->clients.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmaker_stats_client_t *client_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_stats_client_t, dlnode);
+        fprintf(file_ptr,
+                "%s{\"pid\":%d,\"surfaces\":%zu,\"commits\":%"PRIu64
+                ",\"commits_per_sec\":%.1f}",
+                dlnode_ptr->prev_ptr == NULL ? "" : ",",
+                (int)client_ptr->pid,
+                client_ptr->surfaces,
+                client_ptr->commits,
+                _wlmaker_stats_client_rate(client_ptr, now_usec));
+    }
+    fprintf(file_ptr, "],\n");
+}
+
+/* ------------------------------------------------------------------------- */
+/** Writes windows, elements and scene graph nodes of each workspace. */
+void _wlmaker_stats_write_workspaces(
+    wlmaker_stats_t *stats_ptr,
+    FILE *file_ptr)
+{
+    fprintf(file_ptr, "\"workspaces\":[");
+    for (bs_dllist_node_t *dlnode_ptr =
+             stats_ptr->server_ptr->workspaces.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmaker_workspace_t *workspace_ptr = wlmaker_workspace_from_dlnode(
+            dlnode_ptr);
+        int index;
+        const char *name_ptr;
+        wlmaker_workspace_get_details(workspace_ptr, &index, &name_ptr);
+        wlmaker_workspace_stats_t workspace_stats;
+        wlmaker_workspace_get_stats(workspace_ptr, &workspace_stats);
+
+        fprintf(file_ptr, "%s{\"index\":%d,\"name\":",
+                dlnode_ptr->prev_ptr == NULL ? "" : ",", index);
+        wlmtk_util_write_json_string(file_ptr, name_ptr);
+        fprintf(file_ptr,
+                ",\"current\":%s,\"windows\":%zu,\"views\":%zu"
+                ",\"elements\":%zu,\"scene_nodes\":%zu}",
+                workspace_ptr == stats_ptr->server_ptr->current_workspace_ptr ?
+                "true" : "false",
+                workspace_stats.windows,
+                workspace_stats.views,
+                workspace_stats.elements,
+                workspace_stats.scene_nodes);
+    }
+    fprintf(file_ptr, "],\n");
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_client_rate(bs_test_t *test_ptr);
+static void test_write_json(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmaker_stats_test_cases[] = {
+    { 1, "client_rate", test_client_rate },
+    { 1, "write_json", test_write_json },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Verifies the commit rate, over completed and elapsed windows. */
+void test_client_rate(bs_test_t *test_ptr)
+{
+    wlmaker_stats_client_t client = { .window_start_usec = 1000000 };
+
+    // 30 commits within the first window. No window completed yet.
+    for (int i = 0; i < 30; ++i) {
+        _wlmaker_stats_client_commit(&client, 1000000 + i * 30000);
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, 30, client.commits);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, _wlmaker_stats_client_rate(
+                          &client, 1500000));
+    // Once elapsed: Rate of the current window.
+    BS_TEST_VERIFY_EQ(test_ptr, 30, _wlmaker_stats_client_rate(
+                          &client, 2000000));
+
+    // A commit after 1.5s completes the window.
+    _wlmaker_stats_client_commit(&client, 2500000);
+    BS_TEST_VERIFY_EQ(test_ptr, 20, client.commits_per_sec);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, client.window_commits);
+    BS_TEST_VERIFY_EQ(test_ptr, 20, _wlmaker_stats_client_rate(
+                          &client, 3000000));
+
+    // An idle client decays.
+    BS_TEST_VERIFY_EQ(test_ptr, 0.1, _wlmaker_stats_client_rate(
+                          &client, 12500000));
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies the JSON output, for a server without outputs or workspaces. */
+void test_write_json(bs_test_t *test_ptr)
+{
+    wlmaker_server_t server = {};
+    wlmaker_stats_t stats = { .server_ptr = &server, .created_usec = 100 };
+    wlmaker_stats_client_t client = {
+        .pid = 42, .surfaces = 2, .commits = 7, .commits_per_sec = 3.5,
+        .window_start_usec = 1000 };
+    bs_dllist_push_back(&stats.clients, &client.dlnode);
+    wlmaker_stats_record_dispatch(&stats, 10);
+    wlmaker_stats_record_dispatch(&stats, 30);
+
+    char *buf_ptr = NULL;
+    size_t size = 0;
+    FILE *file_ptr = open_memstream(&buf_ptr, &size);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, file_ptr);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, _wlmaker_stats_write_json(&stats, file_ptr, 1100));
+    fclose(file_ptr);
+
+    BS_TEST_VERIFY_NEQ(
+        test_ptr, NULL, strstr(buf_ptr, "{\"uptime_usec\":1000,\n"));
+    BS_TEST_VERIFY_NEQ(
+        test_ptr, NULL, strstr(
+            buf_ptr,
+            "\"event_loop\":{\"dispatches\":2,\"total_usec\":40,"
+            "\"max_usec\":30,\"mean_usec\":20},\n"));
+    BS_TEST_VERIFY_NEQ(
+        test_ptr, NULL, strstr(buf_ptr, "\"outputs\":[],\n"));
+    BS_TEST_VERIFY_NEQ(
+        test_ptr, NULL, strstr(
+            buf_ptr,
+            "\"latency\":{\"pointer\":{\"count\":0,\"discarded\":0,"
+            "\"min_usec\":0,\"p50_usec\":0,\"p95_usec\":0,"
+            "\"p99_usec\":0,\"max_usec\":0},"));
+    BS_TEST_VERIFY_NEQ(
+        test_ptr, NULL, strstr(
+            buf_ptr,
+            "\"clients\":[{\"pid\":42,\"surfaces\":2,\"commits\":7,"
+            "\"commits_per_sec\":3.5}],\n"));
+    BS_TEST_VERIFY_NEQ(
+        test_ptr, NULL, strstr(buf_ptr, "\"workspaces\":[],\n"));
+    BS_TEST_VERIFY_NEQ(
+        test_ptr, NULL, strstr(
+            buf_ptr,
+            "\"subprocesses\":{\"count\":0,\"sigchld\":0,\"windows\":0}}\n"));
+    free(buf_ptr);
+}
+
+/* == End of stats.c ======================================================= */
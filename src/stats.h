@@ -0,0 +1,86 @@
+/* ========================================================================= */
+/**
+ * @file stats.h
+ *
+ * @copyright
+ * Copyright 2024 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __STATS_H__
+#define __STATS_H__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <libbase/libbase.h>
+
+/** Forward declaration: Statistics endpoint. */
+typedef struct _wlmaker_stats_t wlmaker_stats_t;
+
+#include "server.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Creates the statistics endpoint of the server.
+ *
+ * Tracks commits per client, and listens on a UNIX socket next to the
+ * Wayland socket: `$XDG_RUNTIME_DIR/<wl_socket_name>.stats`. Each connection
+ * receives a JSON document of the server's current statistics, and is then
+ * closed. Only a few connections are served at a time, and those not taking
+ * the document in time are dropped. See `apps/wlmaker-stat.c` for a client.
+ *
+ * @param server_ptr
+ *
+ * @return Pointer to the statistics endpoint, or NULL on error.
+ */
+wlmaker_stats_t *wlmaker_stats_create(wlmaker_server_t *server_ptr);
+
+/**
+ * Destroys the statistics endpoint. Closes and removes the socket.
+ *
+ * @param stats_ptr
+ */
+void wlmaker_stats_destroy(wlmaker_stats_t *stats_ptr);
+
+/**
+ * Records the time taken by one dispatch of the event loop.
+ *
+ * @param stats_ptr
+ * @param duration_usec
+ */
+void wlmaker_stats_record_dispatch(
+    wlmaker_stats_t *stats_ptr,
+    uint64_t duration_usec);
+
+/**
+ * Writes the server's statistics as JSON.
+ *
+ * @param stats_ptr
+ * @param file_ptr
+ *
+ * @return true on success.
+ */
+bool wlmaker_stats_write_json(wlmaker_stats_t *stats_ptr, FILE *file_ptr);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmaker_stats_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __STATS_H__ */
+/* == End of stats.h ======================================================= */
@@ -22,17 +22,74 @@
 
 #include "toolkit/toolkit.h"
 
+#include <errno.h>
+#include <fcntl.h>
 #include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/syscall.h>
 #include <unistd.h>
 
 /* == Declarations ========================================================= */
 
+/**
+ * Maximum length of a retained output line, including the terminating NUL.
+ * Longer lines are split.
+ */
+#define WLMAKER_SUBPROCESS_OUTPUT_LINE_SIZE 256
+/** Number of lines logged when the subprocess terminates abnormally. */
+#define WLMAKER_SUBPROCESS_EXIT_DUMP_LINES 16
+/** Bytes read per read(2) call. */
+#define WLMAKER_SUBPROCESS_READ_SIZE 4096
+/** Maximum bytes read per event loop dispatch, to not starve others. */
+#define WLMAKER_SUBPROCESS_READ_BUDGET 65536
+
+/** The output streams of a subprocess. */
+typedef enum {
+    WLMAKER_SUBPROCESS_STDOUT = 0,
+    WLMAKER_SUBPROCESS_STDERR = 1,
+} wlmaker_subprocess_stream_t;
+
+/** A line of output from the subprocess. */
+typedef struct {
+    /** Which stream the line was written to. */
+    wlmaker_subprocess_stream_t stream;
+    /** The line, NUL-terminated and without the newline. */
+    char                      text[WLMAKER_SUBPROCESS_OUTPUT_LINE_SIZE];
+} wlmaker_subprocess_line_t;
+
+/** Bounded output of a subprocess: Most recent lines, and partial lines. */
+typedef struct {
+    /** Ring buffer of the most recent lines. */
+    wlmaker_subprocess_line_t lines[WLMAKER_SUBPROCESS_OUTPUT_LINES];
+    /** Index into `lines` where the next line will be stored. */
+    size_t                    next_line;
+    /** Number of valid lines in `lines`. */
+    size_t                    num_lines;
+
+    /** Per-stream bytes of the current line, not yet terminated. */
+    char                      partial[2][WLMAKER_SUBPROCESS_OUTPUT_LINE_SIZE];
+    /** Per-stream number of bytes in `partial`. */
+    size_t                    partial_len[2];
+
+    /** PID, for logging. */
+    intmax_t                  pid;
+    /** Whether to log each line as it gets completed. */
+    bool                      log_lines;
+} wlmaker_subprocess_output_t;
+
 /** State of the subprocess monitor. */
 struct _wlmaker_subprocess_monitor_t {
     /** Reference to the event loop. */
     struct wl_event_loop      *wl_event_loop_ptr;
-    /** Event source used for monitoring SIGCHLD. */
+    /**
+     * Event source used for monitoring SIGCHLD. Only used for subprocesses
+     * where no pidfd could be obtained, see
+     * @ref wlmaker_subprocess_handle_t::pidfd.
+     */
     struct wl_event_source    *sigchld_event_source_ptr;
+    /** Number of monitored subprocesses that rely on SIGCHLD. */
+    size_t                    sigchld_subprocesses;
 
     /** Listener: Receives a signal whenever a window is created. */
     struct wl_listener        window_created_listener;
@@ -45,6 +102,8 @@ struct _wlmaker_subprocess_monitor_t {
 
     /** Monitored subprocesses. */
     bs_dllist_t               subprocesses;
+    /** Monitored subprocesses, by PID. @ref wlmaker_subprocess_handle_t. */
+    bs_avltree_t              *pid_tree_ptr;
     /** Windows for monitored subprocesses. */
     bs_avltree_t              *window_tree_ptr;
 };
@@ -53,8 +112,21 @@ struct _wlmaker_subprocess_monitor_t {
 struct _wlmaker_subprocess_handle_t {
     /** Element of @ref wlmaker_subprocess_monitor_t `subprocesses`. */
     bs_dllist_node_t          dlnode;
+    /** Node of @ref wlmaker_subprocess_monitor_t::pid_tree_ptr. */
+    bs_avltree_node_t         avlnode;
+    /** Back-link to the monitor. */
+    wlmaker_subprocess_monitor_t *monitor_ptr;
     /** Points to the subprocess. */
     bs_subprocess_t           *subprocess_ptr;
+    /** PID of the subprocess. Also the key for `avlnode`. */
+    pid_t                     pid;
+    /** Whether `avlnode` is inserted into the monitor's `pid_tree_ptr`. */
+    bool                      in_pid_tree;
+
+    /** pidfd of the subprocess, or -1 if falling back to SIGCHLD. */
+    int                       pidfd;
+    /** Event source for the pidfd turning readable, ie. the process exits. */
+    struct wl_event_source    *pidfd_wl_event_source_ptr;
 
     /** File descriptor of the subprocess' stdout. */
     int                       stdout_read_fd;
@@ -64,6 +136,8 @@ struct _wlmaker_subprocess_handle_t {
     int                       stderr_read_fd;
     /** Event source corresponding to events related to reading stderr. */
     struct wl_event_source    *stderr_wl_event_source_ptr;
+    /** Output of the subprocess. Allocated when the first bytes arrive. */
+    wlmaker_subprocess_output_t *output_ptr;
 
     /** Callback:  The subprocess was terminated. */
     wlmaker_subprocess_terminated_callback_t terminated_callback;
@@ -99,10 +173,15 @@ typedef struct {
 } wlmaker_subprocess_window_t;
 
 static wlmaker_subprocess_handle_t *wlmaker_subprocess_handle_create(
-    bs_subprocess_t *subprocess_ptr,
-    struct wl_event_loop *wl_event_loop_ptr);
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    bs_subprocess_t *subprocess_ptr);
 static void wlmaker_subprocess_handle_destroy(
     wlmaker_subprocess_handle_t *sp_handle_ptr);
+static bool wlmaker_subprocess_handle_reap(
+    wlmaker_subprocess_handle_t *sp_handle_ptr);
+static int _wlmaker_subprocess_monitor_pidfd_open(pid_t pid);
+static int _wlmaker_subprocess_monitor_handle_pidfd(
+    int fd, uint32_t mask, void *data_ptr);
 static int _wlmaker_subprocess_monitor_handle_read_stdout(
     int fd, uint32_t mask, void *data_ptr);
 static int _wlmaker_subprocess_monitor_handle_read_stderr(
@@ -113,7 +192,20 @@ static int _wlmaker_subprocess_monitor_process_fd(
     struct wl_event_source **wl_event_source_ptr_ptr,
     int fd,
     uint32_t mask,
-    const char *fd_name_ptr);
+    wlmaker_subprocess_stream_t stream);
+
+static void _wlmaker_subprocess_output_append(
+    wlmaker_subprocess_output_t *output_ptr,
+    wlmaker_subprocess_stream_t stream,
+    const char *data_ptr,
+    size_t len);
+static void _wlmaker_subprocess_output_flush(
+    wlmaker_subprocess_output_t *output_ptr,
+    wlmaker_subprocess_stream_t stream);
+static void _wlmaker_subprocess_output_dump(
+    wlmaker_subprocess_output_t *output_ptr,
+    size_t max_lines,
+    bs_log_severity_t severity);
 
 static int _wlmaker_subprocess_monitor_handle_sigchld(int signum, void *data_ptr);
 
@@ -140,6 +232,9 @@ static wlmaker_subprocess_window_t *wlmaker_subprocess_window_create(
 static void wlmaker_subprocess_window_destroy(
     wlmaker_subprocess_window_t *ws_window_ptr);
 
+static int wlmaker_subprocess_handle_node_cmp(
+    const bs_avltree_node_t *node_ptr,
+    const void *key_ptr);
 static int wlmaker_subprocess_window_node_cmp(
     const bs_avltree_node_t *node_ptr,
     const void *key_ptr);
@@ -156,6 +251,16 @@ wlmaker_subprocess_monitor_t* wlmaker_subprocess_monitor_create(
         1, sizeof(wlmaker_subprocess_monitor_t));
     if (NULL == monitor_ptr) return NULL;
 
+    // Handles are owned by `subprocesses`, hence no destructor for the tree.
+    monitor_ptr->pid_tree_ptr = bs_avltree_create(
+        wlmaker_subprocess_handle_node_cmp, NULL);
+    if (NULL == monitor_ptr->pid_tree_ptr) {
+        bs_log(BS_ERROR, "Failed bs_avltree_create(%p, NULL)",
+               wlmaker_subprocess_handle_node_cmp);
+        wlmaker_subprocess_monitor_destroy(monitor_ptr);
+        return NULL;
+    }
+
     monitor_ptr->window_tree_ptr = bs_avltree_create(
         wlmaker_subprocess_window_node_cmp,
         wlmaker_subprocess_window_node_destroy);
@@ -219,6 +324,10 @@ void wlmaker_subprocess_monitor_destroy(
         bs_avltree_destroy(monitor_ptr->window_tree_ptr);
         monitor_ptr->window_tree_ptr = NULL;
     }
+    if (NULL != monitor_ptr->pid_tree_ptr) {
+        bs_avltree_destroy(monitor_ptr->pid_tree_ptr);
+        monitor_ptr->pid_tree_ptr = NULL;
+    }
 
     monitor_ptr->wl_event_loop_ptr = NULL;
     free(monitor_ptr);
@@ -236,11 +345,22 @@ wlmaker_subprocess_handle_t *wlmaker_subprocess_monitor_entrust(
     wlmaker_subprocess_window_callback_t window_destroyed_callback)
 {
     wlmaker_subprocess_handle_t *subprocess_handle_ptr =
-        wlmaker_subprocess_handle_create(
-            subprocess_ptr, monitor_ptr->wl_event_loop_ptr);
+        wlmaker_subprocess_handle_create(monitor_ptr, subprocess_ptr);
     if (NULL == subprocess_handle_ptr) return NULL;
     bs_dllist_push_back(&monitor_ptr->subprocesses,
                         &subprocess_handle_ptr->dlnode);
+    subprocess_handle_ptr->in_pid_tree = bs_avltree_insert(
+        monitor_ptr->pid_tree_ptr,
+        (void*)(intptr_t)subprocess_handle_ptr->pid,
+        &subprocess_handle_ptr->avlnode,
+        false);
+    if (!subprocess_handle_ptr->in_pid_tree) {
+        // A PID is unique among running children. Keep monitoring the
+        // process, but it won't be looked up for window events.
+        bs_log(BS_WARNING, "Subprocess with PID %"PRIdMAX" already monitored.",
+               (intmax_t)subprocess_handle_ptr->pid);
+    }
+    if (0 > subprocess_handle_ptr->pidfd) ++monitor_ptr->sigchld_subprocesses;
 
     subprocess_handle_ptr->terminated_callback = terminated_callback;
     subprocess_handle_ptr->userdata_ptr = userdata_ptr;
@@ -286,6 +406,23 @@ void wlmaker_subprocess_monitor_cede(
     subprocess_handle_ptr->terminated_callback = NULL;
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmaker_subprocess_monitor_get_stats(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    wlmaker_subprocess_monitor_stats_t *stats_ptr)
+{
+    memset(stats_ptr, 0, sizeof(wlmaker_subprocess_monitor_stats_t));
+    stats_ptr->sigchld_subprocesses = monitor_ptr->sigchld_subprocesses;
+    for (bs_dllist_node_t *dlnode_ptr = monitor_ptr->subprocesses.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmaker_subprocess_handle_t *sp_handle_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_subprocess_handle_t, dlnode);
+        ++stats_ptr->subprocesses;
+        stats_ptr->windows += bs_dllist_size(&sp_handle_ptr->windows);
+    }
+}
+
 /* ------------------------------------------------------------------------- */
 bs_subprocess_t *wlmaker_subprocess_from_subprocess_handle(
     wlmaker_subprocess_handle_t *subprocess_handle_ptr)
@@ -299,26 +436,60 @@ bs_subprocess_t *wlmaker_subprocess_from_subprocess_handle(
 /**
  * Creates a @ref wlmaker_subprocess_handle_t and connects to subprocess_ptr.
  *
+ * Termination is tracked through a pidfd registered with the event loop. If
+ * the kernel doesn't support pidfds, the handle relies on SIGCHLD instead.
+ *
+ * @param monitor_ptr
  * @param subprocess_ptr
- * @param wl_event_loop_ptr
  *
  * @return The subprocess handle or NULL on error.
  */
 wlmaker_subprocess_handle_t *wlmaker_subprocess_handle_create(
-    bs_subprocess_t *subprocess_ptr,
-    struct wl_event_loop *wl_event_loop_ptr)
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    bs_subprocess_t *subprocess_ptr)
 {
+    struct wl_event_loop *wl_event_loop_ptr = monitor_ptr->wl_event_loop_ptr;
     wlmaker_subprocess_handle_t *subprocess_handle_ptr = logged_calloc(
         1, sizeof(wlmaker_subprocess_handle_t));
     if (NULL == subprocess_handle_ptr) return NULL;
 
+    subprocess_handle_ptr->monitor_ptr = monitor_ptr;
     subprocess_handle_ptr->subprocess_ptr = subprocess_ptr;
+    subprocess_handle_ptr->pid = bs_subprocess_pid(subprocess_ptr);
+
+    subprocess_handle_ptr->pidfd = _wlmaker_subprocess_monitor_pidfd_open(
+        subprocess_handle_ptr->pid);
+    if (0 <= subprocess_handle_ptr->pidfd) {
+        subprocess_handle_ptr->pidfd_wl_event_source_ptr =
+            wl_event_loop_add_fd(
+                wl_event_loop_ptr,
+                subprocess_handle_ptr->pidfd,
+                WL_EVENT_READABLE,
+                _wlmaker_subprocess_monitor_handle_pidfd,
+                subprocess_handle_ptr);
+        if (NULL == subprocess_handle_ptr->pidfd_wl_event_source_ptr) {
+            bs_log(BS_WARNING, "Failed wl_event_loop_add_fd(%p, %d, ...)",
+                   wl_event_loop_ptr, subprocess_handle_ptr->pidfd);
+            close(subprocess_handle_ptr->pidfd);
+            subprocess_handle_ptr->pidfd = -1;
+        }
+    }
 
     bs_subprocess_get_fds(
         subprocess_ptr,
         NULL,  // no interest in stdin.
         &subprocess_handle_ptr->stdout_read_fd,
         &subprocess_handle_ptr->stderr_read_fd);
+    // Non-blocking, so we can read until EAGAIN.
+    int fds[2] = { subprocess_handle_ptr->stdout_read_fd,
+                   subprocess_handle_ptr->stderr_read_fd };
+    for (size_t i = 0; i < 2; ++i) {
+        int flags = fcntl(fds[i], F_GETFL);
+        if (0 > flags || 0 > fcntl(fds[i], F_SETFL, flags | O_NONBLOCK)) {
+            bs_log(BS_WARNING | BS_ERRNO,
+                   "Failed fcntl(%d, F_SETFL, O_NONBLOCK)", fds[i]);
+        }
+    }
 
     subprocess_handle_ptr->stdout_wl_event_source_ptr = wl_event_loop_add_fd(
         wl_event_loop_ptr,
@@ -357,6 +528,39 @@ void wlmaker_subprocess_handle_destroy(
     bs_log(BS_DEBUG, "Terminated subprocess %p. Status %d, signal %d.",
            sp_handle_ptr->subprocess_ptr, exit_status, signal_number);
 
+    // Pick up what the subprocess wrote before exiting.
+    if (NULL != sp_handle_ptr->stdout_wl_event_source_ptr) {
+        _wlmaker_subprocess_monitor_process_fd(
+            sp_handle_ptr,
+            &sp_handle_ptr->stdout_wl_event_source_ptr,
+            sp_handle_ptr->stdout_read_fd,
+            WL_EVENT_READABLE,
+            WLMAKER_SUBPROCESS_STDOUT);
+    }
+    if (NULL != sp_handle_ptr->stderr_wl_event_source_ptr) {
+        _wlmaker_subprocess_monitor_process_fd(
+            sp_handle_ptr,
+            &sp_handle_ptr->stderr_wl_event_source_ptr,
+            sp_handle_ptr->stderr_read_fd,
+            WL_EVENT_READABLE,
+            WLMAKER_SUBPROCESS_STDERR);
+    }
+    if (NULL != sp_handle_ptr->output_ptr) {
+        _wlmaker_subprocess_output_flush(
+            sp_handle_ptr->output_ptr, WLMAKER_SUBPROCESS_STDOUT);
+        _wlmaker_subprocess_output_flush(
+            sp_handle_ptr->output_ptr, WLMAKER_SUBPROCESS_STDERR);
+        if (0 != exit_status || 0 != signal_number) {
+            bs_log(BS_WARNING, "subprocess %"PRIdMAX": Terminated with "
+                   "status %d, signal %d. Most recent output:",
+                   (intmax_t)sp_handle_ptr->pid, exit_status, signal_number);
+            _wlmaker_subprocess_output_dump(
+                sp_handle_ptr->output_ptr,
+                WLMAKER_SUBPROCESS_EXIT_DUMP_LINES,
+                BS_WARNING);
+        }
+    }
+
     if (NULL != sp_handle_ptr->terminated_callback) {
         sp_handle_ptr->terminated_callback(
             sp_handle_ptr->userdata_ptr,
@@ -379,9 +583,111 @@ void wlmaker_subprocess_handle_destroy(
         wl_event_source_remove(sp_handle_ptr->stderr_wl_event_source_ptr);
         sp_handle_ptr->stderr_wl_event_source_ptr = NULL;
     }
+    if (NULL != sp_handle_ptr->pidfd_wl_event_source_ptr) {
+        wl_event_source_remove(sp_handle_ptr->pidfd_wl_event_source_ptr);
+        sp_handle_ptr->pidfd_wl_event_source_ptr = NULL;
+    }
+    if (0 <= sp_handle_ptr->pidfd) {
+        close(sp_handle_ptr->pidfd);
+        sp_handle_ptr->pidfd = -1;
+    }
+    if (NULL != sp_handle_ptr->output_ptr) {
+        free(sp_handle_ptr->output_ptr);
+        sp_handle_ptr->output_ptr = NULL;
+    }
     free(sp_handle_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Checks whether the subprocess has terminated. If so, removes the handle
+ * from the monitor and destroys it.
+ *
+ * @param sp_handle_ptr
+ *
+ * @return true if the subprocess had terminated and the handle was destroyed.
+ */
+bool wlmaker_subprocess_handle_reap(wlmaker_subprocess_handle_t *sp_handle_ptr)
+{
+    wlmaker_subprocess_monitor_t *monitor_ptr = sp_handle_ptr->monitor_ptr;
+
+    int exit_status, signal_number;
+    if (!bs_subprocess_terminated(sp_handle_ptr->subprocess_ptr,
+                                  &exit_status, &signal_number)) {
+        return false;
+    }
+
+    bs_dllist_remove(&monitor_ptr->subprocesses, &sp_handle_ptr->dlnode);
+    if (sp_handle_ptr->in_pid_tree) {
+        bs_avltree_node_t *avlnode_ptr = bs_avltree_delete(
+            monitor_ptr->pid_tree_ptr, (void*)(intptr_t)sp_handle_ptr->pid);
+        BS_ASSERT(avlnode_ptr == &sp_handle_ptr->avlnode);
+        sp_handle_ptr->in_pid_tree = false;
+    }
+    if (0 > sp_handle_ptr->pidfd) {
+        BS_ASSERT(0 < monitor_ptr->sigchld_subprocesses);
+        --monitor_ptr->sigchld_subprocesses;
+    }
+    wlmaker_subprocess_handle_destroy(sp_handle_ptr);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Opens a pidfd for `pid`.
+ *
+ * @param pid
+ *
+ * @return The pidfd, or -1 if not supported by the system or on error.
+ */
+int _wlmaker_subprocess_monitor_pidfd_open(pid_t pid)
+{
+#if defined(SYS_pidfd_open)
+    int pidfd = syscall(SYS_pidfd_open, pid, 0);
+    if (0 > pidfd && ENOSYS != errno) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed pidfd_open(%"PRIdMAX", 0)",
+               (intmax_t)pid);
+    }
+    return pidfd;
+#else
+    (void)pid;
+    return -1;
+#endif
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handler for the pidfd turning readable, as prescribed by
+ * wl_event_loop_fd_func_t. This happens once the subprocess exits.
+ *
+ * @param fd
+ * @param mask
+ * @param data_ptr            Points to a @ref wlmaker_subprocess_handle_t.
+ *
+ * @return 0.
+ */
+int _wlmaker_subprocess_monitor_handle_pidfd(
+    int fd,
+    __UNUSED__ uint32_t mask,
+    void *data_ptr)
+{
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr = data_ptr;
+    BS_ASSERT(fd == subprocess_handle_ptr->pidfd);
+    if (wlmaker_subprocess_handle_reap(subprocess_handle_ptr)) return 0;
+
+    // Readable, but not terminated? Should not happen. Avoid spinning on the
+    // level-triggered fd, and let SIGCHLD take care of it.
+    bs_log(BS_WARNING, "pidfd %d for subprocess %"PRIdMAX" is readable, but "
+           "process not terminated. Falling back to SIGCHLD.",
+           fd, (intmax_t)subprocess_handle_ptr->pid);
+    wl_event_source_remove(subprocess_handle_ptr->pidfd_wl_event_source_ptr);
+    subprocess_handle_ptr->pidfd_wl_event_source_ptr = NULL;
+    close(subprocess_handle_ptr->pidfd);
+    subprocess_handle_ptr->pidfd = -1;
+    ++subprocess_handle_ptr->monitor_ptr->sigchld_subprocesses;
+    return 0;
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Handler for activity on stdout file descriptor, as prescribed by
@@ -404,7 +710,7 @@ int _wlmaker_subprocess_monitor_handle_read_stdout(
         &subprocess_handle_ptr->stdout_wl_event_source_ptr,
         subprocess_handle_ptr->stdout_read_fd,
         mask,
-        "stdout");
+        WLMAKER_SUBPROCESS_STDOUT);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -429,18 +735,23 @@ int _wlmaker_subprocess_monitor_handle_read_stderr(
         &subprocess_handle_ptr->stderr_wl_event_source_ptr,
         subprocess_handle_ptr->stderr_read_fd,
         mask,
-        "stderr");
+        WLMAKER_SUBPROCESS_STDERR);
 }
 
 /* ------------------------------------------------------------------------- */
 /**
  * Processes activity on a file descriptor, matches wl_event_loop_fd_func_t.
  *
+ * Reads until the pipe is drained (EAGAIN), up to a budget per dispatch, and
+ * frames the data into lines. On HANGUP, the source is only removed once the
+ * pipe is drained. Each line gets logged -- stderr as BS_WARNING,
+ * stdout as BS_INFO -- and retained in the subprocess' output ring buffer.
+ *
  * @param subprocess_handle_ptr
  * @param wl_event_source_ptr_ptr
  * @param fd
  * @param mask
- * @param fd_name_ptr
+ * @param stream
  *
  * @return 0.
  */
@@ -449,47 +760,194 @@ int _wlmaker_subprocess_monitor_process_fd(
     struct wl_event_source **wl_event_source_ptr_ptr,
     int fd,
     uint32_t mask,
-    const char *fd_name_ptr)
+    wlmaker_subprocess_stream_t stream)
 {
     // Convenience copy.
-    intmax_t pid = bs_subprocess_pid(subprocess_handle_ptr->subprocess_ptr);
+    intmax_t pid = subprocess_handle_ptr->pid;
+    const char *fd_name_ptr =
+        WLMAKER_SUBPROCESS_STDERR == stream ? "stderr" : "stdout";
 
     if (mask & WL_EVENT_READABLE) {
-        ssize_t read_bytes;
-        char buf[1024];
-        read_bytes = read(fd, buf, sizeof(buf));
-        buf[BS_MIN(read_bytes, 1023)] = '\0';
-        if (0 < read_bytes) {
-            // TODO(kaeser@gubbe.ch): Find a way to log this appropriately.
-            // We'd want to have STDERR logged as WARN, and STDOUT in INFO.
-            bs_log(BS_DEBUG, "subprocess %"PRIdMAX" %s: %s",
-                   pid, fd_name_ptr, buf);
-        } else if (0 > read_bytes) {
-            bs_log(BS_WARNING | BS_ERRNO,
-                   "subprocess %"PRIdMAX" %s: Failed raad(%d, ...)",
-                   pid, fd_name_ptr, fd);
+        char buf[WLMAKER_SUBPROCESS_READ_SIZE];
+        bool drained = false;
+        for (size_t total_bytes = 0;
+             !drained && total_bytes < WLMAKER_SUBPROCESS_READ_BUDGET;) {
+            ssize_t read_bytes = read(fd, buf, sizeof(buf));
+            if (0 < read_bytes) {
+                if (NULL == subprocess_handle_ptr->output_ptr) {
+                    subprocess_handle_ptr->output_ptr = logged_calloc(
+                        1, sizeof(wlmaker_subprocess_output_t));
+                    if (NULL == subprocess_handle_ptr->output_ptr) return 0;
+                    subprocess_handle_ptr->output_ptr->pid = pid;
+                    subprocess_handle_ptr->output_ptr->log_lines = true;
+                }
+                _wlmaker_subprocess_output_append(
+                    subprocess_handle_ptr->output_ptr,
+                    stream, buf, read_bytes);
+                total_bytes += read_bytes;
+            } else if (0 == read_bytes) {
+                // End of file. Terminate any partial line, and stop watching.
+                if (NULL != subprocess_handle_ptr->output_ptr) {
+                    _wlmaker_subprocess_output_flush(
+                        subprocess_handle_ptr->output_ptr, stream);
+                }
+                mask |= WL_EVENT_HANGUP;
+                drained = true;
+            } else if (EINTR == errno) {
+                continue;
+            } else if (EAGAIN == errno || EWOULDBLOCK == errno) {
+                drained = true;
+            } else {
+                bs_log(BS_WARNING | BS_ERRNO,
+                       "subprocess %"PRIdMAX" %s: Failed read(%d, ...)",
+                       pid, fd_name_ptr, fd);
+                drained = true;
+            }
         }
-        return 0;
+        // Budget exhausted: Read the rest on the next dispatch, even if the
+        // subprocess hung up meanwhile.
+        if (!drained) return 0;
     }
 
-    if (mask & (WL_EVENT_HANGUP | WL_EVENT_ERROR) &&
-        NULL != *wl_event_source_ptr_ptr) {
-        bs_log(BS_DEBUG, "subprocess %"PRIdMAX" %s: Mask 0x%x, removing.",
-               pid, fd_name_ptr, mask);
-        wl_event_source_remove(*wl_event_source_ptr_ptr);
-        *wl_event_source_ptr_ptr = NULL;
+    if (mask & (WL_EVENT_HANGUP | WL_EVENT_ERROR)) {
+        if (NULL != *wl_event_source_ptr_ptr) {
+            bs_log(BS_DEBUG, "subprocess %"PRIdMAX" %s: Mask 0x%x, removing.",
+                   pid, fd_name_ptr, mask);
+            wl_event_source_remove(*wl_event_source_ptr_ptr);
+            *wl_event_source_ptr_ptr = NULL;
+        }
         return 0;
     }
 
-    bs_log(BS_WARNING, "subprocess %"PRIdMAX" %s: Unexpected event, mask 0x%x",
-           pid, fd_name_ptr, mask);
+    if (!(mask & WL_EVENT_READABLE)) {
+        bs_log(BS_WARNING,
+               "subprocess %"PRIdMAX" %s: Unexpected event, mask 0x%x",
+               pid, fd_name_ptr, mask);
+    }
     return 0;
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Appends `data_ptr` to the output of `stream`, framing it into lines.
+ *
+ * Bytes are collected until a newline is found, or the line exceeds
+ * @ref WLMAKER_SUBPROCESS_OUTPUT_LINE_SIZE. Completed lines are stored in the
+ * ring buffer, overwriting the oldest line when full.
+ *
+ * @param output_ptr
+ * @param stream
+ * @param data_ptr
+ * @param len
+ */
+void _wlmaker_subprocess_output_append(
+    wlmaker_subprocess_output_t *output_ptr,
+    wlmaker_subprocess_stream_t stream,
+    const char *data_ptr,
+    size_t len)
+{
+    while (0 < len) {
+        const char *newline_ptr = memchr(data_ptr, '\n', len);
+        size_t chunk_len = (NULL != newline_ptr) ?
+            (size_t)(newline_ptr - data_ptr) : len;
+
+        size_t avail = WLMAKER_SUBPROCESS_OUTPUT_LINE_SIZE - 1 -
+            output_ptr->partial_len[stream];
+        if (chunk_len > avail) {
+            // Line is too long: Fill up the partial line and split it there.
+            memcpy(output_ptr->partial[stream] +
+                   output_ptr->partial_len[stream], data_ptr, avail);
+            output_ptr->partial_len[stream] += avail;
+            _wlmaker_subprocess_output_flush(output_ptr, stream);
+            data_ptr += avail;
+            len -= avail;
+            continue;
+        }
+
+        memcpy(output_ptr->partial[stream] + output_ptr->partial_len[stream],
+               data_ptr, chunk_len);
+        output_ptr->partial_len[stream] += chunk_len;
+        if (NULL == newline_ptr) return;
+
+        _wlmaker_subprocess_output_flush(output_ptr, stream);
+        data_ptr += chunk_len + 1;
+        len -= chunk_len + 1;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Completes the partial line of `stream`, if any: Stores it in the ring
+ * buffer and logs it.
+ *
+ * @param output_ptr
+ * @param stream
+ */
+void _wlmaker_subprocess_output_flush(
+    wlmaker_subprocess_output_t *output_ptr,
+    wlmaker_subprocess_stream_t stream)
+{
+    size_t len = output_ptr->partial_len[stream];
+    if (0 == len) return;
+    // Strip a carriage return, for output from "\r\n"-terminating programs.
+    if ('\r' == output_ptr->partial[stream][len - 1]) --len;
+
+    wlmaker_subprocess_line_t *line_ptr =
+        &output_ptr->lines[output_ptr->next_line];
+    line_ptr->stream = stream;
+    memcpy(line_ptr->text, output_ptr->partial[stream], len);
+    line_ptr->text[len] = '\0';
+    output_ptr->partial_len[stream] = 0;
+
+    output_ptr->next_line = (output_ptr->next_line + 1) %
+        WLMAKER_SUBPROCESS_OUTPUT_LINES;
+    output_ptr->num_lines = BS_MIN(output_ptr->num_lines + 1,
+                                   WLMAKER_SUBPROCESS_OUTPUT_LINES);
+
+    if (!output_ptr->log_lines) return;
+    if (WLMAKER_SUBPROCESS_STDERR == stream) {
+        bs_log(BS_WARNING, "subprocess %"PRIdMAX" stderr: %s",
+               output_ptr->pid, line_ptr->text);
+    } else {
+        bs_log(BS_INFO, "subprocess %"PRIdMAX" stdout: %s",
+               output_ptr->pid, line_ptr->text);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Logs the `max_lines` most recent lines of the output, oldest first.
+ *
+ * @param output_ptr
+ * @param max_lines
+ * @param severity
+ */
+void _wlmaker_subprocess_output_dump(
+    wlmaker_subprocess_output_t *output_ptr,
+    size_t max_lines,
+    bs_log_severity_t severity)
+{
+    size_t lines = BS_MIN(max_lines, output_ptr->num_lines);
+    size_t idx = (output_ptr->next_line + WLMAKER_SUBPROCESS_OUTPUT_LINES -
+                  lines) % WLMAKER_SUBPROCESS_OUTPUT_LINES;
+    for (size_t i = 0; i < lines; ++i) {
+        const wlmaker_subprocess_line_t *line_ptr = &output_ptr->lines[idx];
+        bs_log(severity, "subprocess %"PRIdMAX" %s: %s",
+               output_ptr->pid,
+               WLMAKER_SUBPROCESS_STDERR == line_ptr->stream ?
+               "stderr" : "stdout",
+               line_ptr->text);
+        idx = (idx + 1) % WLMAKER_SUBPROCESS_OUTPUT_LINES;
+    }
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Handles SIGCHLD. Callback for Wayland event loop.
  *
+ * Only considers subprocesses without a pidfd. These are tracked through
+ * their pidfd's event source.
+ *
  * @param signum
  *
  * @param data_ptr            Points to @ref wlmaker_subprocess_monitor_t.
@@ -498,6 +956,7 @@ int _wlmaker_subprocess_monitor_handle_sigchld(
     __UNUSED__ int signum, void *data_ptr)
 {
     wlmaker_subprocess_monitor_t *monitor_ptr = data_ptr;
+    if (0 == monitor_ptr->sigchld_subprocesses) return 0;
 
     bs_dllist_node_t *dlnode_ptr = monitor_ptr->subprocesses.head_ptr;
     while (NULL != dlnode_ptr) {
@@ -505,14 +964,8 @@ int _wlmaker_subprocess_monitor_handle_sigchld(
             dlnode_ptr, wlmaker_subprocess_handle_t, dlnode);
         dlnode_ptr = dlnode_ptr->next_ptr;
 
-        int exit_status, signal_number;
-        if (bs_subprocess_terminated(subprocess_handle_ptr->subprocess_ptr,
-                                     &exit_status, &signal_number)) {
-            bs_dllist_remove(
-                &monitor_ptr->subprocesses,
-                &subprocess_handle_ptr->dlnode);
-            wlmaker_subprocess_handle_destroy(subprocess_handle_ptr);
-        }
+        if (0 <= subprocess_handle_ptr->pidfd) continue;
+        wlmaker_subprocess_handle_reap(subprocess_handle_ptr);
     }
 
     return 0;
@@ -666,19 +1119,10 @@ wlmaker_subprocess_handle_t *subprocess_handle_from_window(
 {
     const wlmtk_util_client_t *client_ptr = wlmtk_window_get_client_ptr(
         window_ptr);
-    // TODO(kaeser@gubbe.ch): Should be a O(1) or O(log(n)) structure.
-    for (bs_dllist_node_t *dlnode_ptr = monitor_ptr->subprocesses.head_ptr;
-         NULL != dlnode_ptr;
-         dlnode_ptr = dlnode_ptr->next_ptr) {
-        wlmaker_subprocess_handle_t *subprocess_handle_ptr = BS_CONTAINER_OF(
-            dlnode_ptr, wlmaker_subprocess_handle_t, dlnode);
-        if (client_ptr->pid ==
-            bs_subprocess_pid(subprocess_handle_ptr->subprocess_ptr)) {
-            return subprocess_handle_ptr;
-        }
-    }
-
-    return NULL;
+    bs_avltree_node_t *avlnode_ptr = bs_avltree_lookup(
+        monitor_ptr->pid_tree_ptr, (void*)(intptr_t)client_ptr->pid);
+    if (NULL == avlnode_ptr) return NULL;
+    return BS_CONTAINER_OF(avlnode_ptr, wlmaker_subprocess_handle_t, avlnode);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -757,6 +1201,19 @@ void wlmaker_subprocess_window_destroy(
     free(ws_window_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Comparator for the subprocess handles by PID. Key is the PID. */
+int wlmaker_subprocess_handle_node_cmp(const bs_avltree_node_t *node_ptr,
+                                       const void *key_ptr)
+{
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr = BS_CONTAINER_OF(
+        node_ptr, wlmaker_subprocess_handle_t, avlnode);
+    intptr_t pid = (intptr_t)key_ptr;
+    if (subprocess_handle_ptr->pid < pid) return -1;
+    if (subprocess_handle_ptr->pid > pid) return 1;
+    return 0;
+}
+
 /* ------------------------------------------------------------------------- */
 /** Comparator for window registry tree nodes. */
 int wlmaker_subprocess_window_node_cmp(const bs_avltree_node_t *node_ptr,
@@ -776,4 +1233,77 @@ void wlmaker_subprocess_window_node_destroy(bs_avltree_node_t *node_ptr)
     wlmaker_subprocess_window_destroy(ws_window_ptr);
 }
 
+/* == Unit tests =========================================================== */
+
+static void test_output_lines(bs_test_t *test_ptr);
+static void test_output_ring(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmaker_subprocess_monitor_test_cases[] = {
+    { 1, "output_lines", test_output_lines },
+    { 1, "output_ring", test_output_ring },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Verifies output is framed into lines, per stream. */
+void test_output_lines(bs_test_t *test_ptr)
+{
+    wlmaker_subprocess_output_t *o = logged_calloc(
+        1, sizeof(wlmaker_subprocess_output_t));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, o);
+
+    _wlmaker_subprocess_output_append(o, WLMAKER_SUBPROCESS_STDOUT, "ab", 2);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, o->num_lines);
+    _wlmaker_subprocess_output_append(o, WLMAKER_SUBPROCESS_STDERR, "x\n", 2);
+    _wlmaker_subprocess_output_append(
+        o, WLMAKER_SUBPROCESS_STDOUT, "c\r\nd\n\ne", 7);
+    BS_TEST_VERIFY_EQ_OR_RETURN(test_ptr, 3, o->num_lines);
+    BS_TEST_VERIFY_EQ(test_ptr, WLMAKER_SUBPROCESS_STDERR, o->lines[0].stream);
+    BS_TEST_VERIFY_STREQ(test_ptr, "x", o->lines[0].text);
+    BS_TEST_VERIFY_EQ(test_ptr, WLMAKER_SUBPROCESS_STDOUT, o->lines[1].stream);
+    BS_TEST_VERIFY_STREQ(test_ptr, "abc", o->lines[1].text);
+    BS_TEST_VERIFY_STREQ(test_ptr, "d", o->lines[2].text);
+
+    // Empty lines are dropped, a partial line is completed by flushing.
+    _wlmaker_subprocess_output_flush(o, WLMAKER_SUBPROCESS_STDOUT);
+    BS_TEST_VERIFY_EQ_OR_RETURN(test_ptr, 4, o->num_lines);
+    BS_TEST_VERIFY_STREQ(test_ptr, "e", o->lines[3].text);
+
+    // Overly long lines are split.
+    char buf[WLMAKER_SUBPROCESS_OUTPUT_LINE_SIZE + 10];
+    memset(buf, 'z', sizeof(buf));
+    _wlmaker_subprocess_output_append(
+        o, WLMAKER_SUBPROCESS_STDOUT, buf, sizeof(buf));
+    BS_TEST_VERIFY_EQ_OR_RETURN(test_ptr, 5, o->num_lines);
+    BS_TEST_VERIFY_EQ(test_ptr, WLMAKER_SUBPROCESS_OUTPUT_LINE_SIZE - 1,
+                      strlen(o->lines[4].text));
+    BS_TEST_VERIFY_EQ(test_ptr, 11, o->partial_len[WLMAKER_SUBPROCESS_STDOUT]);
+
+    free(o);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies the ring buffer retains the most recent lines. */
+void test_output_ring(bs_test_t *test_ptr)
+{
+    wlmaker_subprocess_output_t *o = logged_calloc(
+        1, sizeof(wlmaker_subprocess_output_t));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, o);
+
+    for (int i = 0; i < WLMAKER_SUBPROCESS_OUTPUT_LINES + 3; ++i) {
+        char line[16];
+        int len = snprintf(line, sizeof(line), "%d\n", i);
+        _wlmaker_subprocess_output_append(
+            o, WLMAKER_SUBPROCESS_STDOUT, line, len);
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, WLMAKER_SUBPROCESS_OUTPUT_LINES,
+                      o->num_lines);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, o->next_line);
+    // Oldest retained line is #3, overwritten slot 0 holds #64.
+    BS_TEST_VERIFY_STREQ(test_ptr, "3", o->lines[3].text);
+    BS_TEST_VERIFY_STREQ(test_ptr, "64", o->lines[0].text);
+
+    free(o);
+}
+
 /* == End of subprocess_monitor.c ========================================== */
@@ -31,6 +31,13 @@ typedef struct _wlmaker_subprocess_handle_t wlmaker_subprocess_handle_t;
 
 #include "toolkit/toolkit.h"
 
+/**
+ * Number of output lines retained per subprocess. These are logged with
+ * BS_WARNING severity when the subprocess exits with a non-zero status or
+ * through a signal.
+ */
+#define WLMAKER_SUBPROCESS_OUTPUT_LINES 64
+
 #ifdef __cplusplus
 extern "C" {
 #endif  // __cplusplus
@@ -118,10 +125,33 @@ void wlmaker_subprocess_monitor_cede(
     wlmaker_subprocess_monitor_t *monitor_ptr,
     wlmaker_subprocess_handle_t *subprocess_handle_ptr);
 
+/** Counters of the subprocess monitor. */
+typedef struct {
+    /** Number of monitored subprocesses. */
+    size_t                    subprocesses;
+    /** Thereof, subprocesses monitored through SIGCHLD instead of a pidfd. */
+    size_t                    sigchld_subprocesses;
+    /** Number of windows of monitored subprocesses. */
+    size_t                    windows;
+} wlmaker_subprocess_monitor_stats_t;
+
+/**
+ * Retrieves counters of `monitor_ptr`.
+ *
+ * @param monitor_ptr
+ * @param stats_ptr
+ */
+void wlmaker_subprocess_monitor_get_stats(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    wlmaker_subprocess_monitor_stats_t *stats_ptr);
+
 /** Returns the `bs_subprocess_t` from the @ref wlmaker_subprocess_handle_t. */
 bs_subprocess_t *wlmaker_subprocess_from_subprocess_handle(
     wlmaker_subprocess_handle_t *subprocess_handle_ptr);
 
+/** Unit test cases. */
+extern const bs_test_case_t wlmaker_subprocess_monitor_test_cases[];
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -28,6 +28,7 @@
 
 #include <libbase/libbase.h>
 #include <limits.h>
+#include <string.h>
 
 /// Include unstable interfaces of wlroots.
 #define WLR_USE_UNSTABLE
@@ -48,6 +49,18 @@ struct _wlmaker_task_list_t {
 
     /** Scnee buffer: Wraps task list (WLR buffer) into scene graph. */
     struct wlr_scene_buffer   *wlr_scene_buffer_ptr;
+    /**
+     * Buffers the task list is composed into. Used alternately, so the
+     * buffer shown by the scene graph is not drawn into. A buffer that is
+     * still locked when due is replaced. See @ref task_list_next_buffer.
+     */
+    struct wlr_buffer         *wlr_buffer_ptrs[2];
+    /** Index into `wlr_buffer_ptrs` for the next refresh. */
+    size_t                    next_buffer;
+    /** Background of the task list. From the fill cache. */
+    bs_gfxbuf_t               *background_gfxbuf_ptr;
+    /** Rendered rows, by window. See @ref wlmaker_task_list_row_t. */
+    bs_avltree_t              *row_tree_ptr;
 
     /** Listener for the `task_list_enabled` signal by `wlmaker_server_t`. */
     struct wl_listener        task_list_enabled_listener;
@@ -58,11 +71,27 @@ struct _wlmaker_task_list_t {
     struct wl_listener        window_mapped_listener;
     /** Listener for the `window_unmapped_event` signal by `wlmaker_server_t`. */
     struct wl_listener        window_unmapped_listener;
+    /** Listener for `window_destroyed_event` signal by `wlmaker_server_t`. */
+    struct wl_listener        window_destroyed_listener;
 
     /** Whether the task list is currently enabled (mapped). */
     bool                      enabled;
 };
 
+/** A window's row in the task list, rendered once and then re-used. */
+typedef struct {
+    /** Node of @ref wlmaker_task_list_t::row_tree_ptr. */
+    bs_avltree_node_t         avlnode;
+    /** The window. Also the tree lookup key. */
+    wlmtk_window_t            *window_ptr;
+    /** Title the row was rendered with. Re-rendered if the title changes. */
+    char                      *title_ptr;
+    /** Remainder of the name: PID, commandline and window. Set once. */
+    char                      *details_ptr;
+    /** The rendered row, for the inactive (0) and active (1) window. */
+    cairo_surface_t           *surface_ptrs[2];
+} wlmaker_task_list_row_t;
+
 static void get_size(wlmaker_view_t *view_ptr,
                      uint32_t *width_ptr,
                      uint32_t *height_ptr);
@@ -78,20 +107,35 @@ const wlmaker_view_impl_t     task_list_view_impl = {
 static const uint32_t         task_list_width = 400;
 /** Height of the task list overlay. */
 static const uint32_t         task_list_height = 200;
+/** Height of a row in the task list. */
+static const int              task_list_row_height = 26;
+/** Position of the text baseline within a row. */
+static const int              task_list_row_baseline = 20;
 
 static void task_list_refresh(
     wlmaker_task_list_t *task_list_ptr);
-static struct wlr_buffer *create_wlr_buffer(
-    wlmaker_workspace_t *workspace_ptr);
+static struct wlr_buffer *task_list_next_buffer(
+    wlmaker_task_list_t *task_list_ptr);
 static void draw_into_cairo(
+    wlmaker_task_list_t *task_list_ptr,
     cairo_t *cairo_ptr,
     wlmaker_workspace_t *workspace_ptr);
 static void draw_window_into_cairo(
+    wlmaker_task_list_t *task_list_ptr,
     cairo_t *cairo_ptr,
     wlmtk_window_t *window_ptr,
     bool active,
     int pos_y);
-static const char *window_name(wlmtk_window_t *window_ptr);
+static cairo_surface_t *row_surface(
+    wlmaker_task_list_row_t *row_ptr,
+    bool active);
+static wlmaker_task_list_row_t *row_create(wlmtk_window_t *window_ptr);
+static void row_invalidate(wlmaker_task_list_row_t *row_ptr);
+static void row_destroy(wlmaker_task_list_row_t *row_ptr);
+static int row_node_cmp(const bs_avltree_node_t *node_ptr,
+                        const void *key_ptr);
+static void row_node_destroy(bs_avltree_node_t *node_ptr);
+static char *window_details(wlmtk_window_t *window_ptr);
 
 static void handle_task_list_enabled(
     struct wl_listener *listener_ptr,
@@ -105,6 +149,9 @@ static void handle_window_mapped(
 static void handle_window_unmapped(
     struct wl_listener *listener_ptr,
     void *data_ptr);
+static void handle_window_destroyed(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
 
 /* == Exported methods ===================================================== */
 
@@ -116,6 +163,15 @@ wlmaker_task_list_t *wlmaker_task_list_create(
         1, sizeof(wlmaker_task_list_t));
     task_list_ptr->server_ptr = server_ptr;
 
+    task_list_ptr->row_tree_ptr = bs_avltree_create(
+        row_node_cmp, row_node_destroy);
+    if (NULL == task_list_ptr->row_tree_ptr) {
+        bs_log(BS_ERROR, "Failed bs_avltree_create(%p, %p)",
+               row_node_cmp, row_node_destroy);
+        free(task_list_ptr);
+        return NULL;
+    }
+
     task_list_ptr->wlr_scene_tree_ptr = wlr_scene_tree_create(
         &server_ptr->void_wlr_scene_ptr->tree);
     if (NULL == task_list_ptr->wlr_scene_tree_ptr) {
@@ -161,6 +217,10 @@ wlmaker_task_list_t *wlmaker_task_list_create(
         &server_ptr->window_unmapped_event,
         &task_list_ptr->window_unmapped_listener,
         handle_window_unmapped);
+    wlmtk_util_connect_listener_signal(
+        &server_ptr->window_destroyed_event,
+        &task_list_ptr->window_destroyed_listener,
+        handle_window_destroyed);
 
     return task_list_ptr;
 }
@@ -168,6 +228,7 @@ wlmaker_task_list_t *wlmaker_task_list_create(
 /* ------------------------------------------------------------------------- */
 void wlmaker_task_list_destroy(wlmaker_task_list_t *task_list_ptr)
 {
+    wl_list_remove(&task_list_ptr->window_destroyed_listener.link);
     wl_list_remove(&task_list_ptr->window_unmapped_listener.link);
     wl_list_remove(&task_list_ptr->window_mapped_listener.link);
     wl_list_remove(&task_list_ptr->task_list_disabled_listener.link);
@@ -175,6 +236,18 @@ void wlmaker_task_list_destroy(wlmaker_task_list_t *task_list_ptr)
 
     wlmaker_view_fini(&task_list_ptr->view);
 
+    for (size_t i = 0; i < 2; ++i) {
+        wlr_buffer_drop_nullify(&task_list_ptr->wlr_buffer_ptrs[i]);
+    }
+    if (NULL != task_list_ptr->background_gfxbuf_ptr) {
+        wlmtk_fill_cache_release(task_list_ptr->background_gfxbuf_ptr);
+        task_list_ptr->background_gfxbuf_ptr = NULL;
+    }
+    if (NULL != task_list_ptr->row_tree_ptr) {
+        bs_avltree_destroy(task_list_ptr->row_tree_ptr);
+        task_list_ptr->row_tree_ptr = NULL;
+    }
+
     free(task_list_ptr);
 }
 
@@ -203,6 +276,9 @@ void get_size(
 /**
  * Refreshes the task list. Should be done whenever a list is mapped/unmapped.
  *
+ * Composes the background and the cached rows of the visible windows into
+ * one of the recycled buffers, and hands that to the scene graph.
+ *
  * @param task_list_ptr
  */
 void task_list_refresh(wlmaker_task_list_t *task_list_ptr)
@@ -210,8 +286,28 @@ void task_list_refresh(wlmaker_task_list_t *task_list_ptr)
     wlmaker_workspace_t *workspace_ptr = wlmaker_server_get_current_workspace(
         task_list_ptr->server_ptr);
 
-    struct wlr_buffer *wlr_buffer_ptr = create_wlr_buffer(
-        workspace_ptr);
+    if (NULL == task_list_ptr->background_gfxbuf_ptr) {
+        task_list_ptr->background_gfxbuf_ptr = wlmtk_fill_cache_acquire(
+            &wlmaker_config_theme.task_list_fill,
+            task_list_width, task_list_height);
+        if (NULL == task_list_ptr->background_gfxbuf_ptr) return;
+    }
+
+    struct wlr_buffer *wlr_buffer_ptr = task_list_next_buffer(task_list_ptr);
+    if (NULL == wlr_buffer_ptr) return;
+
+    bs_gfxbuf_copy_area(
+        bs_gfxbuf_from_wlr_buffer(wlr_buffer_ptr),
+        0, 0,
+        task_list_ptr->background_gfxbuf_ptr,
+        0, 0,
+        task_list_width, task_list_height);
+
+    cairo_t *cairo_ptr = cairo_create_from_wlr_buffer(wlr_buffer_ptr);
+    if (NULL == cairo_ptr) return;
+    draw_into_cairo(task_list_ptr, cairo_ptr, workspace_ptr);
+    cairo_destroy(cairo_ptr);
+
     wlr_scene_buffer_set_buffer(
         task_list_ptr->wlr_scene_buffer_ptr,
         wlr_buffer_ptr);
@@ -219,42 +315,45 @@ void task_list_refresh(wlmaker_task_list_t *task_list_ptr)
 
 /* ------------------------------------------------------------------------- */
 /**
- * Creates a `struct wlr_buffer` with windows of `workspace_ptr` drawn into.
+ * Returns the next of the recycled buffers to compose the task list into.
  *
- * @param workspace_ptr
+ * A buffer that is still locked, eg. by the scene graph or by a pending
+ * output commit, must not be drawn into: It is dropped, to be destroyed once
+ * released, and replaced by a fresh buffer.
  *
- * @return A pointer to the `struct wlr_buffer` with the list of windows
- *     (tasks), or NULL on error.
+ * @param task_list_ptr
+ *
+ * @return Pointer to the buffer, or NULL on error. Owned by `task_list_ptr`.
  */
-struct wlr_buffer *create_wlr_buffer(wlmaker_workspace_t *workspace_ptr)
+struct wlr_buffer *task_list_next_buffer(wlmaker_task_list_t *task_list_ptr)
 {
-    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(
-        task_list_width, task_list_height);
-    if (NULL == wlr_buffer_ptr) return NULL;
-
-    cairo_t *cairo_ptr = cairo_create_from_wlr_buffer(wlr_buffer_ptr);
-    if (NULL == cairo_ptr) {
-        wlr_buffer_drop(wlr_buffer_ptr);
-        return NULL;
+    struct wlr_buffer **wlr_buffer_ptr_ptr =
+        &task_list_ptr->wlr_buffer_ptrs[task_list_ptr->next_buffer];
+    if (NULL != *wlr_buffer_ptr_ptr && 0 < (*wlr_buffer_ptr_ptr)->n_locks) {
+        wlr_buffer_drop_nullify(wlr_buffer_ptr_ptr);
     }
-    draw_into_cairo(cairo_ptr, workspace_ptr);
-    cairo_destroy(cairo_ptr);
-
-    return wlr_buffer_ptr;
+    if (NULL == *wlr_buffer_ptr_ptr) {
+        *wlr_buffer_ptr_ptr = bs_gfxbuf_create_wlr_buffer(
+            task_list_width, task_list_height);
+        if (NULL == *wlr_buffer_ptr_ptr) return NULL;
+    }
+    task_list_ptr->next_buffer = (task_list_ptr->next_buffer + 1) % 2;
+    return *wlr_buffer_ptr_ptr;
 }
 
 /* ------------------------------------------------------------------------- */
 /**
  * Draws all tasks of `workspace_ptr` into `cairo_ptr`.
  *
+ * @param task_list_ptr
  * @param cairo_ptr
  * @param workspace_ptr
  */
-void draw_into_cairo(cairo_t *cairo_ptr, wlmaker_workspace_t *workspace_ptr)
+void draw_into_cairo(
+    wlmaker_task_list_t *task_list_ptr,
+    cairo_t *cairo_ptr,
+    wlmaker_workspace_t *workspace_ptr)
 {
-    wlmaker_primitives_cairo_fill(
-        cairo_ptr, &wlmaker_config_theme.task_list_fill);
-
     // Not tied to a workspace? We're done, all set.
     if (NULL == workspace_ptr) return;
 
@@ -278,6 +377,7 @@ void draw_into_cairo(cairo_t *cairo_ptr, wlmaker_workspace_t *workspace_ptr)
 
     int pos_y = task_list_height / 2 + 10;
     draw_window_into_cairo(
+        task_list_ptr,
         cairo_ptr,
         wlmtk_window_from_dlnode(centered_dlnode_ptr),
         centered_dlnode_ptr == active_dlnode_ptr,
@@ -288,10 +388,11 @@ void draw_into_cairo(cairo_t *cairo_ptr, wlmaker_workspace_t *workspace_ptr)
          NULL != dlnode_ptr && further_windows <= 3;
          dlnode_ptr = dlnode_ptr->prev_ptr, ++further_windows) {
         draw_window_into_cairo(
+            task_list_ptr,
             cairo_ptr,
             wlmtk_window_from_dlnode(dlnode_ptr),
             false,
-            pos_y - further_windows * 26);
+            pos_y - further_windows * task_list_row_height);
     }
 
     dlnode_ptr = centered_dlnode_ptr->next_ptr;
@@ -299,28 +400,86 @@ void draw_into_cairo(cairo_t *cairo_ptr, wlmaker_workspace_t *workspace_ptr)
          NULL != dlnode_ptr && further_windows <= 3;
          dlnode_ptr = dlnode_ptr->next_ptr, ++further_windows) {
         draw_window_into_cairo(
+            task_list_ptr,
             cairo_ptr,
             wlmtk_window_from_dlnode(dlnode_ptr),
             false,
-            pos_y + further_windows * 26);
+            pos_y + further_windows * task_list_row_height);
     }
 }
 
 /* ------------------------------------------------------------------------- */
 /**
- * Draws one window (task) into `cairo_ptr`.
+ * Draws one window (task) into `cairo_ptr`: Composes the window's cached
+ * row, and renders it only if not cached yet.
  *
+ * @param task_list_ptr
  * @param cairo_ptr
  * @param window_ptr
  * @param active              Whether this window is currently active.
- * @param pos_y               Y position within the `cairo_ptr`.
+ * @param pos_y               Y position of the baseline within `cairo_ptr`.
  */
 void draw_window_into_cairo(
+    wlmaker_task_list_t *task_list_ptr,
     cairo_t *cairo_ptr,
     wlmtk_window_t *window_ptr,
     bool active,
     int pos_y)
 {
+    wlmaker_task_list_row_t *row_ptr;
+    bs_avltree_node_t *avlnode_ptr = bs_avltree_lookup(
+        task_list_ptr->row_tree_ptr, window_ptr);
+    if (NULL != avlnode_ptr) {
+        row_ptr = BS_CONTAINER_OF(avlnode_ptr, wlmaker_task_list_row_t,
+                                  avlnode);
+    } else {
+        row_ptr = row_create(window_ptr);
+        if (NULL == row_ptr) return;
+        bs_avltree_insert(task_list_ptr->row_tree_ptr, window_ptr,
+                          &row_ptr->avlnode, false);
+    }
+
+    cairo_surface_t *surface_ptr = row_surface(row_ptr, active);
+    if (NULL == surface_ptr) return;
+    cairo_set_source_surface(
+        cairo_ptr, surface_ptr, 0, pos_y - task_list_row_baseline);
+    cairo_paint(cairo_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the rendered row of the window. Renders the row, if the title
+ * changed or the row was not rendered yet.
+ *
+ * @param row_ptr
+ * @param active
+ *
+ * @return Pointer to the surface, or NULL on error. Owned by `row_ptr`.
+ */
+cairo_surface_t *row_surface(wlmaker_task_list_row_t *row_ptr, bool active)
+{
+    const char *title_ptr = wlmtk_window_get_title(row_ptr->window_ptr);
+    if (NULL == title_ptr) title_ptr = "";
+    if (NULL == row_ptr->title_ptr ||
+        0 != strcmp(title_ptr, row_ptr->title_ptr)) {
+        row_invalidate(row_ptr);
+        row_ptr->title_ptr = logged_strdup(title_ptr);
+        if (NULL == row_ptr->title_ptr) return NULL;
+    }
+    if (NULL != row_ptr->surface_ptrs[active]) {
+        return row_ptr->surface_ptrs[active];
+    }
+
+    cairo_surface_t *surface_ptr = cairo_image_surface_create(
+        CAIRO_FORMAT_ARGB32, task_list_width, task_list_row_height);
+    if (CAIRO_STATUS_SUCCESS != cairo_surface_status(surface_ptr)) {
+        bs_log(BS_ERROR, "Failed cairo_image_surface_create(%d, %"PRIu32", "
+               "%d)", CAIRO_FORMAT_ARGB32, task_list_width,
+               task_list_row_height);
+        cairo_surface_destroy(surface_ptr);
+        return NULL;
+    }
+    cairo_t *cairo_ptr = cairo_create(surface_ptr);
     cairo_set_source_argb8888(
         cairo_ptr,
         wlmaker_config_theme.task_list_text_color);
@@ -330,36 +489,103 @@ void draw_window_into_cairo(
         "Helvetica",
         CAIRO_FONT_SLANT_NORMAL,
         active ? CAIRO_FONT_WEIGHT_BOLD : CAIRO_FONT_WEIGHT_NORMAL);
-    cairo_move_to(cairo_ptr, 10, pos_y);
-    cairo_show_text(cairo_ptr, window_name(window_ptr));
- }
+    cairo_move_to(cairo_ptr, 10, task_list_row_baseline);
+    cairo_show_text(cairo_ptr, row_ptr->title_ptr);
+    cairo_show_text(cairo_ptr, row_ptr->details_ptr);
+    cairo_destroy(cairo_ptr);
+    cairo_surface_flush(surface_ptr);
+
+    row_ptr->surface_ptrs[active] = surface_ptr;
+    return surface_ptr;
+}
 
 /* ------------------------------------------------------------------------- */
 /**
- * Constructs a comprehensive name for the window.
+ * Creates a row for the window. Rendering is deferred to @ref row_surface.
  *
  * @param window_ptr
  *
- * @return Pointer to the constructed name. This is a static buffer that does
- *     not require to be free'd, but will be re-used upon next call to
- *     window_name.
+ * @return Pointer to the row, or NULL on error. Must be destroyed by calling
+ *     @ref row_destroy.
  */
-const char *window_name(wlmtk_window_t *window_ptr)
+wlmaker_task_list_row_t *row_create(wlmtk_window_t *window_ptr)
 {
-    static char               name[256];
+    wlmaker_task_list_row_t *row_ptr = logged_calloc(
+        1, sizeof(wlmaker_task_list_row_t));
+    if (NULL == row_ptr) return NULL;
+    row_ptr->window_ptr = window_ptr;
+    row_ptr->details_ptr = window_details(window_ptr);
+    if (NULL == row_ptr->details_ptr) {
+        row_destroy(row_ptr);
+        return NULL;
+    }
+    return row_ptr;
+}
 
-    size_t pos = 0;
+/* ------------------------------------------------------------------------- */
+/** Drops the rendered surfaces and title of the row. */
+void row_invalidate(wlmaker_task_list_row_t *row_ptr)
+{
+    for (size_t i = 0; i < 2; ++i) {
+        if (NULL != row_ptr->surface_ptrs[i]) {
+            cairo_surface_destroy(row_ptr->surface_ptrs[i]);
+            row_ptr->surface_ptrs[i] = NULL;
+        }
+    }
+    if (NULL != row_ptr->title_ptr) {
+        free(row_ptr->title_ptr);
+        row_ptr->title_ptr = NULL;
+    }
+}
 
-    const char *title_ptr = wlmtk_window_get_title(window_ptr);
-    if (NULL != title_ptr) {
-        pos = bs_strappendf(name, sizeof(name), pos, "%s", title_ptr);
+/* ------------------------------------------------------------------------- */
+/** Destroys the row. */
+void row_destroy(wlmaker_task_list_row_t *row_ptr)
+{
+    row_invalidate(row_ptr);
+    if (NULL != row_ptr->details_ptr) {
+        free(row_ptr->details_ptr);
+        row_ptr->details_ptr = NULL;
     }
+    free(row_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Comparator for @ref wlmaker_task_list_t::row_tree_ptr. */
+int row_node_cmp(const bs_avltree_node_t *node_ptr, const void *key_ptr)
+{
+    wlmaker_task_list_row_t *row_ptr = BS_CONTAINER_OF(
+        node_ptr, wlmaker_task_list_row_t, avlnode);
+    return bs_avltree_cmp_ptr(row_ptr->window_ptr, key_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destructor for @ref wlmaker_task_list_t::row_tree_ptr. */
+void row_node_destroy(bs_avltree_node_t *node_ptr)
+{
+    row_destroy(BS_CONTAINER_OF(node_ptr, wlmaker_task_list_row_t, avlnode));
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Constructs the details of the window's name, to follow the title: Process
+ * ID, commandline and the window's address.
+ *
+ * This reads from /proc, and is expected to be called once per window.
+ *
+ * @param window_ptr
+ *
+ * @return Pointer to the details, or NULL on error. Must be free'd.
+ */
+char *window_details(wlmtk_window_t *window_ptr)
+{
+    char                      name[256];
+    size_t pos = 0;
 
     const wlmtk_util_client_t *client_ptr = wlmtk_window_get_client_ptr(
         window_ptr);
     if (NULL != client_ptr && 0 != client_ptr->pid) {
-        if (0 < pos) pos = bs_strappendf(name, sizeof(name), pos, " ");
-        pos = bs_strappendf(name, sizeof(name), pos, "[%"PRIdMAX,
+        pos = bs_strappendf(name, sizeof(name), pos, " [%"PRIdMAX,
                             (intmax_t)client_ptr->pid);
         char fname[PATH_MAX], cmdline[PATH_MAX];
         snprintf(fname, sizeof(fname), "/proc/%"PRIdMAX"/cmdline",
@@ -372,9 +598,8 @@ const char *window_name(wlmtk_window_t *window_ptr)
         pos = bs_strappendf(name, sizeof(name), pos, "]");
     }
 
-    if (0 < pos) pos = bs_strappendf(name, sizeof(name), pos, " ");
-    pos = bs_strappendf(name, sizeof(name), pos, "(%p)", window_ptr);
-    return &name[0];
+    pos = bs_strappendf(name, sizeof(name), pos, " (%p)", window_ptr);
+    return logged_strdup(name);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -456,20 +681,117 @@ void handle_window_mapped(
 
 /* ------------------------------------------------------------------------- */
 /**
- * Handler for the `window_unmapped_listener`: Refreshes the list (if enabled).
+ * Handler for the `window_unmapped_listener`: Drops the window's row, and
+ * refreshes the list (if enabled).
  *
  * @param listener_ptr
- * @param data_ptr
+ * @param data_ptr            Points to the unmapped `wlmtk_window_t`.
  */
 void handle_window_unmapped(
     struct wl_listener *listener_ptr,
-    __UNUSED__ void *data_ptr)
+    void *data_ptr)
 {
     wlmaker_task_list_t *task_list_ptr = BS_CONTAINER_OF(
         listener_ptr, wlmaker_task_list_t, window_unmapped_listener);
+    bs_avltree_node_t *avlnode_ptr = bs_avltree_delete(
+        task_list_ptr->row_tree_ptr, data_ptr);
+    if (NULL != avlnode_ptr) row_node_destroy(avlnode_ptr);
     if (task_list_ptr->enabled) {
         task_list_refresh(task_list_ptr);
     }
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Handler for the `window_destroyed_listener`: Drops the window's row.
+ *
+ * @param listener_ptr
+ * @param data_ptr            Points to the destroyed `wlmtk_window_t`.
+ */
+void handle_window_destroyed(
+    struct wl_listener *listener_ptr,
+    void *data_ptr)
+{
+    wlmaker_task_list_t *task_list_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_task_list_t, window_destroyed_listener);
+    bs_avltree_node_t *avlnode_ptr = bs_avltree_delete(
+        task_list_ptr->row_tree_ptr, data_ptr);
+    if (NULL != avlnode_ptr) row_node_destroy(avlnode_ptr);
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_next_buffer(bs_test_t *test_ptr);
+static void test_row(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmaker_task_list_test_cases[] = {
+    { 1, "next_buffer", test_next_buffer },
+    { 1, "row", test_row },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Verifies the buffers alternate, and locked buffers are not re-used. */
+void test_next_buffer(bs_test_t *test_ptr)
+{
+    wlmaker_task_list_t task_list = {};
+
+    struct wlr_buffer *b1_ptr = task_list_next_buffer(&task_list);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, b1_ptr);
+    struct wlr_buffer *b2_ptr = task_list_next_buffer(&task_list);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, b2_ptr);
+    BS_TEST_VERIFY_NEQ(test_ptr, b1_ptr, b2_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, b1_ptr, task_list_next_buffer(&task_list));
+
+    // Still locked, eg. by the scene graph: Gets replaced.
+    wlr_buffer_lock(b2_ptr);
+    struct wlr_buffer *b3_ptr = task_list_next_buffer(&task_list);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, b3_ptr);
+    BS_TEST_VERIFY_NEQ(test_ptr, b2_ptr, b3_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, b3_ptr, task_list.wlr_buffer_ptrs[1]);
+    // The dropped buffer is destroyed once released.
+    wlr_buffer_unlock(b2_ptr);
+
+    for (size_t i = 0; i < 2; ++i) {
+        wlr_buffer_drop_nullify(&task_list.wlr_buffer_ptrs[i]);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies rows are rendered once per variant, and again on a new title. */
+void test_row(bs_test_t *test_ptr)
+{
+    wlmtk_fake_window_t *fw_ptr = wlmtk_fake_window_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fw_ptr);
+    wlmtk_window_set_title(fw_ptr->window_ptr, "Title");
+
+    wlmaker_task_list_row_t *row_ptr = row_create(fw_ptr->window_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, row_ptr);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, row_ptr->details_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, row_ptr->surface_ptrs[0]);
+
+    // Rendered on first use, then re-used.
+    cairo_surface_t *s0_ptr = row_surface(row_ptr, false);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, s0_ptr);
+    BS_TEST_VERIFY_STREQ(test_ptr, "Title", row_ptr->title_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, s0_ptr, row_surface(row_ptr, false));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, row_ptr->surface_ptrs[1]);
+
+    // The active variant is rendered separately. Both are kept.
+    cairo_surface_t *s1_ptr = row_surface(row_ptr, true);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, s1_ptr);
+    BS_TEST_VERIFY_NEQ(test_ptr, s0_ptr, s1_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, s0_ptr, row_surface(row_ptr, false));
+    BS_TEST_VERIFY_EQ(test_ptr, s1_ptr, row_surface(row_ptr, true));
+
+    // A new title drops both variants, and renders the requested one.
+    wlmtk_window_set_title(fw_ptr->window_ptr, "Other");
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, row_surface(row_ptr, false));
+    BS_TEST_VERIFY_STREQ(test_ptr, "Other", row_ptr->title_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, row_ptr->surface_ptrs[1]);
+
+    row_destroy(row_ptr);
+    wlmtk_fake_window_destroy(fw_ptr);
+}
+
 /* == End of task_list.c =================================================== */
@@ -78,6 +78,9 @@ wlmaker_task_list_t *wlmaker_task_list_create(
 void wlmaker_task_list_destroy(
     wlmaker_task_list_t *task_list_ptr);
 
+/** Unit test cases. */
+extern const bs_test_case_t wlmaker_task_list_test_cases[];
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -20,6 +20,8 @@
 
 #include "buffer.h"
 
+#include "container.h"
+#include "gfxbuf.h"
 #include "util.h"
 
 #define WLR_USE_UNSTABLE
@@ -73,6 +75,7 @@ void wlmtk_buffer_fini(wlmtk_buffer_t *buffer_ptr)
         wlr_buffer_unlock(buffer_ptr->wlr_buffer_ptr);
         buffer_ptr->wlr_buffer_ptr = NULL;
     }
+    wlmtk_element_invalidate_bounds(&buffer_ptr->super_element);
 
     if (NULL != buffer_ptr->wlr_scene_buffer_ptr) {
         wlr_scene_node_destroy(&buffer_ptr->wlr_scene_buffer_ptr->node);
@@ -87,7 +90,10 @@ void wlmtk_buffer_set(
     wlmtk_buffer_t *buffer_ptr,
     struct wlr_buffer *wlr_buffer_ptr)
 {
+    int old_width = 0, old_height = 0;
     if (NULL != buffer_ptr->wlr_buffer_ptr) {
+        old_width = buffer_ptr->wlr_buffer_ptr->width;
+        old_height = buffer_ptr->wlr_buffer_ptr->height;
         wlr_buffer_unlock(buffer_ptr->wlr_buffer_ptr);
     }
 
@@ -102,6 +108,16 @@ void wlmtk_buffer_set(
             buffer_ptr->wlr_scene_buffer_ptr,
             buffer_ptr->wlr_buffer_ptr);
     }
+
+    // The parents' cached bounds depend on the buffer's dimensions.
+    int width = 0, height = 0;
+    if (NULL != buffer_ptr->wlr_buffer_ptr) {
+        width = buffer_ptr->wlr_buffer_ptr->width;
+        height = buffer_ptr->wlr_buffer_ptr->height;
+    }
+    if (width != old_width || height != old_height) {
+        wlmtk_element_invalidate_bounds(&buffer_ptr->super_element);
+    }
 }
 
 /* == Local (static) methods =============================================== */
@@ -189,4 +205,68 @@ void handle_wlr_scene_buffer_node_destroy(
     wl_list_remove(&buffer_ptr->wlr_scene_buffer_node_destroy_listener.link);
 }
 
+/* == Unit tests =========================================================== */
+
+static void test_resize_in_container(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmtk_buffer_test_cases[] = {
+    { 1, "resize_in_container", test_resize_in_container },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Verifies that resizing the buffer updates the container's bounds, index. */
+void test_resize_in_container(bs_test_t *test_ptr)
+{
+    wlmtk_container_t container;
+    BS_ASSERT(wlmtk_container_init(&container, NULL));
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_container_enable_spatial_index(&container));
+    wlmtk_buffer_t buffer;
+    BS_ASSERT(wlmtk_buffer_init(&buffer, NULL));
+    wlmtk_element_set_visible(&buffer.super_element, true);
+    wlmtk_container_add_element(&container, &buffer.super_element);
+
+    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(10, 5);
+    wlmtk_buffer_set(&buffer, wlr_buffer_ptr);
+    wlr_buffer_drop(wlr_buffer_ptr);
+    struct wlr_box box = wlmtk_element_get_dimensions_box(
+        &container.super_element);
+    BS_TEST_VERIFY_EQ(test_ptr, 10, box.width);
+    BS_TEST_VERIFY_EQ(test_ptr, 5, box.height);
+    BS_TEST_VERIFY_TRUE(test_ptr, container.super_element.bounds_cache_valid);
+    BS_TEST_VERIFY_FALSE(
+        test_ptr,
+        wlmtk_element_pointer_motion(&container.super_element, 20, 6, 7));
+
+    // Same dimensions: The cached bounds remain valid.
+    wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(10, 5);
+    wlmtk_buffer_set(&buffer, wlr_buffer_ptr);
+    wlr_buffer_drop(wlr_buffer_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, container.super_element.bounds_cache_valid);
+
+    // Resized: The container picks up the new dimensions.
+    wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(30, 7);
+    wlmtk_buffer_set(&buffer, wlr_buffer_ptr);
+    wlr_buffer_drop(wlr_buffer_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, container.super_element.bounds_cache_valid);
+    box = wlmtk_element_get_dimensions_box(&container.super_element);
+    BS_TEST_VERIFY_EQ(test_ptr, 30, box.width);
+    BS_TEST_VERIFY_EQ(test_ptr, 7, box.height);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_element_pointer_motion(&container.super_element, 20, 6, 7));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &buffer.super_element, container.pointer_focus_element_ptr);
+
+    // Cleared: No more bounds.
+    wlmtk_buffer_set(&buffer, NULL);
+    box = wlmtk_element_get_dimensions_box(&container.super_element);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, box.width);
+
+    wlmtk_container_remove_element(&container, &buffer.super_element);
+    wlmtk_buffer_fini(&buffer);
+    wlmtk_container_fini(&container);
+}
+
 /* == End of buffer.c ====================================================== */
@@ -82,6 +82,9 @@ void wlmtk_buffer_set(
     wlmtk_buffer_t *buffer_ptr,
     struct wlr_buffer *wlr_buffer_ptr);
 
+/** Unit test cases. */
+extern const bs_test_case_t wlmtk_buffer_test_cases[];
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -20,6 +20,7 @@
 
 #include "container.h"
 
+#include "trace.h"
 #include "util.h"
 
 #define WLR_USE_UNSTABLE
@@ -71,6 +72,16 @@ static bool update_pointer_focus_at(
     double x,
     double y,
     uint32_t time_msec);
+static bool _wlmtk_container_focus_element_at(
+    wlmtk_container_t *container_ptr,
+    wlmtk_element_t *element_ptr,
+    double x,
+    double y,
+    uint32_t time_msec);
+static bool _wlmtk_container_build_spatial_index(
+    wlmtk_container_t *container_ptr);
+static void _wlmtk_container_update_bounds_cache(
+    wlmtk_container_t *container_ptr);
 static void _wlmtk_container_update_layout(wlmtk_container_t *container_ptr);
 
 /** Virtual method table for the container's super class: Element. */
@@ -90,6 +101,9 @@ static const wlmtk_container_vmt_t container_vmt = {
     .update_layout = _wlmtk_container_update_layout,
 };
 
+/** Cell size of the spatial index, in pixels. */
+static const int              _wlmtk_container_spatial_index_cell_size = 128;
+
 /* == Exported methods ===================================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -154,6 +168,11 @@ void wlmtk_container_fini(wlmtk_container_t *container_ptr)
         wlmtk_element_destroy(element_ptr);
     }
 
+    if (NULL != container_ptr->spatial_index_ptr) {
+        wlmtk_spatial_index_destroy(container_ptr->spatial_index_ptr);
+        container_ptr->spatial_index_ptr = NULL;
+    }
+
     // For containers created with wlmtk_container_init_attached(): We also
     // need to remove references to the WLR scene tree.
     if (NULL != container_ptr->wlr_scene_tree_ptr) {
@@ -270,9 +289,24 @@ void wlmtk_container_raise_element_to_top(
     wlmtk_container_update_layout(container_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+bool wlmtk_container_enable_spatial_index(wlmtk_container_t *container_ptr)
+{
+    if (NULL != container_ptr->spatial_index_ptr) return true;
+
+    container_ptr->spatial_index_ptr = wlmtk_spatial_index_create(
+        _wlmtk_container_spatial_index_cell_size);
+    container_ptr->spatial_index_dirty = true;
+    return NULL != container_ptr->spatial_index_ptr;
+}
+
 /* ------------------------------------------------------------------------- */
 void wlmtk_container_update_pointer_focus(wlmtk_container_t *container_ptr)
 {
+    // Called when an element moved: The index and bounds must follow.
+    container_ptr->spatial_index_dirty = true;
+    container_ptr->super_element.bounds_cache_valid = false;
+
     if (NULL != container_ptr->super_element.parent_container_ptr) {
         wlmtk_container_update_pointer_focus(
             container_ptr->super_element.parent_container_ptr);
@@ -315,6 +349,25 @@ struct wlr_scene_tree *wlmtk_container_wlr_scene_tree(
     return container_ptr->wlr_scene_tree_ptr;
 }
 
+/* ------------------------------------------------------------------------- */
+size_t wlmtk_container_count_elements(wlmtk_container_t *container_ptr)
+{
+    size_t count = 0;
+    for (bs_dllist_node_t *dlnode_ptr = container_ptr->elements.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_element_t *element_ptr = wlmtk_element_from_dlnode(dlnode_ptr);
+        ++count;
+        // Containers do not override the scene node method: Recurse.
+        if (element_ptr->vmt.create_scene_node ==
+            _wlmtk_container_element_create_scene_node) {
+            count += wlmtk_container_count_elements(BS_CONTAINER_OF(
+                element_ptr, wlmtk_container_t, super_element));
+        }
+    }
+    return count;
+}
+
 /* == Local (static) methods =============================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -377,32 +430,13 @@ void _wlmtk_container_element_get_dimensions(
 {
     wlmtk_container_t *container_ptr = BS_CONTAINER_OF(
         element_ptr, wlmtk_container_t, super_element);
+    _wlmtk_container_update_bounds_cache(container_ptr);
 
-    int left = INT32_MAX, top = INT32_MAX;
-    int right = INT32_MIN, bottom = INT32_MIN;
-    for (bs_dllist_node_t *dlnode_ptr = container_ptr->elements.head_ptr;
-         dlnode_ptr != NULL;
-         dlnode_ptr = dlnode_ptr->next_ptr) {
-        wlmtk_element_t *element_ptr = wlmtk_element_from_dlnode(dlnode_ptr);
-        if (!element_ptr->visible) continue;
-
-        int x_pos, y_pos;
-        wlmtk_element_get_position(element_ptr, &x_pos, &y_pos);
-        int x1, y1, x2, y2;
-        wlmtk_element_get_dimensions(element_ptr, &x1, &y1, &x2, &y2);
-        left = BS_MIN(left, x_pos + x1);
-        top = BS_MIN(top, y_pos + y1);
-        right = BS_MAX(right, x_pos + x2);
-        bottom = BS_MAX(bottom, y_pos + y2);
-    }
-
-    if (left >= right) { left = 0; right = 0; }
-    if (top >= bottom) { top = 0; bottom = 0; }
-
-    if (NULL != left_ptr) *left_ptr = left;
-    if (NULL != top_ptr) *top_ptr = top;
-    if (NULL != right_ptr) *right_ptr = right;
-    if (NULL != bottom_ptr) *bottom_ptr = bottom;
+    struct wlr_box *box_ptr = &element_ptr->cached_dimensions;
+    if (NULL != left_ptr) *left_ptr = box_ptr->x;
+    if (NULL != top_ptr) *top_ptr = box_ptr->y;
+    if (NULL != right_ptr) *right_ptr = box_ptr->x + box_ptr->width;
+    if (NULL != bottom_ptr) *bottom_ptr = box_ptr->y + box_ptr->height;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -424,9 +458,35 @@ void _wlmtk_container_element_get_pointer_area(
 {
     wlmtk_container_t *container_ptr = BS_CONTAINER_OF(
         element_ptr, wlmtk_container_t, super_element);
+    _wlmtk_container_update_bounds_cache(container_ptr);
+
+    struct wlr_box *box_ptr = &element_ptr->cached_pointer_area;
+    if (NULL != left_ptr) *left_ptr = box_ptr->x;
+    if (NULL != top_ptr) *top_ptr = box_ptr->y;
+    if (NULL != right_ptr) *right_ptr = box_ptr->x + box_ptr->width;
+    if (NULL != bottom_ptr) *bottom_ptr = box_ptr->y + box_ptr->height;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Computes the union of the visible elements' dimensions and pointer areas,
+ * and stores them in the container element's cache. Does nothing if the
+ * cache is still valid.
+ *
+ * The cache is invalidated through @ref wlmtk_element_invalidate_bounds, or
+ * when elements are moved or when the layout is updated.
+ *
+ * @param container_ptr
+ */
+void _wlmtk_container_update_bounds_cache(wlmtk_container_t *container_ptr)
+{
+    wlmtk_element_t *container_element_ptr = &container_ptr->super_element;
+    if (container_element_ptr->bounds_cache_valid) return;
 
     int left = INT32_MAX, top = INT32_MAX;
     int right = INT32_MIN, bottom = INT32_MIN;
+    int pa_left = INT32_MAX, pa_top = INT32_MAX;
+    int pa_right = INT32_MIN, pa_bottom = INT32_MIN;
     for (bs_dllist_node_t *dlnode_ptr = container_ptr->elements.head_ptr;
          dlnode_ptr != NULL;
          dlnode_ptr = dlnode_ptr->next_ptr) {
@@ -436,20 +496,30 @@ void _wlmtk_container_element_get_pointer_area(
         int x_pos, y_pos;
         wlmtk_element_get_position(element_ptr, &x_pos, &y_pos);
         int x1, y1, x2, y2;
-        wlmtk_element_get_pointer_area(element_ptr, &x1, &y1, &x2, &y2);
+        wlmtk_element_get_dimensions(element_ptr, &x1, &y1, &x2, &y2);
         left = BS_MIN(left, x_pos + x1);
         top = BS_MIN(top, y_pos + y1);
         right = BS_MAX(right, x_pos + x2);
         bottom = BS_MAX(bottom, y_pos + y2);
+
+        wlmtk_element_get_pointer_area(element_ptr, &x1, &y1, &x2, &y2);
+        pa_left = BS_MIN(pa_left, x_pos + x1);
+        pa_top = BS_MIN(pa_top, y_pos + y1);
+        pa_right = BS_MAX(pa_right, x_pos + x2);
+        pa_bottom = BS_MAX(pa_bottom, y_pos + y2);
     }
 
     if (left >= right) { left = 0; right = 0; }
     if (top >= bottom) { top = 0; bottom = 0; }
-
-    if (NULL != left_ptr) *left_ptr = left;
-    if (NULL != top_ptr) *top_ptr = top;
-    if (NULL != right_ptr) *right_ptr = right;
-    if (NULL != bottom_ptr) *bottom_ptr = bottom;
+    if (pa_left >= pa_right) { pa_left = 0; pa_right = 0; }
+    if (pa_top >= pa_bottom) { pa_top = 0; pa_bottom = 0; }
+
+    container_element_ptr->cached_dimensions = (struct wlr_box){
+        .x = left, .y = top, .width = right - left, .height = bottom - top };
+    container_element_ptr->cached_pointer_area = (struct wlr_box){
+        .x = pa_left, .y = pa_top,
+        .width = pa_right - pa_left, .height = pa_bottom - pa_top };
+    container_element_ptr->bounds_cache_valid = true;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -469,6 +539,7 @@ bool _wlmtk_container_element_pointer_motion(
     double y,
     uint32_t time_msec)
 {
+    WLMTK_TRACE_SCOPE("container_pointer_motion");
     wlmtk_container_t *container_ptr = BS_CONTAINER_OF(
         element_ptr, wlmtk_container_t, super_element);
     container_ptr->orig_super_element_vmt.pointer_motion(
@@ -491,6 +562,7 @@ bool _wlmtk_container_element_pointer_button(
     wlmtk_element_t *element_ptr,
     const wlmtk_button_event_t *button_event_ptr)
 {
+    WLMTK_TRACE_SCOPE("container_pointer_button");
     wlmtk_container_t *container_ptr = BS_CONTAINER_OF(
         element_ptr, wlmtk_container_t, super_element);
     bool accepted = false;
@@ -656,34 +728,52 @@ bool update_pointer_focus_at(
     double y,
     uint32_t time_msec)
 {
-    for (bs_dllist_node_t *dlnode_ptr = container_ptr->elements.head_ptr;
-         dlnode_ptr != NULL;
-         dlnode_ptr = dlnode_ptr->next_ptr) {
-        wlmtk_element_t *element_ptr = wlmtk_element_from_dlnode(dlnode_ptr);
-
-        if (!element_ptr->visible) continue;
-
-        int x_pos, y_pos;
-        wlmtk_element_get_position(element_ptr, &x_pos, &y_pos);
-        int x1, y1, x2, y2;
-        wlmtk_element_get_pointer_area(element_ptr, &x1, &y1, &x2, &y2);
-        if (x_pos + x1 <= x && x < x_pos + x2 &&
-            y_pos + y1 <= y && y < y_pos + y2) {
-            if (!wlmtk_element_pointer_motion(
-                    element_ptr, x - x_pos, y - y_pos, time_msec)) {
-                continue;
-            }
-
-            // There is a focus change. Invalidate coordinates in old element.
-            if (container_ptr->pointer_focus_element_ptr != element_ptr &&
-                NULL != container_ptr->pointer_focus_element_ptr) {
-                wlmtk_element_pointer_motion(
-                    container_ptr->pointer_focus_element_ptr,
-                    NAN, NAN, time_msec);
-
-            }
-            container_ptr->pointer_focus_element_ptr = element_ptr;
-            return true;
+    bool scanned = false;
+    if (NULL != container_ptr->spatial_index_ptr &&
+        !container_ptr->spatial_index_in_use &&
+        (!container_ptr->spatial_index_dirty ||
+         _wlmtk_container_build_spatial_index(container_ptr))) {
+        // The index holds the visible elements, in stacking order.
+        size_t count;
+        const wlmtk_spatial_index_item_t * const *items_ptr =
+            wlmtk_spatial_index_lookup(
+                container_ptr->spatial_index_ptr, x, y, &count);
+        bool focussed = false;
+        container_ptr->spatial_index_in_use = true;
+        for (size_t i = 0;
+             i < count && !focussed && !container_ptr->spatial_index_dirty;
+             ++i) {
+            const struct wlr_box *box_ptr = &items_ptr[i]->box;
+            focussed = (
+                box_ptr->x <= x && x < box_ptr->x + box_ptr->width &&
+                box_ptr->y <= y && y < box_ptr->y + box_ptr->height &&
+                _wlmtk_container_focus_element_at(
+                    container_ptr, items_ptr[i]->data_ptr,
+                    x, y, time_msec));
+        }
+        container_ptr->spatial_index_in_use = false;
+        if (focussed) return true;
+        // If a callback changed the layout, the remaining candidates may be
+        // stale. Scan the elements instead.
+        scanned = !container_ptr->spatial_index_dirty;
+    }
+    if (!scanned) {
+        for (bs_dllist_node_t *dlnode_ptr = container_ptr->elements.head_ptr;
+             dlnode_ptr != NULL;
+             dlnode_ptr = dlnode_ptr->next_ptr) {
+            wlmtk_element_t *element_ptr =
+                wlmtk_element_from_dlnode(dlnode_ptr);
+
+            if (!element_ptr->visible) continue;
+
+            int x_pos, y_pos;
+            wlmtk_element_get_position(element_ptr, &x_pos, &y_pos);
+            int x1, y1, x2, y2;
+            wlmtk_element_get_pointer_area(element_ptr, &x1, &y1, &x2, &y2);
+            if (x_pos + x1 <= x && x < x_pos + x2 &&
+                y_pos + y1 <= y && y < y_pos + y2 &&
+                _wlmtk_container_focus_element_at(
+                    container_ptr, element_ptr, x, y, time_msec)) return true;
         }
     }
 
@@ -699,6 +789,82 @@ bool update_pointer_focus_at(
     return false;
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Passes the motion to `element_ptr`, and updates pointer focus if accepted.
+ *
+ * @param container_ptr
+ * @param element_ptr         An element of the container, whose pointer area
+ *                            covers (x, y).
+ * @param x
+ * @param y
+ * @param time_msec
+ *
+ * @return Whether the element accepted the motion, and has pointer focus.
+ */
+bool _wlmtk_container_focus_element_at(
+    wlmtk_container_t *container_ptr,
+    wlmtk_element_t *element_ptr,
+    double x,
+    double y,
+    uint32_t time_msec)
+{
+    int x_pos, y_pos;
+    wlmtk_element_get_position(element_ptr, &x_pos, &y_pos);
+    if (!wlmtk_element_pointer_motion(
+            element_ptr, x - x_pos, y - y_pos, time_msec)) {
+        return false;
+    }
+
+    // There is a focus change. Invalidate coordinates in old element.
+    if (container_ptr->pointer_focus_element_ptr != element_ptr &&
+        NULL != container_ptr->pointer_focus_element_ptr) {
+        wlmtk_element_pointer_motion(
+            container_ptr->pointer_focus_element_ptr,
+            NAN, NAN, time_msec);
+    }
+    container_ptr->pointer_focus_element_ptr = element_ptr;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Rebuilds @ref wlmtk_container_t::spatial_index_ptr from the pointer areas
+ * of all visible elements, in stacking order.
+ *
+ * @param container_ptr
+ *
+ * @return true on success. On failure, the index remains dirty and the caller
+ *     should fall back to iterating over @ref wlmtk_container_t::elements.
+ */
+bool _wlmtk_container_build_spatial_index(wlmtk_container_t *container_ptr)
+{
+    wlmtk_spatial_index_clear(container_ptr->spatial_index_ptr);
+    for (bs_dllist_node_t *dlnode_ptr = container_ptr->elements.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_element_t *element_ptr = wlmtk_element_from_dlnode(dlnode_ptr);
+        if (!element_ptr->visible) continue;
+
+        int x_pos, y_pos;
+        wlmtk_element_get_position(element_ptr, &x_pos, &y_pos);
+        int x1, y1, x2, y2;
+        wlmtk_element_get_pointer_area(element_ptr, &x1, &y1, &x2, &y2);
+        struct wlr_box box = {
+            .x = x_pos + x1, .y = y_pos + y1,
+            .width = x2 - x1, .height = y2 - y1 };
+        if (!wlmtk_spatial_index_add(
+                container_ptr->spatial_index_ptr, element_ptr, &box)) {
+            return false;
+        }
+    }
+    if (!wlmtk_spatial_index_build(container_ptr->spatial_index_ptr)) {
+        return false;
+    }
+    container_ptr->spatial_index_dirty = false;
+    return true;
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Base implementation of wlmtk_container_vmt_t::update_layout. If there's
@@ -709,6 +875,9 @@ bool update_pointer_focus_at(
  */
 void _wlmtk_container_update_layout(wlmtk_container_t *container_ptr)
 {
+    container_ptr->spatial_index_dirty = true;
+    container_ptr->super_element.bounds_cache_valid = false;
+
     if (NULL != container_ptr->super_element.parent_container_ptr) {
         wlmtk_container_update_layout(
             container_ptr->super_element.parent_container_ptr);
@@ -777,10 +946,13 @@ static void test_init_fini(bs_test_t *test_ptr);
 static void test_add_remove(bs_test_t *test_ptr);
 static void test_add_remove_with_scene_graph(bs_test_t *test_ptr);
 static void test_add_with_raise(bs_test_t *test_ptr);
+static void test_count_elements(bs_test_t *test_ptr);
 static void test_pointer_motion(bs_test_t *test_ptr);
+static void test_bounds_cache(bs_test_t *test_ptr);
 static void test_pointer_focus(bs_test_t *test_ptr);
 static void test_pointer_focus_move(bs_test_t *test_ptr);
 static void test_pointer_focus_layered(bs_test_t *test_ptr);
+static void test_pointer_focus_indexed(bs_test_t *test_ptr);
 static void test_pointer_button(bs_test_t *test_ptr);
 static void test_pointer_axis(bs_test_t *test_ptr);
 static void test_keyboard_event(bs_test_t *test_ptr);
@@ -790,10 +962,13 @@ const bs_test_case_t wlmtk_container_test_cases[] = {
     { 1, "add_remove", test_add_remove },
     { 1, "add_remove_with_scene_graph", test_add_remove_with_scene_graph },
     { 1, "add_with_raise", test_add_with_raise },
+    { 1, "count_elements", test_count_elements },
     { 1, "pointer_motion", test_pointer_motion },
+    { 1, "bounds_cache", test_bounds_cache },
     { 1, "pointer_focus", test_pointer_focus },
     { 1, "pointer_focus_move", test_pointer_focus_move },
     { 1, "pointer_focus_layered", test_pointer_focus_layered },
+    { 1, "pointer_focus_indexed", test_pointer_focus_indexed },
     { 1, "pointer_button", test_pointer_button },
     { 1, "pointer_axis", test_pointer_axis },
     { 1, "keyboard_event", test_keyboard_event },
@@ -1204,6 +1379,64 @@ void test_pointer_motion(bs_test_t *test_ptr)
     wlmtk_container_fini(&container);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Verifies the cached bounds follow moves and size changes of elements. */
+void test_bounds_cache(bs_test_t *test_ptr)
+{
+    wlmtk_container_t parent_container;
+    BS_ASSERT(wlmtk_container_init(&parent_container, NULL));
+    wlmtk_container_t container;
+    BS_ASSERT(wlmtk_container_init(&container, NULL));
+    wlmtk_element_set_visible(&container.super_element, true);
+    wlmtk_container_add_element(&parent_container, &container.super_element);
+
+    wlmtk_fake_element_t *fe_ptr = wlmtk_fake_element_create();
+    fe_ptr->dimensions.width = 10;
+    fe_ptr->dimensions.height = 5;
+    wlmtk_element_set_visible(&fe_ptr->element, true);
+    wlmtk_container_add_element(&container, &fe_ptr->element);
+
+    struct wlr_box box = wlmtk_element_get_dimensions_box(
+        &parent_container.super_element);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, box.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 10, box.width);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, parent_container.super_element.bounds_cache_valid);
+    BS_TEST_VERIFY_TRUE(test_ptr, container.super_element.bounds_cache_valid);
+
+    // Moving the element invalidates all parents' bounds.
+    wlmtk_element_set_position(&fe_ptr->element, 20, 0);
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, parent_container.super_element.bounds_cache_valid);
+    BS_TEST_VERIFY_FALSE(test_ptr, container.super_element.bounds_cache_valid);
+    box = wlmtk_element_get_dimensions_box(&parent_container.super_element);
+    BS_TEST_VERIFY_EQ(test_ptr, 20, box.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 10, box.width);
+
+    // Without invalidation, a size change is not picked up.
+    fe_ptr->dimensions.width = 30;
+    box = wlmtk_element_get_dimensions_box(&parent_container.super_element);
+    BS_TEST_VERIFY_EQ(test_ptr, 10, box.width);
+    wlmtk_element_invalidate_bounds(&fe_ptr->element);
+    box = wlmtk_element_get_dimensions_box(&parent_container.super_element);
+    BS_TEST_VERIFY_EQ(test_ptr, 30, box.width);
+    int l, t, r, b;
+    wlmtk_element_get_pointer_area(
+        &parent_container.super_element, &l, &t, &r, &b);
+    BS_TEST_VERIFY_EQ(test_ptr, 19, l);
+    BS_TEST_VERIFY_EQ(test_ptr, 53, r);
+
+    // Hiding the element clears the bounds.
+    wlmtk_element_set_visible(&fe_ptr->element, false);
+    box = wlmtk_element_get_dimensions_box(&parent_container.super_element);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, box.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, box.width);
+
+    wlmtk_container_remove_element(&parent_container, &container.super_element);
+    wlmtk_container_fini(&container);
+    wlmtk_container_fini(&parent_container);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Tests that pointer focus is updated when elements are updated. */
 void test_pointer_focus(bs_test_t *test_ptr)
@@ -1337,6 +1570,33 @@ void test_pointer_focus_move(bs_test_t *test_ptr)
 }
 
 
+/* ------------------------------------------------------------------------- */
+/** Tests @ref wlmtk_container_count_elements, with a nested container. */
+void test_count_elements(bs_test_t *test_ptr)
+{
+    wlmtk_container_t container1;
+    BS_ASSERT(wlmtk_container_init(&container1, NULL));
+    wlmtk_container_t container2;
+    BS_ASSERT(wlmtk_container_init(&container2, NULL));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_container_count_elements(&container1));
+
+    wlmtk_fake_element_t *elem1_ptr = wlmtk_fake_element_create();
+    wlmtk_container_add_element(&container1, &elem1_ptr->element);
+    wlmtk_fake_element_t *elem2_ptr = wlmtk_fake_element_create();
+    wlmtk_container_add_element(&container2, &elem2_ptr->element);
+    wlmtk_fake_element_t *elem3_ptr = wlmtk_fake_element_create();
+    wlmtk_container_add_element(&container2, &elem3_ptr->element);
+    wlmtk_container_add_element(&container1, &container2.super_element);
+
+    // elem1, container2 and the two elements of container2.
+    BS_TEST_VERIFY_EQ(test_ptr, 4, wlmtk_container_count_elements(&container1));
+    BS_TEST_VERIFY_EQ(test_ptr, 2, wlmtk_container_count_elements(&container2));
+
+    wlmtk_container_remove_element(&container1, &container2.super_element);
+    wlmtk_container_fini(&container2);
+    wlmtk_container_fini(&container1);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Tests that pointer focus is updated across layers of containers. */
 void test_pointer_focus_layered(bs_test_t *test_ptr)
@@ -1414,6 +1674,91 @@ void test_pointer_focus_layered(bs_test_t *test_ptr)
     wlmtk_container_fini(&container1);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tests pointer focus with the spatial index, as the container changes. */
+void test_pointer_focus_indexed(bs_test_t *test_ptr)
+{
+    wlmtk_container_t container;
+    BS_ASSERT(wlmtk_container_init(&container, NULL));
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_container_enable_spatial_index(&container));
+
+    // Note: pointer area extends by (-1, -2, 3, 4) on each fake element.
+    wlmtk_fake_element_t *elem1_ptr = wlmtk_fake_element_create();
+    elem1_ptr->dimensions.width = 100;
+    elem1_ptr->dimensions.height = 100;
+    wlmtk_element_set_visible(&elem1_ptr->element, true);
+    wlmtk_container_add_element(&container, &elem1_ptr->element);
+    wlmtk_fake_element_t *elem2_ptr = wlmtk_fake_element_create();
+    elem2_ptr->dimensions.width = 100;
+    elem2_ptr->dimensions.height = 100;
+    wlmtk_element_set_position(&elem2_ptr->element, 1000, 1000);
+    wlmtk_element_set_visible(&elem2_ptr->element, true);
+    wlmtk_container_add_element(&container, &elem2_ptr->element);
+
+    // Nothing at (500, 500). But elem1 at (50, 50), and elem2 at (1050, 1050).
+    BS_TEST_VERIFY_FALSE(
+        test_ptr,
+        wlmtk_element_pointer_motion(&container.super_element, 500, 500, 7));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, container.pointer_focus_element_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, container.spatial_index_dirty);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_element_pointer_motion(&container.super_element, 50, 50, 7));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &elem1_ptr->element, container.pointer_focus_element_ptr);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_element_pointer_motion(
+            &container.super_element, 1050, 1050, 7));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &elem2_ptr->element, container.pointer_focus_element_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, elem1_ptr->pointer_leave_called);
+
+    // The pointer area, not just the dimensions, is considered.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_element_pointer_motion(&container.super_element, 102, 103, 7));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &elem1_ptr->element, container.pointer_focus_element_ptr);
+
+    // Moving elem2 below the pointer: It's on top, and takes focus.
+    wlmtk_element_set_position(&elem2_ptr->element, 50, 50);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &elem2_ptr->element, container.pointer_focus_element_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, container.spatial_index_dirty);
+
+    // Raising elem1: Takes focus.
+    wlmtk_container_raise_element_to_top(&container, &elem1_ptr->element);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &elem1_ptr->element, container.pointer_focus_element_ptr);
+
+    // Hiding elem1: Focus goes back to elem2.
+    wlmtk_element_set_visible(&elem1_ptr->element, false);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &elem2_ptr->element, container.pointer_focus_element_ptr);
+
+    // When re-entered while dispatching to candidates: Doesn't rebuild the
+    // index, and scans the elements instead.
+    container.spatial_index_in_use = true;
+    container.spatial_index_dirty = true;
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_element_pointer_motion(&container.super_element, 60, 60, 7));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &elem2_ptr->element, container.pointer_focus_element_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, container.spatial_index_dirty);
+    container.spatial_index_in_use = false;
+
+    // Removing elem2: No more focus.
+    wlmtk_container_remove_element(&container, &elem2_ptr->element);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, container.pointer_focus_element_ptr);
+    wlmtk_element_destroy(&elem2_ptr->element);
+
+    // Container is teared down with the remaining element, and the index.
+    wlmtk_container_fini(&container);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Tests that pointer DOWN is forwarded to element with pointer focus. */
 void test_pointer_button(bs_test_t *test_ptr)
@@ -29,6 +29,7 @@ typedef struct _wlmtk_container_t wlmtk_container_t;
 typedef struct _wlmtk_container_vmt_t wlmtk_container_vmt_t;
 
 #include "element.h"
+#include "spatial_index.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -80,6 +81,25 @@ struct _wlmtk_container_t {
     wlmtk_element_t           *left_button_element_ptr;
     /** Stores the element with current keyboard focus. May be NULL. */
     wlmtk_element_t           *keyboard_focus_element_ptr;
+
+    /**
+     * Optional index of the visible elements' pointer areas, to look up
+     * pointer focus candidates. NULL, unless enabled through
+     * @ref wlmtk_container_enable_spatial_index.
+     */
+    wlmtk_spatial_index_t     *spatial_index_ptr;
+    /**
+     * Whether @ref wlmtk_container_t::spatial_index_ptr must be rebuilt
+     * before the next lookup. Set whenever elements were added, removed,
+     * re-stacked, moved or changed visibility or dimensions.
+     */
+    bool                      spatial_index_dirty;
+    /**
+     * Whether candidates from @ref wlmtk_container_t::spatial_index_ptr are
+     * being dispatched to. Motion callbacks may re-enter the container, and
+     * must not rebuild (and re-allocate) the index meanwhile.
+     */
+    bool                      spatial_index_in_use;
 };
 
 /**
@@ -180,6 +200,27 @@ void wlmtk_container_raise_element_to_top(
     wlmtk_container_t *container_ptr,
     wlmtk_element_t *element_ptr);
 
+/**
+ * Enables the spatial index for looking up the pointer focus.
+ *
+ * Without index, each pointer motion is tested against each of the visible
+ * elements, in stacking order. With index enabled, only the elements whose
+ * pointer area overlap the grid cell of the pointer position are tested.
+ * The index is rebuilt lazily, on the first motion after a change to the
+ * container's layout.
+ *
+ * Recommended for containers that hold many elements, eg. windows.
+ *
+ * Requires all contained elements to call @ref wlmtk_container_update_layout
+ * when their dimensions change, as documented for
+ * @ref wlmtk_container_vmt_t::update_layout.
+ *
+ * @param container_ptr
+ *
+ * @return true on success.
+ */
+bool wlmtk_container_enable_spatial_index(wlmtk_container_t *container_ptr);
+
 /**
  * Updates pointer focus of the container.
  *
@@ -222,6 +263,16 @@ static inline void wlmtk_container_update_layout(
 struct wlr_scene_tree *wlmtk_container_wlr_scene_tree(
     wlmtk_container_t *container_ptr);
 
+/**
+ * Counts the elements of the container, including the elements of contained
+ * containers. For statistics.
+ *
+ * @param container_ptr
+ *
+ * @return Number of elements, recursively.
+ */
+size_t wlmtk_container_count_elements(wlmtk_container_t *container_ptr);
+
 /** Unit tests for the container. */
 extern const bs_test_case_t wlmtk_container_test_cases[];
 
@@ -230,6 +230,18 @@ void wlmtk_element_set_visible(wlmtk_element_t *element_ptr, bool visible)
     }
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmtk_element_invalidate_bounds(wlmtk_element_t *element_ptr)
+{
+    while (NULL != element_ptr) {
+        element_ptr->bounds_cache_valid = false;
+        if (NULL == element_ptr->parent_container_ptr) break;
+        // The parent's spatial index holds the element's old pointer area.
+        element_ptr->parent_container_ptr->spatial_index_dirty = true;
+        element_ptr = &element_ptr->parent_container_ptr->super_element;
+    }
+}
+
 /* ------------------------------------------------------------------------- */
 void wlmtk_element_get_position(
     wlmtk_element_t *element_ptr,
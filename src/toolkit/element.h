@@ -217,6 +217,23 @@ struct _wlmtk_element_t {
     uint32_t                  last_pointer_time_msec;
     /** Whether the pointer is currently within the element's bounds. */
     bool                      pointer_inside;
+
+    /**
+     * Cached result of @ref wlmtk_element_vmt_t::get_dimensions, as a box.
+     *
+     * Maintained by implementations that derive their dimensions from other
+     * elements, such as @ref wlmtk_container_t. Only valid if
+     * @ref wlmtk_element_t::bounds_cache_valid is set.
+     */
+    struct wlr_box            cached_dimensions;
+    /** Cached result of @ref wlmtk_element_vmt_t::get_pointer_area. */
+    struct wlr_box            cached_pointer_area;
+    /**
+     * Whether @ref wlmtk_element_t::cached_dimensions and
+     * @ref wlmtk_element_t::cached_pointer_area are valid. Cleared by
+     * @ref wlmtk_element_invalidate_bounds.
+     */
+    bool                      bounds_cache_valid;
 };
 
 /**
@@ -301,6 +318,18 @@ void wlmtk_element_attach_to_scene_graph(
  */
 void wlmtk_element_set_visible(wlmtk_element_t *element_ptr, bool visible);
 
+/**
+ * Invalidates the cached bounds of the element and of all parent containers.
+ * Also marks the parent containers' spatial index as dirty.
+ *
+ * Must be called by elements that change their dimensions or pointer area,
+ * unless they update the parent container's layout through
+ * @ref wlmtk_container_update_layout.
+ *
+ * @param element_ptr
+ */
+void wlmtk_element_invalidate_bounds(wlmtk_element_t *element_ptr);
+
 /**
  * Returns the position of the element.
  *
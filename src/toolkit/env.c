@@ -24,6 +24,7 @@
 
 #define WLR_USE_UNSTABLE
 #include <wlr/types/wlr_cursor.h>
+#include <wlr/types/wlr_seat.h>
 #undef WLR_USE_UNSTABLE
 
 /* == Declarations ========================================================= */
@@ -107,4 +108,11 @@ struct wlr_seat *wlmtk_env_wlr_seat(wlmtk_env_t *env_ptr)
     return env_ptr->wlr_seat_ptr;
 }
 
+/* ------------------------------------------------------------------------- */
+struct wl_event_loop *wlmtk_env_wl_event_loop(wlmtk_env_t *env_ptr)
+{
+    if (NULL == env_ptr || NULL == env_ptr->wlr_seat_ptr) return NULL;
+    return wl_display_get_event_loop(env_ptr->wlr_seat_ptr->display);
+}
+
 /* == End of env.c ========================================================= */
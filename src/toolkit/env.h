@@ -29,6 +29,8 @@ struct wlr_cursor;
 struct wlr_seat;
 /** Forward declaration. */
 struct wlr_xcursor_manager;
+/** Forward declaration. */
+struct wl_event_loop;
 
 #ifdef __cplusplus
 extern "C" {
@@ -82,6 +84,16 @@ void wlmtk_env_set_cursor(wlmtk_env_t *env_ptr, wlmtk_env_cursor_t cursor);
  */
 struct wlr_seat *wlmtk_env_wlr_seat(wlmtk_env_t *env_ptr);
 
+/**
+ * Returns the event loop of the seat's display.
+ *
+ * @param env_ptr             May be NULL.
+ *
+ * @return Pointer to the `wl_event_loop`, or NULL if `env_ptr` is NULL or
+ *     has no seat. Callers should then process synchronously.
+ */
+struct wl_event_loop *wlmtk_env_wl_event_loop(wlmtk_env_t *env_ptr);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -0,0 +1,417 @@
+/* ========================================================================= */
+/**
+ * @file fill_cache.c
+ *
+ * @copyright
+ * Copyright 2024 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fill_cache.h"
+
+#include "primitives.h"
+
+/* == Declarations ========================================================= */
+
+/** An entry of the fill cache: A pre-rendered buffer. */
+typedef struct {
+    /** Node within @ref _wlmtk_fill_cache_entries. */
+    bs_dllist_node_t          dlnode;
+    /** The fill the buffer was rendered with. */
+    wlmtk_style_fill_t        fill;
+    /** The pre-rendered buffer. */
+    bs_gfxbuf_t               *gfxbuf_ptr;
+    /** Number of references held, through @ref wlmtk_fill_cache_acquire. */
+    int                       references;
+} wlmtk_fill_cache_entry_t;
+
+static wlmtk_fill_cache_entry_t *_wlmtk_fill_cache_entry_create(
+    const wlmtk_style_fill_t *fill_ptr,
+    unsigned width,
+    unsigned height);
+static void _wlmtk_fill_cache_entry_destroy(
+    wlmtk_fill_cache_entry_t *entry_ptr);
+static bool _wlmtk_fill_cache_entry_matches(
+    wlmtk_fill_cache_entry_t *entry_ptr,
+    const wlmtk_style_fill_t *fill_ptr,
+    unsigned width,
+    unsigned height);
+static void _wlmtk_fill_cache_trim(size_t max_unused);
+
+/* == Data ================================================================= */
+
+/**
+ * All entries of the cache, most recently used first. Holds referenced and
+ * unreferenced entries.
+ */
+static bs_dllist_t            _wlmtk_fill_cache_entries;
+/** Number of entries in @ref _wlmtk_fill_cache_entries without reference. */
+static size_t                 _wlmtk_fill_cache_unused_entries;
+
+/** Maximum number of unreferenced entries to keep around for re-use. */
+static const size_t           _wlmtk_fill_cache_max_unused_entries = 8;
+/** Solid fills are rendered in multiples of this width. */
+static const unsigned         _wlmtk_fill_cache_solid_width_granularity = 256;
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+bs_gfxbuf_t *wlmtk_fill_cache_acquire(
+    const wlmtk_style_fill_t *fill_ptr,
+    unsigned width,
+    unsigned height)
+{
+    wlmtk_fill_cache_entry_t *entry_ptr = NULL;
+    for (bs_dllist_node_t *dlnode_ptr = _wlmtk_fill_cache_entries.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_fill_cache_entry_t *e_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_fill_cache_entry_t, dlnode);
+        if (_wlmtk_fill_cache_entry_matches(e_ptr, fill_ptr, width, height)) {
+            entry_ptr = e_ptr;
+            break;
+        }
+    }
+
+    if (NULL == entry_ptr) {
+        entry_ptr = _wlmtk_fill_cache_entry_create(fill_ptr, width, height);
+        if (NULL == entry_ptr) return NULL;
+    } else {
+        bs_dllist_remove(&_wlmtk_fill_cache_entries, &entry_ptr->dlnode);
+        if (0 == entry_ptr->references) --_wlmtk_fill_cache_unused_entries;
+    }
+    bs_dllist_push_front(&_wlmtk_fill_cache_entries, &entry_ptr->dlnode);
+    ++entry_ptr->references;
+    return entry_ptr->gfxbuf_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_fill_cache_release(bs_gfxbuf_t *gfxbuf_ptr)
+{
+    for (bs_dllist_node_t *dlnode_ptr = _wlmtk_fill_cache_entries.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_fill_cache_entry_t *entry_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_fill_cache_entry_t, dlnode);
+        if (entry_ptr->gfxbuf_ptr != gfxbuf_ptr) continue;
+
+        BS_ASSERT(0 < entry_ptr->references);
+        if (0 < --entry_ptr->references) return;
+
+        // Last reference gone: Keep as most recent unused entry.
+        bs_dllist_remove(&_wlmtk_fill_cache_entries, &entry_ptr->dlnode);
+        bs_dllist_push_front(&_wlmtk_fill_cache_entries, &entry_ptr->dlnode);
+        ++_wlmtk_fill_cache_unused_entries;
+        _wlmtk_fill_cache_trim(_wlmtk_fill_cache_max_unused_entries);
+        return;
+    }
+    bs_log(BS_FATAL, "Buffer %p not found in fill cache.", gfxbuf_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_fill_cache_purge(void)
+{
+    _wlmtk_fill_cache_trim(0);
+}
+
+/* ------------------------------------------------------------------------- */
+size_t wlmtk_fill_cache_bytes(void)
+{
+    size_t bytes = 0;
+    for (bs_dllist_node_t *dlnode_ptr = _wlmtk_fill_cache_entries.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_fill_cache_entry_t *entry_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_fill_cache_entry_t, dlnode);
+        bytes += (size_t)entry_ptr->gfxbuf_ptr->pixels_per_line *
+            entry_ptr->gfxbuf_ptr->height * sizeof(uint32_t);
+    }
+    return bytes;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates a cache entry and renders the fill into it's buffer.
+ *
+ * @param fill_ptr
+ * @param width
+ * @param height
+ *
+ * @return Pointer to the entry, with no references, or NULL on error. Must
+ *     be destroyed by @ref _wlmtk_fill_cache_entry_destroy.
+ */
+wlmtk_fill_cache_entry_t *_wlmtk_fill_cache_entry_create(
+    const wlmtk_style_fill_t *fill_ptr,
+    unsigned width,
+    unsigned height)
+{
+    wlmtk_fill_cache_entry_t *entry_ptr = logged_calloc(
+        1, sizeof(wlmtk_fill_cache_entry_t));
+    if (NULL == entry_ptr) return NULL;
+    memcpy(&entry_ptr->fill, fill_ptr, sizeof(wlmtk_style_fill_t));
+
+    // Solid fills look the same at any width: Round up, for more re-use.
+    if (WLMTK_STYLE_COLOR_SOLID == fill_ptr->type) {
+        unsigned g = _wlmtk_fill_cache_solid_width_granularity;
+        width = BS_MAX(1u, (width + g - 1) / g) * g;
+    }
+
+    entry_ptr->gfxbuf_ptr = bs_gfxbuf_create(width, height);
+    if (NULL == entry_ptr->gfxbuf_ptr) {
+        _wlmtk_fill_cache_entry_destroy(entry_ptr);
+        return NULL;
+    }
+    cairo_t *cairo_ptr = cairo_create_from_bs_gfxbuf(entry_ptr->gfxbuf_ptr);
+    if (NULL == cairo_ptr) {
+        _wlmtk_fill_cache_entry_destroy(entry_ptr);
+        return NULL;
+    }
+    wlmaker_primitives_cairo_fill(cairo_ptr, fill_ptr);
+    cairo_destroy(cairo_ptr);
+    return entry_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroys the cache entry. Must not be in the list of entries. */
+void _wlmtk_fill_cache_entry_destroy(wlmtk_fill_cache_entry_t *entry_ptr)
+{
+    if (NULL != entry_ptr->gfxbuf_ptr) {
+        bs_gfxbuf_destroy(entry_ptr->gfxbuf_ptr);
+        entry_ptr->gfxbuf_ptr = NULL;
+    }
+    free(entry_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns whether the entry can serve a buffer for the given parameters.
+ *
+ * @param entry_ptr
+ * @param fill_ptr
+ * @param width
+ * @param height
+ *
+ * @return true if it matches.
+ */
+bool _wlmtk_fill_cache_entry_matches(
+    wlmtk_fill_cache_entry_t *entry_ptr,
+    const wlmtk_style_fill_t *fill_ptr,
+    unsigned width,
+    unsigned height)
+{
+    if (entry_ptr->fill.type != fill_ptr->type) return false;
+
+    // Solid fills and horizontal gradients do not vary vertically: Serve
+    // from taller buffers, too. Gradients stretch across the width, and
+    // diagonal gradients across both dimensions.
+    switch (fill_ptr->type) {
+    case WLMTK_STYLE_COLOR_SOLID:
+        return (entry_ptr->fill.param.solid.color ==
+                fill_ptr->param.solid.color &&
+                entry_ptr->gfxbuf_ptr->width >= width &&
+                entry_ptr->gfxbuf_ptr->height >= height);
+    case WLMTK_STYLE_COLOR_HGRADIENT:
+        return (entry_ptr->fill.param.hgradient.from ==
+                fill_ptr->param.hgradient.from &&
+                entry_ptr->fill.param.hgradient.to ==
+                fill_ptr->param.hgradient.to &&
+                entry_ptr->gfxbuf_ptr->width == width &&
+                entry_ptr->gfxbuf_ptr->height >= height);
+    case WLMTK_STYLE_COLOR_DGRADIENT:
+        return (entry_ptr->fill.param.dgradient.from ==
+                fill_ptr->param.dgradient.from &&
+                entry_ptr->fill.param.dgradient.to ==
+                fill_ptr->param.dgradient.to &&
+                entry_ptr->gfxbuf_ptr->width == width &&
+                entry_ptr->gfxbuf_ptr->height == height);
+    default:
+        break;
+    }
+    return false;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Destroys the least recently used unreferenced entries, until there are at
+ * most `max_unused` left.
+ *
+ * @param max_unused
+ */
+void _wlmtk_fill_cache_trim(size_t max_unused)
+{
+    bs_dllist_node_t *dlnode_ptr = _wlmtk_fill_cache_entries.tail_ptr;
+    while (_wlmtk_fill_cache_unused_entries > max_unused &&
+           NULL != dlnode_ptr) {
+        wlmtk_fill_cache_entry_t *entry_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_fill_cache_entry_t, dlnode);
+        dlnode_ptr = dlnode_ptr->prev_ptr;
+        if (0 < entry_ptr->references) continue;
+
+        bs_dllist_remove(&_wlmtk_fill_cache_entries, &entry_ptr->dlnode);
+        _wlmtk_fill_cache_entry_destroy(entry_ptr);
+        --_wlmtk_fill_cache_unused_entries;
+    }
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_acquire_release(bs_test_t *test_ptr);
+static void test_solid(bs_test_t *test_ptr);
+static void test_heights(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmtk_fill_cache_test_cases[] = {
+    { 1, "acquire_release", test_acquire_release },
+    { 1, "solid", test_solid },
+    { 1, "heights", test_heights },
+    { 0, NULL, NULL }
+};
+
+/** A horizontal gradient, for tests. */
+static const wlmtk_style_fill_t _test_hgradient = {
+    .type = WLMTK_STYLE_COLOR_HGRADIENT,
+    .param = { .hgradient = { .from = 0xff102040, .to = 0xff405060 }}
+};
+
+/* ------------------------------------------------------------------------- */
+/** Verifies buffers are shared by fill and size, and retained for re-use. */
+void test_acquire_release(bs_test_t *test_ptr)
+{
+    wlmtk_fill_cache_purge();
+    bs_gfxbuf_t *g1_ptr = wlmtk_fill_cache_acquire(&_test_hgradient, 100, 22);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, g1_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 100, g1_ptr->width);
+    BS_TEST_VERIFY_EQ(test_ptr, 22, g1_ptr->height);
+    BS_TEST_VERIFY_TRUE(test_ptr, 100 * 22 * 4 <= wlmtk_fill_cache_bytes());
+
+    // Same parameters: Same buffer.
+    bs_gfxbuf_t *g2_ptr = wlmtk_fill_cache_acquire(&_test_hgradient, 100, 22);
+    BS_TEST_VERIFY_EQ(test_ptr, g1_ptr, g2_ptr);
+
+    // A gradient stretches across the width: Needs a different buffer.
+    bs_gfxbuf_t *g3_ptr = wlmtk_fill_cache_acquire(&_test_hgradient, 90, 22);
+    BS_TEST_VERIFY_NEQ(test_ptr, g1_ptr, g3_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 90, g3_ptr->width);
+
+    // Different colors: Different buffer.
+    wlmtk_style_fill_t fill = _test_hgradient;
+    fill.param.hgradient.to = 0xff000000;
+    bs_gfxbuf_t *g4_ptr = wlmtk_fill_cache_acquire(&fill, 100, 22);
+    BS_TEST_VERIFY_NEQ(test_ptr, g1_ptr, g4_ptr);
+
+    wlmtk_fill_cache_release(g4_ptr);
+    wlmtk_fill_cache_release(g3_ptr);
+    wlmtk_fill_cache_release(g2_ptr);
+    wlmtk_fill_cache_release(g1_ptr);
+
+    // Unreferenced entries are kept, until purged.
+    BS_TEST_VERIFY_EQ(test_ptr, 3, _wlmtk_fill_cache_unused_entries);
+    g1_ptr = wlmtk_fill_cache_acquire(&_test_hgradient, 90, 22);
+    BS_TEST_VERIFY_EQ(test_ptr, g3_ptr, g1_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, _wlmtk_fill_cache_unused_entries);
+    wlmtk_fill_cache_release(g1_ptr);
+
+    wlmtk_fill_cache_purge();
+    BS_TEST_VERIFY_EQ(test_ptr, 0, _wlmtk_fill_cache_unused_entries);
+    BS_TEST_VERIFY_TRUE(test_ptr, bs_dllist_empty(&_wlmtk_fill_cache_entries));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_fill_cache_bytes());
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies that solid fills are shared across widths. */
+void test_solid(bs_test_t *test_ptr)
+{
+    wlmtk_fill_cache_purge();
+    wlmtk_style_fill_t fill = {
+        .type = WLMTK_STYLE_COLOR_SOLID,
+        .param = { .solid = { .color = 0xffc2c0c5 }}
+    };
+
+    bs_gfxbuf_t *g1_ptr = wlmtk_fill_cache_acquire(&fill, 100, 7);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, g1_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 256, g1_ptr->width);
+    BS_TEST_VERIFY_EQ(test_ptr, 7, g1_ptr->height);
+
+    bs_gfxbuf_t *g2_ptr = wlmtk_fill_cache_acquire(&fill, 200, 7);
+    BS_TEST_VERIFY_EQ(test_ptr, g1_ptr, g2_ptr);
+
+    bs_gfxbuf_t *g3_ptr = wlmtk_fill_cache_acquire(&fill, 300, 7);
+    BS_TEST_VERIFY_NEQ(test_ptr, g1_ptr, g3_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 512, g3_ptr->width);
+
+    bs_gfxbuf_t *g4_ptr = wlmtk_fill_cache_acquire(&fill, 300, 8);
+    BS_TEST_VERIFY_NEQ(test_ptr, g3_ptr, g4_ptr);
+
+    // A lower height is served from the taller buffer.
+    bs_gfxbuf_t *g5_ptr = wlmtk_fill_cache_acquire(&fill, 300, 5);
+    BS_TEST_VERIFY_EQ(test_ptr, g4_ptr, g5_ptr);
+
+    wlmtk_fill_cache_release(g5_ptr);
+    wlmtk_fill_cache_release(g4_ptr);
+    wlmtk_fill_cache_release(g3_ptr);
+    wlmtk_fill_cache_release(g2_ptr);
+    wlmtk_fill_cache_release(g1_ptr);
+    wlmtk_fill_cache_purge();
+    BS_TEST_VERIFY_TRUE(test_ptr, bs_dllist_empty(&_wlmtk_fill_cache_entries));
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies horizontal gradients are shared across heights, not diagonals. */
+void test_heights(bs_test_t *test_ptr)
+{
+    wlmtk_fill_cache_purge();
+    bs_gfxbuf_t *g1_ptr = wlmtk_fill_cache_acquire(&_test_hgradient, 100, 22);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, g1_ptr);
+
+    // Lower: Served from the taller buffer. Taller: Needs its own.
+    bs_gfxbuf_t *g2_ptr = wlmtk_fill_cache_acquire(&_test_hgradient, 100, 7);
+    BS_TEST_VERIFY_EQ(test_ptr, g1_ptr, g2_ptr);
+    bs_gfxbuf_t *g3_ptr = wlmtk_fill_cache_acquire(&_test_hgradient, 100, 30);
+    BS_TEST_VERIFY_NEQ(test_ptr, g1_ptr, g3_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 30, g3_ptr->height);
+
+    // The sub-area matches a rendering of the lower height.
+    bs_gfxbuf_t *gfxbuf_ptr = bs_gfxbuf_create(100, 7);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, gfxbuf_ptr);
+    cairo_t *cairo_ptr = cairo_create_from_bs_gfxbuf(gfxbuf_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, cairo_ptr);
+    wlmaker_primitives_cairo_fill(cairo_ptr, &_test_hgradient);
+    cairo_destroy(cairo_ptr);
+    for (unsigned y = 0; y < gfxbuf_ptr->height; ++y) {
+        BS_TEST_VERIFY_MEMEQ(
+            test_ptr,
+            &gfxbuf_ptr->data_ptr[y * gfxbuf_ptr->pixels_per_line],
+            &g2_ptr->data_ptr[y * g2_ptr->pixels_per_line],
+            gfxbuf_ptr->width * sizeof(uint32_t));
+    }
+    bs_gfxbuf_destroy(gfxbuf_ptr);
+
+    // A diagonal gradient stretches across the height, too.
+    wlmtk_style_fill_t fill = _test_hgradient;
+    fill.type = WLMTK_STYLE_COLOR_DGRADIENT;
+    bs_gfxbuf_t *g4_ptr = wlmtk_fill_cache_acquire(&fill, 100, 22);
+    bs_gfxbuf_t *g5_ptr = wlmtk_fill_cache_acquire(&fill, 100, 7);
+    BS_TEST_VERIFY_NEQ(test_ptr, g4_ptr, g5_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 7, g5_ptr->height);
+
+    wlmtk_fill_cache_release(g5_ptr);
+    wlmtk_fill_cache_release(g4_ptr);
+    wlmtk_fill_cache_release(g3_ptr);
+    wlmtk_fill_cache_release(g2_ptr);
+    wlmtk_fill_cache_release(g1_ptr);
+    wlmtk_fill_cache_purge();
+}
+
+/* == End of fill_cache.c ================================================== */
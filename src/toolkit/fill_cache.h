@@ -0,0 +1,78 @@
+/* ========================================================================= */
+/**
+ * @file fill_cache.h
+ *
+ * @copyright
+ * Copyright 2024 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMTK_FILL_CACHE_H__
+#define __WLMTK_FILL_CACHE_H__
+
+#include <libbase/libbase.h>
+
+#include "style.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Acquires a graphics buffer filled with `fill_ptr`, from a shared cache.
+ *
+ * Buffers are shared between all callers asking for the same fill and size,
+ * and must not be modified. For fills that do not vary horizontally (solid
+ * fills), the buffer may be wider than requested, and is shared with all
+ * callers requiring a width up to the buffer's width. Likewise for fills that
+ * do not vary vertically (solid fills and horizontal gradients), where the
+ * buffer may be taller than requested. Callers copy the sub-area they need.
+ *
+ * @param fill_ptr
+ * @param width
+ * @param height
+ *
+ * @return Pointer to a graphics buffer of at least `width` and `height`, or
+ *     NULL on error. Must be released by @ref wlmtk_fill_cache_release.
+ */
+bs_gfxbuf_t *wlmtk_fill_cache_acquire(
+    const wlmtk_style_fill_t *fill_ptr,
+    unsigned width,
+    unsigned height);
+
+/**
+ * Releases a reference to a graphics buffer obtained from
+ * @ref wlmtk_fill_cache_acquire.
+ *
+ * Buffers are kept for a while after the last reference is released, for
+ * re-use by subsequent calls to @ref wlmtk_fill_cache_acquire.
+ *
+ * @param gfxbuf_ptr
+ */
+void wlmtk_fill_cache_release(bs_gfxbuf_t *gfxbuf_ptr);
+
+/** Destroys all cached buffers that are no longer referenced. */
+void wlmtk_fill_cache_purge(void);
+
+/** @return Bytes of pixel memory held by the cache's buffers. */
+size_t wlmtk_fill_cache_bytes(void);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmtk_fill_cache_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMTK_FILL_CACHE_H__ */
+/* == End of fill_cache.h ================================================== */
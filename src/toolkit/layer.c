@@ -42,8 +42,16 @@ struct _wlmtk_layer_t {
 
     /** Panels, holds nodes at @ref wlmtk_panel_t::dlnode. */
     bs_dllist_t               panels;
+
+    /** Event loop for deferring reconfiguration. NULL to run it at once. */
+    struct wl_event_loop      *wl_event_loop_ptr;
+    /** Idle source of a scheduled reconfiguration, or NULL if none. */
+    struct wl_event_source    *idle_event_source_ptr;
 };
 
+static void _wlmtk_layer_handle_idle(void *data_ptr);
+static void _wlmtk_layer_reconfigure_now(wlmtk_layer_t *layer_ptr);
+
 /* == Exported methods ===================================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -56,6 +64,7 @@ wlmtk_layer_t *wlmtk_layer_create(wlmtk_env_t *env_ptr)
         wlmtk_layer_destroy(layer_ptr);
         return NULL;
     }
+    layer_ptr->wl_event_loop_ptr = wlmtk_env_wl_event_loop(env_ptr);
 
     return layer_ptr;
 }
@@ -63,6 +72,10 @@ wlmtk_layer_t *wlmtk_layer_create(wlmtk_env_t *env_ptr)
 /* ------------------------------------------------------------------------- */
 void wlmtk_layer_destroy(wlmtk_layer_t *layer_ptr)
 {
+    if (NULL != layer_ptr->idle_event_source_ptr) {
+        wl_event_source_remove(layer_ptr->idle_event_source_ptr);
+        layer_ptr->idle_event_source_ptr = NULL;
+    }
     wlmtk_container_fini(&layer_ptr->super_container);
     free(layer_ptr);
 }
@@ -106,6 +119,59 @@ void wlmtk_layer_remove_panel(wlmtk_layer_t *layer_ptr,
 /* ------------------------------------------------------------------------- */
 void wlmtk_layer_reconfigure(wlmtk_layer_t *layer_ptr)
 {
+    // Already scheduled? Then this request is covered.
+    if (NULL != layer_ptr->idle_event_source_ptr) return;
+
+    if (NULL != layer_ptr->wl_event_loop_ptr) {
+        layer_ptr->idle_event_source_ptr = wl_event_loop_add_idle(
+            layer_ptr->wl_event_loop_ptr,
+            _wlmtk_layer_handle_idle,
+            layer_ptr);
+        if (NULL != layer_ptr->idle_event_source_ptr) return;
+        bs_log(BS_WARNING, "Failed wl_event_loop_add_idle(%p, ...)",
+               layer_ptr->wl_event_loop_ptr);
+    }
+
+    _wlmtk_layer_reconfigure_now(layer_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_layer_set_workspace(wlmtk_layer_t *layer_ptr,
+                               wlmtk_workspace_t *workspace_ptr)
+{
+    layer_ptr->workspace_ptr = workspace_ptr;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Callback for the idle event source: Runs the scheduled reconfiguration.
+ *
+ * @param data_ptr            Points to the @ref wlmtk_layer_t.
+ */
+void _wlmtk_layer_handle_idle(void *data_ptr)
+{
+    wlmtk_layer_t *layer_ptr = data_ptr;
+
+    // Idle sources are removed by the event loop once dispatched.
+    layer_ptr->idle_event_source_ptr = NULL;
+    _wlmtk_layer_reconfigure_now(layer_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Computes dimensions of each panel, and applies them through
+ * @ref wlmtk_panel_configure. Panels with unchanged size will not be asked
+ * to resize.
+ *
+ * @param layer_ptr
+ */
+void _wlmtk_layer_reconfigure_now(wlmtk_layer_t *layer_ptr)
+{
+    // Guard clause: Layer is not (or no longer) part of a workspace.
+    if (NULL == layer_ptr->workspace_ptr) return;
+
     struct wlr_box extents = wlmtk_workspace_get_fullscreen_extents(
         layer_ptr->workspace_ptr);
     struct wlr_box usable_area = extents;
@@ -123,34 +189,20 @@ void wlmtk_layer_reconfigure(wlmtk_layer_t *layer_ptr)
             usable_area = new_usable_area;
         }
 
-        wlmtk_panel_request_size(
-            panel_ptr,
-            panel_dimensions.width,
-            panel_dimensions.height);
-        wlmtk_element_set_position(
-            wlmtk_panel_element(panel_ptr),
-            panel_dimensions.x,
-            panel_dimensions.y);
+        wlmtk_panel_configure(panel_ptr, &panel_dimensions);
     }
 }
 
-/* ------------------------------------------------------------------------- */
-void wlmtk_layer_set_workspace(wlmtk_layer_t *layer_ptr,
-                               wlmtk_workspace_t *workspace_ptr)
-{
-    layer_ptr->workspace_ptr = workspace_ptr;
-}
-
-/* == Local (static) methods =============================================== */
-
 /* == Unit tests =========================================================== */
 
 static void test_add_remove(bs_test_t *test_ptr);
 static void test_layout(bs_test_t *test_ptr);
+static void test_reconfigure(bs_test_t *test_ptr);
 
 const bs_test_case_t wlmtk_layer_test_cases[] = {
     { 1, "add_remove", test_add_remove },
     { 1, "layout", test_layout },
+    { 1, "reconfigure", test_reconfigure },
     { 0, NULL, NULL }
 };
 
@@ -215,6 +267,7 @@ void test_layout(bs_test_t *test_ptr)
     wlmtk_element_set_visible(wlmtk_panel_element(&fp1_ptr->panel), true);
 
     wlmtk_layer_add_panel(layer_ptr, &fp1_ptr->panel);
+    wlmtk_panel_commit(&fp1_ptr->panel, 0, &fp1_ptr->panel.positioning);
     BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_panel_element(&fp1_ptr->panel)->x);
     BS_TEST_VERIFY_EQ(test_ptr, 359, wlmtk_panel_element(&fp1_ptr->panel)->y);
     BS_TEST_VERIFY_EQ(test_ptr, 100, fp1_ptr->requested_width);
@@ -228,6 +281,7 @@ void test_layout(bs_test_t *test_ptr)
     wlmtk_element_set_visible(wlmtk_panel_element(&fp2_ptr->panel), false);
     BS_ASSERT_NOTNULL(fp2_ptr);
     wlmtk_layer_add_panel(layer_ptr, &fp2_ptr->panel);
+    wlmtk_panel_commit(&fp2_ptr->panel, 0, &fp2_ptr->panel.positioning);
     BS_TEST_VERIFY_EQ(test_ptr, 40, wlmtk_panel_element(&fp2_ptr->panel)->x);
     BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_panel_element(&fp2_ptr->panel)->y);
     BS_TEST_VERIFY_EQ(test_ptr, 100, fp2_ptr->requested_width);
@@ -238,6 +292,7 @@ void test_layout(bs_test_t *test_ptr)
     wlmtk_element_set_visible(wlmtk_panel_element(&fp3_ptr->panel), true);
     BS_ASSERT_NOTNULL(fp3_ptr);
     wlmtk_layer_add_panel(layer_ptr, &fp3_ptr->panel);
+    wlmtk_panel_commit(&fp3_ptr->panel, 0, &fp3_ptr->panel.positioning);
     BS_TEST_VERIFY_EQ(test_ptr, 40, wlmtk_panel_element(&fp3_ptr->panel)->x);
     BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_panel_element(&fp3_ptr->panel)->y);
     BS_TEST_VERIFY_EQ(test_ptr, 100, fp3_ptr->requested_width);
@@ -257,4 +312,64 @@ void test_layout(bs_test_t *test_ptr)
     wlmtk_layer_destroy(layer_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Verifies panels are only resized on change, and moved once committed. */
+void test_reconfigure(bs_test_t *test_ptr)
+{
+    wlmtk_layer_t *layer_ptr = BS_ASSERT_NOTNULL(wlmtk_layer_create(NULL));
+    wlmtk_fake_workspace_t *fake_workspace_ptr = BS_ASSERT_NOTNULL(
+        wlmtk_fake_workspace_create(1024, 768));
+    wlmtk_layer_set_workspace(layer_ptr, fake_workspace_ptr->workspace_ptr);
+
+    wlmtk_panel_positioning_t pos = {
+        .desired_width = 100,
+        .desired_height = 50,
+        .anchor = WLR_EDGE_LEFT | WLR_EDGE_TOP
+    };
+    wlmtk_fake_panel_t *fp_ptr = BS_ASSERT_NOTNULL(
+        wlmtk_fake_panel_create(&pos));
+    wlmtk_element_t *element_ptr = wlmtk_panel_element(&fp_ptr->panel);
+    wlmtk_element_set_position(element_ptr, 1, 2);
+    fp_ptr->serial = 42;
+
+    // Adding requests the size. Position is pending the commit of serial.
+    wlmtk_layer_add_panel(layer_ptr, &fp_ptr->panel);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, fp_ptr->request_size_calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, element_ptr->x);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, element_ptr->y);
+    wlmtk_panel_commit(&fp_ptr->panel, 41, &pos);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, element_ptr->x);
+    wlmtk_panel_commit(&fp_ptr->panel, 42, &pos);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, element_ptr->x);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, element_ptr->y);
+
+    // Unchanged geometry: No further size request.
+    wlmtk_layer_reconfigure(layer_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, fp_ptr->request_size_calls);
+
+    // Position-only change: Applied right away, without size request.
+    pos.margin_left = 10;
+    wlmtk_panel_commit(&fp_ptr->panel, 42, &pos);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, fp_ptr->request_size_calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 10, element_ptr->x);
+
+    // Size change: Requested, and position waits for the new serial.
+    pos.desired_width = 200;
+    pos.margin_left = 20;
+    fp_ptr->serial = 43;
+    wlmtk_panel_commit(&fp_ptr->panel, 42, &pos);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, fp_ptr->request_size_calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 200, fp_ptr->requested_width);
+    BS_TEST_VERIFY_EQ(test_ptr, 10, element_ptr->x);
+    wlmtk_panel_commit(&fp_ptr->panel, 43, &pos);
+    BS_TEST_VERIFY_EQ(test_ptr, 20, element_ptr->x);
+
+    wlmtk_layer_remove_panel(layer_ptr, &fp_ptr->panel);
+    wlmtk_fake_panel_destroy(fp_ptr);
+
+    wlmtk_layer_set_workspace(layer_ptr, NULL);
+    wlmtk_fake_workspace_destroy(fake_workspace_ptr);
+    wlmtk_layer_destroy(layer_ptr);
+}
+
 /* == End of layer.c ======================================================= */
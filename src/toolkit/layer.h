@@ -78,6 +78,11 @@ void wlmtk_layer_remove_panel(wlmtk_layer_t *layer_ptr,
  * the panels in sequence as they were added (found in the container, back
  * to front).
  *
+ * If the layer's environment provides an event loop, the computation is
+ * deferred to the next idle pass, and multiple calls before then result in
+ * a single pass. Panels are asked to resize only if their size changed.
+ * Without event loop (eg. in tests), this runs right away.
+ *
  * @param layer_ptr
  */
 void wlmtk_layer_reconfigure(wlmtk_layer_t *layer_ptr);
@@ -106,6 +106,10 @@ void wlmtk_panel_set_layer(wlmtk_panel_t *panel_ptr,
     // only if one is set.
     BS_ASSERT((NULL == layer_ptr) != (NULL == panel_ptr->layer_ptr));
     panel_ptr->layer_ptr = layer_ptr;
+
+    // A panel (re)added to a layer must receive a size request.
+    panel_ptr->configured = false;
+    panel_ptr->position_pending = false;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -114,15 +118,51 @@ wlmtk_layer_t *wlmtk_panel_get_layer(wlmtk_panel_t *panel_ptr)
     return panel_ptr->layer_ptr;
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmtk_panel_configure(
+    wlmtk_panel_t *panel_ptr,
+    const struct wlr_box *dimensions_ptr)
+{
+    if (!panel_ptr->configured ||
+        panel_ptr->configured_width != dimensions_ptr->width ||
+        panel_ptr->configured_height != dimensions_ptr->height) {
+        panel_ptr->configured = true;
+        panel_ptr->configured_width = dimensions_ptr->width;
+        panel_ptr->configured_height = dimensions_ptr->height;
+        panel_ptr->pending_serial = wlmtk_panel_request_size(
+            panel_ptr, dimensions_ptr->width, dimensions_ptr->height);
+        panel_ptr->position_pending = true;
+    }
+
+    if (panel_ptr->position_pending) {
+        // Still waiting for the size to be committed. Update the target.
+        panel_ptr->pending_x = dimensions_ptr->x;
+        panel_ptr->pending_y = dimensions_ptr->y;
+        return;
+    }
+
+    wlmtk_element_set_position(
+        wlmtk_panel_element(panel_ptr),
+        dimensions_ptr->x,
+        dimensions_ptr->y);
+}
+
 /* ------------------------------------------------------------------------- */
 void wlmtk_panel_commit(
     wlmtk_panel_t *panel_ptr,
-    __UNUSED__ uint32_t serial,
+    uint32_t serial,
     const wlmtk_panel_positioning_t *positioning_ptr)
 {
-    // TODO(kaeser@gubbe.ch): Make use of `serial` and only update the
-    // element's position once this matches the corresponding call to
-    // @ref wlmtk_panel_request_size.
+    // Apply the position once the requested size got committed. Serials may
+    // wrap, hence compare through the signed difference.
+    if (panel_ptr->position_pending &&
+        0 <= (int32_t)(serial - panel_ptr->pending_serial)) {
+        panel_ptr->position_pending = false;
+        wlmtk_element_set_position(
+            wlmtk_panel_element(panel_ptr),
+            panel_ptr->pending_x,
+            panel_ptr->pending_y);
+    }
 
     // Guard clause: No updates, nothing more to do.
     if (0 == memcmp(
@@ -270,6 +310,7 @@ uint32_t _wlmtk_fake_panel_request_size(
         panel_ptr, wlmtk_fake_panel_t, panel);
     fake_panel_ptr->requested_width = width;
     fake_panel_ptr->requested_height = height;
+    ++fake_panel_ptr->request_size_calls;
     return fake_panel_ptr->serial;
 }
 
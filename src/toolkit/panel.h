@@ -98,6 +98,22 @@ struct _wlmtk_panel_t {
 
     /** Positioning parameters. */
     wlmtk_panel_positioning_t positioning;
+
+    /** Whether a size was requested since the panel was added to a layer. */
+    bool                      configured;
+    /** Width of the last call to @ref wlmtk_panel_request_size. */
+    int                       configured_width;
+    /** Height of the last call to @ref wlmtk_panel_request_size. */
+    int                       configured_height;
+
+    /** Whether a position awaits the commit of `pending_serial`. */
+    bool                      position_pending;
+    /** Serial returned from the last @ref wlmtk_panel_request_size. */
+    uint32_t                  pending_serial;
+    /** Horizontal position to apply once `pending_serial` is committed. */
+    int                       pending_x;
+    /** Vertical position to apply once `pending_serial` is committed. */
+    int                       pending_y;
 };
 
 /**
@@ -163,9 +179,29 @@ static inline uint32_t wlmtk_panel_request_size(
     return panel_ptr->vmt.request_size(panel_ptr, width, height);
 }
 
+/**
+ * Applies the dimensions computed by the layer to the panel.
+ *
+ * Requests a new size only if it differs from the last requested size. If a
+ * new size is requested, the position is applied once the panel commits the
+ * corresponding serial, so the panel does not move before it is resized.
+ * Otherwise, the position is applied right away.
+ *
+ * @protected This method must only be called from @ref wlmtk_layer_t.
+ *
+ * @param panel_ptr
+ * @param dimensions_ptr
+ */
+void wlmtk_panel_configure(
+    wlmtk_panel_t *panel_ptr,
+    const struct wlr_box *dimensions_ptr);
+
 /**
  * Reports a commit for the given serial, and updates positioning.
  *
+ * A position that is pending on a size request will be applied, if `serial`
+ * is at or past the serial returned from that request.
+ *
  * @param panel_ptr
  * @param serial
  * @param positioning_ptr
@@ -209,6 +245,8 @@ struct _wlmtk_fake_panel_t {
     int                       requested_width;
     /** `height` argument of last @ref wlmtk_content_request_size call. */
     int                       requested_height;
+    /** Number of @ref wlmtk_panel_request_size calls. */
+    int                       request_size_calls;
 };
 /** Creates a fake panel, for tests. */
 wlmtk_fake_panel_t *wlmtk_fake_panel_create(
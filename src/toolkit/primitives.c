@@ -22,6 +22,11 @@
 
 #include <libbase/libbase.h>
 
+/* == Data ================================================================= */
+
+const double wlmaker_primitives_window_title_x = 6;
+const double wlmaker_primitives_window_title_y = 17;
+
 /* == Exported methods ===================================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -201,15 +206,38 @@ void wlmaker_primitives_draw_window_title(
     uint32_t color)
 {
     cairo_save(cairo_ptr);
+    wlmaker_primitives_set_window_title_font(cairo_ptr);
+    cairo_set_source_argb8888(cairo_ptr, color);
+
+    cairo_move_to(
+        cairo_ptr,
+        wlmaker_primitives_window_title_x,
+        wlmaker_primitives_window_title_y);
+    cairo_show_text(cairo_ptr, title_ptr ? title_ptr : "Unnamed");
+    cairo_restore(cairo_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_primitives_set_window_title_font(cairo_t *cairo_ptr)
+{
     cairo_select_font_face(
         cairo_ptr, "Helvetica",
         CAIRO_FONT_SLANT_NORMAL,
         CAIRO_FONT_WEIGHT_BOLD);
     cairo_set_font_size(cairo_ptr, 15.0);
-    cairo_set_source_argb8888(cairo_ptr, color);
+}
 
-    cairo_move_to(cairo_ptr, 6, 17);
-    cairo_show_text(cairo_ptr, title_ptr ? title_ptr : "Unnamed");
+/* ------------------------------------------------------------------------- */
+void wlmaker_primitives_draw_window_title_glyphs(
+    cairo_t *cairo_ptr,
+    const cairo_glyph_t *glyphs_ptr,
+    int num_glyphs,
+    uint32_t color)
+{
+    cairo_save(cairo_ptr);
+    wlmaker_primitives_set_window_title_font(cairo_ptr);
+    cairo_set_source_argb8888(cairo_ptr, color);
+    cairo_show_glyphs(cairo_ptr, glyphs_ptr, num_glyphs);
     cairo_restore(cairo_ptr);
 }
 
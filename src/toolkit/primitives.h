@@ -139,6 +139,37 @@ void wlmaker_primitives_draw_window_title(
     const char *title_ptr,
     uint32_t color);
 
+/**
+ * Selects the font face and size used for the window title.
+ *
+ * @param cairo_ptr
+ */
+void wlmaker_primitives_set_window_title_font(cairo_t *cairo_ptr);
+
+/**
+ * Draws pre-computed glyphs of a window title into the `cairo_t`.
+ *
+ * @param cairo_ptr
+ * @param glyphs_ptr          Glyphs, as from `cairo_scaled_font_text_to_glyphs`
+ *                            with the font selected by
+ *                            @ref wlmaker_primitives_set_window_title_font,
+ *                            positioned relative to
+ *                            @ref wlmaker_primitives_window_title_x and
+ *                            @ref wlmaker_primitives_window_title_y.
+ * @param num_glyphs
+ * @param color               As an ARGB 8888 value.
+ */
+void wlmaker_primitives_draw_window_title_glyphs(
+    cairo_t *cairo_ptr,
+    const cairo_glyph_t *glyphs_ptr,
+    int num_glyphs,
+    uint32_t color);
+
+/** Horizontal position of the window title's text origin. */
+extern const double wlmaker_primitives_window_title_x;
+/** Vertical position of the window title's baseline. */
+extern const double wlmaker_primitives_window_title_y;
+
 /** Unit tests. */
 extern const bs_test_case_t   wlmaker_primitives_test_cases[];
 
@@ -119,6 +119,7 @@ void wlmtk_rectangle_set_size(
 {
     rectangle_ptr->width = width;
     rectangle_ptr->height = height;
+    wlmtk_element_invalidate_bounds(&rectangle_ptr->super_element);
 
     if (NULL != rectangle_ptr->wlr_scene_rect_ptr) {
         wlr_scene_rect_set_size(
@@ -22,9 +22,11 @@
 
 #include "box.h"
 #include "buffer.h"
+#include "fill_cache.h"
 #include "gfxbuf.h"
 #include "primitives.h"
 #include "resizebar_area.h"
+#include "trace.h"
 
 #include <libbase/libbase.h>
 
@@ -45,7 +47,7 @@ struct _wlmtk_resizebar_t {
     /** Style of the resize bar. */
     wlmtk_resizebar_style_t   style;
 
-    /** Background. */
+    /** Background. From the fill cache, may be wider than `width`. */
     bs_gfxbuf_t               *gfxbuf_ptr;
 
     /** Left element of the resizebar. */
@@ -151,7 +153,7 @@ void wlmtk_resizebar_destroy(wlmtk_resizebar_t *resizebar_ptr)
     }
 
     if (NULL != resizebar_ptr->gfxbuf_ptr) {
-        bs_gfxbuf_destroy(resizebar_ptr->gfxbuf_ptr);
+        wlmtk_fill_cache_release(resizebar_ptr->gfxbuf_ptr);
         resizebar_ptr->gfxbuf_ptr = NULL;
     }
 
@@ -167,7 +169,7 @@ bool wlmtk_resizebar_set_width(
     if (resizebar_ptr->width == width) return true;
     if (!redraw_buffers(resizebar_ptr, width)) return false;
     BS_ASSERT(width == resizebar_ptr->width);
-    BS_ASSERT(width == resizebar_ptr->gfxbuf_ptr->width);
+    BS_ASSERT(width <= resizebar_ptr->gfxbuf_ptr->width);
 
     int right_corner_width = BS_MIN(
         (int)width, (int)resizebar_ptr->style.corner_width);
@@ -235,21 +237,13 @@ void _wlmtk_resizebar_element_destroy(wlmtk_element_t *element_ptr)
 /** Redraws the resizebar's background in appropriate size. */
 bool redraw_buffers(wlmtk_resizebar_t *resizebar_ptr, unsigned width)
 {
-    cairo_t *cairo_ptr;
-
-    bs_gfxbuf_t *gfxbuf_ptr = bs_gfxbuf_create(
-        width, resizebar_ptr->style.height);
+    WLMTK_TRACE_SCOPE("resizebar_redraw_buffers");
+    bs_gfxbuf_t *gfxbuf_ptr = wlmtk_fill_cache_acquire(
+        &resizebar_ptr->style.fill, width, resizebar_ptr->style.height);
     if (NULL == gfxbuf_ptr) return false;
-    cairo_ptr = cairo_create_from_bs_gfxbuf(gfxbuf_ptr);
-    if (NULL == cairo_ptr) {
-        bs_gfxbuf_destroy(gfxbuf_ptr);
-        return false;
-    }
-    wlmaker_primitives_cairo_fill(cairo_ptr, &resizebar_ptr->style.fill);
-    cairo_destroy(cairo_ptr);
 
     if (NULL != resizebar_ptr->gfxbuf_ptr) {
-        bs_gfxbuf_destroy(resizebar_ptr->gfxbuf_ptr);
+        wlmtk_fill_cache_release(resizebar_ptr->gfxbuf_ptr);
     }
     resizebar_ptr->gfxbuf_ptr = gfxbuf_ptr;
     resizebar_ptr->width = width;
@@ -0,0 +1,421 @@
+/* ========================================================================= */
+/**
+ * @file spatial_index.c
+ *
+ * @copyright
+ * Copyright 2024 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "spatial_index.h"
+
+#include <math.h>
+
+/* == Declarations ========================================================= */
+
+/**
+ * Upper bound for the number of grid cells. If the items span a larger area,
+ * the cell size is doubled until the grid fits.
+ */
+static const size_t           _wlmtk_spatial_index_max_cells = 4096;
+
+/** State of the spatial index. */
+struct _wlmtk_spatial_index_t {
+    /** Preferred cell size, as provided to the ctor. */
+    int                       preferred_cell_size;
+
+    /** Items, in order of @ref wlmtk_spatial_index_add. */
+    wlmtk_spatial_index_item_t *items_ptr;
+    /** Number of items in `items_ptr`. */
+    size_t                    items;
+    /** Allocated capacity of `items_ptr`. */
+    size_t                    items_capacity;
+
+    /** Whether the grid was built from the current set of items. */
+    bool                      built;
+    /** Cell size used for the current grid. */
+    int                       cell_size;
+    /** Position of the grid's top-left corner. */
+    int                       origin_x;
+    /** Position of the grid's top-left corner. */
+    int                       origin_y;
+    /** Number of grid columns. */
+    int                       columns;
+    /** Number of grid rows. */
+    int                       rows;
+
+    /**
+     * Offsets into `entries_ptr`, one per cell plus a trailing one. Cell `i`
+     * holds the entries [cell_offsets_ptr[i], cell_offsets_ptr[i + 1]).
+     */
+    size_t                    *cell_offsets_ptr;
+    /** Allocated capacity of `cell_offsets_ptr`. */
+    size_t                    cell_offsets_capacity;
+    /** Item pointers, grouped by cell. */
+    const wlmtk_spatial_index_item_t **entries_ptr;
+    /** Allocated capacity of `entries_ptr`. */
+    size_t                    entries_capacity;
+};
+
+static bool _wlmtk_spatial_index_reserve(
+    void **array_ptr_ptr,
+    size_t *capacity_ptr,
+    size_t required,
+    size_t element_size);
+static void _wlmtk_spatial_index_cell_range(
+    wlmtk_spatial_index_t *index_ptr,
+    const struct wlr_box *box_ptr,
+    int *col1_ptr, int *row1_ptr,
+    int *col2_ptr, int *row2_ptr);
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlmtk_spatial_index_t *wlmtk_spatial_index_create(int cell_size)
+{
+    BS_ASSERT(0 < cell_size);
+    wlmtk_spatial_index_t *index_ptr = logged_calloc(
+        1, sizeof(wlmtk_spatial_index_t));
+    if (NULL == index_ptr) return NULL;
+    index_ptr->preferred_cell_size = cell_size;
+    return index_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_spatial_index_destroy(wlmtk_spatial_index_t *index_ptr)
+{
+    if (NULL != index_ptr->entries_ptr) {
+        free(index_ptr->entries_ptr);
+        index_ptr->entries_ptr = NULL;
+    }
+    if (NULL != index_ptr->cell_offsets_ptr) {
+        free(index_ptr->cell_offsets_ptr);
+        index_ptr->cell_offsets_ptr = NULL;
+    }
+    if (NULL != index_ptr->items_ptr) {
+        free(index_ptr->items_ptr);
+        index_ptr->items_ptr = NULL;
+    }
+    free(index_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_spatial_index_clear(wlmtk_spatial_index_t *index_ptr)
+{
+    index_ptr->items = 0;
+    index_ptr->built = false;
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_spatial_index_add(
+    wlmtk_spatial_index_t *index_ptr,
+    void *data_ptr,
+    const struct wlr_box *box_ptr)
+{
+    if (!_wlmtk_spatial_index_reserve(
+            (void**)&index_ptr->items_ptr,
+            &index_ptr->items_capacity,
+            index_ptr->items + 1,
+            sizeof(wlmtk_spatial_index_item_t))) return false;
+
+    wlmtk_spatial_index_item_t *item_ptr =
+        &index_ptr->items_ptr[index_ptr->items++];
+    item_ptr->data_ptr = data_ptr;
+    item_ptr->box = *box_ptr;
+    index_ptr->built = false;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_spatial_index_build(wlmtk_spatial_index_t *index_ptr)
+{
+    // Bounds of all non-empty items.
+    int x1 = INT32_MAX, y1 = INT32_MAX, x2 = INT32_MIN, y2 = INT32_MIN;
+    for (size_t i = 0; i < index_ptr->items; ++i) {
+        const struct wlr_box *box_ptr = &index_ptr->items_ptr[i].box;
+        if (0 >= box_ptr->width || 0 >= box_ptr->height) continue;
+        x1 = BS_MIN(x1, box_ptr->x);
+        y1 = BS_MIN(y1, box_ptr->y);
+        x2 = BS_MAX(x2, box_ptr->x + box_ptr->width);
+        y2 = BS_MAX(y2, box_ptr->y + box_ptr->height);
+    }
+    if (x1 >= x2 || y1 >= y2) { x1 = 0; y1 = 0; x2 = 0; y2 = 0; }
+
+    // Pick a cell size such that the grid stays within bounds.
+    int64_t cell_size = index_ptr->preferred_cell_size;
+    int64_t columns, rows;
+    while (true) {
+        columns = ((int64_t)x2 - x1 + cell_size - 1) / cell_size;
+        rows = ((int64_t)y2 - y1 + cell_size - 1) / cell_size;
+        if ((uint64_t)(columns * rows) <=
+            _wlmtk_spatial_index_max_cells) break;
+        cell_size *= 2;
+    }
+    index_ptr->cell_size = cell_size;
+    index_ptr->origin_x = x1;
+    index_ptr->origin_y = y1;
+    index_ptr->columns = columns;
+    index_ptr->rows = rows;
+    size_t cells = columns * rows;
+
+    // First pass: Count the entries of each cell.
+    if (!_wlmtk_spatial_index_reserve(
+            (void**)&index_ptr->cell_offsets_ptr,
+            &index_ptr->cell_offsets_capacity,
+            cells + 1,
+            sizeof(size_t))) goto error;
+    memset(index_ptr->cell_offsets_ptr, 0, (cells + 1) * sizeof(size_t));
+    for (size_t i = 0; i < index_ptr->items; ++i) {
+        const struct wlr_box *box_ptr = &index_ptr->items_ptr[i].box;
+        if (0 >= box_ptr->width || 0 >= box_ptr->height) continue;
+        int col1, row1, col2, row2;
+        _wlmtk_spatial_index_cell_range(
+            index_ptr, box_ptr, &col1, &row1, &col2, &row2);
+        for (int row = row1; row <= row2; ++row) {
+            for (int col = col1; col <= col2; ++col) {
+                // Counts go into the *next* slot, for the prefix sum below.
+                index_ptr->cell_offsets_ptr[row * columns + col + 1]++;
+            }
+        }
+    }
+    for (size_t cell = 0; cell < cells; ++cell) {
+        index_ptr->cell_offsets_ptr[cell + 1] +=
+            index_ptr->cell_offsets_ptr[cell];
+    }
+
+    // Second pass: Fill the entries. Uses the offsets as insertion cursors,
+    // which leaves each at the *end* of the cell. Restored further below.
+    if (!_wlmtk_spatial_index_reserve(
+            (void**)&index_ptr->entries_ptr,
+            &index_ptr->entries_capacity,
+            index_ptr->cell_offsets_ptr[cells],
+            sizeof(wlmtk_spatial_index_item_t*))) goto error;
+    for (size_t i = 0; i < index_ptr->items; ++i) {
+        const struct wlr_box *box_ptr = &index_ptr->items_ptr[i].box;
+        if (0 >= box_ptr->width || 0 >= box_ptr->height) continue;
+        int col1, row1, col2, row2;
+        _wlmtk_spatial_index_cell_range(
+            index_ptr, box_ptr, &col1, &row1, &col2, &row2);
+        for (int row = row1; row <= row2; ++row) {
+            for (int col = col1; col <= col2; ++col) {
+                size_t *offset_ptr =
+                    &index_ptr->cell_offsets_ptr[row * columns + col];
+                index_ptr->entries_ptr[(*offset_ptr)++] =
+                    &index_ptr->items_ptr[i];
+            }
+        }
+    }
+    for (size_t cell = cells; cell > 0; --cell) {
+        index_ptr->cell_offsets_ptr[cell] =
+            index_ptr->cell_offsets_ptr[cell - 1];
+    }
+    index_ptr->cell_offsets_ptr[0] = 0;
+
+    index_ptr->built = true;
+    return true;
+
+error:
+    wlmtk_spatial_index_clear(index_ptr);
+    return false;
+}
+
+/* ------------------------------------------------------------------------- */
+const wlmtk_spatial_index_item_t * const *wlmtk_spatial_index_lookup(
+    wlmtk_spatial_index_t *index_ptr,
+    double x,
+    double y,
+    size_t *count_ptr)
+{
+    *count_ptr = 0;
+    if (!index_ptr->built || isnan(x) || isnan(y)) return NULL;
+
+    double col = floor((floor(x) - index_ptr->origin_x) / index_ptr->cell_size);
+    double row = floor((floor(y) - index_ptr->origin_y) / index_ptr->cell_size);
+    if (0 > col || col >= index_ptr->columns ||
+        0 > row || row >= index_ptr->rows) return NULL;
+
+    size_t cell = (size_t)row * index_ptr->columns + (size_t)col;
+    size_t begin = index_ptr->cell_offsets_ptr[cell];
+    *count_ptr = index_ptr->cell_offsets_ptr[cell + 1] - begin;
+    return &index_ptr->entries_ptr[begin];
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Ensures `*array_ptr_ptr` has capacity for at least `required` elements.
+ *
+ * @param array_ptr_ptr
+ * @param capacity_ptr
+ * @param required
+ * @param element_size
+ *
+ * @return true on success.
+ */
+bool _wlmtk_spatial_index_reserve(
+    void **array_ptr_ptr,
+    size_t *capacity_ptr,
+    size_t required,
+    size_t element_size)
+{
+    if (required <= *capacity_ptr) return true;
+
+    size_t capacity = BS_MAX((size_t)16, *capacity_ptr);
+    while (capacity < required) capacity *= 2;
+    void *array_ptr = realloc(*array_ptr_ptr, capacity * element_size);
+    if (NULL == array_ptr) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed realloc(%p, %zu)",
+               *array_ptr_ptr, capacity * element_size);
+        return false;
+    }
+    *array_ptr_ptr = array_ptr;
+    *capacity_ptr = capacity;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Computes the (inclusive) range of grid cells covered by a non-empty box. */
+void _wlmtk_spatial_index_cell_range(
+    wlmtk_spatial_index_t *index_ptr,
+    const struct wlr_box *box_ptr,
+    int *col1_ptr, int *row1_ptr,
+    int *col2_ptr, int *row2_ptr)
+{
+    *col1_ptr = (box_ptr->x - index_ptr->origin_x) / index_ptr->cell_size;
+    *row1_ptr = (box_ptr->y - index_ptr->origin_y) / index_ptr->cell_size;
+    *col2_ptr = (box_ptr->x + box_ptr->width - 1 - index_ptr->origin_x) /
+        index_ptr->cell_size;
+    *row2_ptr = (box_ptr->y + box_ptr->height - 1 - index_ptr->origin_y) /
+        index_ptr->cell_size;
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_create_destroy(bs_test_t *test_ptr);
+static void test_lookup(bs_test_t *test_ptr);
+static void test_large(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmtk_spatial_index_test_cases[] = {
+    { 1, "create_destroy", test_create_destroy },
+    { 1, "lookup", test_lookup },
+    { 1, "large", test_large },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Exercises setup and teardown, and lookups on an empty index. */
+void test_create_destroy(bs_test_t *test_ptr)
+{
+    wlmtk_spatial_index_t *index_ptr = wlmtk_spatial_index_create(64);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, index_ptr);
+
+    size_t count = 42;
+    wlmtk_spatial_index_lookup(index_ptr, 0, 0, &count);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, count);
+
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_spatial_index_build(index_ptr));
+    wlmtk_spatial_index_lookup(index_ptr, 0, 0, &count);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, count);
+
+    wlmtk_spatial_index_destroy(index_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies candidates are found and returned in order of addition. */
+void test_lookup(bs_test_t *test_ptr)
+{
+    wlmtk_spatial_index_t *index_ptr = wlmtk_spatial_index_create(64);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, index_ptr);
+    int a, b, c, d;
+    struct wlr_box box_a = { .x = -10, .y = -10, .width = 20, .height = 20 };
+    struct wlr_box box_b = { .x = 100, .y = 0, .width = 100, .height = 50 };
+    struct wlr_box box_c = { .x = 0, .y = 0, .width = 300, .height = 300 };
+    struct wlr_box box_d = { .x = 5, .y = 5, .width = 0, .height = 10 };
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_spatial_index_add(index_ptr, &a, &box_a));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_spatial_index_add(index_ptr, &b, &box_b));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_spatial_index_add(index_ptr, &c, &box_c));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_spatial_index_add(index_ptr, &d, &box_d));
+
+    // Not built yet: No candidates.
+    size_t count;
+    wlmtk_spatial_index_lookup(index_ptr, 0, 0, &count);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, count);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_spatial_index_build(index_ptr));
+
+    // At (0, 0): 'a' and 'c', in that order. The empty 'd' is skipped.
+    const wlmtk_spatial_index_item_t * const *items_ptr;
+    items_ptr = wlmtk_spatial_index_lookup(index_ptr, 0, 0, &count);
+    BS_TEST_VERIFY_EQ_OR_RETURN(test_ptr, 2, count);
+    BS_TEST_VERIFY_EQ(test_ptr, &a, items_ptr[0]->data_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, &c, items_ptr[1]->data_ptr);
+
+    // At (150, 25): 'b' and 'c'.
+    items_ptr = wlmtk_spatial_index_lookup(index_ptr, 150.5, 25, &count);
+    BS_TEST_VERIFY_EQ_OR_RETURN(test_ptr, 2, count);
+    BS_TEST_VERIFY_EQ(test_ptr, &b, items_ptr[0]->data_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, &c, items_ptr[1]->data_ptr);
+
+    // At (250, 250): Only 'c'.
+    items_ptr = wlmtk_spatial_index_lookup(index_ptr, 250, 250, &count);
+    BS_TEST_VERIFY_EQ_OR_RETURN(test_ptr, 1, count);
+    BS_TEST_VERIFY_EQ(test_ptr, &c, items_ptr[0]->data_ptr);
+
+    // Outside the grid, or NAN: Nothing.
+    wlmtk_spatial_index_lookup(index_ptr, -10.5, 0, &count);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, count);
+    wlmtk_spatial_index_lookup(index_ptr, 310, 0, &count);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, count);
+    wlmtk_spatial_index_lookup(index_ptr, NAN, NAN, &count);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, count);
+
+    // Clearing the index also clears the grid.
+    wlmtk_spatial_index_clear(index_ptr);
+    wlmtk_spatial_index_lookup(index_ptr, 0, 0, &count);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, count);
+
+    wlmtk_spatial_index_destroy(index_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies the grid adapts cell size when items span a large area. */
+void test_large(bs_test_t *test_ptr)
+{
+    wlmtk_spatial_index_t *index_ptr = wlmtk_spatial_index_create(1);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, index_ptr);
+    int a, b;
+    struct wlr_box box_a = { .x = 0, .y = 0, .width = 10, .height = 10 };
+    struct wlr_box box_b = {
+        .x = 100000, .y = 100000, .width = 10, .height = 10 };
+    wlmtk_spatial_index_add(index_ptr, &a, &box_a);
+    wlmtk_spatial_index_add(index_ptr, &b, &box_b);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_spatial_index_build(index_ptr));
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        (size_t)(index_ptr->columns * index_ptr->rows) <=
+        _wlmtk_spatial_index_max_cells);
+
+    size_t count;
+    const wlmtk_spatial_index_item_t * const *items_ptr;
+    items_ptr = wlmtk_spatial_index_lookup(index_ptr, 5, 5, &count);
+    BS_TEST_VERIFY_EQ_OR_RETURN(test_ptr, 1, count);
+    BS_TEST_VERIFY_EQ(test_ptr, &a, items_ptr[0]->data_ptr);
+    items_ptr = wlmtk_spatial_index_lookup(index_ptr, 100005, 100005, &count);
+    BS_TEST_VERIFY_EQ_OR_RETURN(test_ptr, 1, count);
+    BS_TEST_VERIFY_EQ(test_ptr, &b, items_ptr[0]->data_ptr);
+
+    wlmtk_spatial_index_destroy(index_ptr);
+}
+
+/* == End of spatial_index.c =============================================== */
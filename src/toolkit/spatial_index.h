@@ -0,0 +1,128 @@
+/* ========================================================================= */
+/**
+ * @file spatial_index.h
+ *
+ * @copyright
+ * Copyright 2024 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMTK_SPATIAL_INDEX_H__
+#define __WLMTK_SPATIAL_INDEX_H__
+
+#include <libbase/libbase.h>
+
+#include "wlr/util/box.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/** Forward declaration: Spatial index. */
+typedef struct _wlmtk_spatial_index_t wlmtk_spatial_index_t;
+
+/** An item of the spatial index: An opaque pointer and it's bounds. */
+typedef struct {
+    /** Opaque pointer to the indexed object. */
+    void                      *data_ptr;
+    /** Bounds of the object. Spans [x, x + width) and [y, y + height). */
+    struct wlr_box            box;
+} wlmtk_spatial_index_item_t;
+
+/**
+ * Creates a spatial index: A uniform grid, mapping each grid cell to the
+ * items overlapping it.
+ *
+ * The index is built in bulk: @ref wlmtk_spatial_index_clear, followed by a
+ * @ref wlmtk_spatial_index_add for each item, then a call to
+ * @ref wlmtk_spatial_index_build. The order in which items are added is
+ * retained for @ref wlmtk_spatial_index_lookup.
+ *
+ * @param cell_size           Preferred width and height of a grid cell, in
+ *                            pixels. Will be increased when building, if the
+ *                            items span a large area.
+ *
+ * @return Pointer to the spatial index, or NULL on error. Must be destroyed
+ *     by calling @ref wlmtk_spatial_index_destroy.
+ */
+wlmtk_spatial_index_t *wlmtk_spatial_index_create(int cell_size);
+
+/**
+ * Destroys the spatial index.
+ *
+ * @param index_ptr
+ */
+void wlmtk_spatial_index_destroy(wlmtk_spatial_index_t *index_ptr);
+
+/**
+ * Removes all items from the index. Retains the allocated memory.
+ *
+ * @param index_ptr
+ */
+void wlmtk_spatial_index_clear(wlmtk_spatial_index_t *index_ptr);
+
+/**
+ * Adds an item to the index. Requires @ref wlmtk_spatial_index_build before
+ * the item can be looked up.
+ *
+ * @param index_ptr
+ * @param data_ptr
+ * @param box_ptr             Bounds of the item. Items with an empty box
+ *                            are accepted, but will never be looked up.
+ *
+ * @return true on success.
+ */
+bool wlmtk_spatial_index_add(
+    wlmtk_spatial_index_t *index_ptr,
+    void *data_ptr,
+    const struct wlr_box *box_ptr);
+
+/**
+ * Builds the grid from all items added since the last clear.
+ *
+ * @param index_ptr
+ *
+ * @return true on success. On failure, the index is cleared.
+ */
+bool wlmtk_spatial_index_build(wlmtk_spatial_index_t *index_ptr);
+
+/**
+ * Looks up the candidate items at (x, y).
+ *
+ * Candidates are all items whose box overlaps the grid cell containing
+ * (x, y), in the order they were added. The caller must still verify whether
+ * (x, y) is within @ref wlmtk_spatial_index_item_t::box.
+ *
+ * @param index_ptr
+ * @param x
+ * @param y
+ * @param count_ptr           Will be set to the number of candidates.
+ *
+ * @return Pointer to an array of `*count_ptr` item pointers. Valid until the
+ *     index is cleared or destroyed.
+ */
+const wlmtk_spatial_index_item_t * const *wlmtk_spatial_index_lookup(
+    wlmtk_spatial_index_t *index_ptr,
+    double x,
+    double y,
+    size_t *count_ptr);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmtk_spatial_index_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMTK_SPATIAL_INDEX_H__ */
+/* == End of spatial_index.h =============================================== */
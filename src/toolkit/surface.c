@@ -22,6 +22,7 @@
 
 #include "element.h"
 #include "gfxbuf.h"
+#include "trace.h"
 #include "util.h"
 
 #define WLR_USE_UNSTABLE
@@ -606,6 +607,7 @@ void _wlmtk_surface_handle_surface_commit(
     struct wl_listener *listener_ptr,
     __UNUSED__ void *data_ptr)
 {
+    WLMTK_TRACE_SCOPE("surface_commit");
     wlmtk_surface_t *surface_ptr = BS_CONTAINER_OF(
         listener_ptr, wlmtk_surface_t, surface_commit_listener);
 
@@ -617,7 +619,8 @@ void _wlmtk_surface_handle_surface_commit(
 
 /* ------------------------------------------------------------------------- */
 /**
- * Surface commits a new size: Store the size, and update the parent's layout.
+ * Surface commits a size: If it changed, store the size and update the
+ * parent's layout.
  *
  * @param surface_ptr
  * @param width
@@ -632,11 +635,12 @@ void _wlmtk_surface_commit_size(
         surface_ptr->committed_height != height) {
         surface_ptr->committed_width = width;
         surface_ptr->committed_height = height;
-    }
 
-    if (NULL != surface_ptr->super_element.parent_container_ptr) {
-        wlmtk_container_update_layout(
-            surface_ptr->super_element.parent_container_ptr);
+        // A commit of the same size leaves the parent's layout as-is.
+        if (NULL != surface_ptr->super_element.parent_container_ptr) {
+            wlmtk_container_update_layout(
+                surface_ptr->super_element.parent_container_ptr);
+        }
     }
 }
 
@@ -772,10 +776,12 @@ void _wlmtk_fake_surface_element_pointer_leave(
 
 static void test_create_destroy(bs_test_t *test_ptr);
 static void test_fake_commit(bs_test_t *test_ptr);
+static void test_commit_layout(bs_test_t *test_ptr);
 
 const bs_test_case_t wlmtk_surface_test_cases[] = {
     { 1, "create_destroy", test_create_destroy },
     { 1, "fake_commit", test_fake_commit },
+    { 1, "commit_layout", test_commit_layout },
     { 0, NULL, NULL }
 };
 
@@ -813,4 +819,41 @@ void test_fake_commit(bs_test_t *test_ptr)
     wlmtk_fake_surface_destroy(fake_surface_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Verifies that only size changes update the parent container's layout. */
+void test_commit_layout(bs_test_t *test_ptr)
+{
+    wlmtk_container_t container;
+    BS_ASSERT(wlmtk_container_init(&container, NULL));
+    wlmtk_fake_surface_t *fake_surface_ptr = wlmtk_fake_surface_create();
+    BS_ASSERT(NULL != fake_surface_ptr);
+    wlmtk_element_t *element_ptr = &fake_surface_ptr->surface.super_element;
+    wlmtk_element_set_visible(element_ptr, true);
+    wlmtk_container_add_element(&container, element_ptr);
+
+    wlmtk_fake_surface_commit_size(fake_surface_ptr, 200, 100);
+    BS_TEST_VERIFY_TRUE(test_ptr, container.spatial_index_dirty);
+    struct wlr_box box = wlmtk_element_get_dimensions_box(
+        &container.super_element);
+    BS_TEST_VERIFY_EQ(test_ptr, 200, box.width);
+    BS_TEST_VERIFY_TRUE(test_ptr, container.super_element.bounds_cache_valid);
+
+    // A commit of the same size leaves the container's layout as it was.
+    container.spatial_index_dirty = false;
+    wlmtk_fake_surface_commit_size(fake_surface_ptr, 200, 100);
+    BS_TEST_VERIFY_FALSE(test_ptr, container.spatial_index_dirty);
+    BS_TEST_VERIFY_TRUE(test_ptr, container.super_element.bounds_cache_valid);
+
+    // A new size does update it.
+    wlmtk_fake_surface_commit_size(fake_surface_ptr, 300, 100);
+    BS_TEST_VERIFY_TRUE(test_ptr, container.spatial_index_dirty);
+    BS_TEST_VERIFY_FALSE(test_ptr, container.super_element.bounds_cache_valid);
+    box = wlmtk_element_get_dimensions_box(&container.super_element);
+    BS_TEST_VERIFY_EQ(test_ptr, 300, box.width);
+
+    wlmtk_container_remove_element(&container, element_ptr);
+    wlmtk_fake_surface_destroy(fake_surface_ptr);
+    wlmtk_container_fini(&container);
+}
+
 /* == End of surface.c ===================================================== */
@@ -0,0 +1,697 @@
+/* ========================================================================= */
+/**
+ * @file title_cache.c
+ *
+ * @copyright
+ * Copyright 2024 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "title_cache.h"
+
+#include "gfxbuf.h"
+#include "primitives.h"
+
+/* == Declarations ========================================================= */
+
+/** A rendered title texture. */
+typedef struct {
+    /** Node within @ref _wlmtk_title_cache_textures. */
+    bs_dllist_node_t          dlnode;
+    /** The title. */
+    char                      *title_ptr;
+    /** Text color the title was drawn with. */
+    uint32_t                  text_color;
+    /** Hash of the background area the title was drawn onto. */
+    uint64_t                  background_hash;
+    /** Copy of that background area, to tell apart colliding hashes. */
+    bs_gfxbuf_t               *background_gfxbuf_ptr;
+    /** The texture. Holds the creator's reference. */
+    struct wlr_buffer         *wlr_buffer_ptr;
+} wlmtk_title_texture_t;
+
+/** Glyphs of a title, in the window title font. */
+typedef struct {
+    /** Node within @ref _wlmtk_title_cache_glyph_runs. */
+    bs_dllist_node_t          dlnode;
+    /** The title. */
+    char                      *title_ptr;
+    /** Glyphs, from `cairo_glyph_allocate`. */
+    cairo_glyph_t             *glyphs_ptr;
+    /** Number of glyphs at `glyphs_ptr`. */
+    int                       num_glyphs;
+    /** Clusters, mapping bytes of the title to glyphs. */
+    cairo_text_cluster_t      *clusters_ptr;
+    /** Number of clusters at `clusters_ptr`. */
+    int                       num_clusters;
+    /** Flags of the clusters. */
+    cairo_text_cluster_flags_t cluster_flags;
+} wlmtk_title_glyph_run_t;
+
+static struct wlr_buffer *_wlmtk_title_cache_render(
+    bs_gfxbuf_t *gfxbuf_ptr,
+    unsigned position,
+    unsigned width,
+    unsigned height,
+    uint32_t text_color,
+    const char *title_ptr);
+static wlmtk_title_glyph_run_t *_wlmtk_title_cache_glyph_run(
+    cairo_t *cairo_ptr,
+    const char *title_ptr);
+static wlmtk_title_glyph_run_t *_wlmtk_title_cache_glyph_run_create(
+    cairo_scaled_font_t *scaled_font_ptr,
+    const char *title_ptr,
+    const wlmtk_title_glyph_run_t *prefix_run_ptr);
+static void _wlmtk_title_cache_glyph_run_destroy(
+    wlmtk_title_glyph_run_t *glyph_run_ptr);
+static void _wlmtk_title_cache_texture_destroy(
+    wlmtk_title_texture_t *texture_ptr);
+static size_t _wlmtk_title_cache_common_prefix(
+    const char *a_ptr,
+    const char *b_ptr);
+static uint64_t _wlmtk_title_cache_hash_area(
+    bs_gfxbuf_t *gfxbuf_ptr,
+    unsigned position,
+    unsigned width,
+    unsigned height);
+static bool _wlmtk_title_cache_area_equals(
+    bs_gfxbuf_t *background_gfxbuf_ptr,
+    bs_gfxbuf_t *gfxbuf_ptr,
+    unsigned position);
+
+/* == Data ================================================================= */
+
+/** Rendered title textures, most recently used first. */
+static bs_dllist_t            _wlmtk_title_cache_textures;
+/** Glyph runs of recent titles, most recently used first. */
+static bs_dllist_t            _wlmtk_title_cache_glyph_runs;
+/** The scaled font used for window titles. Set on first use. */
+static cairo_scaled_font_t    *_wlmtk_title_cache_scaled_font_ptr;
+/** Counters. */
+static wlmtk_title_cache_stats_t _wlmtk_title_cache_stats;
+
+/** Maximum number of textures to keep in the cache. */
+static const size_t           _wlmtk_title_cache_max_textures = 64;
+/** Maximum number of glyph runs to keep in the cache. */
+static const size_t           _wlmtk_title_cache_max_glyph_runs = 32;
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+struct wlr_buffer *wlmtk_title_cache_acquire(
+    bs_gfxbuf_t *gfxbuf_ptr,
+    unsigned position,
+    unsigned width,
+    unsigned height,
+    uint32_t text_color,
+    const char *title_ptr)
+{
+    BS_ASSERT(NULL != title_ptr);
+    BS_ASSERT(position + width <= gfxbuf_ptr->width);
+    BS_ASSERT(height <= gfxbuf_ptr->height);
+    uint64_t hash = _wlmtk_title_cache_hash_area(
+        gfxbuf_ptr, position, width, height);
+
+    wlmtk_title_texture_t *texture_ptr = NULL;
+    for (bs_dllist_node_t *dlnode_ptr = _wlmtk_title_cache_textures.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_title_texture_t *t_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_title_texture_t, dlnode);
+        if (t_ptr->background_hash == hash &&
+            t_ptr->text_color == text_color &&
+            (unsigned)t_ptr->wlr_buffer_ptr->width == width &&
+            (unsigned)t_ptr->wlr_buffer_ptr->height == height &&
+            0 == strcmp(t_ptr->title_ptr, title_ptr) &&
+            _wlmtk_title_cache_area_equals(
+                t_ptr->background_gfxbuf_ptr, gfxbuf_ptr, position)) {
+            texture_ptr = t_ptr;
+            break;
+        }
+    }
+
+    if (NULL != texture_ptr) {
+        ++_wlmtk_title_cache_stats.texture_hits;
+        bs_dllist_remove(&_wlmtk_title_cache_textures, &texture_ptr->dlnode);
+        bs_dllist_push_front(&_wlmtk_title_cache_textures,
+                             &texture_ptr->dlnode);
+        return wlr_buffer_lock(texture_ptr->wlr_buffer_ptr);
+    }
+
+    ++_wlmtk_title_cache_stats.texture_misses;
+    texture_ptr = logged_calloc(1, sizeof(wlmtk_title_texture_t));
+    if (NULL == texture_ptr) return NULL;
+    texture_ptr->text_color = text_color;
+    texture_ptr->background_hash = hash;
+    texture_ptr->title_ptr = logged_strdup(title_ptr);
+    texture_ptr->background_gfxbuf_ptr = bs_gfxbuf_create(width, height);
+    texture_ptr->wlr_buffer_ptr = _wlmtk_title_cache_render(
+        gfxbuf_ptr, position, width, height, text_color, title_ptr);
+    if (NULL == texture_ptr->title_ptr ||
+        NULL == texture_ptr->background_gfxbuf_ptr ||
+        NULL == texture_ptr->wlr_buffer_ptr) {
+        _wlmtk_title_cache_texture_destroy(texture_ptr);
+        return NULL;
+    }
+    bs_gfxbuf_copy_area(
+        texture_ptr->background_gfxbuf_ptr, 0, 0,
+        gfxbuf_ptr, position, 0, width, height);
+
+    bs_dllist_push_front(&_wlmtk_title_cache_textures, &texture_ptr->dlnode);
+    while (bs_dllist_size(&_wlmtk_title_cache_textures) >
+           _wlmtk_title_cache_max_textures) {
+        wlmtk_title_texture_t *t_ptr = BS_CONTAINER_OF(
+            _wlmtk_title_cache_textures.tail_ptr,
+            wlmtk_title_texture_t, dlnode);
+        bs_dllist_remove(&_wlmtk_title_cache_textures, &t_ptr->dlnode);
+        _wlmtk_title_cache_texture_destroy(t_ptr);
+    }
+    return wlr_buffer_lock(texture_ptr->wlr_buffer_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_title_cache_purge(void)
+{
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(
+                        &_wlmtk_title_cache_textures))) {
+        _wlmtk_title_cache_texture_destroy(BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_title_texture_t, dlnode));
+    }
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(
+                        &_wlmtk_title_cache_glyph_runs))) {
+        _wlmtk_title_cache_glyph_run_destroy(BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_title_glyph_run_t, dlnode));
+    }
+    if (NULL != _wlmtk_title_cache_scaled_font_ptr) {
+        cairo_scaled_font_destroy(_wlmtk_title_cache_scaled_font_ptr);
+        _wlmtk_title_cache_scaled_font_ptr = NULL;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+const wlmtk_title_cache_stats_t *wlmtk_title_cache_stats(void)
+{
+    return &_wlmtk_title_cache_stats;
+}
+
+/* ------------------------------------------------------------------------- */
+size_t wlmtk_title_cache_bytes(void)
+{
+    size_t bytes = 0;
+    for (bs_dllist_node_t *dlnode_ptr = _wlmtk_title_cache_textures.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_title_texture_t *texture_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_title_texture_t, dlnode);
+        // The texture, and the copy of it's background.
+        bytes += 2 * (size_t)texture_ptr->wlr_buffer_ptr->width *
+            texture_ptr->wlr_buffer_ptr->height * sizeof(uint32_t);
+    }
+    return bytes;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Renders the title texture: Copies the background, draws bezel and title.
+ *
+ * @param gfxbuf_ptr
+ * @param position
+ * @param width
+ * @param height
+ * @param text_color
+ * @param title_ptr
+ *
+ * @return A `struct wlr_buffer`, or NULL on error.
+ */
+struct wlr_buffer *_wlmtk_title_cache_render(
+    bs_gfxbuf_t *gfxbuf_ptr,
+    unsigned position,
+    unsigned width,
+    unsigned height,
+    uint32_t text_color,
+    const char *title_ptr)
+{
+    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(
+        width, height);
+    if (NULL == wlr_buffer_ptr) return NULL;
+
+    bs_gfxbuf_copy_area(
+        bs_gfxbuf_from_wlr_buffer(wlr_buffer_ptr),
+        0, 0,
+        gfxbuf_ptr,
+        position, 0,
+        width, height);
+
+    cairo_t *cairo_ptr = cairo_create_from_wlr_buffer(wlr_buffer_ptr);
+    if (NULL == cairo_ptr) {
+        wlr_buffer_drop(wlr_buffer_ptr);
+        return NULL;
+    }
+    wlmaker_primitives_draw_bezel_at(
+        cairo_ptr, 0, 0, width, height, 1.0, true);
+
+    wlmtk_title_glyph_run_t *glyph_run_ptr = _wlmtk_title_cache_glyph_run(
+        cairo_ptr, title_ptr);
+    if (NULL == glyph_run_ptr) {
+        cairo_destroy(cairo_ptr);
+        wlr_buffer_drop(wlr_buffer_ptr);
+        return NULL;
+    }
+    wlmaker_primitives_draw_window_title_glyphs(
+        cairo_ptr,
+        glyph_run_ptr->glyphs_ptr,
+        glyph_run_ptr->num_glyphs,
+        text_color);
+    cairo_destroy(cairo_ptr);
+
+    return wlr_buffer_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Looks up the glyph run for `title_ptr`, or creates it.
+ *
+ * @param cairo_ptr           Used to obtain the scaled font, on first use.
+ * @param title_ptr
+ *
+ * @return The glyph run, owned by the cache. Or NULL on error.
+ */
+wlmtk_title_glyph_run_t *_wlmtk_title_cache_glyph_run(
+    cairo_t *cairo_ptr,
+    const char *title_ptr)
+{
+    if (NULL == _wlmtk_title_cache_scaled_font_ptr) {
+        cairo_save(cairo_ptr);
+        wlmaker_primitives_set_window_title_font(cairo_ptr);
+        _wlmtk_title_cache_scaled_font_ptr = cairo_scaled_font_reference(
+            cairo_get_scaled_font(cairo_ptr));
+        cairo_restore(cairo_ptr);
+    }
+
+    // Find an identical title, or the one sharing the longest prefix.
+    wlmtk_title_glyph_run_t *prefix_run_ptr = NULL;
+    size_t prefix_len = 0;
+    for (bs_dllist_node_t *dlnode_ptr =
+             _wlmtk_title_cache_glyph_runs.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_title_glyph_run_t *run_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_title_glyph_run_t, dlnode);
+        if (0 == strcmp(run_ptr->title_ptr, title_ptr)) {
+            ++_wlmtk_title_cache_stats.glyph_run_hits;
+            bs_dllist_remove(&_wlmtk_title_cache_glyph_runs,
+                             &run_ptr->dlnode);
+            bs_dllist_push_front(&_wlmtk_title_cache_glyph_runs,
+                                 &run_ptr->dlnode);
+            return run_ptr;
+        }
+        size_t len = _wlmtk_title_cache_common_prefix(
+            run_ptr->title_ptr, title_ptr);
+        if (len > prefix_len) {
+            prefix_len = len;
+            prefix_run_ptr = run_ptr;
+        }
+    }
+
+    wlmtk_title_glyph_run_t *run_ptr = _wlmtk_title_cache_glyph_run_create(
+        _wlmtk_title_cache_scaled_font_ptr, title_ptr, prefix_run_ptr);
+    if (NULL == run_ptr) return NULL;
+
+    bs_dllist_push_front(&_wlmtk_title_cache_glyph_runs, &run_ptr->dlnode);
+    while (bs_dllist_size(&_wlmtk_title_cache_glyph_runs) >
+           _wlmtk_title_cache_max_glyph_runs) {
+        wlmtk_title_glyph_run_t *r_ptr = BS_CONTAINER_OF(
+            _wlmtk_title_cache_glyph_runs.tail_ptr,
+            wlmtk_title_glyph_run_t, dlnode);
+        bs_dllist_remove(&_wlmtk_title_cache_glyph_runs, &r_ptr->dlnode);
+        _wlmtk_title_cache_glyph_run_destroy(r_ptr);
+    }
+    return run_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates the glyph run for `title_ptr`.
+ *
+ * The glyphs for the clusters that `title_ptr` shares with `prefix_run_ptr`
+ * are copied over, and only the remainder is converted, starting at the
+ * advance of the last copied glyph. The window title font is a cairo "toy"
+ * font without kerning, so this gives the same glyphs as converting the
+ * whole title.
+ *
+ * @param scaled_font_ptr
+ * @param title_ptr
+ * @param prefix_run_ptr      Glyph run of a title with common prefix, or
+ *                            NULL.
+ *
+ * @return The glyph run, or NULL on error. Must be destroyed by calling
+ *     @ref _wlmtk_title_cache_glyph_run_destroy.
+ */
+wlmtk_title_glyph_run_t *_wlmtk_title_cache_glyph_run_create(
+    cairo_scaled_font_t *scaled_font_ptr,
+    const char *title_ptr,
+    const wlmtk_title_glyph_run_t *prefix_run_ptr)
+{
+    wlmtk_title_glyph_run_t *run_ptr = logged_calloc(
+        1, sizeof(wlmtk_title_glyph_run_t));
+    if (NULL == run_ptr) return NULL;
+    run_ptr->title_ptr = logged_strdup(title_ptr);
+    if (NULL == run_ptr->title_ptr) {
+        _wlmtk_title_cache_glyph_run_destroy(run_ptr);
+        return NULL;
+    }
+
+    // Determine how many clusters and glyphs of the prefix can be re-used.
+    size_t prefix_bytes = 0;
+    int prefix_glyphs = 0, prefix_clusters = 0;
+    if (NULL != prefix_run_ptr &&
+        0 == (prefix_run_ptr->cluster_flags &
+              CAIRO_TEXT_CLUSTER_FLAG_BACKWARD)) {
+        size_t len = _wlmtk_title_cache_common_prefix(
+            prefix_run_ptr->title_ptr, title_ptr);
+        for (; prefix_clusters < prefix_run_ptr->num_clusters;
+             ++prefix_clusters) {
+            const cairo_text_cluster_t *c_ptr =
+                &prefix_run_ptr->clusters_ptr[prefix_clusters];
+            if (prefix_bytes + c_ptr->num_bytes > len) break;
+            prefix_bytes += c_ptr->num_bytes;
+            prefix_glyphs += c_ptr->num_glyphs;
+        }
+    }
+
+    double x = wlmaker_primitives_window_title_x;
+    double y = wlmaker_primitives_window_title_y;
+    if (0 < prefix_glyphs) {
+        const cairo_glyph_t *g_ptr =
+            &prefix_run_ptr->glyphs_ptr[prefix_glyphs - 1];
+        cairo_text_extents_t extents;
+        cairo_scaled_font_glyph_extents(scaled_font_ptr, g_ptr, 1, &extents);
+        x = g_ptr->x + extents.x_advance;
+        y = g_ptr->y + extents.y_advance;
+    }
+
+    cairo_glyph_t *glyphs_ptr = NULL;
+    int num_glyphs = 0;
+    cairo_text_cluster_t *clusters_ptr = NULL;
+    int num_clusters = 0;
+    cairo_status_t status = cairo_scaled_font_text_to_glyphs(
+        scaled_font_ptr, x, y,
+        title_ptr + prefix_bytes, -1,
+        &glyphs_ptr, &num_glyphs,
+        &clusters_ptr, &num_clusters, &run_ptr->cluster_flags);
+    if (CAIRO_STATUS_SUCCESS != status) {
+        bs_log(BS_WARNING, "Failed cairo_scaled_font_text_to_glyphs(%p, "
+               "\"%s\"): %s", scaled_font_ptr, title_ptr,
+               cairo_status_to_string(status));
+        _wlmtk_title_cache_glyph_run_destroy(run_ptr);
+        return NULL;
+    }
+    _wlmtk_title_cache_stats.glyphs_converted += num_glyphs;
+
+    if (0 == prefix_glyphs) {
+        run_ptr->glyphs_ptr = glyphs_ptr;
+        run_ptr->num_glyphs = num_glyphs;
+        run_ptr->clusters_ptr = clusters_ptr;
+        run_ptr->num_clusters = num_clusters;
+        return run_ptr;
+    }
+
+    // Concatenate the prefix' glyphs and clusters with the converted ones.
+    run_ptr->num_glyphs = prefix_glyphs + num_glyphs;
+    run_ptr->glyphs_ptr = cairo_glyph_allocate(run_ptr->num_glyphs);
+    run_ptr->num_clusters = prefix_clusters + num_clusters;
+    run_ptr->clusters_ptr = cairo_text_cluster_allocate(
+        run_ptr->num_clusters);
+    if (NULL != run_ptr->glyphs_ptr && NULL != run_ptr->clusters_ptr) {
+        memcpy(run_ptr->glyphs_ptr, prefix_run_ptr->glyphs_ptr,
+               prefix_glyphs * sizeof(cairo_glyph_t));
+        memcpy(run_ptr->glyphs_ptr + prefix_glyphs, glyphs_ptr,
+               num_glyphs * sizeof(cairo_glyph_t));
+        memcpy(run_ptr->clusters_ptr, prefix_run_ptr->clusters_ptr,
+               prefix_clusters * sizeof(cairo_text_cluster_t));
+        memcpy(run_ptr->clusters_ptr + prefix_clusters, clusters_ptr,
+               num_clusters * sizeof(cairo_text_cluster_t));
+    }
+    cairo_glyph_free(glyphs_ptr);
+    cairo_text_cluster_free(clusters_ptr);
+    if (NULL == run_ptr->glyphs_ptr || NULL == run_ptr->clusters_ptr) {
+        _wlmtk_title_cache_glyph_run_destroy(run_ptr);
+        return NULL;
+    }
+    _wlmtk_title_cache_stats.glyphs_reused += prefix_glyphs;
+    return run_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroys the glyph run. Must not be in the list of glyph runs. */
+void _wlmtk_title_cache_glyph_run_destroy(
+    wlmtk_title_glyph_run_t *glyph_run_ptr)
+{
+    if (NULL != glyph_run_ptr->clusters_ptr) {
+        cairo_text_cluster_free(glyph_run_ptr->clusters_ptr);
+        glyph_run_ptr->clusters_ptr = NULL;
+    }
+    if (NULL != glyph_run_ptr->glyphs_ptr) {
+        cairo_glyph_free(glyph_run_ptr->glyphs_ptr);
+        glyph_run_ptr->glyphs_ptr = NULL;
+    }
+    if (NULL != glyph_run_ptr->title_ptr) {
+        free(glyph_run_ptr->title_ptr);
+        glyph_run_ptr->title_ptr = NULL;
+    }
+    free(glyph_run_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Destroys the texture entry. Must not be in the list of textures. Drops the
+ * cache's reference; the buffer stays alive while locked by others.
+ */
+void _wlmtk_title_cache_texture_destroy(wlmtk_title_texture_t *texture_ptr)
+{
+    wlr_buffer_drop_nullify(&texture_ptr->wlr_buffer_ptr);
+    if (NULL != texture_ptr->background_gfxbuf_ptr) {
+        bs_gfxbuf_destroy(texture_ptr->background_gfxbuf_ptr);
+        texture_ptr->background_gfxbuf_ptr = NULL;
+    }
+    if (NULL != texture_ptr->title_ptr) {
+        free(texture_ptr->title_ptr);
+        texture_ptr->title_ptr = NULL;
+    }
+    free(texture_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the length of the common prefix of both strings, in bytes. Does
+ * not end within an UTF-8 sequence.
+ *
+ * @param a_ptr
+ * @param b_ptr
+ *
+ * @return Length.
+ */
+size_t _wlmtk_title_cache_common_prefix(const char *a_ptr, const char *b_ptr)
+{
+    size_t len = 0;
+    while (a_ptr[len] != '\0' && a_ptr[len] == b_ptr[len]) ++len;
+    // Back off while the next byte continues an UTF-8 sequence.
+    while (0 < len &&
+           ((a_ptr[len] & 0xc0) == 0x80 || (b_ptr[len] & 0xc0) == 0x80)) {
+        --len;
+    }
+    return len;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Computes a 64-bit FNV-1a hash of the pixels in the area of `gfxbuf_ptr`.
+ *
+ * @param gfxbuf_ptr
+ * @param position
+ * @param width
+ * @param height
+ *
+ * @return The hash.
+ */
+uint64_t _wlmtk_title_cache_hash_area(
+    bs_gfxbuf_t *gfxbuf_ptr,
+    unsigned position,
+    unsigned width,
+    unsigned height)
+{
+    uint64_t hash = UINT64_C(0xcbf29ce484222325);
+    for (unsigned y = 0; y < height; ++y) {
+        const uint8_t *data_ptr = (const uint8_t*)(
+            gfxbuf_ptr->data_ptr + y * gfxbuf_ptr->pixels_per_line + position);
+        for (size_t i = 0; i < width * sizeof(uint32_t); ++i) {
+            hash = (hash ^ data_ptr[i]) * UINT64_C(0x100000001b3);
+        }
+    }
+    return hash;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Compares the background area of `gfxbuf_ptr` at `position` with the copy
+ * stored for a texture.
+ *
+ * @param background_gfxbuf_ptr Copy of the background, as stored with the
+ *                            texture. Determines width and height.
+ * @param gfxbuf_ptr
+ * @param position
+ *
+ * @return true if the pixels are identical.
+ */
+bool _wlmtk_title_cache_area_equals(
+    bs_gfxbuf_t *background_gfxbuf_ptr,
+    bs_gfxbuf_t *gfxbuf_ptr,
+    unsigned position)
+{
+    for (unsigned y = 0; y < background_gfxbuf_ptr->height; ++y) {
+        if (0 != memcmp(
+                background_gfxbuf_ptr->data_ptr +
+                y * background_gfxbuf_ptr->pixels_per_line,
+                gfxbuf_ptr->data_ptr + y * gfxbuf_ptr->pixels_per_line +
+                position,
+                background_gfxbuf_ptr->width * sizeof(uint32_t))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_texture(bs_test_t *test_ptr);
+static void test_glyph_run(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmtk_title_cache_test_cases[] = {
+    { 1, "texture", test_texture },
+    { 1, "glyph_run", test_glyph_run },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Verifies textures are shared for same title, color and background. */
+void test_texture(bs_test_t *test_ptr)
+{
+    wlmtk_title_cache_purge();
+    wlmtk_title_cache_stats_t s = *wlmtk_title_cache_stats();
+    bs_gfxbuf_t *gfxbuf_ptr = bs_gfxbuf_create(120, 22);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, gfxbuf_ptr);
+    bs_gfxbuf_clear(gfxbuf_ptr, 0xff2020c0);
+
+    struct wlr_buffer *b1_ptr = wlmtk_title_cache_acquire(
+        gfxbuf_ptr, 10, 90, 22, 0xffc0c0c0, "Title");
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, b1_ptr);
+    BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
+        test_ptr, bs_gfxbuf_from_wlr_buffer(b1_ptr),
+        "toolkit/title_focussed.png");
+
+    // Same parameters: Shared. Position is irrelevant, for a plain color.
+    struct wlr_buffer *b2_ptr = wlmtk_title_cache_acquire(
+        gfxbuf_ptr, 20, 90, 22, 0xffc0c0c0, "Title");
+    BS_TEST_VERIFY_EQ(test_ptr, b1_ptr, b2_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, s.texture_hits + 1,
+                      wlmtk_title_cache_stats()->texture_hits);
+    BS_TEST_VERIFY_EQ(test_ptr, s.texture_misses + 1,
+                      wlmtk_title_cache_stats()->texture_misses);
+
+    // Different text color, width or title: Not shared.
+    struct wlr_buffer *b3_ptr = wlmtk_title_cache_acquire(
+        gfxbuf_ptr, 10, 90, 22, 0xff808080, "Title");
+    BS_TEST_VERIFY_NEQ(test_ptr, b1_ptr, b3_ptr);
+    struct wlr_buffer *b4_ptr = wlmtk_title_cache_acquire(
+        gfxbuf_ptr, 10, 70, 22, 0xffc0c0c0, "Title");
+    BS_TEST_VERIFY_NEQ(test_ptr, b1_ptr, b4_ptr);
+    struct wlr_buffer *b5_ptr = wlmtk_title_cache_acquire(
+        gfxbuf_ptr, 10, 90, 22, 0xffc0c0c0, "Other");
+    BS_TEST_VERIFY_NEQ(test_ptr, b1_ptr, b5_ptr);
+
+    // Changed background: Not shared.
+    bs_gfxbuf_clear(gfxbuf_ptr, 0xff404040);
+    struct wlr_buffer *b6_ptr = wlmtk_title_cache_acquire(
+        gfxbuf_ptr, 10, 90, 22, 0xffc0c0c0, "Title");
+    BS_TEST_VERIFY_NEQ(test_ptr, b1_ptr, b6_ptr);
+
+    // Purging retains the buffers still in use.
+    wlmtk_title_cache_purge();
+    BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
+        test_ptr, bs_gfxbuf_from_wlr_buffer(b1_ptr),
+        "toolkit/title_focussed.png");
+
+    wlr_buffer_unlock(b6_ptr);
+    wlr_buffer_unlock(b5_ptr);
+    wlr_buffer_unlock(b4_ptr);
+    wlr_buffer_unlock(b3_ptr);
+    wlr_buffer_unlock(b2_ptr);
+    wlr_buffer_unlock(b1_ptr);
+    bs_gfxbuf_destroy(gfxbuf_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies glyphs are re-used for titles with a common prefix. */
+void test_glyph_run(bs_test_t *test_ptr)
+{
+    wlmtk_title_cache_purge();
+    wlmtk_title_cache_stats_t s = *wlmtk_title_cache_stats();
+    bs_gfxbuf_t *gfxbuf_ptr = bs_gfxbuf_create(120, 22);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, gfxbuf_ptr);
+    bs_gfxbuf_clear(gfxbuf_ptr, 0xff2020c0);
+
+    struct wlr_buffer *b1_ptr = wlmtk_title_cache_acquire(
+        gfxbuf_ptr, 10, 90, 22, 0xffc0c0c0, "Title");
+    BS_TEST_VERIFY_EQ(test_ptr, s.glyphs_converted + 5,
+                      wlmtk_title_cache_stats()->glyphs_converted);
+
+    // Same title in another color: Re-uses the glyph run.
+    struct wlr_buffer *b2_ptr = wlmtk_title_cache_acquire(
+        gfxbuf_ptr, 10, 90, 22, 0xff808080, "Title");
+    BS_TEST_VERIFY_EQ(test_ptr, s.glyph_run_hits + 1,
+                      wlmtk_title_cache_stats()->glyph_run_hits);
+    BS_TEST_VERIFY_EQ(test_ptr, s.glyphs_converted + 5,
+                      wlmtk_title_cache_stats()->glyphs_converted);
+
+    // Shortened title: Re-uses the glyphs of the prefix.
+    struct wlr_buffer *b3_ptr = wlmtk_title_cache_acquire(
+        gfxbuf_ptr, 10, 90, 22, 0xffc0c0c0, "Tit");
+    BS_TEST_VERIFY_EQ(test_ptr, s.glyphs_reused + 3,
+                      wlmtk_title_cache_stats()->glyphs_reused);
+    wlr_buffer_unlock(b3_ptr);
+    wlmtk_title_cache_purge();
+
+    // Renders "Tit", then "Title" from it's prefix. Must look the same.
+    b3_ptr = wlmtk_title_cache_acquire(
+        gfxbuf_ptr, 10, 90, 22, 0xffc0c0c0, "Tit");
+    struct wlr_buffer *b4_ptr = wlmtk_title_cache_acquire(
+        gfxbuf_ptr, 10, 90, 22, 0xffc0c0c0, "Title");
+    BS_TEST_VERIFY_EQ(test_ptr, s.glyphs_reused + 6,
+                      wlmtk_title_cache_stats()->glyphs_reused);
+    BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
+        test_ptr, bs_gfxbuf_from_wlr_buffer(b4_ptr),
+        "toolkit/title_focussed.png");
+
+    wlmtk_title_cache_purge();
+    wlr_buffer_unlock(b4_ptr);
+    wlr_buffer_unlock(b3_ptr);
+    wlr_buffer_unlock(b2_ptr);
+    wlr_buffer_unlock(b1_ptr);
+    bs_gfxbuf_destroy(gfxbuf_ptr);
+}
+
+/* == End of title_cache.c ================================================= */
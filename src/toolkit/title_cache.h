@@ -0,0 +1,97 @@
+/* ========================================================================= */
+/**
+ * @file title_cache.h
+ *
+ * @copyright
+ * Copyright 2024 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMTK_TITLE_CACHE_H__
+#define __WLMTK_TITLE_CACHE_H__
+
+#include <stdint.h>
+#include <libbase/libbase.h>
+
+#define WLR_USE_UNSTABLE
+#include <wlr/types/wlr_buffer.h>
+#undef WLR_USE_UNSTABLE
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/** Counters of the title cache, for tests and benchmarks. */
+typedef struct {
+    /** Textures found in the cache. */
+    uint64_t                  texture_hits;
+    /** Textures that had to be rendered. */
+    uint64_t                  texture_misses;
+    /** Glyph runs found in the cache, for an identical title. */
+    uint64_t                  glyph_run_hits;
+    /** Glyphs re-used from the cached run of a title with same prefix. */
+    uint64_t                  glyphs_reused;
+    /** Glyphs that had to be converted from text. */
+    uint64_t                  glyphs_converted;
+} wlmtk_title_cache_stats_t;
+
+/**
+ * Acquires a rendered window title texture from the shared title cache.
+ *
+ * The texture is the area [position, position + width) of `gfxbuf_ptr`, with
+ * a bezel and the title drawn in `text_color`. Textures are looked up by
+ * title, text color, size and the contents of the background area, so
+ * windows with the same title and decoration share the texture. Titles not
+ * found are rendered, re-using the glyphs of a cached title with the same
+ * prefix.
+ *
+ * @param gfxbuf_ptr          Titlebar background.
+ * @param position            Position of the title in `gfxbuf_ptr`.
+ * @param width
+ * @param height
+ * @param text_color          As an ARGB 8888 value.
+ * @param title_ptr
+ *
+ * @return A `struct wlr_buffer` locked for the caller, or NULL on error.
+ *     Must be released by calling `wlr_buffer_unlock`. The contents must not
+ *     be modified.
+ */
+struct wlr_buffer *wlmtk_title_cache_acquire(
+    bs_gfxbuf_t *gfxbuf_ptr,
+    unsigned position,
+    unsigned width,
+    unsigned height,
+    uint32_t text_color,
+    const char *title_ptr);
+
+/** Drops all cached textures and glyph runs. In-use textures stay valid. */
+void wlmtk_title_cache_purge(void);
+
+/** @return Pointer to the counters of the title cache. */
+const wlmtk_title_cache_stats_t *wlmtk_title_cache_stats(void);
+
+/**
+ * @return Bytes of pixel memory held by the cached textures, including the
+ *     copies of their backgrounds.
+ */
+size_t wlmtk_title_cache_bytes(void);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmtk_title_cache_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMTK_TITLE_CACHE_H__ */
+/* == End of title_cache.h ================================================= */
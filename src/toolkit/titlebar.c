@@ -23,10 +23,12 @@
 #include "box.h"
 #include "button.h"
 #include "buffer.h"
+#include "fill_cache.h"
 #include "gfxbuf.h"
 #include "primitives.h"
 #include "titlebar_button.h"
 #include "titlebar_title.h"
+#include "trace.h"
 #include "window.h"
 
 #define WLR_USE_UNSTABLE
@@ -174,11 +176,11 @@ void wlmtk_titlebar_destroy(wlmtk_titlebar_t *titlebar_ptr)
     }
 
     if (NULL != titlebar_ptr->blurred_gfxbuf_ptr) {
-        bs_gfxbuf_destroy(titlebar_ptr->blurred_gfxbuf_ptr);
+        wlmtk_fill_cache_release(titlebar_ptr->blurred_gfxbuf_ptr);
         titlebar_ptr->blurred_gfxbuf_ptr = NULL;
     }
     if (NULL != titlebar_ptr->focussed_gfxbuf_ptr) {
-        bs_gfxbuf_destroy(titlebar_ptr->focussed_gfxbuf_ptr);
+        wlmtk_fill_cache_release(titlebar_ptr->focussed_gfxbuf_ptr);
         titlebar_ptr->focussed_gfxbuf_ptr = NULL;
     }
 
@@ -276,39 +278,23 @@ void _wlmtk_titlebar_element_destroy(wlmtk_element_t *element_ptr)
 /** Redraws the titlebar's background in appropriate size. */
 bool redraw_buffers(wlmtk_titlebar_t *titlebar_ptr, unsigned width)
 {
-    cairo_t *cairo_ptr;
-
-    bs_gfxbuf_t *focussed_gfxbuf_ptr = bs_gfxbuf_create(
-        width, titlebar_ptr->style.height);
+    WLMTK_TRACE_SCOPE("titlebar_redraw_buffers");
+    bs_gfxbuf_t *focussed_gfxbuf_ptr = wlmtk_fill_cache_acquire(
+        &titlebar_ptr->style.focussed_fill, width, titlebar_ptr->style.height);
     if (NULL == focussed_gfxbuf_ptr) return false;
-    cairo_ptr = cairo_create_from_bs_gfxbuf(focussed_gfxbuf_ptr);
-    if (NULL == cairo_ptr) {
-        bs_gfxbuf_destroy(focussed_gfxbuf_ptr);
-        return false;
-    }
-    wlmaker_primitives_cairo_fill(
-        cairo_ptr, &titlebar_ptr->style.focussed_fill);
-    cairo_destroy(cairo_ptr);
-
-    bs_gfxbuf_t *blurred_gfxbuf_ptr = bs_gfxbuf_create(
-        width, titlebar_ptr->style.height);
-    if (NULL == blurred_gfxbuf_ptr) return false;
-    cairo_ptr = cairo_create_from_bs_gfxbuf(blurred_gfxbuf_ptr);
-    if (NULL == cairo_ptr) {
-        bs_gfxbuf_destroy(blurred_gfxbuf_ptr);
-        bs_gfxbuf_destroy(focussed_gfxbuf_ptr);
+    bs_gfxbuf_t *blurred_gfxbuf_ptr = wlmtk_fill_cache_acquire(
+        &titlebar_ptr->style.blurred_fill, width, titlebar_ptr->style.height);
+    if (NULL == blurred_gfxbuf_ptr) {
+        wlmtk_fill_cache_release(focussed_gfxbuf_ptr);
         return false;
     }
-    wlmaker_primitives_cairo_fill(
-        cairo_ptr, &titlebar_ptr->style.blurred_fill);
-    cairo_destroy(cairo_ptr);
 
     if (NULL != titlebar_ptr->focussed_gfxbuf_ptr) {
-        bs_gfxbuf_destroy(titlebar_ptr->focussed_gfxbuf_ptr);
+        wlmtk_fill_cache_release(titlebar_ptr->focussed_gfxbuf_ptr);
     }
     titlebar_ptr->focussed_gfxbuf_ptr = focussed_gfxbuf_ptr;
     if (NULL != titlebar_ptr->blurred_gfxbuf_ptr) {
-        bs_gfxbuf_destroy(titlebar_ptr->blurred_gfxbuf_ptr);
+        wlmtk_fill_cache_release(titlebar_ptr->blurred_gfxbuf_ptr);
     }
     titlebar_ptr->blurred_gfxbuf_ptr = blurred_gfxbuf_ptr;
     titlebar_ptr->width = width;
@@ -319,6 +305,7 @@ bool redraw_buffers(wlmtk_titlebar_t *titlebar_ptr, unsigned width)
 /** Redraws the titlebar elements. */
 bool redraw(wlmtk_titlebar_t *titlebar_ptr)
 {
+    WLMTK_TRACE_SCOPE("titlebar_redraw");
     // Guard clause: Nothing to do... yet.
     if (0 >= titlebar_ptr->width) return true;
 
@@ -51,11 +51,25 @@ struct _wlmtk_titlebar_button_t {
     struct wlr_buffer         *focussed_pressed_wlr_buffer_ptr;
     /** WLR buffer of the button when blurred. */
     struct wlr_buffer         *blurred_wlr_buffer_ptr;
+
+    /**
+     * Background for the variant not drawn yet: Blurred, if activated, and
+     * focussed otherwise. That variant is drawn on the next activation
+     * change, see @ref update_buffers. Re-used across redraws.
+     */
+    bs_gfxbuf_t               *pending_gfxbuf_ptr;
+    /** Style, as of the last @ref wlmtk_titlebar_button_redraw. */
+    wlmtk_titlebar_style_t    style;
 };
 
 static void titlebar_button_element_destroy(wlmtk_element_t *element_ptr);
 static void titlebar_button_clicked(wlmtk_button_t *button_ptr);
 static void update_buffers(wlmtk_titlebar_button_t *titlebar_button_ptr);
+static bool draw_variant(
+    wlmtk_titlebar_button_t *titlebar_button_ptr,
+    bs_gfxbuf_t *gfxbuf_ptr,
+    int position,
+    bool activated);
 static struct wlr_buffer *create_buf(
     bs_gfxbuf_t *gfxbuf_ptr,
     int position,
@@ -118,6 +132,10 @@ void wlmtk_titlebar_button_destroy(
         &titlebar_button_ptr->focussed_pressed_wlr_buffer_ptr);
     wlr_buffer_drop_nullify(
         &titlebar_button_ptr->blurred_wlr_buffer_ptr);
+    if (NULL != titlebar_button_ptr->pending_gfxbuf_ptr) {
+        bs_gfxbuf_destroy(titlebar_button_ptr->pending_gfxbuf_ptr);
+        titlebar_button_ptr->pending_gfxbuf_ptr = NULL;
+    }
 
     wlmtk_button_fini(&titlebar_button_ptr->super_button);
     free(titlebar_button_ptr);
@@ -141,45 +159,54 @@ bool wlmtk_titlebar_button_redraw(
     int position,
     const wlmtk_titlebar_style_t *style_ptr)
 {
-    BS_ASSERT(focussed_gfxbuf_ptr->width == blurred_gfxbuf_ptr->width);
-    BS_ASSERT(focussed_gfxbuf_ptr->height == blurred_gfxbuf_ptr->height);
-    BS_ASSERT(style_ptr->height == focussed_gfxbuf_ptr->height);
+    BS_ASSERT(style_ptr->height <= focussed_gfxbuf_ptr->height);
+    BS_ASSERT(style_ptr->height <= blurred_gfxbuf_ptr->height);
     BS_ASSERT(position + style_ptr->height <= focussed_gfxbuf_ptr->width);
+    BS_ASSERT(position + style_ptr->height <= blurred_gfxbuf_ptr->width);
+
+    memcpy(&titlebar_button_ptr->style, style_ptr,
+           sizeof(wlmtk_titlebar_style_t));
+
+    // Keep the background of the currently hidden variant, to draw it later.
+    bs_gfxbuf_t *pending_gfxbuf_ptr = titlebar_button_ptr->pending_gfxbuf_ptr;
+    if (NULL != pending_gfxbuf_ptr &&
+        pending_gfxbuf_ptr->height != style_ptr->height) {
+        bs_gfxbuf_destroy(pending_gfxbuf_ptr);
+        pending_gfxbuf_ptr = NULL;
+        titlebar_button_ptr->pending_gfxbuf_ptr = NULL;
+    }
+    if (NULL == pending_gfxbuf_ptr) {
+        pending_gfxbuf_ptr = bs_gfxbuf_create(
+            style_ptr->height, style_ptr->height);
+        if (NULL == pending_gfxbuf_ptr) return false;
+        titlebar_button_ptr->pending_gfxbuf_ptr = pending_gfxbuf_ptr;
+    }
 
-    struct wlr_buffer *focussed_released_ptr = create_buf(
-        focussed_gfxbuf_ptr, position, false, style_ptr,
-        titlebar_button_ptr->draw);
-    struct wlr_buffer *focussed_pressed_ptr = create_buf(
-        focussed_gfxbuf_ptr, position, true, style_ptr,
-        titlebar_button_ptr->draw);
-    struct wlr_buffer *blurred_ptr = create_buf(
-        blurred_gfxbuf_ptr, position, false, style_ptr,
-        titlebar_button_ptr->draw);
+    if (!draw_variant(
+            titlebar_button_ptr,
+            titlebar_button_ptr->activated ?
+            focussed_gfxbuf_ptr : blurred_gfxbuf_ptr,
+            position,
+            titlebar_button_ptr->activated)) {
+        return false;
+    }
+    bs_gfxbuf_copy_area(
+        pending_gfxbuf_ptr, 0, 0,
+        titlebar_button_ptr->activated ?
+        blurred_gfxbuf_ptr : focussed_gfxbuf_ptr,
+        position, 0, style_ptr->height, style_ptr->height);
 
-    if (NULL != focussed_released_ptr &&
-        NULL != focussed_pressed_ptr &&
-        NULL != blurred_ptr) {
+    if (titlebar_button_ptr->activated) {
+        wlr_buffer_drop_nullify(&titlebar_button_ptr->blurred_wlr_buffer_ptr);
+    } else {
         wlr_buffer_drop_nullify(
             &titlebar_button_ptr->focussed_released_wlr_buffer_ptr);
         wlr_buffer_drop_nullify(
             &titlebar_button_ptr->focussed_pressed_wlr_buffer_ptr);
-        wlr_buffer_drop_nullify(
-            &titlebar_button_ptr->blurred_wlr_buffer_ptr);
-
-        titlebar_button_ptr->focussed_released_wlr_buffer_ptr =
-            focussed_released_ptr;
-        titlebar_button_ptr->focussed_pressed_wlr_buffer_ptr =
-            focussed_pressed_ptr;
-        titlebar_button_ptr->blurred_wlr_buffer_ptr = blurred_ptr;
-
-        update_buffers(titlebar_button_ptr);
-        return true;
     }
 
-    wlr_buffer_drop_nullify(&focussed_released_ptr);
-    wlr_buffer_drop_nullify(&focussed_pressed_ptr);
-    wlr_buffer_drop_nullify(&blurred_ptr);
-    return false;
+    update_buffers(titlebar_button_ptr);
+    return true;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -211,20 +238,34 @@ void titlebar_button_clicked(wlmtk_button_t *button_ptr)
 }
 
 /* ------------------------------------------------------------------------- */
-/** Updates the button's buffer depending on activation status. */
+/**
+ * Updates the button's buffer depending on activation status. Draws the
+ * variant for the activation status, if not drawn yet.
+ */
 void update_buffers(wlmtk_titlebar_button_t *titlebar_button_ptr)
 {
-    // No buffer: Nothing to update.
-    if (NULL == titlebar_button_ptr->focussed_released_wlr_buffer_ptr ||
-        NULL == titlebar_button_ptr->focussed_pressed_wlr_buffer_ptr ||
-        NULL == titlebar_button_ptr->blurred_wlr_buffer_ptr) return;
+    bool drawn = titlebar_button_ptr->activated ?
+        (NULL != titlebar_button_ptr->focussed_released_wlr_buffer_ptr &&
+         NULL != titlebar_button_ptr->focussed_pressed_wlr_buffer_ptr) :
+        NULL != titlebar_button_ptr->blurred_wlr_buffer_ptr;
+    if (!drawn && NULL != titlebar_button_ptr->pending_gfxbuf_ptr) {
+        if (!draw_variant(titlebar_button_ptr,
+                          titlebar_button_ptr->pending_gfxbuf_ptr, 0,
+                          titlebar_button_ptr->activated)) return;
+    }
 
     if (titlebar_button_ptr->activated) {
+        // No buffer: Nothing to update.
+        if (NULL == titlebar_button_ptr->focussed_released_wlr_buffer_ptr ||
+            NULL == titlebar_button_ptr->focussed_pressed_wlr_buffer_ptr) {
+            return;
+        }
         wlmtk_button_set(
             &titlebar_button_ptr->super_button,
             titlebar_button_ptr->focussed_released_wlr_buffer_ptr,
             titlebar_button_ptr->focussed_pressed_wlr_buffer_ptr);
     } else {
+        if (NULL == titlebar_button_ptr->blurred_wlr_buffer_ptr) return;
         wlmtk_button_set(
             &titlebar_button_ptr->super_button,
             titlebar_button_ptr->blurred_wlr_buffer_ptr,
@@ -232,6 +273,57 @@ void update_buffers(wlmtk_titlebar_button_t *titlebar_button_ptr)
     }
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Draws the focussed or the blurred variant of the button, and stores the
+ * buffers in `titlebar_button_ptr`.
+ *
+ * @param titlebar_button_ptr
+ * @param gfxbuf_ptr          Background for the variant.
+ * @param position            Position of the button within `gfxbuf_ptr`.
+ * @param activated           Whether to draw the focussed variant.
+ *
+ * @return true on success.
+ */
+bool draw_variant(
+    wlmtk_titlebar_button_t *titlebar_button_ptr,
+    bs_gfxbuf_t *gfxbuf_ptr,
+    int position,
+    bool activated)
+{
+    const wlmtk_titlebar_style_t *style_ptr = &titlebar_button_ptr->style;
+    if (!activated) {
+        struct wlr_buffer *blurred_ptr = create_buf(
+            gfxbuf_ptr, position, false, style_ptr,
+            titlebar_button_ptr->draw);
+        if (NULL == blurred_ptr) return false;
+        wlr_buffer_drop_nullify(&titlebar_button_ptr->blurred_wlr_buffer_ptr);
+        titlebar_button_ptr->blurred_wlr_buffer_ptr = blurred_ptr;
+        return true;
+    }
+
+    struct wlr_buffer *focussed_released_ptr = create_buf(
+        gfxbuf_ptr, position, false, style_ptr,
+        titlebar_button_ptr->draw);
+    struct wlr_buffer *focussed_pressed_ptr = create_buf(
+        gfxbuf_ptr, position, true, style_ptr,
+        titlebar_button_ptr->draw);
+    if (NULL == focussed_released_ptr || NULL == focussed_pressed_ptr) {
+        wlr_buffer_drop_nullify(&focussed_released_ptr);
+        wlr_buffer_drop_nullify(&focussed_pressed_ptr);
+        return false;
+    }
+    wlr_buffer_drop_nullify(
+        &titlebar_button_ptr->focussed_released_wlr_buffer_ptr);
+    wlr_buffer_drop_nullify(
+        &titlebar_button_ptr->focussed_pressed_wlr_buffer_ptr);
+    titlebar_button_ptr->focussed_released_wlr_buffer_ptr =
+        focussed_released_ptr;
+    titlebar_button_ptr->focussed_pressed_wlr_buffer_ptr =
+        focussed_pressed_ptr;
+    return true;
+}
+
 /* ------------------------------------------------------------------------- */
 /** Helper: Creates a WLR buffer for the button. */
 struct wlr_buffer *create_buf(
@@ -301,6 +393,8 @@ void test_button(bs_test_t *test_ptr)
     BS_TEST_VERIFY_TRUE(
         test_ptr,
         wlmtk_titlebar_button_redraw(button_ptr, f_ptr, b_ptr, 30, &style));
+    // The blurred variant is only drawn once needed.
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, button_ptr->blurred_wlr_buffer_ptr);
     bs_gfxbuf_destroy(b_ptr);
     bs_gfxbuf_destroy(f_ptr);
     BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
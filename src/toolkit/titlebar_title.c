@@ -23,6 +23,7 @@
 #include "buffer.h"
 #include "gfxbuf.h"
 #include "primitives.h"
+#include "title_cache.h"
 #include "window.h"
 
 #define WLR_USE_UNSTABLE
@@ -38,10 +39,21 @@ struct _wlmtk_titlebar_title_t {
     /** Pointer to the window the title element belongs to. */
     wlmtk_window_t            *window_ptr;
 
-    /** The drawn title, when focussed. */
+    /** The drawn title, when focussed. Locked, from the title cache. */
     struct wlr_buffer         *focussed_wlr_buffer_ptr;
-    /** The drawn title, when blurred. */
+    /** The drawn title, when blurred. Locked, from the title cache. */
     struct wlr_buffer         *blurred_wlr_buffer_ptr;
+
+    /** Whether the variant `pending_activated` is not drawn yet. */
+    bool                      pending;
+    /** Background of the pending variant. Re-used across redraws. */
+    bs_gfxbuf_t               *pending_gfxbuf_ptr;
+    /** Whether the pending variant is the focussed one. */
+    bool                      pending_activated;
+    /** Text color for the pending variant. */
+    uint32_t                  pending_text_color;
+    /** Title for the pending variant. */
+    char                      *pending_title_ptr;
 };
 
 static void _wlmtk_titlebar_title_element_destroy(
@@ -56,13 +68,13 @@ static bool _wlmtk_titlebar_title_element_pointer_axis(
 static void title_set_activated(
     wlmtk_titlebar_title_t *titlebar_title_ptr,
     bool activated);
-struct wlr_buffer *title_create_buffer(
-    bs_gfxbuf_t *gfxbuf_ptr,
-    unsigned position,
+static void title_unlock_nullify(struct wlr_buffer **wlr_buffer_ptr_ptr);
+static bool title_prepare_pending(
+    wlmtk_titlebar_title_t *titlebar_title_ptr,
     unsigned width,
-    uint32_t text_color,
-    const char *title_ptr,
-    const wlmtk_titlebar_style_t *style_ptr);
+    unsigned height,
+    const char *title_ptr);
+static void title_clear_pending(wlmtk_titlebar_title_t *titlebar_title_ptr);
 
 /* == Data ================================================================= */
 
@@ -99,8 +111,9 @@ wlmtk_titlebar_title_t *wlmtk_titlebar_title_create(
 /* ------------------------------------------------------------------------- */
 void wlmtk_titlebar_title_destroy(wlmtk_titlebar_title_t *titlebar_title_ptr)
 {
-    wlr_buffer_drop_nullify(&titlebar_title_ptr->focussed_wlr_buffer_ptr);
-    wlr_buffer_drop_nullify(&titlebar_title_ptr->blurred_wlr_buffer_ptr);
+    title_unlock_nullify(&titlebar_title_ptr->focussed_wlr_buffer_ptr);
+    title_unlock_nullify(&titlebar_title_ptr->blurred_wlr_buffer_ptr);
+    title_clear_pending(titlebar_title_ptr);
     wlmtk_buffer_fini(&titlebar_title_ptr->super_buffer);
     free(titlebar_title_ptr);
 }
@@ -116,32 +129,44 @@ bool wlmtk_titlebar_title_redraw(
     const char *title_ptr,
     const wlmtk_titlebar_style_t *style_ptr)
 {
-    BS_ASSERT(focussed_gfxbuf_ptr->width == blurred_gfxbuf_ptr->width);
-    BS_ASSERT(style_ptr->height == focussed_gfxbuf_ptr->height);
-    BS_ASSERT(style_ptr->height == blurred_gfxbuf_ptr->height);
+    BS_ASSERT(style_ptr->height <= focussed_gfxbuf_ptr->height);
+    BS_ASSERT(style_ptr->height <= blurred_gfxbuf_ptr->height);
     BS_ASSERT(position <= (int)focussed_gfxbuf_ptr->width);
     BS_ASSERT(position + width <= (int)focussed_gfxbuf_ptr->width);
+    BS_ASSERT(position + width <= (int)blurred_gfxbuf_ptr->width);
 
     if (NULL == title_ptr) title_ptr = "";
 
-    struct wlr_buffer *focussed_wlr_buffer_ptr = title_create_buffer(
-        focussed_gfxbuf_ptr, position, width,
-        style_ptr->focussed_text_color, title_ptr, style_ptr);
-    struct wlr_buffer *blurred_wlr_buffer_ptr = title_create_buffer(
-        blurred_gfxbuf_ptr, position, width,
-        style_ptr->blurred_text_color, title_ptr, style_ptr);
-
-    if (NULL == focussed_wlr_buffer_ptr ||
-        NULL == blurred_wlr_buffer_ptr) {
-        wlr_buffer_drop_nullify(&focussed_wlr_buffer_ptr);
-        wlr_buffer_drop_nullify(&blurred_wlr_buffer_ptr);
+    // Only draws the visible variant. Keeps what's needed for the other.
+    struct wlr_buffer *wlr_buffer_ptr = wlmtk_title_cache_acquire(
+        activated ? focussed_gfxbuf_ptr : blurred_gfxbuf_ptr,
+        position, width, style_ptr->height,
+        activated ?
+        style_ptr->focussed_text_color : style_ptr->blurred_text_color,
+        title_ptr);
+    if (NULL == wlr_buffer_ptr) return false;
+    if (!title_prepare_pending(
+            titlebar_title_ptr, width, style_ptr->height, title_ptr)) {
+        wlr_buffer_unlock(wlr_buffer_ptr);
         return false;
     }
+    bs_gfxbuf_copy_area(
+        titlebar_title_ptr->pending_gfxbuf_ptr, 0, 0,
+        activated ? blurred_gfxbuf_ptr : focussed_gfxbuf_ptr,
+        position, 0, width, style_ptr->height);
+
+    title_unlock_nullify(&titlebar_title_ptr->focussed_wlr_buffer_ptr);
+    title_unlock_nullify(&titlebar_title_ptr->blurred_wlr_buffer_ptr);
+    if (activated) {
+        titlebar_title_ptr->focussed_wlr_buffer_ptr = wlr_buffer_ptr;
+    } else {
+        titlebar_title_ptr->blurred_wlr_buffer_ptr = wlr_buffer_ptr;
+    }
 
-    wlr_buffer_drop_nullify(&titlebar_title_ptr->focussed_wlr_buffer_ptr);
-    titlebar_title_ptr->focussed_wlr_buffer_ptr = focussed_wlr_buffer_ptr;
-    wlr_buffer_drop_nullify(&titlebar_title_ptr->blurred_wlr_buffer_ptr);
-    titlebar_title_ptr->blurred_wlr_buffer_ptr = blurred_wlr_buffer_ptr;
+    titlebar_title_ptr->pending = true;
+    titlebar_title_ptr->pending_activated = !activated;
+    titlebar_title_ptr->pending_text_color = activated ?
+        style_ptr->blurred_text_color : style_ptr->focussed_text_color;
 
     title_set_activated(titlebar_title_ptr, activated);
     return true;
@@ -231,7 +256,8 @@ bool _wlmtk_titlebar_title_element_pointer_axis(
 
 /* ------------------------------------------------------------------------- */
 /**
- * Sets whether the title is drawn focussed (activated) or blurred.
+ * Sets whether the title is drawn focussed (activated) or blurred. Draws the
+ * respective variant, if it is still pending.
  *
  * @param titlebar_title_ptr
  * @param activated
@@ -240,6 +266,26 @@ void title_set_activated(
     wlmtk_titlebar_title_t *titlebar_title_ptr,
     bool activated)
 {
+    if (titlebar_title_ptr->pending &&
+        titlebar_title_ptr->pending_activated == activated) {
+        struct wlr_buffer *wlr_buffer_ptr = wlmtk_title_cache_acquire(
+            titlebar_title_ptr->pending_gfxbuf_ptr, 0,
+            titlebar_title_ptr->pending_gfxbuf_ptr->width,
+            titlebar_title_ptr->pending_gfxbuf_ptr->height,
+            titlebar_title_ptr->pending_text_color,
+            titlebar_title_ptr->pending_title_ptr);
+        if (NULL == wlr_buffer_ptr) {
+            bs_log(BS_WARNING, "Failed to draw title %p", titlebar_title_ptr);
+            return;
+        }
+        if (activated) {
+            titlebar_title_ptr->focussed_wlr_buffer_ptr = wlr_buffer_ptr;
+        } else {
+            titlebar_title_ptr->blurred_wlr_buffer_ptr = wlr_buffer_ptr;
+        }
+        titlebar_title_ptr->pending = false;
+    }
+
     wlmtk_buffer_set(
         &titlebar_title_ptr->super_buffer,
         activated ?
@@ -247,51 +293,71 @@ void title_set_activated(
         titlebar_title_ptr->blurred_wlr_buffer_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Unlocks the buffer at `*wlr_buffer_ptr_ptr`, if any, and clears it. */
+void title_unlock_nullify(struct wlr_buffer **wlr_buffer_ptr_ptr)
+{
+    if (NULL == *wlr_buffer_ptr_ptr) return;
+    wlr_buffer_unlock(*wlr_buffer_ptr_ptr);
+    *wlr_buffer_ptr_ptr = NULL;
+}
+
 /* ------------------------------------------------------------------------- */
 /**
- * Creates a WLR buffer with the title's texture, as specified.
+ * Prepares the background buffer and title for the pending variant. Re-uses
+ * those of an earlier redraw, if the dimensions resp. the title match.
  *
- * @param gfxbuf_ptr
- * @param position
+ * @param titlebar_title_ptr
  * @param width
- * @param text_color
+ * @param height
  * @param title_ptr
- * @param style_ptr
  *
- * @return A pointer to a `struct wlr_buffer` with the texture.
+ * @return true on success.
  */
-struct wlr_buffer *title_create_buffer(
-    bs_gfxbuf_t *gfxbuf_ptr,
-    unsigned position,
+bool title_prepare_pending(
+    wlmtk_titlebar_title_t *titlebar_title_ptr,
     unsigned width,
-    uint32_t text_color,
-    const char *title_ptr,
-    const wlmtk_titlebar_style_t *style_ptr)
+    unsigned height,
+    const char *title_ptr)
 {
-    BS_ASSERT(NULL != title_ptr);
-    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(
-        width, style_ptr->height);
-    if (NULL == wlr_buffer_ptr) return NULL;
+    if (NULL != titlebar_title_ptr->pending_gfxbuf_ptr &&
+        (titlebar_title_ptr->pending_gfxbuf_ptr->width != width ||
+         titlebar_title_ptr->pending_gfxbuf_ptr->height != height)) {
+        bs_gfxbuf_destroy(titlebar_title_ptr->pending_gfxbuf_ptr);
+        titlebar_title_ptr->pending_gfxbuf_ptr = NULL;
+        titlebar_title_ptr->pending = false;
+    }
+    if (NULL == titlebar_title_ptr->pending_gfxbuf_ptr) {
+        titlebar_title_ptr->pending_gfxbuf_ptr = bs_gfxbuf_create(
+            width, height);
+        if (NULL == titlebar_title_ptr->pending_gfxbuf_ptr) return false;
+    }
 
-    bs_gfxbuf_copy_area(
-        bs_gfxbuf_from_wlr_buffer(wlr_buffer_ptr),
-        0, 0,
-        gfxbuf_ptr,
-        position, 0,
-        width, style_ptr->height);
-
-    cairo_t *cairo_ptr = cairo_create_from_wlr_buffer(wlr_buffer_ptr);
-    if (NULL == cairo_ptr) {
-        wlr_buffer_drop(wlr_buffer_ptr);
-        return NULL;
+    if (NULL == titlebar_title_ptr->pending_title_ptr ||
+        0 != strcmp(titlebar_title_ptr->pending_title_ptr, title_ptr)) {
+        char *pending_title_ptr = logged_strdup(title_ptr);
+        if (NULL == pending_title_ptr) return false;
+        if (NULL != titlebar_title_ptr->pending_title_ptr) {
+            free(titlebar_title_ptr->pending_title_ptr);
+        }
+        titlebar_title_ptr->pending_title_ptr = pending_title_ptr;
     }
-    wlmaker_primitives_draw_bezel_at(
-        cairo_ptr, 0, 0, width, style_ptr->height, 1.0, true);
-    wlmaker_primitives_draw_window_title(
-        cairo_ptr, title_ptr, text_color);
-    cairo_destroy(cairo_ptr);
+    return true;
+}
 
-    return wlr_buffer_ptr;
+/* ------------------------------------------------------------------------- */
+/** Releases the resources kept for drawing the pending variant. */
+void title_clear_pending(wlmtk_titlebar_title_t *titlebar_title_ptr)
+{
+    titlebar_title_ptr->pending = false;
+    if (NULL != titlebar_title_ptr->pending_gfxbuf_ptr) {
+        bs_gfxbuf_destroy(titlebar_title_ptr->pending_gfxbuf_ptr);
+        titlebar_title_ptr->pending_gfxbuf_ptr = NULL;
+    }
+    if (NULL != titlebar_title_ptr->pending_title_ptr) {
+        free(titlebar_title_ptr->pending_title_ptr);
+        titlebar_title_ptr->pending_title_ptr = NULL;
+    }
 }
 
 /* == Unit tests =========================================================== */
@@ -336,10 +402,9 @@ void test_title(bs_test_t *test_ptr)
         test_ptr,
         bs_gfxbuf_from_wlr_buffer(titlebar_title_ptr->focussed_wlr_buffer_ptr),
         "toolkit/title_focussed.png");
-    BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
-        test_ptr,
-        bs_gfxbuf_from_wlr_buffer(titlebar_title_ptr->blurred_wlr_buffer_ptr),
-        "toolkit/title_blurred.png");
+    // The blurred variant is only drawn once needed.
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL, titlebar_title_ptr->blurred_wlr_buffer_ptr);
 
     // We had started as "activated", verify that's correct.
     wlmtk_buffer_t *super_buffer_ptr = &titlebar_title_ptr->super_buffer;
@@ -350,11 +415,27 @@ void test_title(bs_test_t *test_ptr)
 
     // De-activated the title. Verify that was propagated.
     title_set_activated(titlebar_title_ptr, false);
+    BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
+        test_ptr,
+        bs_gfxbuf_from_wlr_buffer(titlebar_title_ptr->blurred_wlr_buffer_ptr),
+        "toolkit/title_blurred.png");
     BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
         test_ptr,
         bs_gfxbuf_from_wlr_buffer(super_buffer_ptr->wlr_buffer_ptr),
         "toolkit/title_blurred.png");
 
+    // Redraw at the same width: Re-uses the pending background buffer.
+    bs_gfxbuf_t *pending_gfxbuf_ptr = titlebar_title_ptr->pending_gfxbuf_ptr;
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_titlebar_title_redraw(
+            titlebar_title_ptr,
+            focussed_gfxbuf_ptr, blurred_gfxbuf_ptr,
+            10, 90, false, "Title", &style));
+    BS_TEST_VERIFY_TRUE(test_ptr, titlebar_title_ptr->pending);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, pending_gfxbuf_ptr, titlebar_title_ptr->pending_gfxbuf_ptr);
+
     // Redraw with shorter width. Verify that's still correct.
     wlmtk_titlebar_title_redraw(
         titlebar_title_ptr, focussed_gfxbuf_ptr, blurred_gfxbuf_ptr,
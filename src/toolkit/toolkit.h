@@ -38,6 +38,7 @@
 #include "content.h"
 #include "element.h"
 #include "env.h"
+#include "fill_cache.h"
 #include "fsm.h"
 #include "input.h"
 #include "panel.h"
@@ -45,10 +46,13 @@
 #include "rectangle.h"
 #include "resizebar.h"
 #include "resizebar_area.h"
+#include "spatial_index.h"
 #include "surface.h"
+#include "title_cache.h"
 #include "titlebar.h"
 #include "titlebar_button.h"
 #include "titlebar_title.h"
+#include "trace.h"
 #include "util.h"
 #include "window.h"
 #include "workspace.h"
@@ -0,0 +1,375 @@
+/* ========================================================================= */
+/**
+ * @file toolkit_bench.c
+ *
+ * @copyright
+ * Copyright 2024 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "toolkit.h"
+
+#include <inttypes.h>
+
+/* == Declarations ========================================================= */
+
+/** A synthetic tree: Workspaces, each with decorated windows mapped. */
+typedef struct {
+    /** Number of workspaces. */
+    size_t                    workspaces;
+    /** Number of windows per workspace. */
+    size_t                    windows;
+    /** The workspaces, `workspaces` elements. */
+    wlmtk_fake_workspace_t    **fake_workspaces_ptr;
+    /** The windows, `workspaces` x `windows` elements. */
+    wlmtk_fake_window_t       **fake_windows_ptr;
+} bench_tree_t;
+
+/** A benchmark: Runs `iterations` operations on the tree. */
+typedef struct {
+    /** Name, as reported. */
+    const char                *name_ptr;
+    /** Runs the benchmark for `iterations` operations. */
+    void                      (*run)(bench_tree_t *tree_ptr,
+                                     uint64_t iterations);
+} bench_t;
+
+static bench_tree_t *bench_tree_create(size_t workspaces, size_t windows);
+static void bench_tree_destroy(bench_tree_t *tree_ptr);
+static wlmtk_fake_window_t *bench_tree_window(
+    bench_tree_t *tree_ptr, uint64_t i);
+
+static void bench_pointer_motion(bench_tree_t *tree_ptr, uint64_t iterations);
+static void bench_raise_activate(bench_tree_t *tree_ptr, uint64_t iterations);
+static void bench_map_unmap(bench_tree_t *tree_ptr, uint64_t iterations);
+static void bench_resize_configure(
+    bench_tree_t *tree_ptr, uint64_t iterations);
+static void bench_titlebar_redraw(bench_tree_t *tree_ptr, uint64_t iterations);
+static void bench_titlebar_retitle(
+    bench_tree_t *tree_ptr, uint64_t iterations);
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void *__wrap_malloc(size_t size);
+void *__wrap_calloc(size_t nmemb, size_t size);
+void *__wrap_realloc(void *ptr, size_t size);
+
+/* == Data ================================================================= */
+
+/** Allocations made by the toolkit and libbase. See `__wrap_malloc`. */
+static uint64_t               bench_allocations;
+
+/** The benchmarks. */
+static const bench_t          benchmarks[] = {
+    { "pointer_motion", bench_pointer_motion },
+    { "raise_activate", bench_raise_activate },
+    { "map_unmap", bench_map_unmap },
+    { "resize_configure", bench_resize_configure },
+    { "titlebar_redraw", bench_titlebar_redraw },
+    { "titlebar_retitle", bench_titlebar_retitle },
+    { NULL, NULL }
+};
+
+/** Default number of workspaces. */
+static const size_t           bench_default_workspaces = 4;
+/** Default number of windows per workspace. */
+static const size_t           bench_default_windows = 16;
+/** Each benchmark runs for at least this long. */
+static const uint64_t         bench_min_duration_usec = 200000;
+
+/* == Main program ========================================================= */
+
+/**
+ * Main program: Runs the toolkit benchmarks.
+ *
+ * Usage: toolkit_bench [workspaces [windows [filter]]]
+ *
+ * Each benchmark runs on a fresh tree of `workspaces` x `windows` decorated
+ * windows, and reports one JSON object per line: Name, tree size, number of
+ * iterations, nanoseconds and allocations per operation. Allocations are
+ * counted for calls from the toolkit and libbase, which are linked
+ * statically; allocations within cairo or wlroots are not included.
+ *
+ * @param argc
+ * @param argv
+ *
+ * @return 0 on success.
+ */
+int main(int argc, const char **argv)
+{
+    size_t workspaces = bench_default_workspaces;
+    size_t windows = bench_default_windows;
+    const char *filter_ptr = NULL;
+    if (1 < argc) workspaces = strtoul(argv[1], NULL, 10);
+    if (2 < argc) windows = strtoul(argv[2], NULL, 10);
+    if (3 < argc) filter_ptr = argv[3];
+    if (0 == workspaces || 0 == windows) {
+        fprintf(stderr, "Usage: %s [workspaces [windows [filter]]]\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+    bs_log_severity = BS_WARNING;
+
+    for (const bench_t *bench_ptr = &benchmarks[0];
+         NULL != bench_ptr->name_ptr;
+         ++bench_ptr) {
+        if (NULL != filter_ptr &&
+            NULL == strstr(bench_ptr->name_ptr, filter_ptr)) continue;
+
+        bench_tree_t *tree_ptr = bench_tree_create(workspaces, windows);
+        if (NULL == tree_ptr) return EXIT_FAILURE;
+
+        // Warm up, then double the iterations until it runs long enough.
+        bench_ptr->run(tree_ptr, 1);
+        uint64_t iterations = 1, duration_usec = 0, allocations = 0;
+        for (;;) {
+            uint64_t start_allocations = bench_allocations;
+            uint64_t start_usec = wlmtk_util_now_usec();
+            bench_ptr->run(tree_ptr, iterations);
+            duration_usec = wlmtk_util_now_usec() - start_usec;
+            allocations = bench_allocations - start_allocations;
+            if (duration_usec >= bench_min_duration_usec) break;
+            iterations *= 2;
+        }
+
+        printf("{\"benchmark\": \"%s\", \"workspaces\": %zu, "
+               "\"windows\": %zu, \"iterations\": %"PRIu64", "
+               "\"ns_per_op\": %.1f, \"allocs_per_op\": %.2f}\n",
+               bench_ptr->name_ptr, workspaces, windows, iterations,
+               1000.0 * duration_usec / iterations,
+               (double)allocations / iterations);
+        fflush(stdout);
+        bench_tree_destroy(tree_ptr);
+    }
+
+    wlmtk_title_cache_purge();
+    wlmtk_fill_cache_purge();
+    return EXIT_SUCCESS;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates the synthetic tree: `workspaces` fake workspaces, each with
+ * `windows` titled, server-side decorated windows mapped in a cascade.
+ *
+ * @param workspaces
+ * @param windows
+ *
+ * @return Pointer to the tree, or NULL on error. Must be destroyed by
+ *     calling @ref bench_tree_destroy.
+ */
+bench_tree_t *bench_tree_create(size_t workspaces, size_t windows)
+{
+    bench_tree_t *tree_ptr = logged_calloc(1, sizeof(bench_tree_t));
+    if (NULL == tree_ptr) return NULL;
+    tree_ptr->workspaces = workspaces;
+    tree_ptr->windows = windows;
+    tree_ptr->fake_workspaces_ptr = logged_calloc(
+        workspaces, sizeof(wlmtk_fake_workspace_t*));
+    tree_ptr->fake_windows_ptr = logged_calloc(
+        workspaces * windows, sizeof(wlmtk_fake_window_t*));
+    if (NULL == tree_ptr->fake_workspaces_ptr ||
+        NULL == tree_ptr->fake_windows_ptr) {
+        bench_tree_destroy(tree_ptr);
+        return NULL;
+    }
+
+    for (size_t ws = 0; ws < workspaces; ++ws) {
+        wlmtk_fake_workspace_t *fws_ptr = wlmtk_fake_workspace_create(
+            1920, 1080);
+        if (NULL == fws_ptr) {
+            bench_tree_destroy(tree_ptr);
+            return NULL;
+        }
+        tree_ptr->fake_workspaces_ptr[ws] = fws_ptr;
+
+        for (size_t w = 0; w < windows; ++w) {
+            wlmtk_fake_window_t *fw_ptr = wlmtk_fake_window_create();
+            if (NULL == fw_ptr) {
+                bench_tree_destroy(tree_ptr);
+                return NULL;
+            }
+            tree_ptr->fake_windows_ptr[ws * windows + w] = fw_ptr;
+
+            char title[64];
+            snprintf(title, sizeof(title), "Window %zu", w);
+            wlmtk_window_set_title(fw_ptr->window_ptr, title);
+            wlmtk_window_set_server_side_decorated(fw_ptr->window_ptr, true);
+            wlmtk_window_request_position_and_size(
+                fw_ptr->window_ptr,
+                (w * 24) % 1200, (w * 24) % 600, 640, 400);
+            wlmtk_fake_window_commit_size(fw_ptr);
+            wlmtk_workspace_map_window(
+                fws_ptr->workspace_ptr, fw_ptr->window_ptr);
+        }
+    }
+    return tree_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroys the tree. Unmaps and destroys all windows and workspaces. */
+void bench_tree_destroy(bench_tree_t *tree_ptr)
+{
+    if (NULL != tree_ptr->fake_windows_ptr) {
+        for (size_t i = 0; i < tree_ptr->workspaces * tree_ptr->windows; ++i) {
+            wlmtk_fake_window_t *fw_ptr = tree_ptr->fake_windows_ptr[i];
+            if (NULL == fw_ptr) continue;
+            wlmtk_workspace_t *workspace_ptr = wlmtk_window_get_workspace(
+                fw_ptr->window_ptr);
+            if (NULL != workspace_ptr) {
+                wlmtk_workspace_unmap_window(
+                    workspace_ptr, fw_ptr->window_ptr);
+            }
+            wlmtk_fake_window_destroy(fw_ptr);
+        }
+        free(tree_ptr->fake_windows_ptr);
+        tree_ptr->fake_windows_ptr = NULL;
+    }
+    if (NULL != tree_ptr->fake_workspaces_ptr) {
+        for (size_t ws = 0; ws < tree_ptr->workspaces; ++ws) {
+            if (NULL == tree_ptr->fake_workspaces_ptr[ws]) continue;
+            wlmtk_fake_workspace_destroy(tree_ptr->fake_workspaces_ptr[ws]);
+        }
+        free(tree_ptr->fake_workspaces_ptr);
+        tree_ptr->fake_workspaces_ptr = NULL;
+    }
+    free(tree_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return The `i`-th window of the tree, wrapping around. */
+wlmtk_fake_window_t *bench_tree_window(bench_tree_t *tree_ptr, uint64_t i)
+{
+    return tree_ptr->fake_windows_ptr[
+        i % (tree_ptr->workspaces * tree_ptr->windows)];
+}
+
+/* ------------------------------------------------------------------------- */
+/** Moves the pointer across the first workspace, in a coarse raster. */
+void bench_pointer_motion(bench_tree_t *tree_ptr, uint64_t iterations)
+{
+    wlmtk_workspace_t *workspace_ptr =
+        tree_ptr->fake_workspaces_ptr[0]->workspace_ptr;
+    for (uint64_t i = 0; i < iterations; ++i) {
+        wlmtk_workspace_motion(
+            workspace_ptr, (i * 37) % 1920, (i * 53) % 1080, i);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Activates and raises the windows, in turn. */
+void bench_raise_activate(bench_tree_t *tree_ptr, uint64_t iterations)
+{
+    for (uint64_t i = 0; i < iterations; ++i) {
+        wlmtk_fake_window_t *fw_ptr = bench_tree_window(tree_ptr, i);
+        wlmtk_workspace_t *workspace_ptr = wlmtk_window_get_workspace(
+            fw_ptr->window_ptr);
+        wlmtk_workspace_activate_window(workspace_ptr, fw_ptr->window_ptr);
+        wlmtk_workspace_raise_window(workspace_ptr, fw_ptr->window_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Unmaps and re-maps the windows, in turn. One operation is both. */
+void bench_map_unmap(bench_tree_t *tree_ptr, uint64_t iterations)
+{
+    for (uint64_t i = 0; i < iterations; ++i) {
+        wlmtk_fake_window_t *fw_ptr = bench_tree_window(tree_ptr, i);
+        wlmtk_workspace_t *workspace_ptr = wlmtk_window_get_workspace(
+            fw_ptr->window_ptr);
+        wlmtk_workspace_unmap_window(workspace_ptr, fw_ptr->window_ptr);
+        wlmtk_workspace_map_window(workspace_ptr, fw_ptr->window_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Requests a new size for the windows, and commits it. Only changes the
+ * height, so the decorations are not redrawn.
+ */
+void bench_resize_configure(bench_tree_t *tree_ptr, uint64_t iterations)
+{
+    for (uint64_t i = 0; i < iterations; ++i) {
+        wlmtk_fake_window_t *fw_ptr = bench_tree_window(tree_ptr, i);
+        wlmtk_window_request_position_and_size(
+            fw_ptr->window_ptr, 100, 100, 640, 300 + i % 100);
+        wlmtk_fake_window_commit_size(fw_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Changes the windows' width, which redraws titlebar and resizebar. Cycles
+ * through a few widths, so caches see repeated sizes.
+ */
+void bench_titlebar_redraw(bench_tree_t *tree_ptr, uint64_t iterations)
+{
+    for (uint64_t i = 0; i < iterations; ++i) {
+        wlmtk_fake_window_t *fw_ptr = bench_tree_window(tree_ptr, i);
+        wlmtk_window_request_position_and_size(
+            fw_ptr->window_ptr, 100, 100, 400 + 8 * (i % 16), 300);
+        wlmtk_fake_window_commit_size(fw_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Changes the windows' titles, as a terminal would with a progress counter:
+ * The titles share a common prefix and change in every call.
+ */
+void bench_titlebar_retitle(bench_tree_t *tree_ptr, uint64_t iterations)
+{
+    static uint64_t counter = 0;
+    for (uint64_t i = 0; i < iterations; ++i, ++counter) {
+        wlmtk_fake_window_t *fw_ptr = bench_tree_window(tree_ptr, i);
+        char title[64];
+        snprintf(title, sizeof(title), "user@host: ~/src/wlmaker [%"PRIu64"]",
+                 counter % 1000);
+        wlmtk_window_set_title(fw_ptr->window_ptr, title);
+    }
+}
+
+/* == Allocation counting ================================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Counts `malloc` calls. Linked with `-Wl,--wrap=malloc`, so this applies to
+ * the statically linked objects only: The toolkit, libbase and this file.
+ */
+void *__wrap_malloc(size_t size)
+{
+    ++bench_allocations;
+    return __real_malloc(size);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Counts `calloc` calls. See @ref __wrap_malloc. */
+void *__wrap_calloc(size_t nmemb, size_t size)
+{
+    ++bench_allocations;
+    return __real_calloc(nmemb, size);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Counts `realloc` calls. See @ref __wrap_malloc. */
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    ++bench_allocations;
+    return __real_realloc(ptr, size);
+}
+
+/* == End of toolkit_bench.c =============================================== */
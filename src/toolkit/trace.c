@@ -0,0 +1,242 @@
+/* ========================================================================= */
+/**
+ * @file trace.c
+ *
+ * @copyright
+ * Copyright 2024 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/// open_memstream() is a POSIX extension.
+#define _POSIX_C_SOURCE 200809L
+
+#include "trace.h"
+
+#include "util.h"
+
+#include <inttypes.h>
+#include <unistd.h>
+
+/* == Declarations ========================================================= */
+
+/** A recorded trace event. */
+typedef struct {
+    /** Name of the event. */
+    const char                *name_ptr;
+    /** Start time, in microseconds. */
+    uint64_t                  start_usec;
+    /** Duration, in microseconds. */
+    uint64_t                  duration_usec;
+} wlmtk_trace_event_t;
+
+/** State of the tracer. */
+typedef struct {
+    /** Ring of events. */
+    wlmtk_trace_event_t       *events_ptr;
+    /** Capacity of the ring. */
+    size_t                    capacity;
+    /** Number of events recorded since init. Indexes the ring, modulo. */
+    uint64_t                  recorded;
+} wlmtk_trace_t;
+
+/* == Data ================================================================= */
+
+bool wlmtk_trace_enabled = false;
+
+/** The tracer. */
+static wlmtk_trace_t _wlmtk_trace = {};
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_trace_init(size_t capacity)
+{
+    BS_ASSERT(0 < capacity);
+    wlmtk_trace_fini();
+
+    _wlmtk_trace.events_ptr = logged_calloc(
+        capacity, sizeof(wlmtk_trace_event_t));
+    if (NULL == _wlmtk_trace.events_ptr) return false;
+    _wlmtk_trace.capacity = capacity;
+    _wlmtk_trace.recorded = 0;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_trace_fini(void)
+{
+    wlmtk_trace_enabled = false;
+    if (NULL != _wlmtk_trace.events_ptr) {
+        free(_wlmtk_trace.events_ptr);
+        _wlmtk_trace.events_ptr = NULL;
+    }
+    _wlmtk_trace.capacity = 0;
+    _wlmtk_trace.recorded = 0;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_trace_set_enabled(bool enabled)
+{
+    if (enabled && NULL == _wlmtk_trace.events_ptr) {
+        bs_log(BS_WARNING, "Trace buffer not initialized, not enabling.");
+        return;
+    }
+    wlmtk_trace_enabled = enabled;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_trace_record(
+    const char *name_ptr,
+    uint64_t start_usec,
+    uint64_t end_usec)
+{
+    if (NULL == _wlmtk_trace.events_ptr) return;
+
+    wlmtk_trace_event_t *event_ptr = &_wlmtk_trace.events_ptr[
+        _wlmtk_trace.recorded % _wlmtk_trace.capacity];
+    event_ptr->name_ptr = name_ptr;
+    event_ptr->start_usec = start_usec;
+    event_ptr->duration_usec = end_usec - start_usec;
+    ++_wlmtk_trace.recorded;
+}
+
+/* ------------------------------------------------------------------------- */
+size_t wlmtk_trace_size(void)
+{
+    return BS_MIN(_wlmtk_trace.recorded, _wlmtk_trace.capacity);
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_trace_write_json(FILE *file_ptr)
+{
+    pid_t pid = getpid();
+    size_t size = wlmtk_trace_size();
+    uint64_t first = _wlmtk_trace.recorded - size;
+
+    fprintf(file_ptr, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    for (uint64_t i = first; i < _wlmtk_trace.recorded; ++i) {
+        const wlmtk_trace_event_t *event_ptr =
+            &_wlmtk_trace.events_ptr[i % _wlmtk_trace.capacity];
+        fprintf(file_ptr, "%s\n{\"name\":", i == first ? "" : ",");
+        wlmtk_util_write_json_string(file_ptr, event_ptr->name_ptr);
+        fprintf(file_ptr,
+                ",\"cat\":\"wlmaker\",\"ph\":\"X\",\"ts\":%"PRIu64
+                ",\"dur\":%"PRIu64",\"pid\":%d,\"tid\":%d}",
+                event_ptr->start_usec, event_ptr->duration_usec,
+                (int)pid, (int)pid);
+    }
+    fprintf(file_ptr, "\n]}\n");
+    return 0 == ferror(file_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_trace_dump(const char *path_ptr)
+{
+    FILE *file_ptr = fopen(path_ptr, "w");
+    if (NULL == file_ptr) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed fopen(%s, \"w\")", path_ptr);
+        return false;
+    }
+
+    bool rv = wlmtk_trace_write_json(file_ptr);
+    if (0 != fclose(file_ptr)) rv = false;
+    if (rv) {
+        bs_log(BS_INFO, "Wrote %zu trace events to %s",
+               wlmtk_trace_size(), path_ptr);
+    } else {
+        bs_log(BS_WARNING, "Failed to write trace events to %s", path_ptr);
+    }
+    return rv;
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_record(bs_test_t *test_ptr);
+static void test_write_json(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmtk_trace_test_cases[] = {
+    { 1, "record", test_record },
+    { 1, "write_json", test_write_json },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Exercises recording through scopes, and wrapping around the ring. */
+void test_record(bs_test_t *test_ptr)
+{
+    // Without buffer: Cannot enable, records nothing.
+    wlmtk_trace_set_enabled(true);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_trace_enabled);
+    wlmtk_trace_record("a", 1, 2);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_trace_size());
+
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, wlmtk_trace_init(3));
+
+    // Disabled: Scope records nothing.
+    wlmtk_trace_scope_t scope = wlmtk_trace_scope_begin("disabled");
+    wlmtk_trace_scope_end(&scope);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_trace_size());
+
+    wlmtk_trace_set_enabled(true);
+    scope = wlmtk_trace_scope_begin("enabled");
+    wlmtk_trace_scope_end(&scope);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, wlmtk_trace_size());
+    BS_TEST_VERIFY_STREQ(
+        test_ptr, "enabled", _wlmtk_trace.events_ptr[0].name_ptr);
+
+    // Wraps around, and overwrites the oldest.
+    wlmtk_trace_record("b", 10, 11);
+    wlmtk_trace_record("c", 20, 22);
+    wlmtk_trace_record("d", 30, 33);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, wlmtk_trace_size());
+    BS_TEST_VERIFY_STREQ(test_ptr, "d", _wlmtk_trace.events_ptr[0].name_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, _wlmtk_trace.events_ptr[0].duration_usec);
+
+    wlmtk_trace_fini();
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_trace_enabled);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies the JSON output, oldest event first. */
+void test_write_json(bs_test_t *test_ptr)
+{
+    char *buf_ptr = NULL;
+    size_t size = 0;
+
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, wlmtk_trace_init(2));
+    wlmtk_trace_record("a", 1, 2);
+    wlmtk_trace_record("b\"", 10, 12);
+    wlmtk_trace_record("c", 20, 23);
+
+    FILE *file_ptr = open_memstream(&buf_ptr, &size);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, file_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_trace_write_json(file_ptr));
+    fclose(file_ptr);
+
+    char expected[256];
+    int pid = getpid();
+    snprintf(expected, sizeof(expected),
+             "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+             "{\"name\":\"b\\\"\",\"cat\":\"wlmaker\",\"ph\":\"X\","
+             "\"ts\":10,\"dur\":2,\"pid\":%d,\"tid\":%d},\n"
+             "{\"name\":\"c\",\"cat\":\"wlmaker\",\"ph\":\"X\","
+             "\"ts\":20,\"dur\":3,\"pid\":%d,\"tid\":%d}\n"
+             "]}\n", pid, pid, pid, pid);
+    BS_TEST_VERIFY_STREQ(test_ptr, expected, buf_ptr);
+    free(buf_ptr);
+
+    wlmtk_trace_fini();
+}
+
+/* == End of trace.c ======================================================= */
@@ -0,0 +1,162 @@
+/* ========================================================================= */
+/**
+ * @file trace.h
+ *
+ * @copyright
+ * Copyright 2024 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMTK_TRACE_H__
+#define __WLMTK_TRACE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <libbase/libbase.h>
+
+#include "util.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Whether trace events are recorded. Checked inline by the trace macros, so
+ * that a disabled tracer costs a load and a branch.
+ *
+ * Use @ref wlmtk_trace_set_enabled to modify.
+ */
+extern bool wlmtk_trace_enabled;
+
+/** A scope being traced. See @ref WLMTK_TRACE_SCOPE. */
+typedef struct {
+    /** Name of the scope. A string literal. NULL if not recorded. */
+    const char                *name_ptr;
+    /** Start time of the scope, in microseconds. */
+    uint64_t                  start_usec;
+} wlmtk_trace_scope_t;
+
+/**
+ * Allocates the trace buffer. Trace events are kept in a ring of
+ * `capacity` events, overwriting the oldest events when full.
+ *
+ * wlmaker runs all event handling on the event loop's thread. The buffer is
+ * not synchronized, and must be recorded to from that thread only.
+ *
+ * @param capacity
+ *
+ * @return true on success.
+ */
+bool wlmtk_trace_init(size_t capacity);
+
+/** Releases the trace buffer. Recording is disabled. */
+void wlmtk_trace_fini(void);
+
+/**
+ * Enables or disables recording. Enabling requires @ref wlmtk_trace_init.
+ *
+ * @param enabled
+ */
+void wlmtk_trace_set_enabled(bool enabled);
+
+/**
+ * Records a complete event into the ring.
+ *
+ * @param name_ptr            Name of the event. Must outlive the trace
+ *                            buffer, eg. a string literal.
+ * @param start_usec
+ * @param end_usec
+ */
+void wlmtk_trace_record(
+    const char *name_ptr,
+    uint64_t start_usec,
+    uint64_t end_usec);
+
+/** @return Number of events currently held in the ring. */
+size_t wlmtk_trace_size(void);
+
+/**
+ * Writes the recorded events in the Chrome trace event JSON format, oldest
+ * first. Can be loaded into chrome://tracing or https://ui.perfetto.dev.
+ *
+ * @param file_ptr
+ *
+ * @return true on success.
+ */
+bool wlmtk_trace_write_json(FILE *file_ptr);
+
+/**
+ * Writes the recorded events to the file at `path_ptr`.
+ *
+ * @see wlmtk_trace_write_json.
+ *
+ * @param path_ptr
+ *
+ * @return true on success.
+ */
+bool wlmtk_trace_dump(const char *path_ptr);
+
+/** Begins a traced scope. See @ref WLMTK_TRACE_SCOPE. */
+static inline wlmtk_trace_scope_t wlmtk_trace_scope_begin(
+    const char *name_ptr)
+{
+    wlmtk_trace_scope_t scope = {};
+    if (wlmtk_trace_enabled) {
+        scope.name_ptr = name_ptr;
+        scope.start_usec = wlmtk_util_now_usec();
+    }
+    return scope;
+}
+
+/** Ends a traced scope. Cleanup function of @ref WLMTK_TRACE_SCOPE. */
+static inline void wlmtk_trace_scope_end(wlmtk_trace_scope_t *scope_ptr)
+{
+    if (NULL == scope_ptr->name_ptr) return;
+    wlmtk_trace_record(
+        scope_ptr->name_ptr, scope_ptr->start_usec, wlmtk_util_now_usec());
+}
+
+#if defined(WLMTK_TRACE)
+/** Helper for @ref WLMTK_TRACE_SCOPE: Concatenates, after expansion. */
+#define _WLMTK_TRACE_CONCAT(_a, _b) _a ## _b
+/** Helper for @ref WLMTK_TRACE_SCOPE: Expands into a per-line name. */
+#define _WLMTK_TRACE_VAR(_line) \
+    _WLMTK_TRACE_CONCAT(_wlmtk_trace_scope_, _line)
+
+/**
+ * Traces the enclosing scope, from this statement to where it is left.
+ *
+ * Expands to nothing, unless compiled with `WLMTK_TRACE` defined (CMake
+ * option `config_TRACE`).
+ *
+ * @param _name               Name of the event. A string literal.
+ */
+#define WLMTK_TRACE_SCOPE(_name)                                        \
+    __attribute__((cleanup(wlmtk_trace_scope_end)))                    \
+    wlmtk_trace_scope_t _WLMTK_TRACE_VAR(__LINE__) =                    \
+        wlmtk_trace_scope_begin(_name)
+#else  // defined(WLMTK_TRACE)
+/** Tracing is compiled out. */
+#define WLMTK_TRACE_SCOPE(_name) do {} while (0)
+#endif  // defined(WLMTK_TRACE)
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmtk_trace_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMTK_TRACE_H__ */
+/* == End of trace.h ======================================================= */
@@ -18,8 +18,13 @@
  * limitations under the License.
  */
 
+/// clock_gettime(2) is a POSIX extension, needs this macro.
+#define _POSIX_C_SOURCE 199309L
+
 #include "util.h"
 
+#include <time.h>
+
 /* == Exported methods ===================================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -42,6 +47,36 @@ void wlmtk_util_disconnect_listener(
     wl_list_remove(&listener_ptr->link);
 }
 
+/* ------------------------------------------------------------------------- */
+uint64_t wlmtk_util_now_usec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* ------------------------------------------------------------------------- */
+uint64_t wlmtk_util_now_msec(void)
+{
+    return wlmtk_util_now_usec() / 1000;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_util_write_json_string(FILE *file_ptr, const char *str_ptr)
+{
+    fputc('"', file_ptr);
+    for (; *str_ptr; ++str_ptr) {
+        if ('"' == *str_ptr || '\\' == *str_ptr) {
+            fprintf(file_ptr, "\\%c", *str_ptr);
+        } else if ((unsigned char)*str_ptr < 0x20) {
+            fprintf(file_ptr, "\\u%04x", (unsigned char)*str_ptr);
+        } else {
+            fputc(*str_ptr, file_ptr);
+        }
+    }
+    fputc('"', file_ptr);
+}
+
 /* == Unit tests =========================================================== */
 
 static void test_listener(bs_test_t *test_ptr);
@@ -20,6 +20,7 @@
 #ifndef __WLMTK_UTIL_H__
 #define __WLMTK_UTIL_H__
 
+#include <stdio.h>
 #include <libbase/libbase.h>
 #include <wayland-server-core.h>
 
@@ -66,6 +67,21 @@ void wlmtk_util_connect_listener_signal(
 void wlmtk_util_disconnect_listener(
     struct wl_listener *listener_ptr);
 
+/** @return Monotonic time, in microseconds. From CLOCK_MONOTONIC. */
+uint64_t wlmtk_util_now_usec(void);
+
+/** @return Monotonic time, in milliseconds. From CLOCK_MONOTONIC. */
+uint64_t wlmtk_util_now_msec(void);
+
+/**
+ * Writes `str_ptr` as a JSON string: In quotes, and with quotes, backslashes
+ * and control characters escaped.
+ *
+ * @param file_ptr
+ * @param str_ptr
+ */
+void wlmtk_util_write_json_string(FILE *file_ptr, const char *str_ptr);
+
 /** Unit test cases. */
 extern const bs_test_case_t wlmtk_util_test_cases[];
 
@@ -626,6 +626,18 @@ void wlmtk_window_serial(wlmtk_window_t *window_ptr, uint32_t serial)
             pending_update_ptr->y);
         _wlmtk_window_release_update(window_ptr, pending_update_ptr);
     }
+
+    // All caught up: The workspace may have a throttled update to send.
+    if (NULL != window_ptr->workspace_ptr &&
+        NULL == window_ptr->pending_updates.head_ptr) {
+        wlmtk_workspace_window_updated(window_ptr->workspace_ptr, window_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+size_t wlmtk_window_pending_update_count(wlmtk_window_t *window_ptr)
+{
+    return bs_dllist_size(&window_ptr->pending_updates);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -351,6 +351,17 @@ void wlmtk_window_request_position_and_size(
  */
 void wlmtk_window_serial(wlmtk_window_t *window_ptr, uint32_t serial);
 
+/**
+ * Returns the number of positional updates that were requested from the
+ * window's content, but are not yet committed through
+ * @ref wlmtk_window_serial.
+ *
+ * @param window_ptr
+ *
+ * @return Number of pending updates.
+ */
+size_t wlmtk_window_pending_update_count(wlmtk_window_t *window_ptr);
+
 /**
  * Sets @ref wlmtk_window_t::workspace_ptr.
  *
@@ -68,6 +68,10 @@ struct _wlmtk_workspace_t {
     int                       initial_height;
     /** Edges currently active for resizing: `enum wlr_edges`. */
     uint32_t                  resize_edges;
+    /** Latest geometry of the resize, not yet requested from the window. */
+    struct wlr_box            resize_box;
+    /** Whether @ref wlmtk_workspace_t::resize_box is pending. */
+    bool                      resize_pending;
 
     /** Top left X coordinate of workspace. */
     int                       x1;
@@ -120,7 +124,11 @@ static bool pfsm_move_begin(wlmtk_fsm_t *fsm_ptr, void *ud_ptr);
 static bool pfsm_move_motion(wlmtk_fsm_t *fsm_ptr, void *ud_ptr);
 static bool pfsm_resize_begin(wlmtk_fsm_t *fsm_ptr, void *ud_ptr);
 static bool pfsm_resize_motion(wlmtk_fsm_t *fsm_ptr, void *ud_ptr);
+static bool pfsm_resize_end(wlmtk_fsm_t *fsm_ptr, void *ud_ptr);
 static bool pfsm_reset(wlmtk_fsm_t *fsm_ptr, void *ud_ptr);
+static void _wlmtk_workspace_flush_resize(
+    wlmtk_workspace_t *workspace_ptr,
+    size_t max_pending_updates);
 
 /* == Data ================================================================= */
 
@@ -158,11 +166,17 @@ static const wlmtk_fsm_transition_t pfsm_transitions[] = {
     { PFSMS_MOVE, PFSME_RESET, PFSMS_PASSTHROUGH, pfsm_reset },
     { PFSMS_PASSTHROUGH, PFSME_BEGIN_RESIZE, PFSMS_RESIZE, pfsm_resize_begin },
     { PFSMS_RESIZE, PFSME_MOTION, PFSMS_RESIZE, pfsm_resize_motion },
-    { PFSMS_RESIZE, PFSME_RELEASED, PFSMS_PASSTHROUGH, pfsm_reset },
+    { PFSMS_RESIZE, PFSME_RELEASED, PFSMS_PASSTHROUGH, pfsm_resize_end },
     { PFSMS_RESIZE, PFSME_RESET, PFSMS_PASSTHROUGH, pfsm_reset },
     WLMTK_FSM_TRANSITION_SENTINEL,
 };
 
+/**
+ * Maximum number of unacknowledged updates when flushing a resize on an
+ * output frame. Keeps slow clients from accumulating configure requests.
+ */
+static const size_t _wlmtk_workspace_resize_max_pending_updates = 2;
+
 /* == Exported methods ===================================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -187,6 +201,12 @@ wlmtk_workspace_t *wlmtk_workspace_create(
         wlmtk_workspace_destroy(workspace_ptr);
         return NULL;
     }
+    // Workspaces may hold many windows: Index them for pointer lookups.
+    if (!wlmtk_container_enable_spatial_index(
+            &workspace_ptr->window_container)) {
+        wlmtk_workspace_destroy(workspace_ptr);
+        return NULL;
+    }
     wlmtk_element_set_visible(
         &workspace_ptr->window_container.super_element,
         true);
@@ -603,6 +623,22 @@ void wlmtk_workspace_begin_window_resize(
     wlmtk_fsm_event(&workspace_ptr->fsm, PFSME_BEGIN_RESIZE, window_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmtk_workspace_flush_resize(wlmtk_workspace_t *workspace_ptr)
+{
+    _wlmtk_workspace_flush_resize(
+        workspace_ptr, _wlmtk_workspace_resize_max_pending_updates);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_workspace_window_updated(
+    wlmtk_workspace_t *workspace_ptr,
+    wlmtk_window_t *window_ptr)
+{
+    if (window_ptr != workspace_ptr->grabbed_window_ptr) return;
+    _wlmtk_workspace_flush_resize(workspace_ptr, 1);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Acticates `window_ptr`. Will de-activate an earlier window. */
 void wlmtk_workspace_activate_window(
@@ -690,6 +726,12 @@ wlmtk_element_t *wlmtk_workspace_element(wlmtk_workspace_t *workspace_ptr)
     return &workspace_ptr->super_container.super_element;
 }
 
+/* ------------------------------------------------------------------------- */
+size_t wlmtk_workspace_count_elements(wlmtk_workspace_t *workspace_ptr)
+{
+    return wlmtk_container_count_elements(&workspace_ptr->super_container);
+}
+
 /* == Fake workspace methods, useful for tests ============================= */
 
 static void wlmtk_fake_workspace_handle_window_mapped(
@@ -968,12 +1010,20 @@ bool pfsm_resize_begin(wlmtk_fsm_t *fsm_ptr, void *ud_ptr)
         workspace_ptr->grabbed_window_ptr,
         &workspace_ptr->initial_width,
         &workspace_ptr->initial_height);
+    workspace_ptr->resize_pending = false;
 
     return true;
 }
 
 /* ------------------------------------------------------------------------- */
-/** Handles motion during a resize. */
+/**
+ * Handles motion during a resize.
+ *
+ * Stores the new geometry, but requests it from the window only if the window
+ * has no pending updates. Otherwise, it is sent when the window catches up
+ * (@ref wlmtk_workspace_window_updated) or on the next output frame
+ * (@ref wlmtk_workspace_flush_resize).
+ */
 bool pfsm_resize_motion(wlmtk_fsm_t *fsm_ptr, __UNUSED__ void *ud_ptr)
 {
     wlmtk_workspace_t *workspace_ptr = BS_CONTAINER_OF(
@@ -1005,13 +1055,25 @@ bool pfsm_resize_motion(wlmtk_fsm_t *fsm_ptr, __UNUSED__ void *ud_ptr)
         if (right <= left) right = left + 1;
     }
 
-    wlmtk_window_request_position_and_size(
-        workspace_ptr->grabbed_window_ptr,
-        left, top,
-        right - left, bottom - top);
+    workspace_ptr->resize_box.x = left;
+    workspace_ptr->resize_box.y = top;
+    workspace_ptr->resize_box.width = right - left;
+    workspace_ptr->resize_box.height = bottom - top;
+    workspace_ptr->resize_pending = true;
+    _wlmtk_workspace_flush_resize(workspace_ptr, 1);
     return true;
 }
 
+/* ------------------------------------------------------------------------- */
+/** Ends a resize: Requests the final geometry, then resets. */
+bool pfsm_resize_end(wlmtk_fsm_t *fsm_ptr, void *ud_ptr)
+{
+    wlmtk_workspace_t *workspace_ptr = BS_CONTAINER_OF(
+        fsm_ptr, wlmtk_workspace_t, fsm);
+    _wlmtk_workspace_flush_resize(workspace_ptr, SIZE_MAX);
+    return pfsm_reset(fsm_ptr, ud_ptr);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Resets the state machine. */
 bool pfsm_reset(wlmtk_fsm_t *fsm_ptr, __UNUSED__ void *ud_ptr)
@@ -1019,9 +1081,36 @@ bool pfsm_reset(wlmtk_fsm_t *fsm_ptr, __UNUSED__ void *ud_ptr)
     wlmtk_workspace_t *workspace_ptr = BS_CONTAINER_OF(
         fsm_ptr, wlmtk_workspace_t, fsm);
     workspace_ptr->grabbed_window_ptr = NULL;
+    workspace_ptr->resize_pending = false;
     return true;
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Requests the pending resize geometry from the grabbed window, unless the
+ * window has already `max_pending_updates` or more pending updates.
+ *
+ * @param workspace_ptr
+ * @param max_pending_updates
+ */
+void _wlmtk_workspace_flush_resize(
+    wlmtk_workspace_t *workspace_ptr,
+    size_t max_pending_updates)
+{
+    if (!workspace_ptr->resize_pending ||
+        NULL == workspace_ptr->grabbed_window_ptr) return;
+    if (wlmtk_window_pending_update_count(
+            workspace_ptr->grabbed_window_ptr) >= max_pending_updates) return;
+
+    workspace_ptr->resize_pending = false;
+    wlmtk_window_request_position_and_size(
+        workspace_ptr->grabbed_window_ptr,
+        workspace_ptr->resize_box.x,
+        workspace_ptr->resize_box.y,
+        workspace_ptr->resize_box.width,
+        workspace_ptr->resize_box.height);
+}
+
 /* == Unit tests =========================================================== */
 
 static void test_create_destroy(bs_test_t *test_ptr);
@@ -1030,6 +1119,7 @@ static void test_button(bs_test_t *test_ptr);
 static void test_move(bs_test_t *test_ptr);
 static void test_unmap_during_move(bs_test_t *test_ptr);
 static void test_resize(bs_test_t *test_ptr);
+static void test_resize_throttled(bs_test_t *test_ptr);
 static void test_activate(bs_test_t *test_ptr);
 static void test_activate_cycling(bs_test_t *test_ptr);
 
@@ -1040,6 +1130,7 @@ const bs_test_case_t wlmtk_workspace_test_cases[] = {
     { 1, "move", test_move },
     { 1, "unmap_during_move", test_unmap_during_move },
     { 1, "resize", test_resize },
+    { 1, "resize_throttled", test_resize_throttled },
     { 1, "activate", test_activate },
     { 1, "activate_cycling", test_activate_cycling },
     { 0, NULL, NULL }
@@ -1313,6 +1404,75 @@ void test_resize(bs_test_t *test_ptr)
     wlmtk_fake_workspace_destroy(fws_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tests that resizing holds back updates while the window is busy. */
+void test_resize_throttled(bs_test_t *test_ptr)
+{
+    wlmtk_fake_workspace_t *fws_ptr = wlmtk_fake_workspace_create(1024, 768);
+    BS_ASSERT(NULL != fws_ptr);
+    wlmtk_fake_window_t *fw_ptr = wlmtk_fake_window_create();
+    BS_ASSERT(NULL != fw_ptr);
+    wlmtk_fake_content_t *fc_ptr = fw_ptr->fake_content_ptr;
+    wlmtk_window_request_position_and_size(fw_ptr->window_ptr, 0, 0, 40, 20);
+    wlmtk_fake_window_commit_size(fw_ptr);
+    wlmtk_workspace_motion(fws_ptr->workspace_ptr, 0, 0, 42);
+    wlmtk_workspace_map_window(fws_ptr->workspace_ptr, fw_ptr->window_ptr);
+
+    wlmtk_workspace_begin_window_resize(
+        fws_ptr->workspace_ptr, fw_ptr->window_ptr,
+        WLR_EDGE_BOTTOM | WLR_EDGE_RIGHT);
+
+    // No pending updates: The first motion is requested right away.
+    fc_ptr->serial = 1;
+    wlmtk_workspace_motion(fws_ptr->workspace_ptr, 1, 2, 43);
+    BS_TEST_VERIFY_EQ(test_ptr, 41, fc_ptr->requested_width);
+    BS_TEST_VERIFY_EQ(test_ptr, 22, fc_ptr->requested_height);
+
+    // Further motion is held back, until the next frame.
+    fc_ptr->serial = 2;
+    wlmtk_workspace_motion(fws_ptr->workspace_ptr, 3, 4, 44);
+    wlmtk_workspace_motion(fws_ptr->workspace_ptr, 5, 6, 45);
+    BS_TEST_VERIFY_EQ(test_ptr, 41, fc_ptr->requested_width);
+    BS_TEST_VERIFY_EQ(test_ptr, 22, fc_ptr->requested_height);
+    wlmtk_workspace_flush_resize(fws_ptr->workspace_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 45, fc_ptr->requested_width);
+    BS_TEST_VERIFY_EQ(test_ptr, 26, fc_ptr->requested_height);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 2, wlmtk_window_pending_update_count(fw_ptr->window_ptr));
+
+    // Too many pending updates: The frame does not flush.
+    fc_ptr->serial = 3;
+    wlmtk_workspace_motion(fws_ptr->workspace_ptr, 7, 8, 46);
+    wlmtk_workspace_flush_resize(fws_ptr->workspace_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 45, fc_ptr->requested_width);
+    BS_TEST_VERIFY_EQ(test_ptr, 26, fc_ptr->requested_height);
+
+    // Once the window caught up, the held-back geometry is requested.
+    wlmtk_fake_window_commit_size(fw_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 47, fc_ptr->requested_width);
+    BS_TEST_VERIFY_EQ(test_ptr, 28, fc_ptr->requested_height);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 1, wlmtk_window_pending_update_count(fw_ptr->window_ptr));
+
+    // Releasing the button requests the final geometry.
+    fc_ptr->serial = 4;
+    wlmtk_workspace_motion(fws_ptr->workspace_ptr, 9, 10, 47);
+    BS_TEST_VERIFY_EQ(test_ptr, 47, fc_ptr->requested_width);
+    struct wlr_pointer_button_event wlr_pointer_button_event = {
+        .button = BTN_LEFT,
+        .state = WLR_BUTTON_RELEASED,
+        .time_msec = 48,
+    };
+    wlmtk_workspace_button(fws_ptr->workspace_ptr, &wlr_pointer_button_event);
+    BS_TEST_VERIFY_EQ(test_ptr, 49, fc_ptr->requested_width);
+    BS_TEST_VERIFY_EQ(test_ptr, 30, fc_ptr->requested_height);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, fws_ptr->workspace_ptr->grabbed_window_ptr);
+
+    wlmtk_workspace_unmap_window(fws_ptr->workspace_ptr, fw_ptr->window_ptr);
+    wlmtk_fake_window_destroy(fw_ptr);
+    wlmtk_fake_workspace_destroy(fws_ptr);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Tests window activation. */
 void test_activate(bs_test_t *test_ptr)
@@ -246,6 +246,29 @@ void wlmtk_workspace_begin_window_resize(
     wlmtk_window_t *window_ptr,
     uint32_t edges);
 
+/**
+ * Requests the latest geometry of an ongoing window resize from the window,
+ * if there is one that was held back. To be called once per output frame.
+ *
+ * Motion during a resize only requests the new geometry right away if the
+ * window has no pending updates. This throttles configure requests to the
+ * rate of output frames, or to the rate the client keeps up with.
+ *
+ * @param workspace_ptr
+ */
+void wlmtk_workspace_flush_resize(wlmtk_workspace_t *workspace_ptr);
+
+/**
+ * Notifies the workspace that `window_ptr` has committed all pending updates.
+ * Requests a held-back resize geometry, if `window_ptr` is being resized.
+ *
+ * @param workspace_ptr
+ * @param window_ptr
+ */
+void wlmtk_workspace_window_updated(
+    wlmtk_workspace_t *workspace_ptr,
+    wlmtk_window_t *window_ptr);
+
 /** Acticates `window_ptr`. Will de-activate an earlier window. */
 void wlmtk_workspace_activate_window(
     wlmtk_workspace_t *workspace_ptr,
@@ -285,6 +308,9 @@ void wlmtk_workspace_raise_window(
 /** @return Pointer to wlmtk_workspace_t::super_container::super_element. */
 wlmtk_element_t *wlmtk_workspace_element(wlmtk_workspace_t *workspace_ptr);
 
+/** @return Number of elements in the workspace, recursively. */
+size_t wlmtk_workspace_count_elements(wlmtk_workspace_t *workspace_ptr);
+
 /** Fake workspace: A real workspace, but with a fake parent. For testing. */
 typedef struct {
     /** The workspace. */
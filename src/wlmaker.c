@@ -22,18 +22,18 @@
 #define _POSIX_C_SOURCE 200112L
 
 #include <libbase/libbase.h>
-#include <wlr/util/log.h>
 
-#include <limits.h>
-#include <regex.h>
+#include <signal.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <sys/types.h>
 
 #include "clip.h"
+#include "config.h"
 #include "dock.h"
 #include "server.h"
 #include "task_list.h"
+#include "wlr_log_bridge.h"
 
 /** Set of commands to be executed on startup. */
 static const char *autostarted_commands[] = {
@@ -41,67 +41,11 @@ static const char *autostarted_commands[] = {
     NULL  // sentinel.
 };
 
-/** Compiled regular expression for extracting file & line no. from wlr_log. */
-static regex_t                wlmaker_wlr_log_regex;
-/** Regular expression string for extracting file & line no. from wlr_log. */
-static const char             *wlmaker_wlr_log_regex_string =
-    "^\\[([^\\:]+)\\:([0-9]+)\\]\\ ";
-
-/* ------------------------------------------------------------------------- */
-/**
- * Wraps the wlr_log calls on bs_log.
- *
- * @param importance
- * @param fmt
- * @param args
- */
-static void wlr_to_bs_log(
-    enum wlr_log_importance importance,
-    const char *fmt,
-    va_list args)
-{
-    bs_log_severity_t severity = BS_DEBUG;
-
-    switch (importance) {
-    case WLR_SILENT:  // Fall-through to DEBUG severity.
-    case WLR_DEBUG: severity = BS_DEBUG; break;
-    case WLR_INFO: severity = BS_INFO; break;
-    case WLR_ERROR: severity = BS_ERROR; break;
-    default: severity = BS_INFO; break;
-    }
-
-    if (!bs_will_log(severity)) return;
-
-    // Log to buffer. Ignores overflows.
-    char buf[BS_LOG_MAX_BUF_SIZE];
-    vsnprintf(buf, sizeof(buf), fmt, args);
-
-    regmatch_t matches[4];
-    if (0 != regexec(&wlmaker_wlr_log_regex, buf, 4, &matches[0], 0) ||
-        matches[0].rm_so != 0 ||
-        !(matches[0].rm_eo >= 6) ||  // Minimum "[x:1] ".
-        matches[1].rm_so != 1 ||
-        !(matches[2].rm_so > 2) ||
-        matches[3].rm_so != -1) {
-        bs_log(severity, "%s (wlr_log unexpected format!)", buf);
-        return;
-    }
-
-    buf[matches[1].rm_eo] = '\0';
-    buf[matches[2].rm_eo] = '\0';
-    uint64_t line_no = 0;
-    bs_strconvert_uint64(&buf[matches[2].rm_so], &line_no, 10);
-    line_no = BS_MIN((uint64_t)INT_MAX, line_no);
-
-    bs_log_write(severity, &buf[matches[1].rm_so], (int)line_no, "%s",
-        &buf[matches[0].rm_eo]);
-}
-
 /* ------------------------------------------------------------------------- */
 /** Quits the server. */
 void handle_quit(wlmaker_server_t *server_ptr, __UNUSED__ void *arg_ptr)
 {
-    wl_display_terminate(server_ptr->wl_display_ptr);
+    wlmaker_server_terminate(server_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -204,6 +148,47 @@ void toggle_maximize(wlmaker_server_t *server_ptr, __UNUSED__ void *arg_ptr)
     }
 }
 
+/* ------------------------------------------------------------------------- */
+/** Enables or disables trace recording. Allocates the buffer, if needed. */
+void set_tracing(bool enabled)
+{
+#if !defined(WLMTK_TRACE)
+    if (enabled) {
+        bs_log(BS_WARNING, "Built without config_TRACE: No trace points.");
+        return;
+    }
+#endif  // !defined(WLMTK_TRACE)
+
+    // Allocates the buffer on first use. Later, recording continues into it.
+    if (enabled && 0 == wlmtk_trace_size() &&
+        !wlmtk_trace_init(config_trace_events)) return;
+    wlmtk_trace_set_enabled(enabled);
+    bs_log(BS_INFO, "Trace recording %s.", enabled ? "enabled" : "disabled");
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Writes recorded trace events to @ref config_trace_file_ptr, and logs the
+ * input-to-commit latencies.
+ */
+void dump_diagnostics(wlmaker_server_t *server_ptr, __UNUSED__ void *arg_ptr)
+{
+    wlmtk_trace_dump(config_trace_file_ptr);
+    wlmaker_latency_log(server_ptr->latency_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Handles SIGUSR1 and SIGUSR2: Dumps diagnostics, or toggles tracing. */
+int handle_trace_signal(int signal_number, void *data_ptr)
+{
+    if (SIGUSR1 == signal_number) {
+        dump_diagnostics(data_ptr, NULL);
+    } else {
+        set_tracing(!wlmtk_trace_enabled);
+    }
+    return 0;
+}
+
 /* == Main program ========================================================= */
 /** The main program. */
 int main(__UNUSED__ int argc, __UNUSED__ char *argv[])
@@ -213,26 +198,21 @@ int main(__UNUSED__ int argc, __UNUSED__ char *argv[])
     wlmaker_task_list_t       *task_list_ptr = NULL;
     bs_ptr_stack_t            subprocess_stack;
     bs_subprocess_t           *subprocess_ptr;
+    struct wl_event_source    *sigusr1_event_source_ptr = NULL;
+    struct wl_event_source    *sigusr2_event_source_ptr = NULL;
     int                       rv = EXIT_SUCCESS;
 
-    rv = regcomp(
-        &wlmaker_wlr_log_regex,
-        wlmaker_wlr_log_regex_string,
-        REG_EXTENDED);
-    if (0 != rv) {
-        char err_buf[512];
-        regerror(rv, &wlmaker_wlr_log_regex, err_buf, sizeof(err_buf));
-        bs_log(BS_ERROR, "Failed compiling regular expression: %s", err_buf);
-        return EXIT_FAILURE;
-    }
-
-    wlr_log_init(WLR_DEBUG, wlr_to_bs_log);
     bs_log_severity = BS_INFO;
+    wlmaker_wlr_log_bridge_init();
 
     BS_ASSERT(bs_ptr_stack_init(&subprocess_stack));
 
     wlmaker_server_t *server_ptr = wlmaker_server_create();
     if (NULL == server_ptr) return EXIT_FAILURE;
+    if (config_log_async) {
+        wlmaker_wlr_log_bridge_enable_async(
+            wl_display_get_event_loop(server_ptr->wl_display_ptr));
+    }
 
     wlmaker_server_bind_key(
         server_ptr,
@@ -291,6 +271,20 @@ int main(__UNUSED__ int argc, __UNUSED__ char *argv[])
         toggle_maximize,
         NULL);
 
+    wlmaker_server_bind_key(
+        server_ptr,
+        XKB_KEY_D,
+        WLR_MODIFIER_CTRL | WLR_MODIFIER_ALT | WLR_MODIFIER_LOGO,
+        dump_diagnostics,
+        NULL);
+    sigusr1_event_source_ptr = wl_event_loop_add_signal(
+        wl_display_get_event_loop(server_ptr->wl_display_ptr),
+        SIGUSR1, handle_trace_signal, server_ptr);
+    sigusr2_event_source_ptr = wl_event_loop_add_signal(
+        wl_display_get_event_loop(server_ptr->wl_display_ptr),
+        SIGUSR2, handle_trace_signal, server_ptr);
+    if (config_trace_enabled) set_tracing(true);
+
     rv = EXIT_SUCCESS;
     if (wlr_backend_start(server_ptr->wlr_backend_ptr)) {
         bs_log(BS_INFO, "Starting Wayland compositor for server %p at %s ...",
@@ -321,7 +315,7 @@ int main(__UNUSED__ int argc, __UNUSED__ char *argv[])
         if (NULL == dock_ptr || NULL == clip_ptr || NULL == task_list_ptr) {
             bs_log(BS_ERROR, "Failed to create dock, clip or task list.");
         } else {
-            wl_display_run(server_ptr->wl_display_ptr);
+            wlmaker_server_run(server_ptr);
         }
 
     } else {
@@ -332,6 +326,14 @@ int main(__UNUSED__ int argc, __UNUSED__ char *argv[])
     if (NULL != task_list_ptr) wlmaker_task_list_destroy(task_list_ptr);
     if (NULL != clip_ptr) wlmaker_clip_destroy(clip_ptr);
     if (NULL != dock_ptr) wlmaker_dock_destroy(dock_ptr);
+    if (NULL != sigusr2_event_source_ptr) {
+        wl_event_source_remove(sigusr2_event_source_ptr);
+    }
+    if (NULL != sigusr1_event_source_ptr) {
+        wl_event_source_remove(sigusr1_event_source_ptr);
+    }
+    wlmtk_trace_fini();
+    wlmaker_wlr_log_bridge_disable_async();
     wlmaker_server_destroy(server_ptr);
 
     while (NULL != (subprocess_ptr = bs_ptr_stack_pop(&subprocess_stack))) {
@@ -339,7 +341,6 @@ int main(__UNUSED__ int argc, __UNUSED__ char *argv[])
     }
 
     bs_ptr_stack_fini(&subprocess_stack);
-    regfree(&wlmaker_wlr_log_regex);
     return rv;
 }
 
@@ -19,18 +19,36 @@
  */
 
 #include "decorations.h"
+#include "icon_cache.h"
+#include "idle.h"
+#include "key_bindings.h"
+#include "latency.h"
 #include "layer_panel.h"
 #include "menu.h"
 #include "menu_item.h"
+#include "stats.h"
+#include "subprocess_monitor.h"
+#include "task_list.h"
+#include "wlr_log_bridge.h"
 #include "workspace.h"
+#include "xdg_toplevel.h"
 #include "xwl_content.h"
 
 /** WLMaker unit tests. */
 const bs_test_set_t wlmaker_tests[] = {
     { 1, "decorations", wlmaker_decorations_test_cases },
+    { 1, "icon_cache", wlmaker_icon_cache_test_cases },
+    { 1, "idle", wlmaker_idle_test_cases },
+    { 1, "key_bindings", wlmaker_key_bindings_test_cases },
+    { 1, "latency", wlmaker_latency_test_cases },
     { 1, "layer_panel", wlmaker_layer_panel_test_cases },
     { 1, "menu", wlmaker_menu_test_cases },
     { 1, "menu_item", wlmaker_menu_item_test_cases },
+    { 1, "stats", wlmaker_stats_test_cases },
+    { 1, "subprocess_monitor", wlmaker_subprocess_monitor_test_cases },
+    { 1, "task_list", wlmaker_task_list_test_cases },
+    { 1, "wlr_log_bridge", wlmaker_wlr_log_bridge_test_cases },
+    { 1, "xdg_toplevel", wlmaker_xdg_toplevel_test_cases },
     { 1, "xwl_content", wlmaker_xwl_content_test_cases },
     // Known to be broken, ignore for now. TODO(kaeser@gubbe.ch): Fix.
     { 0, "workspace", wlmaker_workspace_test_cases },
@@ -0,0 +1,398 @@
+/* ========================================================================= */
+/**
+ * @file wlr_log_bridge.c
+ *
+ * @copyright
+ * Copyright 2024 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "wlr_log_bridge.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <wlr/util/log.h>
+
+/* == Declarations ========================================================= */
+
+/** Number of messages the ring buffer holds. */
+#define WLMAKER_WLR_LOG_RING_SLOTS 256
+/** Size of a message in the ring buffer, including the terminating NUL. */
+#define WLMAKER_WLR_LOG_MESSAGE_SIZE 256
+/** Size of a file name in the ring buffer, including the terminating NUL. */
+#define WLMAKER_WLR_LOG_FILE_SIZE 64
+
+/** A message in the ring buffer. */
+typedef struct {
+    /** Severity of the message. */
+    bs_log_severity_t         severity;
+    /** File name. Points to a string literal of wlroots, or to `file`. */
+    const char                *file_ptr;
+    /** Line number. */
+    int                       line;
+    /** Storage for file names that were parsed from a formatted message. */
+    char                      file[WLMAKER_WLR_LOG_FILE_SIZE];
+    /** The formatted message. Truncated, if too long. */
+    char                      message[WLMAKER_WLR_LOG_MESSAGE_SIZE];
+} wlmaker_wlr_log_message_t;
+
+/** Ring buffer for asynchronous logging. */
+typedef struct {
+    /** The messages. */
+    wlmaker_wlr_log_message_t slots[WLMAKER_WLR_LOG_RING_SLOTS];
+    /** Index of the oldest message. */
+    size_t                    head;
+    /** Number of messages in the ring. */
+    size_t                    num_messages;
+    /** Messages dropped since the last flush, because the ring was full. */
+    uint64_t                  dropped;
+    /** Timer for flushing the ring. NULL when logging synchronously. */
+    struct wl_event_source    *timer_event_source_ptr;
+} wlmaker_wlr_log_ring_t;
+
+static void _wlmaker_wlr_log_bridge_handler(
+    enum wlr_log_importance importance,
+    const char *fmt_ptr,
+    va_list args);
+static bs_log_severity_t _wlmaker_wlr_log_bridge_severity(
+    enum wlr_log_importance importance);
+static enum wlr_log_importance _wlmaker_wlr_log_bridge_importance(
+    bs_log_severity_t severity);
+static bool _wlmaker_wlr_log_bridge_scan_prefix(
+    const char *str_ptr,
+    size_t *file_len_ptr,
+    int *line_ptr,
+    const char **message_ptr_ptr);
+
+static wlmaker_wlr_log_message_t *_wlmaker_wlr_log_ring_push(
+    wlmaker_wlr_log_ring_t *ring_ptr);
+static void _wlmaker_wlr_log_ring_flush(wlmaker_wlr_log_ring_t *ring_ptr);
+static int _wlmaker_wlr_log_ring_handle_timer(void *data_ptr);
+
+/* == Data ================================================================= */
+
+/** Format prefix added by `wlr_log` and `wlr_log_errno`. */
+static const char             _wlmaker_wlr_log_bridge_prefix[] = "[%s:%d] ";
+
+/** The ring buffer. */
+static wlmaker_wlr_log_ring_t _wlmaker_wlr_log_ring;
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_wlr_log_bridge_init(void)
+{
+    wlr_log_init(_wlmaker_wlr_log_bridge_importance(bs_log_severity),
+                 _wlmaker_wlr_log_bridge_handler);
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmaker_wlr_log_bridge_enable_async(
+    struct wl_event_loop *wl_event_loop_ptr)
+{
+    if (NULL != _wlmaker_wlr_log_ring.timer_event_source_ptr) return true;
+    _wlmaker_wlr_log_ring.timer_event_source_ptr = wl_event_loop_add_timer(
+        wl_event_loop_ptr,
+        _wlmaker_wlr_log_ring_handle_timer,
+        &_wlmaker_wlr_log_ring);
+    if (NULL == _wlmaker_wlr_log_ring.timer_event_source_ptr) {
+        bs_log(BS_ERROR, "Failed wl_event_loop_add_timer(%p, %p, %p)",
+               wl_event_loop_ptr, _wlmaker_wlr_log_ring_handle_timer,
+               &_wlmaker_wlr_log_ring);
+        return false;
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_wlr_log_bridge_disable_async(void)
+{
+    if (NULL == _wlmaker_wlr_log_ring.timer_event_source_ptr) return;
+    wl_event_source_remove(_wlmaker_wlr_log_ring.timer_event_source_ptr);
+    _wlmaker_wlr_log_ring.timer_event_source_ptr = NULL;
+    _wlmaker_wlr_log_ring_flush(&_wlmaker_wlr_log_ring);
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Log handler for wlroots. Passes messages on to `bs_log`, or to the ring.
+ *
+ * `wlr_log` prefixes the format with "[%s:%d] ", and passes file name and
+ * line as the first arguments. These are taken directly, without formatting
+ * and parsing the message. Other messages are formatted and then scanned for
+ * a "[file:line] " prefix.
+ *
+ * @param importance
+ * @param fmt_ptr
+ * @param args
+ */
+void _wlmaker_wlr_log_bridge_handler(
+    enum wlr_log_importance importance,
+    const char *fmt_ptr,
+    va_list args)
+{
+    bs_log_severity_t severity = _wlmaker_wlr_log_bridge_severity(importance);
+    if (!bs_will_log(severity)) return;
+    wlmaker_wlr_log_ring_t *ring_ptr = &_wlmaker_wlr_log_ring;
+
+    if (0 == strncmp(fmt_ptr, _wlmaker_wlr_log_bridge_prefix,
+                     sizeof(_wlmaker_wlr_log_bridge_prefix) - 1)) {
+        const char *file_ptr = va_arg(args, const char *);
+        int line = va_arg(args, int);
+        fmt_ptr += sizeof(_wlmaker_wlr_log_bridge_prefix) - 1;
+
+        if (NULL == ring_ptr->timer_event_source_ptr) {
+            bs_log_vwrite(severity, file_ptr, line, fmt_ptr, args);
+            return;
+        }
+        wlmaker_wlr_log_message_t *msg_ptr = _wlmaker_wlr_log_ring_push(
+            ring_ptr);
+        if (NULL == msg_ptr) return;
+        msg_ptr->severity = severity;
+        msg_ptr->file_ptr = file_ptr;  // A string literal within wlroots.
+        msg_ptr->line = line;
+        vsnprintf(msg_ptr->message, sizeof(msg_ptr->message), fmt_ptr, args);
+        return;
+    }
+
+    // Log to buffer. Ignores overflows.
+    char buf[BS_LOG_MAX_BUF_SIZE];
+    vsnprintf(buf, sizeof(buf), fmt_ptr, args);
+    const char *file_ptr = __FILE__;
+    int line = __LINE__;
+    const char *message_ptr = buf;
+    size_t file_len;
+    if (_wlmaker_wlr_log_bridge_scan_prefix(
+            buf, &file_len, &line, &message_ptr)) {
+        buf[1 + file_len] = '\0';
+        file_ptr = &buf[1];
+    }
+
+    if (NULL == ring_ptr->timer_event_source_ptr) {
+        bs_log_write(severity, file_ptr, line, "%s", message_ptr);
+        return;
+    }
+    wlmaker_wlr_log_message_t *msg_ptr = _wlmaker_wlr_log_ring_push(ring_ptr);
+    if (NULL == msg_ptr) return;
+    msg_ptr->severity = severity;
+    snprintf(msg_ptr->file, sizeof(msg_ptr->file), "%s", file_ptr);
+    msg_ptr->file_ptr = msg_ptr->file;
+    msg_ptr->line = line;
+    snprintf(msg_ptr->message, sizeof(msg_ptr->message), "%s", message_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Returns the `bs_log` severity for the wlroots log importance. */
+bs_log_severity_t _wlmaker_wlr_log_bridge_severity(
+    enum wlr_log_importance importance)
+{
+    switch (importance) {
+    case WLR_SILENT:  // Fall-through to DEBUG severity.
+    case WLR_DEBUG: return BS_DEBUG;
+    case WLR_INFO: return BS_INFO;
+    case WLR_ERROR: return BS_ERROR;
+    default: break;
+    }
+    return BS_INFO;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Returns the wlroots verbosity that covers the `bs_log` severity. */
+enum wlr_log_importance _wlmaker_wlr_log_bridge_importance(
+    bs_log_severity_t severity)
+{
+    if (severity <= BS_DEBUG) return WLR_DEBUG;
+    if (severity <= BS_INFO) return WLR_INFO;
+    return WLR_ERROR;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Scans for a "[file:line] " prefix of a formatted message.
+ *
+ * @param str_ptr
+ * @param file_len_ptr        Set to the length of the file name. The file
+ *                            name starts at `str_ptr + 1`.
+ * @param line_ptr            Set to the line number, clamped to `INT_MAX`.
+ * @param message_ptr_ptr     Set to the message, following the prefix.
+ *
+ * @return true if `str_ptr` has the prefix. Output arguments are not updated
+ *     otherwise.
+ */
+bool _wlmaker_wlr_log_bridge_scan_prefix(
+    const char *str_ptr,
+    size_t *file_len_ptr,
+    int *line_ptr,
+    const char **message_ptr_ptr)
+{
+    if ('[' != str_ptr[0]) return false;
+
+    const char *pos_ptr = str_ptr + 1;
+    while ('\0' != *pos_ptr && ':' != *pos_ptr && ']' != *pos_ptr) ++pos_ptr;
+    if (':' != *pos_ptr || pos_ptr == str_ptr + 1) return false;
+    size_t file_len = pos_ptr - (str_ptr + 1);
+
+    ++pos_ptr;
+    if ('0' > *pos_ptr || '9' < *pos_ptr) return false;
+    int line = 0;
+    for (; '0' <= *pos_ptr && '9' >= *pos_ptr; ++pos_ptr) {
+        int digit = *pos_ptr - '0';
+        line = (line > (INT_MAX - digit) / 10) ? INT_MAX : line * 10 + digit;
+    }
+    if (']' != pos_ptr[0] || ' ' != pos_ptr[1]) return false;
+
+    *file_len_ptr = file_len;
+    *line_ptr = line;
+    *message_ptr_ptr = pos_ptr + 2;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Adds a message to the ring, and arms the flush timer if the ring was empty.
+ *
+ * @param ring_ptr
+ *
+ * @return The message slot to fill in, or NULL if the ring is full.
+ */
+wlmaker_wlr_log_message_t *_wlmaker_wlr_log_ring_push(
+    wlmaker_wlr_log_ring_t *ring_ptr)
+{
+    if (WLMAKER_WLR_LOG_RING_SLOTS <= ring_ptr->num_messages) {
+        ring_ptr->dropped++;
+        return NULL;
+    }
+    size_t idx = (ring_ptr->head + ring_ptr->num_messages) %
+        WLMAKER_WLR_LOG_RING_SLOTS;
+    ring_ptr->num_messages++;
+
+    if (1 == ring_ptr->num_messages &&
+        NULL != ring_ptr->timer_event_source_ptr) {
+        wl_event_source_timer_update(ring_ptr->timer_event_source_ptr, 1);
+    }
+    return &ring_ptr->slots[idx];
+}
+
+/* ------------------------------------------------------------------------- */
+/** Writes and removes all messages of the ring. */
+void _wlmaker_wlr_log_ring_flush(wlmaker_wlr_log_ring_t *ring_ptr)
+{
+    for (; 0 < ring_ptr->num_messages; --ring_ptr->num_messages) {
+        wlmaker_wlr_log_message_t *msg_ptr = &ring_ptr->slots[ring_ptr->head];
+        bs_log_write(msg_ptr->severity, msg_ptr->file_ptr, msg_ptr->line,
+                     "%s", msg_ptr->message);
+        ring_ptr->head = (ring_ptr->head + 1) % WLMAKER_WLR_LOG_RING_SLOTS;
+    }
+    if (0 < ring_ptr->dropped) {
+        bs_log(BS_WARNING, "Dropped %"PRIu64" wlroots log messages.",
+               ring_ptr->dropped);
+        ring_ptr->dropped = 0;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Timer callback: Flushes the ring. */
+int _wlmaker_wlr_log_ring_handle_timer(void *data_ptr)
+{
+    _wlmaker_wlr_log_ring_flush(data_ptr);
+    return 0;
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_scan_prefix(bs_test_t *test_ptr);
+static void test_ring(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmaker_wlr_log_bridge_test_cases[] = {
+    { 1, "scan_prefix", test_scan_prefix },
+    { 1, "ring", test_ring },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Verifies the "[file:line] " prefix is found, and malformed ones are not. */
+void test_scan_prefix(bs_test_t *test_ptr)
+{
+    size_t file_len = 0;
+    int line = 0;
+    const char *message_ptr = NULL;
+
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, _wlmaker_wlr_log_bridge_scan_prefix(
+            "[backend/drm.c:42] hello", &file_len, &line, &message_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, 13, file_len);
+    BS_TEST_VERIFY_EQ(test_ptr, 42, line);
+    BS_TEST_VERIFY_STREQ(test_ptr, "hello", message_ptr);
+
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, _wlmaker_wlr_log_bridge_scan_prefix(
+            "[x:99999999999] ", &file_len, &line, &message_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, 1, file_len);
+    BS_TEST_VERIFY_EQ(test_ptr, INT_MAX, line);
+    BS_TEST_VERIFY_STREQ(test_ptr, "", message_ptr);
+
+    line = 7;
+    const char *bad[] = {
+        "", "x:1] a", "[:1] a", "[x1] a", "[x:] a", "[x:1a] a", "[x:1]a",
+        "[x:1", "[wayland] a", NULL };
+    for (const char **str_ptr_ptr = &bad[0]; NULL != *str_ptr_ptr;
+         ++str_ptr_ptr) {
+        BS_TEST_VERIFY_FALSE(
+            test_ptr, _wlmaker_wlr_log_bridge_scan_prefix(
+                *str_ptr_ptr, &file_len, &line, &message_ptr));
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, 7, line);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies the ring holds messages up to it's size, and counts drops. */
+void test_ring(bs_test_t *test_ptr)
+{
+    wlmaker_wlr_log_ring_t *ring_ptr = logged_calloc(
+        1, sizeof(wlmaker_wlr_log_ring_t));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, ring_ptr);
+
+    for (size_t i = 0; i < WLMAKER_WLR_LOG_RING_SLOTS + 2; ++i) {
+        wlmaker_wlr_log_message_t *msg_ptr = _wlmaker_wlr_log_ring_push(
+            ring_ptr);
+        if (i < WLMAKER_WLR_LOG_RING_SLOTS) {
+            BS_TEST_VERIFY_EQ(test_ptr, &ring_ptr->slots[i], msg_ptr);
+            if (NULL == msg_ptr) continue;
+            msg_ptr->severity = BS_DEBUG;
+            msg_ptr->file_ptr = __FILE__;
+            msg_ptr->line = __LINE__;
+            snprintf(msg_ptr->message, sizeof(msg_ptr->message), "%zu", i);
+        } else {
+            BS_TEST_VERIFY_EQ(test_ptr, NULL, msg_ptr);
+        }
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, WLMAKER_WLR_LOG_RING_SLOTS,
+                      ring_ptr->num_messages);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, ring_ptr->dropped);
+
+    _wlmaker_wlr_log_ring_flush(ring_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, ring_ptr->num_messages);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, ring_ptr->dropped);
+
+    // Wraps around.
+    BS_TEST_VERIFY_EQ(test_ptr, &ring_ptr->slots[0],
+                      _wlmaker_wlr_log_ring_push(ring_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, 1, ring_ptr->num_messages);
+    free(ring_ptr);
+}
+
+/* == End of wlr_log_bridge.c ============================================== */
@@ -0,0 +1,67 @@
+/* ========================================================================= */
+/**
+ * @file wlr_log_bridge.h
+ *
+ * @copyright
+ * Copyright 2024 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLR_LOG_BRIDGE_H__
+#define __WLR_LOG_BRIDGE_H__
+
+#include <stdbool.h>
+#include <libbase/libbase.h>
+#include <wayland-server-core.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Redirects wlroots logging into `bs_log`.
+ *
+ * The wlroots verbosity is set from the current `bs_log_severity`, so that
+ * wlroots drops messages that would not be logged before formatting them.
+ * Must be called again if `bs_log_severity` changes.
+ */
+void wlmaker_wlr_log_bridge_init(void);
+
+/**
+ * Enables asynchronous logging: Messages from wlroots are kept in a fixed
+ * size ring buffer, and written from a timer of the event loop. This keeps
+ * output I/O out of input and frame handling. Messages are dropped, and
+ * counted, if the ring overflows.
+ *
+ * @param wl_event_loop_ptr
+ *
+ * @return true on success.
+ */
+bool wlmaker_wlr_log_bridge_enable_async(
+    struct wl_event_loop *wl_event_loop_ptr);
+
+/**
+ * Writes all pending messages, and returns to synchronous logging. Must be
+ * called before the event loop is destroyed.
+ */
+void wlmaker_wlr_log_bridge_disable_async(void);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmaker_wlr_log_bridge_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLR_LOG_BRIDGE_H__ */
+/* == End of wlr_log_bridge.h ============================================== */
@@ -102,6 +102,7 @@ struct _wlmaker_workspace_t {
 };
 
 static void arrange_layers(wlmaker_workspace_t *workspace_ptr);
+static size_t count_scene_nodes(struct wlr_scene_node *wlr_scene_node_ptr);
 
 /* == Exported methods ===================================================== */
 
@@ -629,6 +630,27 @@ void wlmaker_workspace_get_details(
     *name_ptr_ptr = workspace_ptr->name_ptr;
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmaker_workspace_get_stats(
+    wlmaker_workspace_t *workspace_ptr,
+    wlmaker_workspace_stats_t *stats_ptr)
+{
+    memset(stats_ptr, 0, sizeof(wlmaker_workspace_stats_t));
+    stats_ptr->views = bs_dllist_size(&workspace_ptr->views) +
+        bs_dllist_size(&workspace_ptr->layer_views);
+    if (NULL != workspace_ptr->wlmtk_workspace_ptr) {
+        stats_ptr->windows = bs_dllist_size(
+            wlmtk_workspace_get_windows_dllist(
+                workspace_ptr->wlmtk_workspace_ptr));
+        stats_ptr->elements = wlmtk_workspace_count_elements(
+            workspace_ptr->wlmtk_workspace_ptr);
+    }
+    if (NULL != workspace_ptr->wlr_scene_tree_ptr) {
+        stats_ptr->scene_nodes = count_scene_nodes(
+            &workspace_ptr->wlr_scene_tree_ptr->node);
+    }
+}
+
 /* ------------------------------------------------------------------------- */
 void wlmaker_workspace_get_maximize_area(
     wlmaker_workspace_t *workspace_ptr,
@@ -732,6 +754,28 @@ void arrange_layers(wlmaker_workspace_t *workspace_ptr)
     }
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Counts the nodes of the scene graph, starting at `wlr_scene_node_ptr`.
+ *
+ * @param wlr_scene_node_ptr
+ *
+ * @return Number of nodes, including `wlr_scene_node_ptr`.
+ */
+size_t count_scene_nodes(struct wlr_scene_node *wlr_scene_node_ptr)
+{
+    size_t count = 1;
+    if (WLR_SCENE_NODE_TREE != wlr_scene_node_ptr->type) return count;
+
+    struct wlr_scene_tree *wlr_scene_tree_ptr = wl_container_of(
+        wlr_scene_node_ptr, wlr_scene_tree_ptr, node);
+    struct wlr_scene_node *child_node_ptr;
+    wl_list_for_each(child_node_ptr, &wlr_scene_tree_ptr->children, link) {
+        count += count_scene_nodes(child_node_ptr);
+    }
+    return count;
+}
+
 /* == Unit tests =========================================================== */
 
 /** Max fake calls. */
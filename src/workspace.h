@@ -286,6 +286,28 @@ void wlmaker_workspace_layer_surface_remove(
     wlmaker_workspace_layer_t layer,
     wlmaker_layer_surface_t *layer_surface_ptr);
 
+/** Counters of a workspace. */
+typedef struct {
+    /** Number of toolkit windows. */
+    size_t                    windows;
+    /** Number of views, on all layers. */
+    size_t                    views;
+    /** Number of toolkit elements, recursively. */
+    size_t                    elements;
+    /** Number of nodes in the workspace's scene graph subtree. */
+    size_t                    scene_nodes;
+} wlmaker_workspace_stats_t;
+
+/**
+ * Retrieves counters of this workspace. Walks the scene graph subtree.
+ *
+ * @param workspace_ptr
+ * @param stats_ptr
+ */
+void wlmaker_workspace_get_stats(
+    wlmaker_workspace_t *workspace_ptr,
+    wlmaker_workspace_stats_t *stats_ptr);
+
 /**
  * Retrieves the naming detalis of this workspace.
  *
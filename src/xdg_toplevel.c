@@ -22,8 +22,30 @@
 
 #include "xdg_popup.h"
 
+#include <inttypes.h>
+
 /* == Declarations ========================================================= */
 
+/** Committed state that affects the window's layout. */
+typedef struct {
+    /** Window the state was committed to. */
+    wlmtk_window_t            *window_ptr;
+    /** Width of the surface's committed geometry. */
+    int                       width;
+    /** Height of the surface's committed geometry. */
+    int                       height;
+    /** Width of the committed surface, sets the toolkit surface's size. */
+    int                       surface_width;
+    /** Height of the committed surface, sets the toolkit surface's size. */
+    int                       surface_height;
+    /** Configure serial that was acknowledged with the commit. */
+    uint32_t                  serial;
+    /** Whether the toplevel committed the maximized state. */
+    bool                      maximized;
+    /** Whether the toplevel committed the fullscreen state. */
+    bool                      fullscreen;
+} xdg_toplevel_commit_state_t;
+
 /** State of the content for an XDG toplevel surface. */
 typedef struct {
     /** Super class. */
@@ -67,6 +89,15 @@ typedef struct {
     struct wl_listener        toplevel_set_title_listener;
     /** Listener for `set_app_id` of `wlr_xdg_toplevel::events`. */
     struct wl_listener        toplevel_set_app_id_listener;
+
+    /** State of the last commit that was applied to the window. */
+    xdg_toplevel_commit_state_t last_commit;
+    /** Whether `last_commit` holds a state. */
+    bool                      last_commit_valid;
+    /** Number of commits that updated the window's layout. */
+    uint64_t                  layout_commits;
+    /** Number of content-only commits, where the layout was skipped. */
+    uint64_t                  content_only_commits;
 } xdg_toplevel_surface_t;
 
 static xdg_toplevel_surface_t *xdg_toplevel_surface_create(
@@ -90,6 +121,9 @@ static void handle_surface_unmap(
 static void handle_surface_commit(
     struct wl_listener *listener_ptr,
     void *data_ptr);
+static bool commit_is_content_only(
+    const xdg_toplevel_commit_state_t *last_ptr,
+    const xdg_toplevel_commit_state_t *state_ptr);
 static void handle_toplevel_request_maximize(
     struct wl_listener *listener_ptr,
     void *data_ptr);
@@ -285,6 +319,10 @@ void xdg_toplevel_surface_destroy(
     xdg_toplevel_surface_t *xdg_tl_surface_ptr)
 {
     xdg_toplevel_surface_t *xts_ptr = xdg_tl_surface_ptr;
+    bs_log(BS_DEBUG, "XDG toplevel %p: %"PRIu64" layout commits, "
+           "%"PRIu64" content-only commits.", xts_ptr,
+           xts_ptr->layout_commits, xts_ptr->content_only_commits);
+
     wl_list_remove(&xts_ptr->toplevel_set_app_id_listener.link);
     wl_list_remove(&xts_ptr->toplevel_set_title_listener.link);
     wl_list_remove(&xts_ptr->toplevel_set_parent_listener.link);
@@ -495,6 +533,9 @@ void handle_surface_unmap(
     wlmtk_workspace_unmap_window(
         wlmtk_window_get_workspace(window_ptr),
         window_ptr);
+
+    // A re-mapped window must have its layout applied from the first commit.
+    xdg_tl_surface_ptr->last_commit_valid = false;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -510,23 +551,73 @@ void handle_surface_commit(
 {
     xdg_toplevel_surface_t *xdg_tl_surface_ptr = BS_CONTAINER_OF(
         listener_ptr, xdg_toplevel_surface_t, surface_commit_listener);
+    WLMTK_TRACE_SCOPE("xdg_toplevel_commit");
 
     if (NULL == xdg_tl_surface_ptr->wlr_xdg_surface_ptr) return;
     BS_ASSERT(xdg_tl_surface_ptr->wlr_xdg_surface_ptr->role ==
               WLR_XDG_SURFACE_ROLE_TOPLEVEL);
 
+    struct wlr_xdg_surface *wlr_xdg_surface_ptr =
+        xdg_tl_surface_ptr->wlr_xdg_surface_ptr;
+    xdg_toplevel_commit_state_t state = {
+        .window_ptr = xdg_tl_surface_ptr->super_content.window_ptr,
+        .width = wlr_xdg_surface_ptr->current.geometry.width,
+        .height = wlr_xdg_surface_ptr->current.geometry.height,
+        .surface_width = wlr_xdg_surface_ptr->surface->current.width,
+        .surface_height = wlr_xdg_surface_ptr->surface->current.height,
+        .serial = wlr_xdg_surface_ptr->current.configure_serial,
+        .maximized = wlr_xdg_surface_ptr->toplevel->current.maximized,
+        .fullscreen = wlr_xdg_surface_ptr->toplevel->current.fullscreen
+    };
+
+    // Fast path: A content-only commit (eg. an animation frame) leaves
+    // geometry, surface size, serial and state as they were. Window layout,
+    // decoration and pending updates were all processed with the earlier
+    // commit, and the toolkit surface skips its parent's layout, too.
+    if (xdg_tl_surface_ptr->last_commit_valid &&
+        commit_is_content_only(&xdg_tl_surface_ptr->last_commit, &state)) {
+        ++xdg_tl_surface_ptr->content_only_commits;
+        return;
+    }
+    xdg_tl_surface_ptr->last_commit = state;
+    xdg_tl_surface_ptr->last_commit_valid = true;
+    ++xdg_tl_surface_ptr->layout_commits;
+
     wlmtk_content_commit(
         &xdg_tl_surface_ptr->super_content,
-        xdg_tl_surface_ptr->wlr_xdg_surface_ptr->current.geometry.width,
-        xdg_tl_surface_ptr->wlr_xdg_surface_ptr->current.geometry.height,
-        xdg_tl_surface_ptr->wlr_xdg_surface_ptr->current.configure_serial);
+        state.width,
+        state.height,
+        state.serial);
 
     wlmtk_window_commit_maximized(
         xdg_tl_surface_ptr->super_content.window_ptr,
-        xdg_tl_surface_ptr->wlr_xdg_surface_ptr->toplevel->current.maximized);
+        state.maximized);
     wlmtk_window_commit_fullscreen(
         xdg_tl_surface_ptr->super_content.window_ptr,
-        xdg_tl_surface_ptr->wlr_xdg_surface_ptr->toplevel->current.fullscreen);
+        state.fullscreen);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Classifies a commit as content-only, ie. not affecting the window layout.
+ *
+ * @param last_ptr            State of the last commit applied to the window.
+ * @param state_ptr           State of the current commit.
+ *
+ * @return true if the window's layout needs no update.
+ */
+bool commit_is_content_only(
+    const xdg_toplevel_commit_state_t *last_ptr,
+    const xdg_toplevel_commit_state_t *state_ptr)
+{
+    return (last_ptr->window_ptr == state_ptr->window_ptr &&
+            last_ptr->width == state_ptr->width &&
+            last_ptr->height == state_ptr->height &&
+            last_ptr->surface_width == state_ptr->surface_width &&
+            last_ptr->surface_height == state_ptr->surface_height &&
+            last_ptr->serial == state_ptr->serial &&
+            last_ptr->maximized == state_ptr->maximized &&
+            last_ptr->fullscreen == state_ptr->fullscreen);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -728,4 +819,52 @@ void handle_toplevel_set_app_id(
            xdg_tl_surface_ptr);
 }
 
+/* == Unit tests =========================================================== */
+
+static void test_commit_is_content_only(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmaker_xdg_toplevel_test_cases[] = {
+    { 1, "commit_is_content_only", test_commit_is_content_only },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Verifies that any layout-relevant change classifies as layout commit. */
+void test_commit_is_content_only(bs_test_t *test_ptr)
+{
+    xdg_toplevel_commit_state_t last = {
+        .window_ptr = NULL,
+        .width = 200, .height = 100,
+        .surface_width = 210, .surface_height = 110,
+        .serial = 42, .maximized = false, .fullscreen = false
+    };
+    xdg_toplevel_commit_state_t state = last;
+    BS_TEST_VERIFY_TRUE(test_ptr, commit_is_content_only(&last, &state));
+
+    // Window pointers are only compared, never dereferenced.
+    state.window_ptr = (wlmtk_window_t*)&state;
+    BS_TEST_VERIFY_FALSE(test_ptr, commit_is_content_only(&last, &state));
+    state = last;
+    state.width = 201;
+    BS_TEST_VERIFY_FALSE(test_ptr, commit_is_content_only(&last, &state));
+    state = last;
+    state.height = 101;
+    BS_TEST_VERIFY_FALSE(test_ptr, commit_is_content_only(&last, &state));
+    state = last;
+    state.surface_width = 211;
+    BS_TEST_VERIFY_FALSE(test_ptr, commit_is_content_only(&last, &state));
+    state = last;
+    state.surface_height = 111;
+    BS_TEST_VERIFY_FALSE(test_ptr, commit_is_content_only(&last, &state));
+    state = last;
+    state.serial = 43;
+    BS_TEST_VERIFY_FALSE(test_ptr, commit_is_content_only(&last, &state));
+    state = last;
+    state.maximized = true;
+    BS_TEST_VERIFY_FALSE(test_ptr, commit_is_content_only(&last, &state));
+    state = last;
+    state.fullscreen = true;
+    BS_TEST_VERIFY_FALSE(test_ptr, commit_is_content_only(&last, &state));
+}
+
 /* == End of xdg_toplevel.c ================================================ */
@@ -39,6 +39,9 @@ wlmtk_window_t *wlmtk_window_create_from_xdg_toplevel(
     struct wlr_xdg_surface *wlr_xdg_surface_ptr,
     wlmaker_server_t *server_ptr);
 
+/** Unit tests for XDG toplevel. */
+extern const bs_test_case_t wlmaker_xdg_toplevel_test_cases[];
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
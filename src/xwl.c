@@ -59,6 +59,11 @@
 
 #include "xwl.h"
 
+#include <errno.h>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
 #include <libbase/libbase.h>
 
 #define WLR_USE_UNSTABLE
@@ -67,6 +72,7 @@
 
 #include "toolkit/toolkit.h"
 
+#include "config.h"
 #include "xwl_content.h"
 #include "x11_cursor.xpm"
 
@@ -84,6 +90,18 @@ struct _wlmaker_xwl_t {
     struct wl_listener        ready_listener;
     /** Listener for the `new_surface` signal raised by `wlr_xwayland`. */
     struct wl_listener        new_surface_listener;
+    /** Listener for the `start` signal raised by `wlr_xwayland_server`. */
+    struct wl_listener        server_start_listener;
+
+    /** When the interface was created, in monotonic milliseconds. */
+    uint64_t                  create_msec;
+    /** When the XWayland server was started, in monotonic milliseconds. */
+    uint64_t                  start_msec;
+    /** Whether the XWayland server was started. */
+    bool                      started;
+
+    /** Timer for pre-warming the lazily started XWayland server. */
+    struct wl_event_source    *prewarm_timer_event_source_ptr;
 
     /** XCB atoms we consider relevant. */
     xcb_atom_t                xcb_atoms[XWL_MAX_ATOM_ID];
@@ -95,6 +113,12 @@ static void handle_ready(
 static void handle_new_surface(
     struct wl_listener *listener_ptr,
     void *data_ptr);
+static void handle_server_start(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static int handle_prewarm_timer(void *data_ptr);
+static void prewarm(wlmaker_xwl_t *xwl_ptr);
+static uint64_t rss_kb(pid_t pid);
 
 /* == Data ================================================================= */
 
@@ -120,18 +144,47 @@ wlmaker_xwl_t *wlmaker_xwl_create(wlmaker_server_t *server_ptr)
     wlmaker_xwl_t *xwl_ptr = logged_calloc(1, sizeof(wlmaker_xwl_t));
     if (NULL == xwl_ptr) return NULL;
     xwl_ptr->server_ptr = server_ptr;
+    xwl_ptr->create_msec = wlmtk_util_now_msec();
 
+    bool lazy = (WLMAKER_CONFIG_XWAYLAND_LAZY == config_xwayland);
     xwl_ptr->wlr_xwayland_ptr = wlr_xwayland_create(
         server_ptr->wl_display_ptr,
         server_ptr->wlr_compositor_ptr,
-        false);
+        lazy);
     if (NULL == xwl_ptr->wlr_xwayland_ptr) {
-        bs_log(BS_ERROR, "Failed wlr_xwayland_create(%p, %p, false).",
+        bs_log(BS_ERROR, "Failed wlr_xwayland_create(%p, %p, %d).",
                server_ptr->wl_display_ptr,
-               server_ptr->wlr_compositor_ptr);
+               server_ptr->wlr_compositor_ptr, lazy);
         wlmaker_xwl_destroy(xwl_ptr);
         return NULL;
     }
+    // Eager mode has already started the server; lazy mode will report it.
+    xwl_ptr->started = !lazy;
+    xwl_ptr->start_msec = xwl_ptr->create_msec;
+    wlmtk_util_connect_listener_signal(
+        &xwl_ptr->wlr_xwayland_ptr->server->events.start,
+        &xwl_ptr->server_start_listener,
+        handle_server_start);
+
+    if (lazy && 0 < config_xwayland_prewarm_idle_msec) {
+        xwl_ptr->prewarm_timer_event_source_ptr = wl_event_loop_add_timer(
+            wl_display_get_event_loop(server_ptr->wl_display_ptr),
+            handle_prewarm_timer,
+            xwl_ptr);
+        if (NULL == xwl_ptr->prewarm_timer_event_source_ptr) {
+            bs_log(BS_ERROR, "Failed wl_event_loop_add_timer(%p, %p, %p)",
+                   wl_display_get_event_loop(server_ptr->wl_display_ptr),
+                   handle_prewarm_timer, xwl_ptr);
+            wlmaker_xwl_destroy(xwl_ptr);
+            return NULL;
+        }
+        wl_event_source_timer_update(
+            xwl_ptr->prewarm_timer_event_source_ptr,
+            config_xwayland_prewarm_idle_msec);
+    }
+    bs_log(BS_INFO, "XWayland on %s: %s.",
+           xwl_ptr->wlr_xwayland_ptr->display_name,
+           lazy ? "Deferred until the first X11 client connects" : "Started");
 
     wlmtk_util_connect_listener_signal(
         &xwl_ptr->wlr_xwayland_ptr->events.ready,
@@ -151,7 +204,17 @@ wlmaker_xwl_t *wlmaker_xwl_create(wlmaker_server_t *server_ptr)
 /* ------------------------------------------------------------------------- */
 void wlmaker_xwl_destroy(wlmaker_xwl_t *xwl_ptr)
 {
+    if (NULL != xwl_ptr->prewarm_timer_event_source_ptr) {
+        wl_event_source_remove(xwl_ptr->prewarm_timer_event_source_ptr);
+        xwl_ptr->prewarm_timer_event_source_ptr = NULL;
+    }
+
     if (NULL != xwl_ptr->wlr_xwayland_ptr) {
+        if (!xwl_ptr->started) {
+            bs_log(BS_INFO, "XWayland was never started, for %"PRIu64" ms.",
+                   wlmtk_util_now_msec() - xwl_ptr->create_msec);
+        }
+        wlmtk_util_disconnect_listener(&xwl_ptr->server_start_listener);
         wlr_xwayland_destroy(xwl_ptr->wlr_xwayland_ptr);
         xwl_ptr->wlr_xwayland_ptr = NULL;
     }
@@ -269,6 +332,17 @@ void handle_ready(struct wl_listener *listener_ptr,
             0, 0);
         bs_gfxbuf_destroy(gfxbuf_ptr);
     }
+
+    // Reports what the lazy start saved: The compositor didn't wait for this
+    // startup, and did not hold the server's memory until the start.
+    struct wlr_xwayland_server *server_ptr = xwl_ptr->wlr_xwayland_ptr->server;
+    uint64_t msec = wlmtk_util_now_msec();
+    bs_log(BS_INFO, "XWayland on %s ready after %"PRIu64" ms, pid %d "
+           "RSS %"PRIu64" kB. Started %"PRIu64" ms after compositor.",
+           xwl_ptr->wlr_xwayland_ptr->display_name,
+           msec - xwl_ptr->start_msec, server_ptr->pid,
+           rss_kb(server_ptr->pid),
+           xwl_ptr->start_msec - xwl_ptr->create_msec);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -295,4 +369,109 @@ void handle_new_surface(struct wl_listener *listener_ptr,
     }
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Event handler for the `start` signal raised by `wlr_xwayland_server`.
+ *
+ * @param listener_ptr
+ * @param data_ptr
+ */
+void handle_server_start(struct wl_listener *listener_ptr,
+                         __UNUSED__ void *data_ptr)
+{
+    wlmaker_xwl_t *xwl_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_xwl_t, server_start_listener);
+    if (xwl_ptr->started) return;
+
+    xwl_ptr->started = true;
+    xwl_ptr->start_msec = wlmtk_util_now_msec();
+    if (NULL != xwl_ptr->prewarm_timer_event_source_ptr) {
+        wl_event_source_remove(xwl_ptr->prewarm_timer_event_source_ptr);
+        xwl_ptr->prewarm_timer_event_source_ptr = NULL;
+    }
+    bs_log(BS_INFO, "Starting XWayland on %s.",
+           xwl_ptr->wlr_xwayland_ptr->display_name);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Timer for pre-warming: Starts XWayland once there was no input for
+ * @ref config_xwayland_prewarm_idle_msec. Otherwise, re-arms for the
+ * remaining time.
+ *
+ * @param data_ptr            Untyped pointer to @ref wlmaker_xwl_t.
+ *
+ * @return 0.
+ */
+int handle_prewarm_timer(void *data_ptr)
+{
+    wlmaker_xwl_t *xwl_ptr = data_ptr;
+    if (xwl_ptr->started) return 0;
+
+    uint64_t idle_msec = wlmaker_idle_monitor_idle_msec(
+        xwl_ptr->server_ptr->idle_monitor_ptr);
+    if (idle_msec < (uint64_t)config_xwayland_prewarm_idle_msec) {
+        wl_event_source_timer_update(
+            xwl_ptr->prewarm_timer_event_source_ptr,
+            config_xwayland_prewarm_idle_msec - idle_msec);
+        return 0;
+    }
+    prewarm(xwl_ptr);
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Triggers the lazy start of XWayland, by connecting to it's socket. The
+ * connection is non-blocking and closed right away: wlroots starts the server
+ * as soon as a connection is pending.
+ *
+ * @param xwl_ptr
+ */
+void prewarm(wlmaker_xwl_t *xwl_ptr)
+{
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "/tmp/.X11-unix/X%d",
+             xwl_ptr->wlr_xwayland_ptr->server->display);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (0 > fd) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed socket(AF_UNIX, SOCK_STREAM)");
+        return;
+    }
+    if (0 != connect(fd, (struct sockaddr*)&addr, sizeof(addr)) &&
+        EINPROGRESS != errno && EAGAIN != errno) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed connect(%d, %s)",
+               fd, addr.sun_path);
+    } else {
+        bs_log(BS_INFO, "Pre-warming XWayland on %s.",
+               xwl_ptr->wlr_xwayland_ptr->display_name);
+    }
+    close(fd);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the resident set size of the process.
+ *
+ * @param pid
+ *
+ * @return The `VmRSS` of `pid`, in kB. 0 if unavailable.
+ */
+uint64_t rss_kb(pid_t pid)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/status", pid);
+    FILE *file_ptr = fopen(path, "r");
+    if (NULL == file_ptr) return 0;
+
+    uint64_t kb = 0;
+    char line[256];
+    while (NULL != fgets(line, sizeof(line), file_ptr)) {
+        if (1 == sscanf(line, "VmRSS: %"SCNu64, &kb)) break;
+    }
+    fclose(file_ptr);
+    return kb;
+}
+
 /* == End of xwl.c ========================================================= */